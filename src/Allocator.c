@@ -0,0 +1,76 @@
+#include "Allocator.h"
+#include <string.h>
+
+static void* allocator_heapAlloc(void* context, size_t size)
+{
+	(void)context;
+	return malloc(size);
+}
+
+static void* allocator_heapRealloc(void* context, void* block, size_t size)
+{
+	(void)context;
+	return realloc(block, size);
+}
+
+static void allocator_heapFree(void* context, void* block)
+{
+	(void)context;
+	free(block);
+}
+
+static const Allocator heapAllocator = { allocator_heapAlloc, allocator_heapRealloc, allocator_heapFree, NULL };
+
+// Properties.
+const Allocator* allocator_default()
+{
+	return &heapAllocator;
+}
+
+// Methods.
+void* allocator_alloc(const Allocator* a, size_t size)
+{
+	if (a == NULL)
+		return malloc(size);
+
+	return a->alloc(a->context, size);
+}
+
+void* allocator_calloc(const Allocator* a, size_t count, size_t size)
+{
+	if (a == NULL)
+		return calloc(count, size);
+
+	if (size != 0 && count > (size_t)-1 / size)
+		return NULL;
+
+	void* block = a->alloc(a->context, count * size);
+	if (block)
+		memset(block, 0, count * size);
+	return block;
+}
+
+void* allocator_realloc(const Allocator* a, void* block, size_t size)
+{
+	if (a == NULL)
+		return realloc(block, size);
+
+	return a->realloc(a->context, block, size);
+}
+
+void allocator_free(const Allocator* a, void* block)
+{
+	if (a == NULL)
+		free(block);
+	else if (block)
+		a->free(a->context, block);
+}
+
+char* allocator_strdup(const Allocator* a, const char* str)
+{
+	size_t length = strlen(str);
+	char* copy = allocator_alloc(a, length + 1);
+	if (copy)
+		memcpy(copy, str, length + 1);
+	return copy;
+}
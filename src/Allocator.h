@@ -0,0 +1,40 @@
+#ifndef ALLOCATOR
+#define ALLOCATOR
+
+#include <stdlib.h>
+
+// An allocator handle given to the constructors of the containers, so that the memory of a subsystem can be taken
+// from somewhere else than the heap, or accounted (see 'MemoryTracker'). The functions behave like 'malloc', 'realloc'
+// and 'free', and receive the context of the allocator as their first argument.
+// Do not call the functions directly. Use only methods that start with 'allocator_', which accept NULL as the default
+// allocator (the C heap), so an allocator is always optional.
+typedef struct {
+	void* (*alloc)(void* context, size_t size);
+	void* (*realloc)(void* context, void* block, size_t size);
+	void (*free)(void* context, void* block);
+	void* context;
+} Allocator;
+
+// PROPERTIES.
+
+// Get the allocator that uses 'malloc', 'realloc' and 'free'.
+const Allocator* allocator_default();
+
+// METHODS.
+
+// Returns a block of the given size, or NULL if it could not be allocated.
+void* allocator_alloc(const Allocator* a, size_t size);
+
+// Returns a block for 'count' elements of the given size with all the bytes set to 0, or NULL on failure.
+void* allocator_calloc(const Allocator* a, size_t count, size_t size);
+
+// Changes the size of the block (which can be NULL) like 'realloc'. On failure returns NULL and the block is unchanged.
+void* allocator_realloc(const Allocator* a, void* block, size_t size);
+
+// Gives the block (which can be NULL) back to the allocator it was taken from.
+void allocator_free(const Allocator* a, void* block);
+
+// Returns a copy of the string taken from the allocator, or NULL on failure.
+char* allocator_strdup(const Allocator* a, const char* str);
+
+#endif
@@ -0,0 +1,115 @@
+#include "Arena.h"
+#include <string.h>
+
+// Blocks are aligned to this many bytes, enough for any basic type.
+#define ARENA_ALIGNMENT 16
+
+// The size of the chunk header, rounded up so the memory after it is aligned.
+#define ARENA_HEADER ((sizeof(ArenaChunk) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+static size_t arena_align(size_t size)
+{
+	return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+// Constructor / Destructor.
+Arena* arena_create(size_t chunkSize)
+{
+	Arena* a = calloc(1, sizeof(Arena));
+	if (a)
+		a->chunkSize = chunkSize ? arena_align(chunkSize) : ARENA_DEFAULT_CHUNK;
+
+	return a;
+}
+
+void arena_destroy(Arena* a)
+{
+	if (a == NULL)
+		return;
+
+	while (a->first) {
+		ArenaChunk* next = a->first->next;
+		free(a->first);
+		a->first = next;
+	}
+
+	free(a);
+}
+
+// Properties.
+size_t arena_used(const Arena* a)
+{
+	if (a->current == NULL)
+		return 0;
+
+	size_t used = a->used;
+	for (const ArenaChunk* chunk = a->first; chunk && chunk != a->current; chunk = chunk->next)
+		used += chunk->size;
+
+	return used;
+}
+
+size_t arena_capacity(const Arena* a)
+{
+	size_t capacity = 0;
+	for (const ArenaChunk* chunk = a->first; chunk; chunk = chunk->next)
+		capacity += chunk->size;
+
+	return capacity;
+}
+
+// Methods.
+void* arena_alloc(Arena* a, size_t size)
+{
+	size = arena_align(size ? size : 1);
+
+	// Move to the next chunk that has room, allocating one at the end if there is none.
+	while (a->current == NULL || a->used + size > a->current->size) {
+		ArenaChunk* next = a->current ? a->current->next : a->first;
+		if (next == NULL) {
+			size_t chunkSize = size > a->chunkSize ? size : a->chunkSize;
+			if ((next = malloc(ARENA_HEADER + chunkSize)) == NULL)
+				return NULL;
+
+			next->next = NULL;
+			next->size = chunkSize;
+			if (a->current)
+				a->current->next = next;
+			else
+				a->first = next;
+		}
+
+		a->current = next;
+		a->used = 0;
+	}
+
+	void* block = (char*)a->current + ARENA_HEADER + a->used;
+	a->used += size;
+	return block;
+}
+
+void* arena_calloc(Arena* a, size_t count, size_t size)
+{
+	if (size != 0 && count > (size_t)-1 / size)
+		return NULL;
+
+	void* block = arena_alloc(a, count * size);
+	if (block)
+		memset(block, 0, count * size);
+	return block;
+}
+
+char* arena_strdup(Arena* a, const char* str)
+{
+	size_t length = strlen(str);
+	char* copy = arena_alloc(a, length + 1);
+	if (copy)
+		memcpy(copy, str, length + 1);
+	return copy;
+}
+
+void arena_reset(Arena* a)
+{
+	a->current = NULL;
+	a->used = 0;
+}
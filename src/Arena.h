@@ -0,0 +1,60 @@
+#ifndef ARENA
+#define ARENA
+
+#include <stdlib.h>
+
+// The default size of the chunks of an arena, in bytes.
+#define ARENA_DEFAULT_CHUNK 65536
+
+// A block of memory of an arena. The memory handed out follows the header.
+typedef struct ArenaChunk {
+	struct ArenaChunk* next;
+	size_t size;
+} ArenaChunk;
+
+// The internal data for a bump allocator: memory is handed out from big chunks by moving a pointer forward, and all of it
+// is given back at once with 'arena_reset', which keeps the chunks for the next use. Meant for the temporaries of one request
+// (for example the results of a query printed by the console), so the request does no 'malloc' or 'free' once the arena is warm.
+// Memory of an arena is never freed separately: objects that live in an arena must not be freed or reallocated.
+// Do not use struct members directly. Use only methods that start with 'arena_'.
+// The arena must be initialized with 'arena_create' and destroyed with 'arena_destroy'.
+// If not specified otherwise, arena pointer cannot be NULL in arena methods.
+typedef struct {
+	ArenaChunk* first;
+	ArenaChunk* current;
+	size_t used;
+	size_t chunkSize;
+} Arena;
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize an arena that allocates chunks of the given size (0 means ARENA_DEFAULT_CHUNK). No chunk is allocated yet.
+Arena* arena_create(size_t chunkSize);
+
+// Release all the memory of the arena and the arena itself. If arena is NULL nothing happens.
+void arena_destroy(Arena* a);
+
+// PROPERTIES.
+
+// Returns the number of bytes handed out since the last reset (including alignment padding).
+size_t arena_used(const Arena* a);
+
+// Returns the number of bytes of all the chunks of the arena.
+size_t arena_capacity(const Arena* a);
+
+// METHODS.
+
+// Returns a block of the given size, aligned for any type, or NULL if the memory could not be allocated.
+// Requests bigger than the chunk size get a chunk of their own.
+void* arena_alloc(Arena* a, size_t size);
+
+// Returns a block for 'count' elements of the given size, with all the bytes set to 0, or NULL on failure.
+void* arena_calloc(Arena* a, size_t count, size_t size);
+
+// Returns a copy of the string, or NULL on failure.
+char* arena_strdup(Arena* a, const char* str);
+
+// Give back all the memory handed out, keeping the chunks for the next allocations.
+void arena_reset(Arena* a);
+
+#endif
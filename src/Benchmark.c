@@ -0,0 +1,103 @@
+#include "Benchmark.h"
+#include <time.h>
+
+static int bench_compareSamples(const void* a, const void* b)
+{
+	long long x = *(const long long*)a, y = *(const long long*)b;
+	return (x > y) - (x < y);
+}
+
+static void bench_record(Benchmark* b, long long latency)
+{
+	if (b->ops++ % b->sampleStride == 0)
+		sampleVec_add(&b->samples, latency);
+	b->elapsed += latency;
+}
+
+long long bench_now()
+{
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Constructor / Destructor.
+void bench_begin(Benchmark* b, const char* name, size_t size, size_t expectedOps, long long budget)
+{
+	b->name = name;
+	b->size = size;
+	b->ops = 0;
+	b->expectedOps = expectedOps;
+	b->budget = budget;
+	b->began = bench_now();
+	b->elapsed = 0;
+	b->opStart = 0;
+	b->sampleStride = expectedOps > BENCH_MAX_SAMPLES ? (expectedOps + BENCH_MAX_SAMPLES - 1) / BENCH_MAX_SAMPLES : 1;
+	sampleVec_init(&b->samples);
+	sampleVec_reserve(&b->samples, expectedOps / b->sampleStride + 1);
+}
+
+void bench_free(Benchmark* b)
+{
+	sampleVec_free(&b->samples);
+}
+
+// Properties.
+size_t bench_ops(const Benchmark* b)
+{
+	return b->ops;
+}
+
+double bench_seconds(const Benchmark* b)
+{
+	return (double)b->elapsed / 1e9;
+}
+
+int bench_overBudget(const Benchmark* b)
+{
+	return b->budget > 0 && bench_now() - b->began > b->budget;
+}
+
+int bench_truncated(const Benchmark* b)
+{
+	return b->ops < b->expectedOps;
+}
+
+double bench_opsPerSecond(const Benchmark* b)
+{
+	return b->elapsed > 0 ? (double)b->ops / bench_seconds(b) : 0.0;
+}
+
+long long bench_percentile(const Benchmark* b, double fraction)
+{
+	size_t count = sampleVec_length(&b->samples);
+	if (count == 0)
+		return 0;
+
+	size_t index = (size_t)(fraction * (double)count);
+	return *sampleVec_at(&b->samples, index < count ? index : count - 1);
+}
+
+// Methods.
+void bench_startOp(Benchmark* b)
+{
+	b->opStart = bench_now();
+}
+
+void bench_stopOp(Benchmark* b)
+{
+	bench_record(b, bench_now() - b->opStart);
+}
+
+void bench_end(Benchmark* b)
+{
+	qsort(sampleVec_array(&b->samples), sampleVec_length(&b->samples), sizeof(long long), bench_compareSamples);
+}
+
+void bench_writeJson(const Benchmark* b, FILE* out)
+{
+	fprintf(out, "{\"name\": \"%s\", \"size\": %zu, \"ops\": %zu, \"expectedOps\": %zu, \"seconds\": %.6f, \"opsPerSecond\": %.1f, "
+		"\"p50Ns\": %lld, \"p99Ns\": %lld, \"maxNs\": %lld}",
+		b->name, b->size, b->ops, b->expectedOps, bench_seconds(b), bench_opsPerSecond(b),
+		bench_percentile(b, 0.50), bench_percentile(b, 0.99), bench_percentile(b, 1.0));
+}
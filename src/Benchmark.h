@@ -0,0 +1,83 @@
+#ifndef BENCHMARK
+#define BENCHMARK
+
+#include "TypedVector.h"
+#include <stdio.h>
+
+// The maximum number of latencies kept by a benchmark. Longer runs keep every n-th latency, so memory stays bounded.
+#define BENCH_MAX_SAMPLES 1000000
+
+// The latencies of single operations, in nanoseconds.
+VECTOR_DEFINE(long long, SampleVector, sampleVec)
+
+// The internal data for the measurement of one operation at one catalog size: the total time of the operations,
+// from which the throughput is computed, and the latencies of single operations, from which the percentiles are computed.
+// Do not use struct members directly. Use only methods that start with 'bench_'.
+// A benchmark is a plain value: start it with 'bench_begin', time every operation between 'bench_startOp' and 'bench_stopOp',
+// finish it with 'bench_end' and release it with 'bench_free'. It can be started again after it is released.
+// A benchmark can have a time budget, so that operations that are too slow at big sizes end in a reasonable time:
+// the loop of operations checks 'bench_overBudget' and stops early, and the results show fewer operations than expected.
+// If not specified otherwise, benchmark pointer cannot be NULL in benchmark methods.
+typedef struct {
+	const char* name;
+	size_t size;
+	size_t ops;
+	size_t expectedOps;
+	long long began;
+	long long budget;
+	long long elapsed;
+	long long opStart;
+	size_t sampleStride;
+	SampleVector samples;
+} Benchmark;
+
+// Returns the time in nanoseconds from an unspecified point, for measuring intervals.
+long long bench_now();
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Start measuring the operation with the given name (the string must stay valid while the benchmark is used) on a catalog
+// of the given size. 'expectedOps' is the number of operations that will be timed, used to choose which latencies are kept.
+// 'budget' is the time in nanoseconds after which the benchmark should stop (0 means no limit).
+void bench_begin(Benchmark* b, const char* name, size_t size, size_t expectedOps, long long budget);
+
+// Release the latencies of the benchmark.
+void bench_free(Benchmark* b);
+
+// PROPERTIES.
+
+// Get the number of operations timed.
+size_t bench_ops(const Benchmark* b);
+
+// Get the total time of the timed operations, in seconds.
+double bench_seconds(const Benchmark* b);
+
+// Returns 1 if the benchmark was started more than its budget ago (so the loop of operations should stop), otherwise 0.
+int bench_overBudget(const Benchmark* b);
+
+// Returns 1 if fewer operations than expected were timed (the benchmark ran out of budget), otherwise 0.
+int bench_truncated(const Benchmark* b);
+
+// Get the number of operations per second (0 if no time was measured).
+double bench_opsPerSecond(const Benchmark* b);
+
+// Get the latency, in nanoseconds, that the given fraction (from 0 to 1) of the operations did not exceed.
+// Returns 0 if no operation was timed. Valid only after 'bench_end'.
+long long bench_percentile(const Benchmark* b, double fraction);
+
+// METHODS.
+
+// Start timing one operation.
+void bench_startOp(Benchmark* b);
+
+// Stop timing the operation started by 'bench_startOp'.
+void bench_stopOp(Benchmark* b);
+
+// Finish the measurement.
+void bench_end(Benchmark* b);
+
+// Write the results as a JSON object, on a single line, with the keys:
+// name, size, ops, expectedOps, seconds, opsPerSecond, p50Ns, p99Ns, maxNs.
+void bench_writeJson(const Benchmark* b, FILE* out);
+
+#endif
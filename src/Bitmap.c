@@ -0,0 +1,178 @@
+#include "Bitmap.h"
+#include <string.h>
+
+// Returns the number of words needed for the given number of bits.
+static size_t bitmap_wordsFor(size_t length)
+{
+	return (length + BITMAP_WORD_BITS - 1) / BITMAP_WORD_BITS;
+}
+
+// Returns the number of set bits of the word.
+static size_t bitmap_popCount(unsigned long long w)
+{
+	w = w - ((w >> 1) & 0x5555555555555555ull);
+	w = (w & 0x3333333333333333ull) + ((w >> 2) & 0x3333333333333333ull);
+	w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+	return (size_t)((w * 0x0101010101010101ull) >> 56);
+}
+
+// Returns the index of the lowest set bit of a non zero word.
+static size_t bitmap_lowestBit(unsigned long long w)
+{
+	return bitmap_popCount((w & (0 - w)) - 1);
+}
+
+// Constructor / Destructor.
+Bitmap* bitmap_create(size_t length)
+{
+	Bitmap* b = calloc(1, sizeof(Bitmap));
+	if (b && !bitmap_reset(b, length)) {
+		free(b);
+		b = NULL;
+	}
+
+	return b;
+}
+
+Bitmap* bitmap_createInArena(Arena* arena, size_t length)
+{
+	if (arena == NULL)
+		return bitmap_create(length);
+
+	Bitmap* b = arena_calloc(arena, 1, sizeof(Bitmap));
+	if (b) {
+		b->arena = arena;
+		if (!bitmap_reset(b, length))
+			b = NULL;
+	}
+
+	return b;
+}
+
+void bitmap_destroy(Bitmap* b)
+{
+	if (b == NULL || b->arena)
+		return;
+
+	free(b->words);
+	free(b);
+}
+
+// Properties.
+size_t bitmap_length(const Bitmap* b)
+{
+	return b->length;
+}
+
+const unsigned long long* bitmap_words(const Bitmap* b)
+{
+	return b->words;
+}
+
+unsigned long long* bitmap_wordsMutable(Bitmap* b)
+{
+	return b->words;
+}
+
+size_t bitmap_wordCount(const Bitmap* b)
+{
+	return bitmap_wordsFor(b->length);
+}
+
+int bitmap_get(const Bitmap* b, size_t index)
+{
+	if (index >= b->length)
+		return 0;
+
+	return (b->words[index / BITMAP_WORD_BITS] >> (index % BITMAP_WORD_BITS)) & 1;
+}
+
+void bitmap_set(Bitmap* b, size_t index, int value)
+{
+	if (index >= b->length)
+		return;
+
+	unsigned long long mask = 1ull << (index % BITMAP_WORD_BITS);
+	if (value)
+		b->words[index / BITMAP_WORD_BITS] |= mask;
+	else
+		b->words[index / BITMAP_WORD_BITS] &= ~mask;
+}
+
+// Methods.
+int bitmap_reset(Bitmap* b, size_t length)
+{
+	size_t wordCount = bitmap_wordsFor(length);
+	if (wordCount > b->wordCapacity) {
+		// The bits are cleared below, so there is nothing to copy to new words from an arena.
+		unsigned long long* newWords = b->arena
+			? arena_alloc(b->arena, wordCount * sizeof(unsigned long long))
+			: realloc(b->words, wordCount * sizeof(unsigned long long));
+		if (newWords == NULL)
+			return 0;
+		b->words = newWords;
+		b->wordCapacity = wordCount;
+	}
+
+	b->length = length;
+	if (wordCount > 0)
+		memset(b->words, 0, wordCount * sizeof(unsigned long long));
+	return 1;
+}
+
+void bitmap_fill(Bitmap* b, int value)
+{
+	size_t wordCount = bitmap_wordsFor(b->length);
+	if (wordCount == 0)
+		return;
+
+	memset(b->words, value ? 0xFF : 0, wordCount * sizeof(unsigned long long));
+
+	// Keep the bits after the length cleared.
+	if (value && b->length % BITMAP_WORD_BITS != 0)
+		b->words[wordCount - 1] = (1ull << (b->length % BITMAP_WORD_BITS)) - 1;
+}
+
+void bitmap_and(Bitmap* b, const Bitmap* other)
+{
+	for (size_t i = 0; i < bitmap_wordsFor(b->length); ++i)
+		b->words[i] &= other->words[i];
+}
+
+void bitmap_or(Bitmap* b, const Bitmap* other)
+{
+	for (size_t i = 0; i < bitmap_wordsFor(b->length); ++i)
+		b->words[i] |= other->words[i];
+}
+
+void bitmap_andNot(Bitmap* b, const Bitmap* other)
+{
+	for (size_t i = 0; i < bitmap_wordsFor(b->length); ++i)
+		b->words[i] &= ~other->words[i];
+}
+
+size_t bitmap_count(const Bitmap* b)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < bitmap_wordsFor(b->length); ++i)
+		count += bitmap_popCount(b->words[i]);
+
+	return count;
+}
+
+size_t bitmap_next(const Bitmap* b, size_t from)
+{
+	if (from >= b->length)
+		return b->length;
+
+	size_t wordIndex = from / BITMAP_WORD_BITS;
+	unsigned long long w = b->words[wordIndex] & (~0ull << (from % BITMAP_WORD_BITS));
+
+	while (w == 0) {
+		if (++wordIndex >= bitmap_wordsFor(b->length))
+			return b->length;
+		w = b->words[wordIndex];
+	}
+
+	return wordIndex * BITMAP_WORD_BITS + bitmap_lowestBit(w);
+}
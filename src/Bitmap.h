@@ -0,0 +1,77 @@
+#ifndef BITMAP
+#define BITMAP
+
+#include "Arena.h"
+#include <stdlib.h>
+
+// The internal data used to represent a fixed length sequence of bits, used as a selection of rows.
+// Do not use struct members directly. Use only methods that start with 'bitmap_'.
+// You need to initialize the bitmap with 'bitmap_create', and destroy it with 'bitmap_destroy' when you are done.
+// A bitmap can also live in an arena (see 'bitmap_createInArena'), like a vector.
+// If not specified otherwise, bitmap pointer cannot be NULL in bitmap methods.
+typedef struct {
+	unsigned long long* words;
+	size_t length;
+	size_t wordCapacity;
+	Arena* arena;
+} Bitmap;
+
+// The number of bits stored in a word of the bitmap.
+#define BITMAP_WORD_BITS 64
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize a bitmap with the given number of bits, all cleared.
+Bitmap* bitmap_create(size_t length);
+
+// Initialize a bitmap like 'bitmap_create', allocated from the arena. If arena is NULL, same as 'bitmap_create'.
+// The bitmap can still be destroyed with 'bitmap_destroy', which does nothing for a bitmap in an arena.
+Bitmap* bitmap_createInArena(Arena* arena, size_t length);
+
+// Destroy the bitmap. If pointer is NULL nothing happens.
+void bitmap_destroy(Bitmap* b);
+
+// PROPERTIES.
+
+// Get the number of bits in the bitmap.
+size_t bitmap_length(const Bitmap* b);
+
+// Get the words holding the bits (bit 'i' is bit 'i % 64' of word 'i / 64'). The bits after the length are always cleared.
+const unsigned long long* bitmap_words(const Bitmap* b);
+
+// Get the modifiable words of the bitmap. Keep the bits after the length cleared.
+unsigned long long* bitmap_wordsMutable(Bitmap* b);
+
+// Get the number of words used by the bitmap.
+size_t bitmap_wordCount(const Bitmap* b);
+
+// Returns 1 if the bit on the specified index is set, 0 otherwise (or if the index is invalid).
+int bitmap_get(const Bitmap* b, size_t index);
+
+// Set the bit on the specified index to the given value (0 or not 0). If index is invalid nothing happens.
+void bitmap_set(Bitmap* b, size_t index, int value);
+
+// METHODS.
+
+// Change the number of bits, all bits are cleared. Returns 1 on success, 0 if the memory could not be allocated.
+int bitmap_reset(Bitmap* b, size_t length);
+
+// Clear or set all the bits.
+void bitmap_fill(Bitmap* b, int value);
+
+// Keep only the bits that are also set in the other bitmap. The bitmaps must have the same length.
+void bitmap_and(Bitmap* b, const Bitmap* other);
+
+// Set the bits that are set in the other bitmap. The bitmaps must have the same length.
+void bitmap_or(Bitmap* b, const Bitmap* other);
+
+// Clear the bits that are set in the other bitmap. The bitmaps must have the same length.
+void bitmap_andNot(Bitmap* b, const Bitmap* other);
+
+// Returns the number of set bits.
+size_t bitmap_count(const Bitmap* b);
+
+// Returns the index of the first set bit on an index greater or equal to 'from', or the length if there is none.
+size_t bitmap_next(const Bitmap* b, size_t from);
+
+#endif
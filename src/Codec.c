@@ -0,0 +1,310 @@
+#include "Codec.h"
+#include <string.h>
+
+// The size of the buffer of a reader when it is first filled.
+#define CODEC_READ_BUFFER 0x1000
+
+// Reads from a file. Clears the end of the file, so the bytes appended later are read by the next fill.
+static size_t codec_fillFile(void* source, unsigned char* bytes, size_t size)
+{
+	FILE* file = source;
+	size_t read = fread(bytes, 1, size, file);
+	if (read < size && feof(file))
+		clearerr(file);
+	return read;
+}
+
+// Makes room for 'count' more bytes. Returns 0 if the buffer could not grow.
+static int codecWriter_reserve(CodecWriter* w, size_t count)
+{
+	if (w->length + count <= w->capacity)
+		return 1;
+
+	size_t newCapacity = w->capacity ? w->capacity * 2 : 64;
+	while (newCapacity < w->length + count)
+		newCapacity *= 2;
+
+	unsigned char* newBytes = realloc(w->bytes, newCapacity);
+	if (newBytes == NULL) {
+		w->failed = 1;
+		return 0;
+	}
+
+	w->bytes = newBytes;
+	w->capacity = newCapacity;
+	return 1;
+}
+
+// Reads more bytes from the source after the buffered ones, dropping the bytes before the mark to make room.
+// Returns 0 if there are none for now.
+static int codecReader_fill(CodecReader* r)
+{
+	if (r->mark > 0) {
+		memmove(r->bytes, r->bytes + r->mark, r->length - r->mark);
+		r->length -= r->mark;
+		r->position -= r->mark;
+		r->mark = 0;
+	}
+
+	if (r->length == r->capacity) {
+		size_t newCapacity = r->capacity ? r->capacity * 2 : CODEC_READ_BUFFER;
+		unsigned char* newBytes = realloc(r->bytes, newCapacity);
+		if (newBytes == NULL)
+			return 0;
+		r->bytes = newBytes;
+		r->capacity = newCapacity;
+	}
+
+	size_t read = r->fill(r->source, r->bytes + r->length, r->capacity - r->length);
+	r->length += read;
+	return read > 0;
+}
+
+// Constructor / Destructor.
+void codecWriter_init(CodecWriter* w)
+{
+	w->bytes = NULL;
+	w->length = w->capacity = 0;
+	w->failed = 0;
+}
+
+void codecWriter_free(CodecWriter* w)
+{
+	free(w->bytes);
+	codecWriter_init(w);
+}
+
+void codecReader_init(CodecReader* r, CodecFill fill, void* source)
+{
+	r->fill = fill;
+	r->source = source;
+	r->bytes = NULL;
+	r->length = r->capacity = r->position = r->mark = 0;
+	r->starved = 0;
+}
+
+void codecReader_initFile(CodecReader* r, FILE* file)
+{
+	codecReader_init(r, codec_fillFile, file);
+}
+
+void codecReader_free(CodecReader* r)
+{
+	free(r->bytes);
+	codecReader_init(r, r->fill, r->source);
+}
+
+// Properties.
+const unsigned char* codecWriter_bytes(const CodecWriter* w)
+{
+	return w->bytes;
+}
+
+size_t codecWriter_length(const CodecWriter* w)
+{
+	return w->length;
+}
+
+int codecWriter_failed(const CodecWriter* w)
+{
+	return w->failed;
+}
+
+int codecReader_starved(const CodecReader* r)
+{
+	return r->starved;
+}
+
+// Methods.
+void codecWriter_clear(CodecWriter* w)
+{
+	w->length = 0;
+	w->failed = 0;
+}
+
+void codecWriter_discard(CodecWriter* w, size_t count)
+{
+	if (count >= w->length)
+		w->length = 0;
+	else {
+		memmove(w->bytes, w->bytes + count, w->length - count);
+		w->length -= count;
+	}
+}
+
+void codecWriter_writeByte(CodecWriter* w, unsigned char byte)
+{
+	if (codecWriter_reserve(w, 1))
+		w->bytes[w->length++] = byte;
+}
+
+void codecWriter_writeBytes(CodecWriter* w, const void* bytes, size_t count)
+{
+	if (count > 0 && codecWriter_reserve(w, count)) {
+		memcpy(w->bytes + w->length, bytes, count);
+		w->length += count;
+	}
+}
+
+void codecWriter_writeNumber(CodecWriter* w, unsigned long long number)
+{
+	while (number >= 0x80) {
+		codecWriter_writeByte(w, (unsigned char)(number | 0x80));
+		number >>= 7;
+	}
+	codecWriter_writeByte(w, (unsigned char)number);
+}
+
+void codecWriter_writeSigned(CodecWriter* w, long long number)
+{
+	codecWriter_writeNumber(w, number < 0 ? ((unsigned long long)(-(number + 1)) << 1) | 1 : (unsigned long long)number << 1);
+}
+
+void codecWriter_writeString(CodecWriter* w, const char* str)
+{
+	size_t length = str ? strlen(str) : 0;
+	codecWriter_writeNumber(w, str ? length + 1 : 0);
+	codecWriter_writeBytes(w, str, length);
+}
+
+void codecWriter_writeDate(CodecWriter* w, Date date)
+{
+	codecWriter_writeSigned(w, date.year);
+	codecWriter_writeNumber(w, (unsigned long long)(date.month * 32 + date.day));
+}
+
+void codecWriter_writeMaterial(CodecWriter* w, const Material* mat)
+{
+	codecWriter_writeSigned(w, material_id(mat));
+	codecWriter_writeString(w, material_name(mat));
+	codecWriter_writeString(w, material_supplier(mat));
+	codecWriter_writeSigned(w, material_quantity(mat));
+	codecWriter_writeDate(w, material_expDate(mat));
+}
+
+int codecReader_hasMore(CodecReader* r)
+{
+	return r->position < r->length || codecReader_fill(r);
+}
+
+int codecReader_ensure(CodecReader* r, size_t count)
+{
+	while (r->length - r->position < count) {
+		if (!codecReader_fill(r)) {
+			r->starved = r->length < r->capacity;
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+void codecReader_mark(CodecReader* r)
+{
+	r->mark = r->position;
+	r->starved = 0;
+}
+
+void codecReader_rewind(CodecReader* r)
+{
+	r->position = r->mark;
+	r->starved = 0;
+}
+
+unsigned char codecReader_readByte(CodecReader* r, int* ok)
+{
+	if (!*ok)
+		return 0;
+
+	if (r->position == r->length && !codecReader_fill(r)) {
+		r->starved = 1;
+		*ok = 0;
+		return 0;
+	}
+
+	return r->bytes[r->position++];
+}
+
+void codecReader_readBytes(CodecReader* r, void* bytes, size_t count, int* ok)
+{
+	unsigned char* to = bytes;
+	while (count > 0 && *ok) {
+		if (r->position == r->length && !codecReader_fill(r)) {
+			r->starved = 1;
+			*ok = 0;
+			return;
+		}
+
+		size_t available = r->length - r->position;
+		size_t copied = available < count ? available : count;
+		memcpy(to, r->bytes + r->position, copied);
+		r->position += copied;
+		to += copied;
+		count -= copied;
+	}
+}
+
+unsigned long long codecReader_readNumber(CodecReader* r, int* ok)
+{
+	unsigned long long number = 0;
+	for (int shift = 0; shift < 64 && *ok; shift += 7) {
+		unsigned char byte = codecReader_readByte(r, ok);
+		number |= (unsigned long long)(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+			return number;
+	}
+
+	*ok = 0;
+	return 0;
+}
+
+long long codecReader_readSigned(CodecReader* r, int* ok)
+{
+	unsigned long long number = codecReader_readNumber(r, ok);
+	return number & 1 ? -(long long)(number >> 1) - 1 : (long long)(number >> 1);
+}
+
+Date codecReader_readDate(CodecReader* r, int* ok)
+{
+	Date date;
+	date.year = (int)codecReader_readSigned(r, ok);
+	unsigned long long monthDay = codecReader_readNumber(r, ok);
+	date.month = (int)(monthDay / 32);
+	date.day = (int)(monthDay % 32);
+	return date;
+}
+
+const char* codecReader_readString(CodecReader* r, char** string, size_t* capacity, int* ok)
+{
+	unsigned long long stored = codecReader_readNumber(r, ok);
+	if (!*ok || stored == 0)
+		return NULL;
+	if (stored > CODEC_MAX_STRING) {
+		*ok = 0;
+		return NULL;
+	}
+
+	size_t length = (size_t)stored - 1;
+	if (length + 1 > *capacity) {
+		char* newString = realloc(*string, length + 1);
+		if (newString == NULL) {
+			*ok = 0;
+			return NULL;
+		}
+		*string = newString;
+		*capacity = length + 1;
+	}
+
+	codecReader_readBytes(r, *string, length, ok);
+	(*string)[length] = '\0';
+	return *ok ? *string : NULL;
+}
+
+void codecReader_readMaterial(CodecReader* r, Material* mat, char** strings, size_t* capacities, int* ok)
+{
+	material_id_set(mat, (int)codecReader_readSigned(r, ok));
+	material_name_set(mat, codecReader_readString(r, &strings[0], &capacities[0], ok));
+	material_supplier_set(mat, codecReader_readString(r, &strings[1], &capacities[1], ok));
+	material_quantity_set(mat, codecReader_readSigned(r, ok));
+	material_expDate_set(mat, codecReader_readDate(r, ok));
+}
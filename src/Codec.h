@@ -0,0 +1,124 @@
+#ifndef CODEC
+#define CODEC
+
+#include "Material.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// The longest string a reader accepts. Longer lengths mean the bytes are corrupt.
+#define CODEC_MAX_STRING 0x100000
+
+// The compact binary encoding shared by the traces (see 'TraceWriter') and the replication log (see 'LogShipper'):
+// unsigned numbers are written 7 bits at a time, the high bit of a byte telling if more bytes follow; signed numbers are
+// mapped to unsigned ones so that small negative numbers stay short (-1 is 1, 1 is 2); strings are written as their length
+// plus 1 (0 for NULL) followed by the characters; dates as the signed year and then the month * 32 + the day.
+
+// The internal data for a writer that encodes values at the end of a buffer of bytes, which grows as needed.
+// Do not use struct members directly. Use only methods that start with 'codecWriter_'.
+// A writer is a plain value: initialize it with 'codecWriter_init' and release it with 'codecWriter_free'.
+// If not specified otherwise, writer pointer cannot be NULL in writer methods.
+typedef struct {
+	unsigned char* bytes;
+	size_t length;
+	size_t capacity;
+	int failed;
+} CodecWriter;
+
+// Reads up to 'size' bytes from the source into 'bytes' and returns how many were read: 0 if there are none for now.
+typedef size_t(*CodecFill)(void* source, unsigned char* bytes, size_t size);
+
+// The internal data for a reader that decodes values from a source of bytes (a file, a socket...), through a buffer.
+// The reader keeps the bytes from the last mark (see 'codecReader_mark'), so a record whose bytes have not all arrived yet
+// can be read again from its start once they have (see 'codecReader_rewind').
+// Errors are remembered in 'ok', so a record can be read without checking every value: a read that fails sets it to 0,
+// and the reads after it fail too.
+// Do not use struct members directly. Use only methods that start with 'codecReader_'.
+// A reader is a plain value: initialize it with 'codecReader_init' or 'codecReader_initFile', release it with 'codecReader_free'.
+// If not specified otherwise, reader pointer cannot be NULL in reader methods.
+typedef struct {
+	CodecFill fill;
+	void* source;
+	unsigned char* bytes;
+	size_t length;
+	size_t capacity;
+	size_t position;
+	size_t mark;
+	int starved;
+} CodecReader;
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize an empty writer (no allocation).
+void codecWriter_init(CodecWriter* w);
+
+// Release the buffer of the writer.
+void codecWriter_free(CodecWriter* w);
+
+// Initialize a reader of the bytes the fill function reads from the source (no allocation).
+void codecReader_init(CodecReader* r, CodecFill fill, void* source);
+
+// Initialize a reader of a file (opened in binary mode). Reaching the end of the file does not end the reader:
+// the bytes appended to the file later are read too.
+void codecReader_initFile(CodecReader* r, FILE* file);
+
+// Release the buffer of the reader.
+void codecReader_free(CodecReader* r);
+
+// PROPERTIES.
+
+// Get the encoded bytes and their number.
+const unsigned char* codecWriter_bytes(const CodecWriter* w);
+size_t codecWriter_length(const CodecWriter* w);
+
+// Returns 1 if the buffer could not grow since the last clear (the bytes are incomplete), otherwise 0.
+int codecWriter_failed(const CodecWriter* w);
+
+// Returns 1 if a read failed because the source had no more bytes for now (and not because the bytes are corrupt), otherwise 0.
+int codecReader_starved(const CodecReader* r);
+
+// METHODS.
+
+// Remove the encoded bytes, keeping the memory for the next ones.
+void codecWriter_clear(CodecWriter* w);
+
+// Remove the first 'count' encoded bytes (all of them if there are fewer), for example once they are sent.
+void codecWriter_discard(CodecWriter* w, size_t count);
+
+void codecWriter_writeByte(CodecWriter* w, unsigned char byte);
+void codecWriter_writeBytes(CodecWriter* w, const void* bytes, size_t count);
+void codecWriter_writeNumber(CodecWriter* w, unsigned long long number);
+void codecWriter_writeSigned(CodecWriter* w, long long number);
+void codecWriter_writeString(CodecWriter* w, const char* str);
+void codecWriter_writeDate(CodecWriter* w, Date date);
+
+// Write the id, name, supplier, quantity and expiration date of the material.
+void codecWriter_writeMaterial(CodecWriter* w, const Material* mat);
+
+// Returns 1 if at least one more byte can be read, reading from the source if needed, otherwise 0.
+int codecReader_hasMore(CodecReader* r);
+
+// Returns 1 if the next 'count' bytes are buffered, reading from the source if needed. Otherwise returns 0, and the reader
+// is starved if the source had no more bytes for now (see 'codecReader_starved').
+int codecReader_ensure(CodecReader* r, size_t count);
+
+// Remember the position of the next byte as the start of a record, and forget the bytes before it.
+void codecReader_mark(CodecReader* r);
+
+// Go back to the last mark, to read the record again.
+void codecReader_rewind(CodecReader* r);
+
+unsigned char codecReader_readByte(CodecReader* r, int* ok);
+void codecReader_readBytes(CodecReader* r, void* bytes, size_t count, int* ok);
+unsigned long long codecReader_readNumber(CodecReader* r, int* ok);
+long long codecReader_readSigned(CodecReader* r, int* ok);
+Date codecReader_readDate(CodecReader* r, int* ok);
+
+// Read a string into the given buffer, which grows as needed ('string' and 'capacity' are updated), and return it,
+// or NULL if a NULL string was written or the read failed.
+const char* codecReader_readString(CodecReader* r, char** string, size_t* capacity, int* ok);
+
+// Read a material written by 'codecWriter_writeMaterial' into the given material, the name and the supplier through
+// the first two of the given string buffers (see 'codecReader_readString').
+void codecReader_readMaterial(CodecReader* r, Material* mat, char** strings, size_t* capacities, int* ok);
+
+#endif
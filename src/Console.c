@@ -2,12 +2,21 @@
 #include <stdio.h>
 #include <string.h>
 
+// Set by the signal handler when the latencies should be written to a file. Only a flag can be set safely from a handler.
+static volatile sig_atomic_t console_dumpRequested = 0;
+
 // Constructor / Destructor.
 Console* console_create(MaterialService* matServ, size_t scanBufferSize)
 {
 	Console* c = NULL;
 	if (scanBufferSize > 0 && matServ && (c = calloc(1, sizeof(Console)))) {
 		c->matServ = matServ;
+		if ((c->arena = arena_create(ARENA_DEFAULT_CHUNK)) == NULL) {
+			free(c);
+			return NULL;
+		}
+
+		matServ_setExpiryCallback(matServ, console_on_expired, c);
 		if (c->ScanBuffer = calloc(scanBufferSize, sizeof(char)))
 			c->scanBuffSize = scanBufferSize;
 	}
@@ -17,15 +26,47 @@ Console* console_create(MaterialService* matServ, size_t scanBufferSize)
 void console_destroy(Console* c)
 {
 	if (c) {
+		matServ_setExpiryCallback(c->matServ, NULL, NULL);
+		arena_destroy(c->arena);
 		free(c->ScanBuffer);
 		free(c);
 	}
 }
 
+// Properties.
+void console_setMemoryTracker(Console* c, const MemoryTracker* memory)
+{
+	c->memory = memory;
+}
+
+void console_setShipper(Console* c, LogShipper* shipper)
+{
+	c->shipper = shipper;
+}
+
 // Console functions.
 void console_run(Console* c)
 {
+#if defined(CONSOLE_DUMP_SIGNAL) && defined(SA_RESTART)
+	// Installed without SA_RESTART, so the signal interrupts the blocking read of the next command.
+	struct sigaction action = { 0 };
+	struct sigaction previousAction;
+	action.sa_handler = console_on_dump_signal;
+	sigemptyset(&action.sa_mask);
+	int installed = sigaction(CONSOLE_DUMP_SIGNAL, &action, &previousAction) == 0;
+#elif defined(CONSOLE_DUMP_SIGNAL)
+	void(*previousHandler)(int) = signal(CONSOLE_DUMP_SIGNAL, console_on_dump_signal);
+#endif
+
+	// The console uses the service only while it holds the lock of the shipper, which it lets go while it waits for input
+	// (see 'console_read_line'), so the shipper can take followers meanwhile.
+	if (c->shipper)
+		logShipper_lock(c->shipper);
+
 	for (;;) {
+		console_dump_latency(c);
+		matServ_tick(c->matServ);
+
 		printf("\n\n"
 			"1. Add material.\n"
 			"2. Print all materials.\n"
@@ -36,7 +77,10 @@ void console_run(Console* c)
 			"7. Get materials from a given supplier with quanitty less than a given value.\n"
 			"8. Undo.\n"
 			"9. Redo.\n"
-			"10. Exit.\n"
+			"10. Show the statistics of a supplier or a material name.\n"
+			"11. Show the memory usage.\n"
+			"12. Show the operation latencies.\n"
+			"13. Exit.\n"
 		);
 
 		int command = console_read_int(c, "Enter a number for a command: ");
@@ -60,11 +104,30 @@ void console_run(Console* c)
 		else if (command == 9)
 			console_redo(c);
 		else if (command == 10)
+			console_print_stats(c);
+		else if (command == 11)
+			console_print_memory(c);
+		else if (command == 12)
+			console_print_latency(c);
+		else if (command == 13)
 			break;
 		else
 			printf("Command unknown.\n");
+
+		// Everything the command allocated from the arena is given back at once.
+		arena_reset(c->arena);
 	}
 
+	if (c->shipper)
+		logShipper_unlock(c->shipper);
+
+#if defined(CONSOLE_DUMP_SIGNAL) && defined(SA_RESTART)
+	if (installed)
+		sigaction(CONSOLE_DUMP_SIGNAL, &previousAction, NULL);
+#elif defined(CONSOLE_DUMP_SIGNAL)
+	if (previousHandler != SIG_ERR)
+		signal(CONSOLE_DUMP_SIGNAL, previousHandler);
+#endif
 	printf("Program finished.\n");
 }
 
@@ -83,10 +146,8 @@ void console_add_material(Console* c)
 
 void console_print_all_materials(Console* c)
 {
-	Vector* v = vector_create(0);
-	matServ_getAll(c->matServ, v);
-	console_print_materials(c, v, "Materials are:");
-	vector_destroy(v);
+	MaterialCursor cur = matServ_cursorAll(c->matServ);
+	console_print_cursor(c, &cur, "Materials are:");
 }
 
 void console_update_material(Console* c)
@@ -100,8 +161,10 @@ void console_update_material(Console* c)
 	else {
 		if (result == -1)
 			printf("Error: Validation failed.\n");
-		else if (result == -4)
+		else if (result == -4) {
 			printf("Error: Name, supplier and expiration date not found.\n");
+			console_print_fuzzy_suggestions(c, mat);
+		}
 	}
 
 	material_destroy(mat);
@@ -114,8 +177,10 @@ void console_remove_material(Console* c)
 
 	if (matServ_removeByNSE(c->matServ, material_name(mat), material_supplier(mat), material_expDate(mat), NULL) >= 0)
 		printf("Material removed successfully.\n");
-	else
+	else {
 		printf("Material can't be removed. Name, supplier and expiration date probably not found.\n");
+		console_print_fuzzy_suggestions(c, mat);
+	}
 
 	material_destroy(mat);
 }
@@ -124,36 +189,42 @@ void console_print_materials_past_exp_with_str(Console* c)
 {
 	console_read_line(c, "Containing string (leave empty to see all): ");
 	
-	Vector* v = vector_create(0);
-	matServ_get_materials_past_exp(c->matServ, v, c->ScanBuffer);
-	console_print_materials(c, v, "Requested materials are:");
-	vector_destroy(v);
+	MaterialCursor cur = matServ_cursorExpired(c->matServ, c->ScanBuffer);
+	console_print_cursor(c, &cur, "Requested materials are:");
 }
 
 void console_print_all_materials_sorted_by_quantity(Console* c)
 {
-	Vector* v = vector_create(0);
-	matServ_getMaterialsSortedByQuantity(c->matServ, v);
-	console_print_materials(c, v, "Materials are (sorted by quantity):");
-	vector_destroy(v);
+	printf("Materials are (sorted by quantity):\n");
+
+	const Material* after = NULL;
+	size_t printed = 0;
+	do {
+		Vector* page = vector_createInArena(c->arena, CONSOLE_PAGE_SIZE);
+		matServ_getMaterialsSortedByQuantityPage(c->matServ, page, after, CONSOLE_PAGE_SIZE);
+		after = console_print_page(c, page, &printed);
+		vector_destroy(page);
+	} while (after != NULL && console_read_next_page(c));
 }
 
 void console_print_materials_from_supplier_in_short_supply(Console* c)
 {
 	console_read_line(c, "Supplier: ");
 
-	char* supplier = calloc(strlen(c->ScanBuffer) + 1, sizeof(char));
-	if (supplier != NULL)
-		strcpy(supplier, c->ScanBuffer);
+	char* supplier = arena_strdup(c->arena, c->ScanBuffer);
 
-	float max_quantity = console_read_float(c, "Maximum quantity: ");
+	Quantity max_quantity = console_read_quantity(c, "Maximum quantity: ");
 
-	Vector* v = vector_create(0);
-	matServ_getMaterialsFromSupplierInShortSupply(c->matServ, v, supplier, max_quantity);
-	console_print_materials(c, v, "Materials in short supply are:");
-	vector_destroy(v);
+	printf("Materials in short supply are:\n");
 
-	free(supplier);
+	const Material* after = NULL;
+	size_t printed = 0;
+	do {
+		Vector* page = vector_createInArena(c->arena, CONSOLE_PAGE_SIZE);
+		matServ_getMaterialsFromSupplierInShortSupplyPage(c->matServ, page, supplier, max_quantity, after, CONSOLE_PAGE_SIZE);
+		after = console_print_page(c, page, &printed);
+		vector_destroy(page);
+	} while (after != NULL && console_read_next_page(c));
 }
 
 void console_undo(Console* c)
@@ -172,17 +243,109 @@ void console_redo(Console* c)
 		printf("Redo failed. Probably no more redos left.\n");
 }
 
+void console_print_stats(Console* c)
+{
+	console_read_line(c, "Supplier or material name: ");
+
+	const MaterialAggregate* bySupplier = matServ_statsBySupplier(c->matServ, c->ScanBuffer);
+	const MaterialAggregate* byName = matServ_statsByName(c->matServ, c->ScanBuffer);
+
+	if (bySupplier)
+		console_print_aggregate(c, bySupplier, "Supplier");
+	if (byName)
+		console_print_aggregate(c, byName, "Material");
+	if (bySupplier == NULL && byName == NULL)
+		printf("No materials.\n");
+}
+
+void console_print_memory(Console* c)
+{
+	if (c->memory == NULL) {
+		printf("Memory usage is not tracked.\n");
+		return;
+	}
+
+	for (size_t i = 0; i < memTracker_accountCount(c->memory); ++i)
+		console_print_memory_stats(c, memTracker_stats(c->memory, i));
+	console_print_memory_stats(c, memTracker_total(c->memory));
+}
+
+void console_print_latency(Console* c)
+{
+	if (!matServ_writeLatency(c->matServ, stdout))
+		printf("Operation latencies are not tracked.\n");
+}
+
 // Helper functions.
+void console_on_dump_signal(int signalNumber)
+{
+	console_dumpRequested = 1;
+
+#if !defined(SA_RESTART)
+	// Some platforms reset the handler once it runs.
+	signal(signalNumber, console_on_dump_signal);
+#else
+	(void)signalNumber;
+#endif
+}
+
+void console_dump_latency(Console* c)
+{
+	if (!console_dumpRequested)
+		return;
+
+	console_dumpRequested = 0;
+	FILE* file = fopen(CONSOLE_LATENCY_FILE, "w");
+	if (file == NULL || !matServ_writeLatency(c->matServ, file))
+		printf("Could not write the operation latencies to '%s'.\n", CONSOLE_LATENCY_FILE);
+	else
+		printf("Operation latencies written to '%s'.\n", CONSOLE_LATENCY_FILE);
+	if (file)
+		fclose(file);
+}
+
+void console_on_expired(void* console, const Material* mat)
+{
+	(void)console;
+	printf("Expired: \"%s\" from \"%s\" (expiration date %02d/%02d/%04d).\n", material_name(mat), material_supplier(mat),
+		material_expDate(mat).month, material_expDate(mat).day, material_expDate(mat).year);
+}
+
 void console_read_line(Console* c, const char* prompt)
 {
 	if (prompt)
 		printf("%s", prompt);
 
-	char ch = '\0';
+	console_dump_latency(c);
+	if (c->shipper) {
+		logShipper_tick(c->shipper);
+		logShipper_unlock(c->shipper);
+	}
+
+	int ch = '\0';
 	size_t index = 0;
-	while (scanf("%c", &ch) && ch != '\n' && ch != '\0' && index < c->scanBuffSize - 1)
-		c->ScanBuffer[index++] = ch;
+	while ((ch = getchar()) != '\n' && ch != '\0' && index < c->scanBuffSize - 1) {
+		if (ch == EOF) {
+			// An interrupted read ends like the input does.
+			if (!console_dumpRequested)
+				break;
+
+			clearerr(stdin);
+			if (c->shipper)
+				logShipper_lock(c->shipper);
+			console_dump_latency(c);
+			if (c->shipper)
+				logShipper_unlock(c->shipper);
+			if (prompt)
+				printf("%s", prompt);
+			continue;
+		}
+
+		c->ScanBuffer[index++] = (char)ch;
+	}
 
+	if (c->shipper)
+		logShipper_lock(c->shipper);
 	if (index < c->scanBuffSize)
 		c->ScanBuffer[index] = '\0';
 }
@@ -197,21 +360,58 @@ float console_read_float(Console* c, const char* prompt)
 	return result;
 }
 
+Quantity console_read_quantity(Console* c, const char* prompt)
+{
+	Quantity result = 0;
+	do {
+		console_read_line(c, prompt);
+	} while (!quantity_parse(c->ScanBuffer, &result));
+
+	return result;
+}
+
 int console_read_int(Console* c, const char* prompt)
 {
 	return (int) console_read_float(c, prompt);
 }
 
+void console_read_completed_line(Console* c, const char* prompt, size_t(*complete)(MaterialService*, const char*, Vector*, size_t))
+{
+	for (;;) {
+		console_read_line(c, prompt);
+
+		size_t length = strlen(c->ScanBuffer);
+		if (length == 0 || c->ScanBuffer[length - 1] != '?')
+			return;
+		c->ScanBuffer[length - 1] = '\0';
+
+		Vector* matches = vector_createInArena(c->arena, CONSOLE_SUGGESTIONS);
+		size_t found = complete(c->matServ, c->ScanBuffer, matches, CONSOLE_SUGGESTIONS);
+		if (found == 1 && strlen(vector_get(matches, 0)) < c->scanBuffSize) {
+			strcpy(c->ScanBuffer, vector_get(matches, 0));
+			printf("Completed to \"%s\".\n", c->ScanBuffer);
+			vector_destroy(matches);
+			return;
+		}
+
+		if (found == 0)
+			printf("No suggestions.\n");
+		for (size_t i = 0; i < found; ++i)
+			printf("  %s\n", (const char*)vector_get(matches, i));
+		vector_destroy(matches);
+	}
+}
+
 void console_scan_material(Console* c, Material* mat, int scanQuantity)
 {
-	console_read_line(c, "Name: ");
+	console_read_completed_line(c, "Name (end with '?' for suggestions): ", matServ_completeName);
 	material_name_set(mat, c->ScanBuffer);
 
-	console_read_line(c, "Supplier: ");
+	console_read_completed_line(c, "Supplier (end with '?' for suggestions): ", matServ_completeSupplier);
 	material_supplier_set(mat, c->ScanBuffer);
 
 	if (scanQuantity) {
-		float quantity = console_read_float(c, "Quantity: ");
+		Quantity quantity = console_read_quantity(c, "Quantity: ");
 		material_quantity_set(mat, quantity);
 	}
 
@@ -222,6 +422,19 @@ void console_scan_material(Console* c, Material* mat, int scanQuantity)
 	material_expDate_set(mat, expDate);
 }
 
+void console_print_fuzzy_suggestions(Console* c, const Material* mat)
+{
+	Vector* v = vector_createInArena(c->arena, 0);
+	matServ_fuzzySearch(c->matServ, material_name(mat), CONSOLE_FUZZY_DISTANCE, v);
+
+	if (vector_length(v) > 0)
+		printf("Did you mean:\n");
+	for (size_t i = 0; i < vector_length(v) && i < CONSOLE_SUGGESTIONS; ++i)
+		console_print_material(c, vector_get(v, i), (int)(i + 1));
+
+	vector_destroy(v);
+}
+
 void console_print_material(Console* c, const Material* mat, int index)
 {
 	if (index >= 0)
@@ -229,11 +442,59 @@ void console_print_material(Console* c, const Material* mat, int index)
 
 	// printf("Id: %2d, ", material_id(mat));
 
-	printf("Name: \"%20s\", Supplier: \"%20s\", Quantity: %4.2f, Expiration date: %02d/%02d/%04d.\n",
-		material_name(mat), material_supplier(mat), material_quantity(mat),
+	printf("Name: \"%20s\", Supplier: \"%20s\", Quantity: %4.3f, Expiration date: %02d/%02d/%04d.\n",
+		material_name(mat), material_supplier(mat), quantity_toUnits(material_quantity(mat)),
 		material_expDate(mat).month, material_expDate(mat).day, material_expDate(mat).year);
 }
 
+const Material* console_print_page(Console* c, const Vector* page, size_t* printed)
+{
+	for (size_t i = 0; i < vector_length(page); ++i)
+		console_print_material(c, vector_get(page, i), (int)(*printed + i + 1));
+
+	*printed += vector_length(page);
+	if (*printed == 0)
+		printf("No materials.\n");
+
+	if (vector_length(page) < CONSOLE_PAGE_SIZE)
+		return NULL;
+	return vector_get(page, vector_length(page) - 1);
+}
+
+int console_read_next_page(Console* c)
+{
+	console_read_line(c, "Press enter to see more materials, or type anything to stop: ");
+	return c->ScanBuffer[0] == '\0';
+}
+
+void console_print_aggregate(Console* c, const MaterialAggregate* agg, const char* prompt)
+{
+	(void)c;
+	Date earliest = matAgg_earliestExpiry(agg);
+	printf("%s: Materials: %zu, Total quantity: %4.3f, Earliest expiration date: %02d/%02d/%04d.\n",
+		prompt, matAgg_count(agg), matAgg_totalUnits(agg), earliest.month, earliest.day, earliest.year);
+}
+
+void console_print_memory_stats(Console* c, const MemoryStats* stats)
+{
+	(void)c;
+	printf("%-12s Bytes: %10zu, Peak: %10zu, Blocks: %8zu, Allocations: %8zu, Reallocations: %8zu, Frees: %8zu, Failures: %zu.\n",
+		stats->name, stats->bytes, stats->peakBytes, stats->blocks, stats->allocations, stats->reallocations, stats->frees, stats->failures);
+}
+
+void console_print_cursor(Console* c, MaterialCursor* cur, const char* prompt)
+{
+	if (prompt)
+		printf("%s\n", prompt);
+
+	int printed = 0;
+	for (const Material* mat = matCursor_next(cur); mat != NULL; mat = matCursor_next(cur))
+		console_print_material(c, mat, ++printed);
+
+	if (printed == 0)
+		printf("No materials.\n");
+}
+
 void console_print_materials(Console* c, const Vector* materials, const char* prompt)
 {
 	if (prompt)
@@ -2,20 +2,48 @@
 #define CONSOLE
 
 #include "MaterialService.h"
+#include "MemoryTracker.h"
+#include "MaterialReplication.h"
+#include <signal.h>
+
+// The number of materials printed at once by the sorted reports.
+#define CONSOLE_PAGE_SIZE 20
+
+// The maximum number of suggestions printed when completing a name or a supplier.
+#define CONSOLE_SUGGESTIONS 10
+
+// The maximum number of edits between a mistyped material name and the materials suggested instead.
+#define CONSOLE_FUZZY_DISTANCE 2
+
+// The signal that makes the running console write the operation latencies to CONSOLE_LATENCY_FILE:
+// Ctrl+Break on Windows, SIGUSR1 elsewhere. Where there is neither, it is not defined and the latencies are only shown
+// by the menu command (the interrupt signal is left alone, so it still stops the program).
+#if defined(SIGBREAK)
+#define CONSOLE_DUMP_SIGNAL SIGBREAK
+#elif defined(SIGUSR1)
+#define CONSOLE_DUMP_SIGNAL SIGUSR1
+#endif
+
+// The file the operation latencies are written to when the console receives CONSOLE_DUMP_SIGNAL.
+#define CONSOLE_LATENCY_FILE "latency.txt"
 
 // The internal data for a console that provides ui for given services.
 // Do not use struct members directly. Instead, use only methods that start with 'console_'.
 // The console object must be initialized with 'console_create', started with 'console_run' and destroyed with 'console_destroy'.
 // If not specified otherwise, console pointer cannot be NULL in console methods.
+// The results and temporaries of a command are allocated from an arena that is reset after the command.
 typedef struct {
 	MaterialService* matServ;
 	char* ScanBuffer;
 	size_t scanBuffSize;
+	Arena* arena;
+	const MemoryTracker* memory;
+	LogShipper* shipper;
 } Console;
 
 // CONSTRUCTOR / DESTRUCTOR.
 
-// Initialize a console object that uses the given services.
+// Initialize a console object that uses the given services. The console becomes the expiry callback of the material service.
 // The console uses a buffer for reading input line by line; Make sure the size of this buffer is big enough.
 // Make sure the services are valid and stay valid while you use the console.
 Console* console_create(MaterialService* matServ, size_t scanBufferSize);
@@ -23,9 +51,22 @@ Console* console_create(MaterialService* matServ, size_t scanBufferSize);
 // Release all console resources and free the console itself.
 void console_destroy(Console* c);
 
+// PROPERTIES.
+
+// Set the tracker (can be NULL) whose memory usage is shown by 'console_print_memory'. It must stay valid while the console is used.
+void console_setMemoryTracker(Console* c, const MemoryTracker* memory);
+
+// Set the shipper (can be NULL) of the changes made through the console. Every time the console waits for input, the changes
+// of the last command are flushed to the followers (see 'logShipper_tick'). While it runs, the console holds the lock of the
+// shipper except while it waits for input, so a serving shipper (see 'logShipper_serve') takes followers only then.
+// It must stay valid while the console is used.
+void console_setShipper(Console* c, LogShipper* shipper);
+
 // CONSOLE FUNCTIONS.
 
-// Starts the console application.
+// Starts the console application. While it runs, CONSOLE_DUMP_SIGNAL makes it write the operation latencies
+// to CONSOLE_LATENCY_FILE. The signal handler only sets a flag: the signal interrupts the read the console waits in
+// (see 'console_read_line'), which writes the latencies and goes on reading, and the flag is also checked before every command.
 void console_run(Console* c);
 
 // Read a material from keyboard and add it.
@@ -43,10 +84,10 @@ void console_remove_material(Console* c);
 // Reads an expiration date and prints the materials past it.
 void console_print_materials_past_exp_with_str(Console* c);
 
-// Prints all materials sorted by quantity.
+// Prints all materials sorted by quantity, one page at a time.
 void console_print_all_materials_sorted_by_quantity(Console* c);
 
-// Reads a supplier and a maximum quantity and prints all materials from that supplier with the specified max quantity.
+// Reads a supplier and a maximum quantity and prints all materials from that supplier with the specified max quantity, one page at a time.
 void console_print_materials_from_supplier_in_short_supply(Console* c);
 
 // Performs an undo operation.
@@ -55,27 +96,77 @@ void console_undo(Console* c);
 // Performs a redo operations.
 void console_redo(Console* c);
 
+// Reads a supplier or a material name and prints the totals of its materials.
+void console_print_stats(Console* c);
+
+// Prints the memory usage of every subsystem accounted by the memory tracker of the console, if it has one.
+void console_print_memory(Console* c);
+
+// Prints the latency percentiles of every service and repository operation, if latency tracking is on (see 'matServ_setLatencyTracking').
+void console_print_latency(Console* c);
+
 // HELPER FUNCTIONS.
 
+// Prints a notice for a material that just expired. Registered as the expiry callback of the service, with the console as context.
+// The service is ticked before every command, so the notices show up while the console is running.
+void console_on_expired(void* console, const Material* mat);
+
+// Asks the running console to write the operation latencies to CONSOLE_LATENCY_FILE. Installed as the handler of CONSOLE_DUMP_SIGNAL.
+void console_on_dump_signal(int signalNumber);
+
+// Writes the operation latencies to CONSOLE_LATENCY_FILE if it was asked by 'console_on_dump_signal'.
+void console_dump_latency(Console* c);
+
 // Scans a line character by character and saves it in the internal buffer (without '\n' at the end).
-// If prompt is not NULL, it first prints the prompt.
+// If prompt is not NULL, it first prints the prompt. If CONSOLE_DUMP_SIGNAL interrupts the read, the latencies are written
+// (see 'console_dump_latency'), the prompt is printed again and the read goes on. Before waiting, the changes made since
+// the last read are shipped, and the lock of the shipper is let go until the line is read (see 'console_setShipper').
 void console_read_line(Console* c, const char* prompt);
 
 // Print the prompt if it is not NULL, scan a line and parse it into a float. If input is invalid, repeat the operation.
 float console_read_float(Console* c, const char* prompt);
 
+// Print the prompt if it is not NULL, scan a line and parse it into a quantity, exactly (see 'quantity_parse').
+// If input is invalid, repeat the operation.
+Quantity console_read_quantity(Console* c, const char* prompt);
+
 // Print the prompt if it is not NULL, scan a line and parse it into an int. If input is invalid, repeat the operation.
 int console_read_int(Console* c, const char* prompt);
 
+// Scans a line like 'console_read_line'. If the line ends with '?', the rest of it is completed with the given function
+// (for example 'matServ_completeName'): a single match is used as the line, otherwise the matches are printed and the line is read again.
+void console_read_completed_line(Console* c, const char* prompt, size_t(*complete)(MaterialService*, const char*, Vector*, size_t));
+
 // Scans the properties of a material (except id) line by line with prompts and stores them in the given material object.
-// If 'scanQuantity' is 0 the quantity is not read.
+// The name and the supplier can be completed by ending them with '?'. If 'scanQuantity' is 0 the quantity is not read.
 // Given material cannot be NULL.
 void console_scan_material(Console* c, Material* mat, int scanQuantity);
 
+// Prints the materials whose name or supplier is close to the name of the given material (see 'matServ_fuzzySearch'),
+// at most CONSOLE_SUGGESTIONS of them. Used when the material typed by the user is not found.
+void console_print_fuzzy_suggestions(Console* c, const Material* mat);
+
 // Prints the given material (can't be NULL) using padding, on a single line.
 // If index is greater or equal to 0 prints the index at the beginning.
 void console_print_material(Console* c, const Material* mat, int index);
 
+// Prints a page of materials (cannot be NULL), numbering them after the 'printed' materials of the previous pages, and adds
+// the page length to 'printed'. Returns the last material of the page if the page is full (there might be more), otherwise NULL.
+const Material* console_print_page(Console* c, const Vector* page, size_t* printed);
+
+// Asks the user whether to print the next page. Returns 1 for yes, 0 for no.
+int console_read_next_page(Console* c);
+
+// Prints the totals of a group of materials (cannot be NULL) on a single line, after the prompt.
+void console_print_aggregate(Console* c, const MaterialAggregate* agg, const char* prompt);
+
+// Prints the memory usage (cannot be NULL) on a single line.
+void console_print_memory_stats(Console* c, const MemoryStats* stats);
+
+// Prints all the materials yielded by the cursor (cannot be NULL), numbering them from 1, without storing them.
+// If the prompt is not NULL, it first prints the prompt with a new line character at the end.
+void console_print_cursor(Console* c, MaterialCursor* cur, const char* prompt);
+
 // Prints all the given materials (cannot be NULL and must be a vector of materials).
 // If the prompt is not NULL, it first prints the prompt with a new line character at the end.
 void console_print_materials(Console* c, const Vector* materials, const char* prompt);
@@ -0,0 +1,98 @@
+#include "Date.h"
+#include <time.h>
+
+// Returns the number of days from 1 January of year 1 to the valid date (proleptic Gregorian calendar).
+static long date_dayNumber(Date date)
+{
+	// Count the years from March, so the leap day is the last day of the year.
+	long year = date.month <= 2 ? date.year - 1 : date.year;
+	long month = date.month <= 2 ? date.month + 9 : date.month - 3;
+	long dayOfYear = (153 * month + 2) / 5 + date.day - 1;
+	return year * 365 + year / 4 - year / 100 + year / 400 + dayOfYear - 306;
+}
+
+// Returns the date that is the given number of days (at least 0) after 1 January of year 1.
+static Date date_fromDayNumber(long days)
+{
+	// Same calendar as 'date_dayNumber': split the days in 400 year eras, then in years starting in March.
+	long shifted = days + 306;
+	long era = shifted / 146097;
+	long dayOfEra = shifted - era * 146097;
+	long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+	long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+	long month = (5 * dayOfYear + 2) / 153;
+
+	Date date;
+	date.day = (int)(dayOfYear - (153 * month + 2) / 5 + 1);
+	date.month = (int)(month < 10 ? month + 3 : month - 9);
+	date.year = (int)(era * 400 + yearOfEra + (date.month <= 2));
+	return date;
+}
+
+int date_isLeapYear(int year)
+{
+	return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+}
+
+int date_daysInMonth(int year, int month)
+{
+	static const int DAYS[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	if (month < 1 || month > 12)
+		return 0;
+	return month == 2 && date_isLeapYear(year) ? 29 : DAYS[month - 1];
+}
+
+int date_isValid(Date date)
+{
+	return date.year >= DATE_MIN_YEAR && date.year <= DATE_MAX_YEAR && date.day >= 1 && date.day <= date_daysInMonth(date.year, date.month);
+}
+
+DateSerial date_serial(Date date)
+{
+	return date_isValid(date) ? (DateSerial)date_dayNumber(date) : DATE_SERIAL_NONE;
+}
+
+DateSerial date_serialCeil(Date date)
+{
+	if (date.year < DATE_MIN_YEAR)
+		return 0;
+	if (date.year > DATE_MAX_YEAR)
+		return (DateSerial)date_dayNumber((Date) { DATE_MAX_YEAR, 12, 31 }) + 1;
+
+	// Past the end of the month or of the year is the first day of the next one; before the start is the first day.
+	if (date.month < 1)
+		return (DateSerial)date_dayNumber((Date) { date.year, 1, 1 });
+	if (date.month > 12)
+		return (DateSerial)date_dayNumber((Date) { date.year, 12, 31 }) + 1;
+	if (date.day < 1)
+		return (DateSerial)date_dayNumber((Date) { date.year, date.month, 1 });
+	if (date.day > date_daysInMonth(date.year, date.month))
+		return (DateSerial)date_dayNumber((Date) { date.year, date.month, date_daysInMonth(date.year, date.month) }) + 1;
+	return (DateSerial)date_dayNumber(date);
+}
+
+Date date_fromSerial(DateSerial serial)
+{
+	Date none = { 0 };
+	if (serial < 0 || serial > date_dayNumber((Date) { DATE_MAX_YEAR, 12, 31 }))
+		return none;
+	return date_fromDayNumber(serial);
+}
+
+Date date_addDays(Date date, long days)
+{
+	return date_fromDayNumber(date_dayNumber(date) + days);
+}
+
+long date_diffDays(Date from, Date to)
+{
+	return date_dayNumber(to) - date_dayNumber(from);
+}
+
+Date date_today()
+{
+	time_t seconds = time(NULL);
+	struct tm* current_time = localtime(&seconds);
+	Date today = { current_time->tm_year + 1900, current_time->tm_mon + 1, current_time->tm_mday };
+	return today;
+}
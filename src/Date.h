@@ -1,11 +1,52 @@
 #ifndef DATE
 #define DATE
 
-// This struct is just three numbers put together, given a meaning. It does not have any methods, initializer or destructor.
+#include <limits.h>
+
+// The years of the valid dates.
+#define DATE_MIN_YEAR 1
+#define DATE_MAX_YEAR 9999
+
+// This struct is just three numbers put together, given a meaning. It does not have an initializer or destructor.
 typedef struct {
 	int year;
 	int month;
 	int day;
 } Date;
 
+// A date as a serial day number in 4 bytes: the number of days from 1 January of year 1 (proleptic Gregorian calendar).
+// Serial dates compare with a single integer compare, days are added by adding numbers, and they fit in index keys and vector lanes.
+// DATE_SERIAL_NONE marks a missing or invalid date and comes before all the valid ones.
+typedef int DateSerial;
+#define DATE_SERIAL_NONE INT_MIN
+
+// Returns 1 if the year is a leap year (proleptic Gregorian calendar), otherwise 0.
+int date_isLeapYear(int year);
+
+// Returns the number of days of the month in the given year, or 0 if the month is invalid.
+int date_daysInMonth(int year, int month);
+
+// Returns 1 if the date exists: the year is from DATE_MIN_YEAR to DATE_MAX_YEAR and the day is in its month, otherwise 0.
+int date_isValid(Date date);
+
+// Returns the serial of the date, or DATE_SERIAL_NONE if the date is invalid.
+DateSerial date_serial(Date date);
+
+// Returns the serial of the first valid date that does not come before the given one (which can be invalid, like 31 February),
+// comparing the year, the month and then the day. So any date can be compared with serials: a serial is before the date exactly
+// when it is before the result. Dates before DATE_MIN_YEAR give 0 and dates after DATE_MAX_YEAR give one past the last valid date.
+DateSerial date_serialCeil(Date date);
+
+// Returns the date of the serial, or 0000/00/00 if the serial is not the serial of a valid date.
+Date date_fromSerial(DateSerial serial);
+
+// Returns the date the given number of days (can be negative) after the valid date. The result must be valid too.
+Date date_addDays(Date date, long days);
+
+// Returns the number of days from the first valid date to the second one (negative if the second one comes first).
+long date_diffDays(Date from, Date to);
+
+// Returns the current local date.
+Date date_today();
+
 #endif
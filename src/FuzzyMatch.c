@@ -0,0 +1,93 @@
+#include "FuzzyMatch.h"
+#include <ctype.h>
+#include <string.h>
+
+static unsigned char fuzzy_fold(char c)
+{
+	return (unsigned char)tolower((unsigned char)c);
+}
+
+// Returns the bit of the signature the bigram is hashed to.
+static unsigned long long fuzzy_bigramBit(unsigned char a, unsigned char b)
+{
+	return 1ull << ((a * 31u + b) & 63u);
+}
+
+int fuzzy_compile(FuzzyPattern* p, const char* pattern, int maxDistance)
+{
+	size_t length = strlen(pattern);
+	if (length > FUZZY_MAX_PATTERN || maxDistance < 0)
+		return 0;
+
+	memset(p, 0, sizeof(FuzzyPattern));
+	p->length = length;
+	p->maxDistance = maxDistance;
+
+	for (size_t i = 0; i < length; ++i) {
+		unsigned char c = fuzzy_fold(pattern[i]);
+		p->peq[c] |= 1ull << i;
+		p->peq[toupper(c)] |= 1ull << i;
+		if (i > 0)
+			p->bigrams |= fuzzy_bigramBit(fuzzy_fold(pattern[i - 1]), c);
+	}
+
+	return 1;
+}
+
+int fuzzy_distance(const FuzzyPattern* p, const char* str)
+{
+	size_t m = p->length, n = strlen(str);
+	size_t k = (size_t)p->maxDistance;
+
+	// Length filter: every missing or extra character costs an edit.
+	if ((m > n ? m - n : n - m) > k)
+		return -1;
+
+	if (m == 0)
+		return (int)n;
+
+	// Bigram filter: an edit destroys at most two bigrams, so a string within k edits has at least (n - 1) - 2k of its
+	// bigrams in the pattern. Counting the bigrams whose hash bit is set in the pattern signature can only overcount.
+	if (n > 1 && n - 1 > 2 * k) {
+		size_t shared = 0;
+		for (size_t i = 1; i < n; ++i)
+			shared += (p->bigrams & fuzzy_bigramBit(fuzzy_fold(str[i - 1]), fuzzy_fold(str[i]))) != 0;
+		if (shared + 2 * k < n - 1)
+			return -1;
+	}
+
+	// Myers' algorithm: the columns of the dynamic programming matrix are kept as bit vectors of vertical +1 / -1 deltas.
+	unsigned long long last = 1ull << (m - 1);
+	unsigned long long pv = m == 64 ? ~0ull : (1ull << m) - 1, mv = 0;
+	size_t score = m;
+
+	for (size_t j = 0; j < n; ++j) {
+		unsigned long long eq = p->peq[(unsigned char)str[j]];
+		unsigned long long xv = eq | mv;
+		unsigned long long xh = (((eq & pv) + pv) ^ pv) | eq;
+		unsigned long long ph = mv | ~(xh | pv);
+		unsigned long long mh = pv & xh;
+
+		if (ph & last)
+			++score;
+		else if (mh & last)
+			--score;
+
+		// The first row of the matrix grows by one for every character of the string.
+		ph = (ph << 1) | 1;
+		mh <<= 1;
+		pv = mh | ~(xv | ph);
+		mv = ph & xv;
+
+		// The score drops by at most one for every character left.
+		if (score > k + (n - j - 1))
+			return -1;
+	}
+
+	return score <= k ? (int)score : -1;
+}
+
+int fuzzy_matches(const FuzzyPattern* p, const char* str)
+{
+	return fuzzy_distance(p, str) >= 0;
+}
@@ -0,0 +1,32 @@
+#ifndef FUZZY_MATCH
+#define FUZZY_MATCH
+
+#include <stdlib.h>
+
+// The maximum length of a pattern, one bit per character of a 64 bit word.
+#define FUZZY_MAX_PATTERN 64
+
+// A pattern compiled for approximate matching: finds the strings within a maximum edit distance (insertions, deletions
+// and substitutions of single characters) of the pattern. Letters are compared without regard to case.
+// Strings are first checked with cheap filters (length difference and shared bigrams), and only the ones that pass
+// are compared with Myers' bit-parallel algorithm, which processes a character of the string in a few word operations.
+// Do not use struct members directly. Use only methods that start with 'fuzzy_'.
+// If not specified otherwise, pattern pointer and strings cannot be NULL in fuzzy methods.
+typedef struct {
+	unsigned long long peq[256];
+	unsigned long long bigrams;
+	size_t length;
+	int maxDistance;
+} FuzzyPattern;
+
+// Compile the pattern (at most FUZZY_MAX_PATTERN characters) with the given maximum distance (at least 0) into 'p'.
+// Returns 1 on success and 0 if the pattern is too long or the distance is negative.
+int fuzzy_compile(FuzzyPattern* p, const char* pattern, int maxDistance);
+
+// Returns the edit distance between the pattern and the string if it is at most the maximum distance, otherwise -1.
+int fuzzy_distance(const FuzzyPattern* p, const char* str);
+
+// Returns 1 if the string is within the maximum distance of the pattern, 0 otherwise.
+int fuzzy_matches(const FuzzyPattern* p, const char* str);
+
+#endif
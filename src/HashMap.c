@@ -0,0 +1,140 @@
+#include "HashMap.h"
+#include <string.h>
+
+// Returns the slot of the key, or the empty slot where it would be added.
+static size_t hashMap_findSlot(const HashMap* map, const char* key, size_t hash)
+{
+	size_t mask = map->capacity - 1;
+	size_t slot = hash & mask;
+	while (map->entries[slot].key != NULL && (map->entries[slot].hash != hash || strcmp(map->entries[slot].key, key) != 0))
+		slot = (slot + 1) & mask;
+
+	return slot;
+}
+
+// Changes the number of slots (a power of 2) and places all the entries again.
+static int hashMap_rehash(HashMap* map, size_t capacity)
+{
+	HashMapEntry* newEntries = calloc(capacity, sizeof(HashMapEntry));
+	if (newEntries == NULL)
+		return 0;
+
+	HashMapEntry* oldEntries = map->entries;
+	size_t oldCapacity = map->capacity;
+	map->entries = newEntries;
+	map->capacity = capacity;
+
+	for (size_t i = 0; i < oldCapacity; ++i) {
+		if (oldEntries[i].key != NULL)
+			map->entries[hashMap_findSlot(map, oldEntries[i].key, oldEntries[i].hash)] = oldEntries[i];
+	}
+
+	free(oldEntries);
+	return 1;
+}
+
+// Constructor / Destructor.
+HashMap* hashMap_create()
+{
+	return calloc(1, sizeof(HashMap));
+}
+
+void hashMap_destroy(HashMap* map)
+{
+	if (map == NULL)
+		return;
+
+	for (size_t i = 0; i < map->capacity; ++i)
+		free(map->entries[i].key);
+
+	free(map->entries);
+	free(map);
+}
+
+// Properties.
+size_t hashMap_count(const HashMap* map)
+{
+	return map->count;
+}
+
+size_t hashMap_capacity(const HashMap* map)
+{
+	return map->capacity;
+}
+
+const HashMapEntry* hashMap_entryAt(const HashMap* map, size_t index)
+{
+	if (index >= map->capacity || map->entries[index].key == NULL)
+		return NULL;
+
+	return &map->entries[index];
+}
+
+// Methods.
+void* hashMap_get(const HashMap* map, const char* key)
+{
+	if (map->count == 0)
+		return NULL;
+
+	HashMapEntry* entry = &map->entries[hashMap_findSlot(map, key, hashMap_hashString(key))];
+	return entry->key ? entry->value : NULL;
+}
+
+int hashMap_put(HashMap* map, const char* key, void* value)
+{
+	// Keep the load factor under 3/4.
+	if ((map->count + 1) * 4 > map->capacity * 3 && !hashMap_rehash(map, map->capacity ? map->capacity * 2 : 8))
+		return 0;
+
+	size_t hash = hashMap_hashString(key);
+	HashMapEntry* entry = &map->entries[hashMap_findSlot(map, key, hash)];
+	if (entry->key == NULL) {
+		if ((entry->key = calloc(strlen(key) + 1, sizeof(char))) == NULL)
+			return 0;
+		strcpy(entry->key, key);
+		entry->hash = hash;
+		++map->count;
+	}
+
+	entry->value = value;
+	return 1;
+}
+
+void* hashMap_remove(HashMap* map, const char* key)
+{
+	if (map->count == 0)
+		return NULL;
+
+	size_t mask = map->capacity - 1;
+	size_t slot = hashMap_findSlot(map, key, hashMap_hashString(key));
+	if (map->entries[slot].key == NULL)
+		return NULL;
+
+	void* value = map->entries[slot].value;
+	free(map->entries[slot].key);
+	map->entries[slot].key = NULL;
+	--map->count;
+
+	// Shift back the entries after the removed one that would not be found anymore (no tombstones needed).
+	for (size_t next = (slot + 1) & mask; map->entries[next].key != NULL; next = (next + 1) & mask) {
+		size_t home = map->entries[next].hash & mask;
+		if (((next - home) & mask) >= ((next - slot) & mask)) {
+			map->entries[slot] = map->entries[next];
+			map->entries[next].key = NULL;
+			slot = next;
+		}
+	}
+
+	return value;
+}
+
+size_t hashMap_hashString(const char* str)
+{
+	unsigned long long hash = 14695981039346656037ull;
+	for (size_t i = 0; str[i] != '\0'; ++i) {
+		hash ^= (unsigned char)str[i];
+		hash *= 1099511628211ull;
+	}
+
+	return (size_t)hash;
+}
@@ -0,0 +1,57 @@
+#ifndef HASH_MAP
+#define HASH_MAP
+
+#include <stdlib.h>
+
+// An entry of a hash map. A NULL key marks an empty slot.
+typedef struct {
+	char* key;
+	void* value;
+	size_t hash;
+} HashMapEntry;
+
+// The internal data used to represent a map from strings to pointers, using open addressing with linear probing.
+// Do not use struct members directly. Use only methods that start with 'hashMap_'.
+// You need to initialize the map with 'hashMap_create', and destroy it with 'hashMap_destroy' when you are done.
+// The map owns copies of the keys, but not the values.
+// If not specified otherwise, map pointer and keys cannot be NULL in map methods.
+typedef struct {
+	HashMapEntry* entries;
+	size_t capacity;
+	size_t count;
+} HashMap;
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize an empty map.
+HashMap* hashMap_create();
+
+// Destroy the map (the values are not destroyed). If pointer is NULL nothing happens.
+void hashMap_destroy(HashMap* map);
+
+// PROPERTIES.
+
+// Get the number of keys in the map.
+size_t hashMap_count(const HashMap* map);
+
+// Get the number of slots of the map. Use with 'hashMap_entryAt' to go through all the entries.
+size_t hashMap_capacity(const HashMap* map);
+
+// Get the entry in the specified slot, or NULL if the slot is empty or the index is invalid. Do not modify the key.
+const HashMapEntry* hashMap_entryAt(const HashMap* map, size_t index);
+
+// METHODS.
+
+// Returns the value of the key, or NULL if the key is not in the map.
+void* hashMap_get(const HashMap* map, const char* key);
+
+// Sets the value of the key, adding the key if needed. Returns 1 on success, 0 if the memory could not be allocated.
+int hashMap_put(HashMap* map, const char* key, void* value);
+
+// Removes the key and returns its value, or NULL if the key is not in the map.
+void* hashMap_remove(HashMap* map, const char* key);
+
+// Returns the FNV-1a hash of the string.
+size_t hashMap_hashString(const char* str);
+
+#endif
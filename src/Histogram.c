@@ -0,0 +1,117 @@
+#include "Histogram.h"
+#include <string.h>
+
+// Returns the index of the highest set bit of a non zero value.
+static int hist_highestBit(unsigned long long value)
+{
+	int bit = 0;
+	for (int step = 32; step > 0; step /= 2) {
+		if (value >> step) {
+			value >>= step;
+			bit += step;
+		}
+	}
+	return bit;
+}
+
+// Returns the bucket of the value. The values under HIST_SUB_BUCKETS are their own bucket; a bigger value with the highest bit 'b'
+// falls in the range of bucket group 'b - HIST_SUB_BUCKET_BITS + 1', at the position given by its next HIST_SUB_BUCKET_BITS bits.
+static size_t hist_bucketOf(unsigned long long value)
+{
+	if (value < HIST_SUB_BUCKETS)
+		return (size_t)value;
+
+	int shift = hist_highestBit(value) - HIST_SUB_BUCKET_BITS;
+	return (size_t)(shift + 1) * HIST_SUB_BUCKETS + (size_t)((value >> shift) - HIST_SUB_BUCKETS);
+}
+
+// Returns the biggest value that falls in the bucket.
+static long long hist_bucketMax(size_t bucket)
+{
+	if (bucket < HIST_SUB_BUCKETS)
+		return (long long)bucket;
+
+	int shift = (int)(bucket / HIST_SUB_BUCKETS) - 1;
+	unsigned long long low = (unsigned long long)(HIST_SUB_BUCKETS + bucket % HIST_SUB_BUCKETS) << shift;
+	return (long long)(low + (1ull << shift) - 1);
+}
+
+// Constructor.
+void hist_clear(Histogram* h)
+{
+	memset(h, 0, sizeof(Histogram));
+}
+
+// Properties.
+unsigned long long hist_count(const Histogram* h)
+{
+	return h->count;
+}
+
+long long hist_min(const Histogram* h)
+{
+	return h->min;
+}
+
+long long hist_max(const Histogram* h)
+{
+	return h->max;
+}
+
+double hist_mean(const Histogram* h)
+{
+	return h->count > 0 ? h->total / (double)h->count : 0.0;
+}
+
+// Methods.
+void hist_record(Histogram* h, long long value)
+{
+	if (value < 0)
+		value = 0;
+
+	++h->counts[hist_bucketOf((unsigned long long)value)];
+	if (h->count == 0 || value < h->min)
+		h->min = value;
+	if (value > h->max)
+		h->max = value;
+	h->total += (double)value;
+	++h->count;
+}
+
+long long hist_percentile(const Histogram* h, double fraction)
+{
+	if (h->count == 0)
+		return 0;
+
+	fraction = fraction < 0.0 ? 0.0 : fraction > 1.0 ? 1.0 : fraction;
+	unsigned long long rank = (unsigned long long)(fraction * (double)h->count + 0.5);
+	if (rank == 0)
+		rank = 1;
+
+	unsigned long long seen = 0;
+	for (size_t i = 0; i < HIST_BUCKETS; ++i) {
+		seen += h->counts[i];
+		if (seen >= rank) {
+			long long value = hist_bucketMax(i);
+			return value > h->max ? h->max : value < h->min ? h->min : value;
+		}
+	}
+
+	return h->max;
+}
+
+void hist_merge(Histogram* dest, const Histogram* src)
+{
+	if (src->count == 0)
+		return;
+
+	for (size_t i = 0; i < HIST_BUCKETS; ++i)
+		dest->counts[i] += src->counts[i];
+
+	if (dest->count == 0 || src->min < dest->min)
+		dest->min = src->min;
+	if (src->max > dest->max)
+		dest->max = src->max;
+	dest->total += src->total;
+	dest->count += src->count;
+}
@@ -0,0 +1,58 @@
+#ifndef HISTOGRAM
+#define HISTOGRAM
+
+#include <stdlib.h>
+
+// Every power of two range of values is split in this many equal buckets, so a value is known within 1 / 32 of itself (about 3%).
+#define HIST_SUB_BUCKET_BITS 5
+#define HIST_SUB_BUCKETS (1 << HIST_SUB_BUCKET_BITS)
+
+// The number of buckets needed for all the values up to 2^63: the values under HIST_SUB_BUCKETS have a bucket each,
+// then every power of two range has HIST_SUB_BUCKETS buckets.
+#define HIST_BUCKETS ((64 - HIST_SUB_BUCKET_BITS) * HIST_SUB_BUCKETS)
+
+// The internal data for a histogram of non negative values (latencies in nanoseconds) with a fixed relative precision,
+// in the style of HDR histograms: recording a value is a few shifts and an increment, and the memory does not grow.
+// Do not use struct members directly. Use only methods that start with 'hist_'.
+// A histogram is a plain value: initialize it with 'hist_clear'. It needs no releasing.
+// If not specified otherwise, histogram pointer cannot be NULL in histogram methods.
+typedef struct {
+	unsigned long long counts[HIST_BUCKETS];
+	unsigned long long count;
+	long long min;
+	long long max;
+	double total;
+} Histogram;
+
+// CONSTRUCTOR.
+
+// Remove all the recorded values.
+void hist_clear(Histogram* h);
+
+// PROPERTIES.
+
+// Get the number of recorded values.
+unsigned long long hist_count(const Histogram* h);
+
+// Get the smallest recorded value, or 0 if there are none.
+long long hist_min(const Histogram* h);
+
+// Get the biggest recorded value, or 0 if there are none.
+long long hist_max(const Histogram* h);
+
+// Get the average of the recorded values, or 0 if there are none.
+double hist_mean(const Histogram* h);
+
+// METHODS.
+
+// Record a value. Negative values are recorded as 0.
+void hist_record(Histogram* h, long long value);
+
+// Get the value that the given fraction (from 0 to 1) of the recorded values did not exceed, within the precision of the histogram
+// (the biggest value of its bucket, but not more than the maximum). Returns 0 if there are no values.
+long long hist_percentile(const Histogram* h, double fraction);
+
+// Add all the values recorded by the source histogram to the destination one.
+void hist_merge(Histogram* dest, const Histogram* src);
+
+#endif
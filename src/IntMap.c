@@ -0,0 +1,123 @@
+#include "IntMap.h"
+
+// Spreads the bits of the key, so consecutive ids do not fill consecutive slots.
+static size_t intMap_hash(int key)
+{
+	unsigned long long hash = (unsigned int)key * 0x9E3779B97F4A7C15ull;
+	return (size_t)(hash >> 32);
+}
+
+// Returns the slot of the key, or the empty slot where it would be added.
+static size_t intMap_findSlot(const IntMap* map, int key)
+{
+	size_t mask = map->capacity - 1;
+	size_t slot = intMap_hash(key) & mask;
+	while (map->entries[slot].used && map->entries[slot].key != key)
+		slot = (slot + 1) & mask;
+
+	return slot;
+}
+
+// Changes the number of slots (a power of 2) and places all the entries again.
+static int intMap_rehash(IntMap* map, size_t capacity)
+{
+	IntMapEntry* newEntries = allocator_calloc(map->allocator, capacity, sizeof(IntMapEntry));
+	if (newEntries == NULL)
+		return 0;
+
+	IntMapEntry* oldEntries = map->entries;
+	size_t oldCapacity = map->capacity;
+	map->entries = newEntries;
+	map->capacity = capacity;
+
+	for (size_t i = 0; i < oldCapacity; ++i) {
+		if (oldEntries[i].used)
+			map->entries[intMap_findSlot(map, oldEntries[i].key)] = oldEntries[i];
+	}
+
+	allocator_free(map->allocator, oldEntries);
+	return 1;
+}
+
+// Constructor / Destructor.
+void intMap_init(IntMap* map)
+{
+	intMap_initWith(map, NULL);
+}
+
+void intMap_initWith(IntMap* map, const Allocator* allocator)
+{
+	map->entries = NULL;
+	map->capacity = map->count = 0;
+	map->allocator = allocator;
+}
+
+void intMap_free(IntMap* map)
+{
+	allocator_free(map->allocator, map->entries);
+	intMap_initWith(map, map->allocator);
+}
+
+// Properties.
+size_t intMap_count(const IntMap* map)
+{
+	return map->count;
+}
+
+// Methods.
+int intMap_get(const IntMap* map, int key, size_t* value)
+{
+	if (map->count == 0)
+		return 0;
+
+	const IntMapEntry* entry = &map->entries[intMap_findSlot(map, key)];
+	if (!entry->used)
+		return 0;
+
+	if (value)
+		*value = entry->value;
+	return 1;
+}
+
+int intMap_put(IntMap* map, int key, size_t value)
+{
+	// Keep the load factor under 3/4.
+	if ((map->count + 1) * 4 > map->capacity * 3 && !intMap_rehash(map, map->capacity ? map->capacity * 2 : 8))
+		return 0;
+
+	IntMapEntry* entry = &map->entries[intMap_findSlot(map, key)];
+	if (!entry->used) {
+		entry->key = key;
+		entry->used = 1;
+		++map->count;
+	}
+
+	entry->value = value;
+	return 1;
+}
+
+int intMap_remove(IntMap* map, int key)
+{
+	if (map->count == 0)
+		return 0;
+
+	size_t mask = map->capacity - 1;
+	size_t slot = intMap_findSlot(map, key);
+	if (!map->entries[slot].used)
+		return 0;
+
+	map->entries[slot].used = 0;
+	--map->count;
+
+	// Shift back the entries after the removed one that would not be found anymore (no tombstones needed).
+	for (size_t next = (slot + 1) & mask; map->entries[next].used; next = (next + 1) & mask) {
+		size_t home = intMap_hash(map->entries[next].key) & mask;
+		if (((next - home) & mask) >= ((next - slot) & mask)) {
+			map->entries[slot] = map->entries[next];
+			map->entries[next].used = 0;
+			slot = next;
+		}
+	}
+
+	return 1;
+}
@@ -0,0 +1,52 @@
+#ifndef INT_MAP
+#define INT_MAP
+
+#include "Allocator.h"
+#include <stdlib.h>
+
+// A slot of an int map.
+typedef struct {
+	int key;
+	int used;
+	size_t value;
+} IntMapEntry;
+
+// The internal data used to represent a map from ints to indexes, using open addressing with linear probing.
+// Do not use struct members directly. Use only methods that start with 'intMap_'.
+// A map is a plain value: initialize it with 'intMap_init' (or 'intMap_initWith') and release it with 'intMap_free' when you are done.
+// If not specified otherwise, map pointer cannot be NULL in map methods.
+typedef struct {
+	IntMapEntry* entries;
+	size_t capacity;
+	size_t count;
+	const Allocator* allocator;
+} IntMap;
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize an empty map (no allocation).
+void intMap_init(IntMap* map);
+
+// Initialize an empty map whose slots are taken from the allocator (NULL means the default allocator).
+void intMap_initWith(IntMap* map, const Allocator* allocator);
+
+// Release the slots; the map is empty again and can be reused.
+void intMap_free(IntMap* map);
+
+// PROPERTIES.
+
+// Get the number of keys in the map.
+size_t intMap_count(const IntMap* map);
+
+// METHODS.
+
+// Returns 1 and saves the value of the key in 'value' (if it is not NULL) if the key is in the map, otherwise returns 0.
+int intMap_get(const IntMap* map, int key, size_t* value);
+
+// Sets the value of the key, adding the key if needed. Returns 1 on success, 0 if the memory could not be allocated.
+int intMap_put(IntMap* map, int key, size_t value);
+
+// Removes the key. Returns 1 if it was in the map, otherwise 0.
+int intMap_remove(IntMap* map, int key);
+
+#endif
@@ -0,0 +1,164 @@
+#include "LatencyRecorder.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+long long latency_now()
+{
+	static LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+	if (frequency.QuadPart == 0)
+		QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+
+	// Split the conversion, so the counter times 10^9 cannot overflow.
+	long long seconds = counter.QuadPart / frequency.QuadPart;
+	long long rest = counter.QuadPart % frequency.QuadPart;
+	return seconds * 1000000000LL + rest * 1000000000LL / frequency.QuadPart;
+}
+
+#else
+#include <time.h>
+
+long long latency_now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+#endif
+
+// Returns the histograms of the calling thread, allocating them the first time, or NULL if it has none and cannot get them
+// (then the thread records to the shared histograms).
+static Histogram* latency_threadHistograms(LatencyRecorder* rec)
+{
+	size_t index = thread_index();
+	if (index >= LATENCY_MAX_THREADS)
+		return NULL;
+
+	// Only the thread itself stores its histograms, so there is no race to lose.
+	Histogram* histograms = sync_loadPointer((void* volatile*)&rec->threads[index]);
+	if (histograms == NULL && (histograms = calloc(rec->count, sizeof(Histogram))) != NULL)
+		sync_storePointer((void* volatile*)&rec->threads[index], histograms);
+
+	return histograms;
+}
+
+// Constructor / Destructor.
+LatencyRecorder* latency_create(const char* const* names, size_t count)
+{
+	LatencyRecorder* rec = calloc(1, sizeof(LatencyRecorder));
+	if (rec == NULL)
+		return NULL;
+
+	rec->names = names;
+	rec->count = count;
+	rec->shared = calloc(count > 0 ? count : 1, sizeof(Histogram));
+	rec->merged = calloc(count > 0 ? count : 1, sizeof(Histogram));
+	if (rec->shared == NULL || rec->merged == NULL) {
+		free(rec->shared);
+		free(rec->merged);
+		free(rec);
+		return NULL;
+	}
+
+	mutex_init(&rec->sharedLock);
+	return rec;
+}
+
+void latency_destroy(LatencyRecorder* rec)
+{
+	if (rec == NULL)
+		return;
+
+	for (size_t i = 0; i < LATENCY_MAX_THREADS; ++i)
+		free(rec->threads[i]);
+
+	mutex_free(&rec->sharedLock);
+	free(rec->shared);
+	free(rec->merged);
+	free(rec);
+}
+
+// Properties.
+size_t latency_count(const LatencyRecorder* rec)
+{
+	return rec->count;
+}
+
+const char* latency_name(const LatencyRecorder* rec, size_t op)
+{
+	return op < rec->count ? rec->names[op] : NULL;
+}
+
+const Histogram* latency_histogram(const LatencyRecorder* rec, size_t op)
+{
+	if (op >= rec->count)
+		return NULL;
+
+	Histogram* merged = &rec->merged[op];
+	hist_clear(merged);
+	for (size_t i = 0; i < LATENCY_MAX_THREADS; ++i) {
+		const Histogram* histograms = sync_loadPointer((void* volatile*)&rec->threads[i]);
+		if (histograms)
+			hist_merge(merged, &histograms[op]);
+	}
+
+	mutex_lock((Mutex*)&rec->sharedLock);
+	hist_merge(merged, &rec->shared[op]);
+	mutex_unlock((Mutex*)&rec->sharedLock);
+	return merged;
+}
+
+// Methods.
+long long latency_start(const LatencyRecorder* rec)
+{
+	return rec ? latency_now() : 0;
+}
+
+void latency_stop(LatencyRecorder* rec, size_t op, long long started)
+{
+	if (rec == NULL || op >= rec->count)
+		return;
+
+	long long elapsed = latency_now() - started;
+	Histogram* histograms = latency_threadHistograms(rec);
+	if (histograms) {
+		hist_record(&histograms[op], elapsed);
+		return;
+	}
+
+	mutex_lock(&rec->sharedLock);
+	hist_record(&rec->shared[op], elapsed);
+	mutex_unlock(&rec->sharedLock);
+}
+
+void latency_clear(LatencyRecorder* rec)
+{
+	for (size_t i = 0; i < rec->count; ++i) {
+		for (size_t j = 0; j < LATENCY_MAX_THREADS; ++j) {
+			if (rec->threads[j])
+				hist_clear(&rec->threads[j][i]);
+		}
+		hist_clear(&rec->shared[i]);
+	}
+}
+
+void latency_write(const LatencyRecorder* rec, FILE* out, const char* title)
+{
+	if (title != NULL)
+		fprintf(out, "%s\n", title);
+
+	fprintf(out, "%-28s %10s %10s %10s %10s %10s %10s %10s\n", "operation", "count", "mean us", "p50 us", "p90 us", "p99 us", "p99.9 us", "max us");
+	for (size_t i = 0; i < rec->count; ++i) {
+		const Histogram* h = latency_histogram(rec, i);
+		if (hist_count(h) == 0)
+			continue;
+
+		fprintf(out, "%-28s %10llu %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", rec->names[i], hist_count(h), hist_mean(h) / 1e3,
+			hist_percentile(h, 0.50) / 1e3, hist_percentile(h, 0.90) / 1e3, hist_percentile(h, 0.99) / 1e3,
+			hist_percentile(h, 0.999) / 1e3, hist_max(h) / 1e3);
+	}
+}
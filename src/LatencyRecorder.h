@@ -0,0 +1,70 @@
+#ifndef LATENCY_RECORDER
+#define LATENCY_RECORDER
+
+#include "Histogram.h"
+#include "Thread.h"
+#include <stdio.h>
+
+// The number of threads that record to a recorder without a lock. The threads with a bigger index (see 'thread_index')
+// share one set of histograms behind a lock.
+#define LATENCY_MAX_THREADS 64
+
+// The internal data for the latencies of a fixed list of operations, one histogram per operation.
+// Do not use struct members directly. Use only methods that start with 'latency_'.
+// The recorder must be initialized with 'latency_create' and destroyed with 'latency_destroy'.
+// A module times an operation with 'latency_start' and 'latency_stop'. Both accept a NULL recorder and then do nothing,
+// so a module keeps a NULL recorder while tracking is off and pays only for a pointer check.
+// Every thread records to its own histograms, allocated the first time it records, so recording takes no lock and threads
+// do not share cache lines. The histograms of the threads are merged when they are read.
+// If not specified otherwise, recorder pointer cannot be NULL in recorder methods.
+typedef struct {
+	const char* const* names;
+	size_t count;
+	Histogram* volatile threads[LATENCY_MAX_THREADS];
+	Histogram* shared;
+	Mutex sharedLock;
+	Histogram* merged;
+} LatencyRecorder;
+
+// Returns the time in nanoseconds from an unspecified point, for measuring intervals. The clock is monotonic
+// (QueryPerformanceCounter on Windows, CLOCK_MONOTONIC elsewhere): it is not moved by changes of the wall clock, and it is the
+// same for all the processes of the machine.
+long long latency_now();
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize a recorder for 'count' operations with the given names (the array must stay valid while the recorder is used).
+// Returns NULL if the memory could not be allocated.
+LatencyRecorder* latency_create(const char* const* names, size_t count);
+
+// Free the recorder. If recorder is NULL nothing happens.
+void latency_destroy(LatencyRecorder* rec);
+
+// PROPERTIES.
+
+// Get the number of operations.
+size_t latency_count(const LatencyRecorder* rec);
+
+// Get the name of the operation on the given index, or NULL if the index is invalid.
+const char* latency_name(const LatencyRecorder* rec, size_t op);
+
+// Get the histogram of the operation on the given index, with the latencies of all the threads, or NULL if the index is invalid.
+// Valid until the next call. The other threads are not stopped: the latencies they record meanwhile might be missing.
+const Histogram* latency_histogram(const LatencyRecorder* rec, size_t op);
+
+// METHODS.
+
+// Returns the time an operation starts, to be given to 'latency_stop'. Returns 0 without reading the clock if recorder is NULL.
+long long latency_start(const LatencyRecorder* rec);
+
+// Record the time passed since 'started' for the operation on the given index. If recorder is NULL nothing happens.
+void latency_stop(LatencyRecorder* rec, size_t op, long long started);
+
+// Remove the recorded latencies of all the operations. No other thread can record meanwhile.
+void latency_clear(LatencyRecorder* rec);
+
+// Write a table with a line for every operation that ran: the name, the count, and the mean, p50, p90, p99, p99.9 and maximum
+// latencies in microseconds. If the title is not NULL, it is written first on its own line.
+void latency_write(const LatencyRecorder* rec, FILE* out, const char* title);
+
+#endif
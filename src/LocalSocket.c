@@ -0,0 +1,249 @@
+#include "LocalSocket.h"
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+
+typedef SOCKET LocalSocketHandle;
+#define LOCAL_SOCKET_CLOSED ((long long)INVALID_SOCKET)
+
+// Starts Winsock for a socket about to be opened. Returns 1 on success, otherwise 0.
+static int localSocket_startup()
+{
+	WSADATA data;
+	return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+}
+
+static void localSocket_cleanup()
+{
+	WSACleanup();
+}
+
+static void localSocket_closeHandle(LocalSocketHandle handle)
+{
+	closesocket(handle);
+}
+
+static int localSocket_setNonBlocking(LocalSocketHandle handle)
+{
+	u_long nonBlocking = 1;
+	return ioctlsocket(handle, FIONBIO, &nonBlocking) == 0;
+}
+
+// Returns 1 if the last call failed only because it would have had to wait.
+static int localSocket_wouldBlock()
+{
+	return WSAGetLastError() == WSAEWOULDBLOCK;
+}
+
+#define LOCAL_SOCKET_NO_SIGNAL 0
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+typedef int LocalSocketHandle;
+#define LOCAL_SOCKET_CLOSED -1LL
+#define INVALID_SOCKET -1
+
+static int localSocket_startup()
+{
+	return 1;
+}
+
+static void localSocket_cleanup()
+{
+}
+
+static void localSocket_closeHandle(LocalSocketHandle handle)
+{
+	close(handle);
+}
+
+static int localSocket_setNonBlocking(LocalSocketHandle handle)
+{
+	int flags = fcntl(handle, F_GETFL, 0);
+	return flags != -1 && fcntl(handle, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static int localSocket_wouldBlock()
+{
+	return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+}
+
+// A send to a connection closed by the other side fails instead of raising SIGPIPE.
+#ifdef MSG_NOSIGNAL
+#define LOCAL_SOCKET_NO_SIGNAL MSG_NOSIGNAL
+#else
+#define LOCAL_SOCKET_NO_SIGNAL 0
+#endif
+#endif
+
+static LocalSocketHandle localSocket_handle(const LocalSocket* s)
+{
+	return (LocalSocketHandle)s->handle;
+}
+
+// The address of the port on the loopback interface.
+static struct sockaddr_in localSocket_address(unsigned short port)
+{
+	struct sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = htons(port);
+	return address;
+}
+
+// Opens a TCP socket. Returns 1 on success, otherwise 0 (and the socket stays closed).
+static int localSocket_open(LocalSocket* s)
+{
+	if (!localSocket_startup())
+		return 0;
+
+	LocalSocketHandle handle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (handle == INVALID_SOCKET) {
+		localSocket_cleanup();
+		return 0;
+	}
+
+	s->handle = (long long)handle;
+	return 1;
+}
+
+// Constructor / Destructor.
+void localSocket_init(LocalSocket* s)
+{
+	s->handle = LOCAL_SOCKET_CLOSED;
+}
+
+int localSocket_listen(LocalSocket* s, unsigned short port)
+{
+	localSocket_init(s);
+	if (!localSocket_open(s))
+		return 0;
+
+	struct sockaddr_in address = localSocket_address(port);
+#ifndef _WIN32
+	// A port left by a process that just ended can be listened on again at once.
+	int reuse = 1;
+	setsockopt(localSocket_handle(s), SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+#endif
+	if (bind(localSocket_handle(s), (struct sockaddr*)&address, sizeof(address)) != 0
+		|| listen(localSocket_handle(s), SOMAXCONN) != 0 || !localSocket_setNonBlocking(localSocket_handle(s))) {
+		localSocket_close(s);
+		return 0;
+	}
+
+	return 1;
+}
+
+int localSocket_accept(LocalSocket* listener, LocalSocket* connection)
+{
+	localSocket_init(connection);
+	if (!localSocket_startup())
+		return -1;
+
+	LocalSocketHandle handle = accept(localSocket_handle(listener), NULL, NULL);
+	if (handle == INVALID_SOCKET) {
+		int wouldBlock = localSocket_wouldBlock();
+		localSocket_cleanup();
+		return wouldBlock ? 0 : -1;
+	}
+
+	connection->handle = (long long)handle;
+	if (!localSocket_setNonBlocking(handle)) {
+		localSocket_close(connection);
+		return -1;
+	}
+	return 1;
+}
+
+int localSocket_connect(LocalSocket* s, unsigned short port)
+{
+	localSocket_init(s);
+	if (!localSocket_open(s))
+		return 0;
+
+	// The connection is made while the socket still blocks, then it stops blocking like the others.
+	struct sockaddr_in address = localSocket_address(port);
+	if (connect(localSocket_handle(s), (struct sockaddr*)&address, sizeof(address)) != 0
+		|| !localSocket_setNonBlocking(localSocket_handle(s))) {
+		localSocket_close(s);
+		return 0;
+	}
+
+	return 1;
+}
+
+void localSocket_close(LocalSocket* s)
+{
+	if (!localSocket_isOpen(s))
+		return;
+
+	localSocket_closeHandle(localSocket_handle(s));
+	localSocket_cleanup();
+	localSocket_init(s);
+}
+
+// Properties.
+int localSocket_isOpen(const LocalSocket* s)
+{
+	return s->handle != LOCAL_SOCKET_CLOSED;
+}
+
+unsigned short localSocket_port(const LocalSocket* s)
+{
+	struct sockaddr_in address;
+	socklen_t length = sizeof(address);
+	if (!localSocket_isOpen(s) || getsockname(localSocket_handle(s), (struct sockaddr*)&address, &length) != 0)
+		return 0;
+	return ntohs(address.sin_port);
+}
+
+// Methods.
+long long localSocket_send(LocalSocket* s, const void* bytes, size_t count)
+{
+	// Winsock takes the count as an int.
+	if (count > 0x40000000)
+		count = 0x40000000;
+
+	long long sent = (long long)send(localSocket_handle(s), bytes, (int)count, LOCAL_SOCKET_NO_SIGNAL);
+	if (sent < 0)
+		return localSocket_wouldBlock() ? 0 : -1;
+	return sent;
+}
+
+long long localSocket_receive(LocalSocket* s, void* bytes, size_t size)
+{
+	if (size > 0x40000000)
+		size = 0x40000000;
+
+	long long received = (long long)recv(localSocket_handle(s), bytes, (int)size, 0);
+	if (received < 0)
+		return localSocket_wouldBlock() ? 0 : -1;
+	return received > 0 ? received : -1;
+}
+
+int localSocket_wait(LocalSocket* s, long long timeout)
+{
+	fd_set readable;
+	FD_ZERO(&readable);
+	FD_SET(localSocket_handle(s), &readable);
+	struct timeval time;
+	time.tv_sec = (long)(timeout / 1000000000);
+	time.tv_usec = (long)(timeout % 1000000000 / 1000);
+
+	// Winsock ignores the first argument.
+	int ready = select((int)localSocket_handle(s) + 1, &readable, NULL, NULL, &time);
+	if (ready < 0)
+		return localSocket_wouldBlock() ? 0 : -1;
+	return ready > 0;
+}
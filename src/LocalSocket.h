@@ -0,0 +1,59 @@
+#ifndef LOCAL_SOCKET
+#define LOCAL_SOCKET
+
+#include <stdlib.h>
+
+// TCP sockets on the loopback interface (127.0.0.1), which processes of the same machine talk through: Winsock on Windows,
+// BSD sockets elsewhere. Every socket is non-blocking, so sending, receiving and accepting never wait: waiting is done only
+// by 'localSocket_wait'. On Windows, Winsock is started by every socket that is opened and cleaned up when it is closed.
+// The handle is kept as a number big enough for a Windows SOCKET, so that <winsock2.h> is not included here.
+// Do not use struct members directly. Use only methods that start with 'localSocket_'.
+// A socket is a plain value: it is opened with 'localSocket_listen', 'localSocket_accept' or 'localSocket_connect'
+// and must be closed with 'localSocket_close'. 'localSocket_init' makes it closed.
+// If not specified otherwise, socket pointer cannot be NULL in socket methods.
+typedef struct {
+	long long handle;
+} LocalSocket;
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize a closed socket.
+void localSocket_init(LocalSocket* s);
+
+// Open a socket that listens on the given port of the loopback interface (0 picks a free port, see 'localSocket_port').
+// Returns 1 on success, otherwise 0 (and the socket stays closed).
+int localSocket_listen(LocalSocket* s, unsigned short port);
+
+// Accept the next connection waiting on the listening socket into 'connection'.
+// Returns 1 if one was accepted, 0 if none is waiting, and -1 on an error.
+int localSocket_accept(LocalSocket* listener, LocalSocket* connection);
+
+// Open a connection to the given port of the loopback interface. Returns 1 on success, otherwise 0 (and the socket stays closed).
+int localSocket_connect(LocalSocket* s, unsigned short port);
+
+// Close the socket. If it is closed nothing happens.
+void localSocket_close(LocalSocket* s);
+
+// PROPERTIES.
+
+// Returns 1 if the socket is open, otherwise 0.
+int localSocket_isOpen(const LocalSocket* s);
+
+// Get the local port of the socket, or 0 if it is closed.
+unsigned short localSocket_port(const LocalSocket* s);
+
+// METHODS.
+
+// Send as many of the bytes as the socket takes now. Returns the number sent (0 if the socket is full),
+// or -1 if the connection failed or was closed by the other side.
+long long localSocket_send(LocalSocket* s, const void* bytes, size_t count);
+
+// Receive up to 'size' bytes that arrived. Returns the number received (0 if none arrived yet),
+// or -1 if the connection failed or was closed by the other side (after all its bytes were received).
+long long localSocket_receive(LocalSocket* s, void* bytes, size_t size);
+
+// Wait at most the given time in nanoseconds until bytes arrive on the socket, its connection is closed, or a connection
+// waits to be accepted on a listening socket. Returns 1 if one of them happened, 0 on timeout, and -1 on an error.
+int localSocket_wait(LocalSocket* s, long long timeout);
+
+#endif
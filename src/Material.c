@@ -1,14 +1,50 @@
 #include "material.h"
+#include "SpanTracer.h"
 #include <stdlib.h>
 #include <string.h>
 
+// Stores a copy of the string (can be NULL) as the string with the given flag, in the inline buffer if the string fits in it,
+// otherwise in '*str'.
+static void material_setString(Material* mat, char** str, char* buffer, unsigned char flag, const char* newStr)
+{
+	// Setting a string to itself (for example in 'material_set' with the same material) changes nothing.
+	const char* oldStr = mat->inlineStrings & flag ? buffer : *str;
+	if (newStr == oldStr)
+		return;
+
+	// The new string might be a part of the old one, so the old one is freed last.
+	size_t newLen = newStr ? strlen(newStr) : 0;
+	char* oldHeapStr = *str;
+	*str = NULL;
+
+	if (newStr && newLen < MATERIAL_INLINE_STRING) {
+		memmove(buffer, newStr, newLen + 1);
+		mat->inlineStrings |= flag;
+	}
+	else {
+		mat->inlineStrings &= ~flag;
+		if (newStr && (*str = allocator_alloc(mat->allocator, newLen + 1)))
+			memcpy(*str, newStr, newLen + 1);
+	}
+
+	allocator_free(mat->allocator, oldHeapStr);
+}
+
 // Constructor / Destructor
 Material* material_create()
 {
-	return calloc(1, sizeof(Material));
+	return material_createWith(NULL);
 }
 
-Material* material_construct(int id, const char* name, const char* supplier, float quantity, Date exp_date)
+Material* material_createWith(const Allocator* allocator)
+{
+	Material* mat = allocator_alloc(allocator, sizeof(Material));
+	if (mat)
+		material_init(mat, allocator);
+	return mat;
+}
+
+Material* material_construct(int id, const char* name, const char* supplier, Quantity quantity, Date exp_date)
 {
 	Material* mat = material_create();
 	if (mat) {
@@ -24,21 +60,41 @@ Material* material_construct(int id, const char* name, const char* supplier, flo
 
 Material* material_duplicate(const Material* oldMat)
 {
-	Material* newMat = material_create();
+	return material_duplicateWith(NULL, oldMat);
+}
+
+Material* material_duplicateWith(const Allocator* allocator, const Material* oldMat)
+{
+	SPAN_BEGIN("material_duplicate");
+	Material* newMat = material_createWith(allocator);
 	if (newMat)
 		material_set(newMat, oldMat);
+	SPAN_END();
 	return newMat;
 }
 
 void material_destroy(Material* mat)
 {
 	if (mat) {
-		free(mat->name);
-		free(mat->supplier);
-		free(mat);
+		material_release(mat);
+		allocator_free(mat->allocator, mat);
 	}
 }
 
+void material_init(Material* mat, const Allocator* allocator)
+{
+	memset(mat, 0, sizeof(Material));
+	mat->exp_date = DATE_SERIAL_NONE;
+	mat->allocator = allocator;
+}
+
+void material_release(Material* mat)
+{
+	allocator_free(mat->allocator, mat->name);
+	allocator_free(mat->allocator, mat->supplier);
+	material_init(mat, mat->allocator);
+}
+
 // Set operator.
 void material_set(Material* mat, const Material* other)
 {
@@ -46,7 +102,7 @@ void material_set(Material* mat, const Material* other)
 	material_name_set(mat, material_name(other));
 	material_supplier_set(mat, material_supplier(other));
 	material_quantity_set(mat, material_quantity(other));
-	material_expDate_set(mat, material_expDate(other));
+	mat->exp_date = material_expSerial(other);
 }
 
 // Properties.
@@ -62,54 +118,45 @@ void material_id_set(Material* mat, int newId)
 
 const char* material_name(const Material* mat)
 {
-	return mat->name;
+	return mat->inlineStrings & MATERIAL_INLINE_NAME ? mat->nameBuffer : mat->name;
 }
 
 void material_name_set(Material* mat, const char* newName)
 {
-	free(mat->name);
-	mat->name = NULL;
-
-	if (newName) {
-		size_t nameLen = strlen(newName);
-		if (mat->name = calloc(nameLen + 1, sizeof(char)))
-			strcpy(mat->name, newName);
-	}
+	material_setString(mat, &mat->name, mat->nameBuffer, MATERIAL_INLINE_NAME, newName);
 }
 
 const char* material_supplier(const Material* mat)
 {
-	return mat->supplier;
+	return mat->inlineStrings & MATERIAL_INLINE_SUPPLIER ? mat->supplierBuffer : mat->supplier;
 }
 
 void material_supplier_set(Material* mat, const char* newSupplier)
 {
-	free(mat->supplier);
-	mat->supplier = NULL;
-
-	if (newSupplier) {
-		size_t supplierLen = strlen(newSupplier);
-		if (mat->supplier = calloc(supplierLen + 1, sizeof(char)))
-			strcpy(mat->supplier, newSupplier);
-	}
+	material_setString(mat, &mat->supplier, mat->supplierBuffer, MATERIAL_INLINE_SUPPLIER, newSupplier);
 }
 
-float material_quantity(const Material* mat)
+Quantity material_quantity(const Material* mat)
 {
 	return mat->quantity;
 }
 
-void material_quantity_set(Material* mat, float newQuantity)
+void material_quantity_set(Material* mat, Quantity newQuantity)
 {
 	mat->quantity = newQuantity;
 }
 
 Date material_expDate(const Material* mat)
+{
+	return date_fromSerial(mat->exp_date);
+}
+
+DateSerial material_expSerial(const Material* mat)
 {
 	return mat->exp_date;
 }
 
 void material_expDate_set(Material* mat, Date newExpDate)
 {
-	mat->exp_date = newExpDate;
+	mat->exp_date = date_serial(newExpDate);
 }
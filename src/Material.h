@@ -1,18 +1,36 @@
 #ifndef MATERIAL
 #define MATERIAL
 
+#include "Allocator.h"
 #include "Date.h"
+#include "Quantity.h"
+
+// The size of the buffers inside a material for short names and suppliers (including the null character).
+#define MATERIAL_INLINE_STRING 24
+
+// The flags telling which strings of a material are stored in its buffers.
+#define MATERIAL_INLINE_NAME 0x01
+#define MATERIAL_INLINE_SUPPLIER 0x02
 
 // The internal data used to represent a material in the bakery.
 // Do not use struct members directly. Use only the methods that start with 'material_'.
 // You need to initialize the material with 'material_create' or 'material_construct', and destroy it with 'material_destroy'.
+// Names and suppliers shorter than MATERIAL_INLINE_STRING are stored inside the material (marked in 'inlineStrings', the
+// string pointers are then NULL), so a material usually takes a single allocation; longer ones are allocated separately.
+// A material holds no pointer to itself, so it can be moved in memory, for example when it is stored by value in a vector
+// (see 'material_init'). Do not copy the struct itself and keep using both copies, use 'material_duplicate'.
+// The material and its long strings are taken from the allocator it was created with (the heap by default).
 // If not specified otherwise, material pointer cannot be NULL in the methods that start with 'material_'
 typedef struct {
 	int id;
 	char* name;
 	char* supplier;
-	float quantity;
-	Date exp_date;
+	char nameBuffer[MATERIAL_INLINE_STRING];
+	char supplierBuffer[MATERIAL_INLINE_STRING];
+	unsigned char inlineStrings;
+	Quantity quantity;
+	DateSerial exp_date;
+	const Allocator* allocator;
 } Material;
 
 // CONSTRUCTOR / DESTRUCTOR.
@@ -20,15 +38,28 @@ typedef struct {
 // Initialize a material with NULL name and supplier, quantity 0 and expiration date 0000/00/00.
 Material* material_create();
 
+// Initialize a material like 'material_create', allocated with the given allocator (NULL means the default allocator).
+Material* material_createWith(const Allocator* allocator);
+
 // Initialize a material with the given properties.
-Material* material_construct(int id, const char* name, const char* supplier, float quantity, Date exp_date);
+Material* material_construct(int id, const char* name, const char* supplier, Quantity quantity, Date exp_date);
 
 // Create a material identical with the given material.
 Material* material_duplicate(const Material* mat);
 
+// Create a material identical with the given material, allocated with the given allocator (NULL means the default allocator).
+Material* material_duplicateWith(const Allocator* allocator, const Material* mat);
+
 // Destroy a material. If pointer is NULL nothing happens.
 void material_destroy(Material* mat);
 
+// Initialize a material stored by value (for example inside another struct) like 'material_createWith', without allocating it.
+// Its long strings are taken from the given allocator (NULL means the default allocator).
+void material_init(Material* mat, const Allocator* allocator);
+
+// Release the long strings of a material stored by value, without freeing the material itself. It is empty again and can be reused.
+void material_release(Material* mat);
+
 // SET OPERATOR.
 
 // Set all the properties of the first material as the properties of the second one.
@@ -55,15 +86,18 @@ const char* material_supplier(const Material* mat);
 void material_supplier_set(Material* mat, const char* newSupplier);
 
 // Get the quantity of the material.
-float material_quantity(const Material* mat);
+Quantity material_quantity(const Material* mat);
 
 // Set the quantity of the material.
-void material_quantity_set(Material* mat, float newQuantity);
+void material_quantity_set(Material* mat, Quantity newQuantity);
 
-// Get the expiration date of the material.
+// Get the expiration date of the material, or 0000/00/00 if it is not set or is invalid.
 Date material_expDate(const Material* mat);
 
-// Set the expiration date of the material.
+// Get the expiration date of the material as a serial day number, or DATE_SERIAL_NONE if it is not set or is invalid.
+DateSerial material_expSerial(const Material* mat);
+
+// Set the expiration date of the material. An invalid date (see 'date_isValid') is stored as not set.
 void material_expDate_set(Material* mat, Date newExpDate);
 
 #endif
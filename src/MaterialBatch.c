@@ -0,0 +1,94 @@
+#include "MaterialBatch.h"
+#include <stdlib.h>
+
+// Constructor / Destructor.
+MaterialBatch* matBatch_create()
+{
+	MaterialBatch* batch = calloc(1, sizeof(MaterialBatch));
+	if (batch) {
+		batch->operations = vector_create(0);
+		intVec_init(&batch->results);
+	}
+
+	return batch;
+}
+
+void matBatch_destroy(MaterialBatch* batch)
+{
+	if (batch == NULL)
+		return;
+
+	matBatch_clear(batch);
+	vector_destroy(batch->operations);
+	intVec_free(&batch->results);
+	free(batch);
+}
+
+// Properties.
+size_t matBatch_length(const MaterialBatch* batch)
+{
+	return vector_length(batch->operations);
+}
+
+size_t matBatch_pendingCount(const MaterialBatch* batch)
+{
+	return vector_length(batch->operations) - batch->committed;
+}
+
+const MaterialOperation* matBatch_operation(const MaterialBatch* batch, size_t index)
+{
+	return vector_get(batch->operations, index);
+}
+
+int matBatch_result(const MaterialBatch* batch, size_t index)
+{
+	if (index >= batch->committed)
+		return MAT_BATCH_PENDING;
+
+	return *intVec_at(&batch->results, index);
+}
+
+// Methods.
+int matBatch_enqueue(MaterialBatch* batch, OperationType type, const Material* mat)
+{
+	if (type == NONE || mat == NULL || material_name(mat) == NULL || material_supplier(mat) == NULL)
+		return -1;
+
+	MaterialOperation* op = matOp_construct(type, mat);
+	if (op == NULL)
+		return -1;
+
+	// Grow the results together with the queue, so acknowledging never allocates.
+	size_t newLen = vector_length(batch->operations) + 1;
+	if (!intVec_add(&batch->results, MAT_BATCH_PENDING)) {
+		matOp_destroy(op);
+		return -1;
+	}
+
+	vector_add(batch->operations, op);
+	if (vector_length(batch->operations) != newLen) {
+		intVec_removeLast(&batch->results);
+		matOp_destroy(op);
+		return -1;
+	}
+
+	return (int)(newLen - 1);
+}
+
+void matBatch_acknowledge(MaterialBatch* batch, int result)
+{
+	if (batch->committed >= vector_length(batch->operations))
+		return;
+
+	*intVec_at(&batch->results, batch->committed++) = result;
+}
+
+void matBatch_clear(MaterialBatch* batch)
+{
+	for (size_t i = 0; i < vector_length(batch->operations); ++i)
+		matOp_destroy(vector_get(batch->operations, i));
+
+	vector_clear(batch->operations);
+	intVec_clear(&batch->results);
+	batch->committed = 0;
+}
@@ -0,0 +1,65 @@
+#ifndef MATERIAL_BATCH
+#define MATERIAL_BATCH
+
+#include "MaterialOperation.h"
+#include "Vector.h"
+
+// Value stored as the result of an operation that was not committed yet.
+#define MAT_BATCH_PENDING -100
+
+// A write given to the service without copying the material (see 'matServ_applyWrites'): ADD adds or updates by NSE,
+// UPDATE updates by NSE and REMOVE removes by NSE, like in a batch. 'result' is set when the write is applied.
+typedef struct {
+	OperationType type;
+	const Material* mat;
+	int result;
+} MaterialWrite;
+
+// Internal data for a queue of write operations that are committed together by a material service.
+// Do not use struct members directly. Use only methods that start with 'matBatch_'.
+// The batch must be initialized with 'matBatch_create' and destroyed with 'matBatch_destroy'.
+// If not specified otherwise, batch pointer cannot be NULL in batch methods.
+typedef struct {
+	Vector* operations;
+	IntVector results;
+	size_t committed;
+} MaterialBatch;
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize an empty batch.
+MaterialBatch* matBatch_create();
+
+// Release all batch resources and free the batch itself. If batch is NULL nothing happens.
+void matBatch_destroy(MaterialBatch* batch);
+
+// PROPERTIES.
+
+// Returns the number of operations in the batch (committed or not).
+size_t matBatch_length(const MaterialBatch* batch);
+
+// Returns the number of operations that were not committed yet.
+size_t matBatch_pendingCount(const MaterialBatch* batch);
+
+// Returns the operation on the specified index, or NULL if the index is invalid.
+const MaterialOperation* matBatch_operation(const MaterialBatch* batch, size_t index);
+
+// Returns the result of the operation on the specified index, as returned by the matching 'matServ_*ByNSE' method.
+// If the operation was not committed yet or the index is invalid, returns MAT_BATCH_PENDING.
+int matBatch_result(const MaterialBatch* batch, size_t index);
+
+// METHODS.
+
+// Queue a copy of the given material to be written when the batch is committed and return its index in the batch.
+// ADD adds or updates by NSE (the material id is used only if the material is added, -1 assigns an unused one),
+// UPDATE updates by NSE and REMOVE removes by NSE.
+// If the operation is NONE or the material is NULL or has no name or supplier, returns -1.
+int matBatch_enqueue(MaterialBatch* batch, OperationType type, const Material* mat);
+
+// Store the result of the next pending operation. Not recommended to use outside the service.
+void matBatch_acknowledge(MaterialBatch* batch, int result);
+
+// Remove all the operations and results.
+void matBatch_clear(MaterialBatch* batch);
+
+#endif
@@ -0,0 +1,76 @@
+#include "MaterialCursor.h"
+
+// Returns the next material of the source, without filtering, or NULL at the end.
+static const Material* matCursor_nextFromSource(MaterialCursor* cur)
+{
+	if (cur->inner)
+		return matCursor_next(cur->inner);
+
+	if (cur->vector) {
+		if (cur->index >= vector_length(cur->vector))
+			return NULL;
+		return vector_get(cur->vector, cur->index++);
+	}
+
+	if (cur->repository == NULL || cur->index >= matRepo_matCount(cur->repository))
+		return NULL;
+	return matRepo_getByIndex(cur->repository, cur->index++);
+}
+
+// Constructors.
+MaterialCursor matCursor_overRepository(MaterialRepository* rep)
+{
+	MaterialCursor cur = { 0 };
+	cur.repository = rep;
+	return cur;
+}
+
+MaterialCursor matCursor_overVector(const Vector* v)
+{
+	MaterialCursor cur = { 0 };
+	cur.vector = v;
+	return cur;
+}
+
+MaterialCursor matCursor_overCursor(MaterialCursor* inner)
+{
+	MaterialCursor cur = { 0 };
+	cur.inner = inner;
+	return cur;
+}
+
+// Filters.
+MaterialCursor* matCursor_where(MaterialCursor* cur, const MaterialQuery* q)
+{
+	cur->query = q;
+	return cur;
+}
+
+MaterialCursor* matCursor_filter(MaterialCursor* cur, int(*filter)(void* context, const Material* mat), void* context)
+{
+	cur->filter = filter;
+	cur->context = context;
+	return cur;
+}
+
+// Methods.
+const Material* matCursor_next(MaterialCursor* cur)
+{
+	const Material* mat;
+	while ((mat = matCursor_nextFromSource(cur)) != NULL) {
+		if (cur->query && !matQuery_matches(cur->query, mat))
+			continue;
+		if (cur->filter && !cur->filter(cur->context, mat))
+			continue;
+		return mat;
+	}
+
+	return NULL;
+}
+
+void matCursor_rewind(MaterialCursor* cur)
+{
+	cur->index = 0;
+	if (cur->inner)
+		matCursor_rewind(cur->inner);
+}
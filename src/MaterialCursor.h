@@ -0,0 +1,52 @@
+#ifndef MATERIAL_CURSOR
+#define MATERIAL_CURSOR
+
+#include "MaterialQuery.h"
+#include "MaterialRepository.h"
+
+// The internal data for a cursor that yields materials one at a time, from the repository, from a vector of materials,
+// or from another cursor, skipping the materials rejected by its filters. Nothing is copied, so memory use is constant.
+// Do not use struct members directly. Use only methods that start with 'matCursor_'.
+// A cursor is a plain value: initialize it with one of the 'matCursor_over*' methods and drop it when you are done.
+// The source must stay valid and must not be modified while the cursor is used.
+// If not specified otherwise, cursor pointer cannot be NULL in cursor methods.
+typedef struct MaterialCursor {
+	MaterialRepository* repository;
+	const Vector* vector;
+	struct MaterialCursor* inner;
+	size_t index;
+	const MaterialQuery* query;
+	int(*filter)(void* context, const Material* mat);
+	void* context;
+} MaterialCursor;
+
+// CONSTRUCTORS.
+
+// Returns a cursor over all the materials of the repository, in the order of their indexes.
+MaterialCursor matCursor_overRepository(MaterialRepository* rep);
+
+// Returns a cursor over the materials of the given vector, in order.
+MaterialCursor matCursor_overVector(const Vector* v);
+
+// Returns a cursor over the materials yielded by another cursor, so that filters can be chained.
+MaterialCursor matCursor_overCursor(MaterialCursor* inner);
+
+// FILTERS.
+// Each method sets a filter and returns the cursor, so calls can be chained. A cursor has at most one filter of each kind;
+// use 'matCursor_overCursor' to stack more.
+
+// Yield only the materials matching the conditions of the query (order and limit are ignored). The query is not copied.
+MaterialCursor* matCursor_where(MaterialCursor* cur, const MaterialQuery* q);
+
+// Yield only the materials for which the function returns non-zero. The context is passed to the function.
+MaterialCursor* matCursor_filter(MaterialCursor* cur, int(*filter)(void* context, const Material* mat), void* context);
+
+// METHODS.
+
+// Returns the next material that passes the filters, or NULL if there are no more. Don't modify the material.
+const Material* matCursor_next(MaterialCursor* cur);
+
+// Starts the cursor (and the cursors under it) from the beginning again.
+void matCursor_rewind(MaterialCursor* cur);
+
+#endif
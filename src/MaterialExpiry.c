@@ -0,0 +1,117 @@
+#include "MaterialExpiry.h"
+#include <stdio.h>
+
+// Writes the key of the material in the timers map.
+static void matExpiry_key(const Material* mat, char* key)
+{
+	sprintf(key, "%d", material_id(mat));
+}
+
+// Returns the day the material expires on: the day after its expiration date.
+static long matExpiry_day(const Material* mat)
+{
+	return (long)material_expSerial(mat) + 1;
+}
+
+static void matExpiry_fire(void* context, void* item)
+{
+	MaterialExpiry* expiry = context;
+	const Material* mat = item;
+
+	char key[16];
+	matExpiry_key(mat, key);
+	hashMap_remove(expiry->timers, key);
+
+	if (expiry->callback)
+		expiry->callback(expiry->context, mat);
+}
+
+// Drops all the timers.
+static void matExpiry_clear(MaterialExpiry* expiry)
+{
+	for (size_t i = 0; i < hashMap_capacity(expiry->timers); ++i) {
+		const HashMapEntry* entry = hashMap_entryAt(expiry->timers, i);
+		if (entry)
+			wheel_cancel(expiry->wheel, entry->value);
+	}
+
+	hashMap_destroy(expiry->timers);
+	expiry->timers = hashMap_create();
+}
+
+// Constructor / Destructor.
+MaterialExpiry* matExpiry_create(Date today)
+{
+	MaterialExpiry* expiry = calloc(1, sizeof(MaterialExpiry));
+	if (expiry) {
+		expiry->wheel = wheel_create(date_serialCeil(today));
+		expiry->timers = hashMap_create();
+	}
+
+	return expiry;
+}
+
+void matExpiry_destroy(MaterialExpiry* expiry)
+{
+	if (expiry == NULL)
+		return;
+
+	wheel_destroy(expiry->wheel);
+	hashMap_destroy(expiry->timers);
+	free(expiry);
+}
+
+// Properties.
+size_t matExpiry_count(const MaterialExpiry* expiry)
+{
+	return wheel_count(expiry->wheel);
+}
+
+void matExpiry_setCallback(MaterialExpiry* expiry, ExpiryCallback callback, void* context)
+{
+	expiry->callback = callback;
+	expiry->context = context;
+}
+
+// Methods.
+void matExpiry_reset(MaterialExpiry* expiry, MaterialRepository* repository, Date today)
+{
+	matExpiry_clear(expiry);
+	wheel_destroy(expiry->wheel);
+	expiry->wheel = wheel_create(date_serialCeil(today));
+
+	for (size_t i = 0; i < matRepo_matCount(repository); ++i)
+		matExpiry_onChange(expiry, NULL, matRepo_getByIndex(repository, i));
+}
+
+size_t matExpiry_advance(MaterialExpiry* expiry, Date today)
+{
+	return wheel_advance(expiry->wheel, date_serialCeil(today), matExpiry_fire, expiry);
+}
+
+void matExpiry_onChange(void* context, const Material* oldMat, const Material* newMat)
+{
+	MaterialExpiry* expiry = context;
+	char key[16];
+	matExpiry_key(oldMat ? oldMat : newMat, key);
+	WheelTimer* timer = hashMap_get(expiry->timers, key);
+
+	// Removed, or already past its date: nothing left to fire.
+	if (newMat == NULL || matExpiry_day(newMat) <= wheel_now(expiry->wheel)) {
+		if (timer) {
+			hashMap_remove(expiry->timers, key);
+			wheel_cancel(expiry->wheel, timer);
+		}
+		return;
+	}
+
+	// Updates keep the material in place, so only the time changes.
+	if (timer) {
+		wheel_reschedule(expiry->wheel, timer, matExpiry_day(newMat));
+		return;
+	}
+
+	timer = wheel_schedule(expiry->wheel, matExpiry_day(newMat), (void*)newMat);
+	if (timer && !hashMap_put(expiry->timers, key, timer))
+		wheel_cancel(expiry->wheel, timer);
+}
@@ -0,0 +1,54 @@
+#ifndef MATERIAL_EXPIRY
+#define MATERIAL_EXPIRY
+
+#include "MaterialRepository.h"
+#include "HashMap.h"
+#include "TimingWheel.h"
+
+// A function called for a material that just expired: the day after its expiration date was reached.
+// It must not change the repository.
+typedef void(*ExpiryCallback)(void* context, const Material* mat);
+
+// The internal data for an expiry scheduler: a timer for every material that did not expire yet, kept in a timing wheel
+// of days, so that adding, updating and removing a material is O(1) and advancing the day only touches the materials
+// that expire. The scheduler must be told about every change of the repository (see 'matExpiry_onChange').
+// Do not use struct members directly. Use only methods that start with 'matExpiry_'.
+// The scheduler must be initialized with 'matExpiry_create' and destroyed with 'matExpiry_destroy'.
+// If not specified otherwise, scheduler pointer cannot be NULL in scheduler methods.
+typedef struct {
+	TimingWheel* wheel;
+	HashMap* timers;
+	ExpiryCallback callback;
+	void* context;
+} MaterialExpiry;
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize a scheduler without materials, starting on the given day.
+MaterialExpiry* matExpiry_create(Date today);
+
+// Release all scheduler resources and free the scheduler. If scheduler is NULL nothing happens.
+void matExpiry_destroy(MaterialExpiry* expiry);
+
+// PROPERTIES.
+
+// Returns the number of materials waiting to expire.
+size_t matExpiry_count(const MaterialExpiry* expiry);
+
+// Set the function called for every material that expires (NULL only drops them).
+void matExpiry_setCallback(MaterialExpiry* expiry, ExpiryCallback callback, void* context);
+
+// METHODS.
+
+// Drop all the timers, move to the given day and schedule the materials of the repository that did not expire yet. O(n).
+void matExpiry_reset(MaterialExpiry* expiry, MaterialRepository* repository, Date today);
+
+// Move forward to the given day and call the callback for every material that expired in the meantime, in the order of
+// their expiration dates. Returns the number of materials that expired.
+size_t matExpiry_advance(MaterialExpiry* expiry, Date today);
+
+// Tell the scheduler about a change of the repository. Has the signature of a 'MaterialObserver', with the scheduler as context.
+// A material added or updated with a date that is already past is not scheduled, since it does not cross its expiration date anymore.
+void matExpiry_onChange(void* expiry, const Material* oldMat, const Material* newMat);
+
+#endif
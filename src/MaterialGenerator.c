@@ -0,0 +1,96 @@
+#include "MaterialGenerator.h"
+#include <stdio.h>
+
+// Words the names and suppliers start with, so they look like the real ones (and share prefixes, like the real ones).
+static const char* NAME_WORDS[] = { "Flour", "Milk", "Sugar", "Butter", "Eggs", "Yeast", "Salt", "Raisins",
+	"Cocoa", "Vanilla", "Honey", "Walnuts", "Cream", "Cinnamon", "Almonds", "Water" };
+static const char* SUPPLIER_WORDS[] = { "Good Mill", "Cow inc", "Sweet inc", "Best Farm", "Bakery Stuff", "Golden Grain",
+	"Green Valley", "Sunny Fields" };
+
+#define NAME_WORD_COUNT (sizeof(NAME_WORDS) / sizeof(NAME_WORDS[0]))
+#define SUPPLIER_WORD_COUNT (sizeof(SUPPLIER_WORDS) / sizeof(SUPPLIER_WORDS[0]))
+
+GeneratorConfig matGen_defaultConfig()
+{
+	GeneratorConfig config = { 1, 1000, 100, { 2020, 1, 1 }, 3650, GEN_DATES_UNIFORM, QUANTITY(100) };
+	return config;
+}
+
+// Constructor / Destructor.
+MaterialGenerator* matGen_create(const GeneratorConfig* config)
+{
+	GeneratorConfig settings = config ? *config : matGen_defaultConfig();
+	if (settings.nameCount < 1 || settings.supplierCount < 1 || settings.dateSpan < 1 || !date_isValid(settings.firstDate) || settings.maxQuantity < 1)
+		return NULL;
+
+	MaterialGenerator* gen = calloc(1, sizeof(MaterialGenerator));
+	if (gen) {
+		gen->config = settings;
+		gen->firstDay = date_serial(settings.firstDate);
+		matGen_rewind(gen);
+	}
+
+	return gen;
+}
+
+void matGen_destroy(MaterialGenerator* gen)
+{
+	free(gen);
+}
+
+// Properties.
+const GeneratorConfig* matGen_config(const MaterialGenerator* gen)
+{
+	return &gen->config;
+}
+
+// Methods.
+unsigned long long matGen_random(MaterialGenerator* gen)
+{
+	// SplitMix64: every seed gives a good sequence, and the state is a single number.
+	unsigned long long z = (gen->state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+size_t matGen_randomBelow(MaterialGenerator* gen, size_t bound)
+{
+	return (size_t)(matGen_random(gen) % bound);
+}
+
+const char* matGen_name(MaterialGenerator* gen, size_t index)
+{
+	snprintf(gen->name, MAT_GEN_STRING, "%s %zu", NAME_WORDS[index % NAME_WORD_COUNT], index / NAME_WORD_COUNT);
+	return gen->name;
+}
+
+const char* matGen_supplier(MaterialGenerator* gen, size_t index)
+{
+	snprintf(gen->supplier, MAT_GEN_STRING, "%s %zu SRL", SUPPLIER_WORDS[index % SUPPLIER_WORD_COUNT], index / SUPPLIER_WORD_COUNT);
+	return gen->supplier;
+}
+
+void matGen_next(MaterialGenerator* gen, Material* mat)
+{
+	const GeneratorConfig* config = &gen->config;
+	size_t day = matGen_randomBelow(gen, (size_t)config->dateSpan);
+	if (config->dates == GEN_DATES_EARLY) {
+		// The smaller of two uniform days has a linearly falling distribution.
+		size_t other = matGen_randomBelow(gen, (size_t)config->dateSpan);
+		day = other < day ? other : day;
+	}
+
+	Quantity quantity = 1 + (Quantity)(matGen_random(gen) % (unsigned long long)config->maxQuantity);
+
+	material_id_set(mat, -1);
+	material_name_set(mat, matGen_name(gen, matGen_randomBelow(gen, config->nameCount)));
+	material_supplier_set(mat, matGen_supplier(gen, matGen_randomBelow(gen, config->supplierCount)));
+	material_quantity_set(mat, quantity);
+	material_expDate_set(mat, date_fromSerial(gen->firstDay + (DateSerial)day));
+}
+
+void matGen_rewind(MaterialGenerator* gen)
+{
+	gen->state = gen->config.seed;
+}
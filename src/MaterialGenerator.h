@@ -0,0 +1,84 @@
+#ifndef MATERIAL_GENERATOR
+#define MATERIAL_GENERATOR
+
+#include "Material.h"
+#include <stdlib.h>
+
+// The size of the buffers for the generated names and suppliers (including the null character).
+#define MAT_GEN_STRING 32
+
+// How the expiration dates of the generated materials are spread over the date span.
+// GEN_DATES_UNIFORM: every day of the span is equally likely.
+// GEN_DATES_EARLY: the earlier days are more likely (the chance falls linearly to 0 at the end of the span),
+// like a stock where most materials expire soon.
+typedef enum {
+	GEN_DATES_UNIFORM,
+	GEN_DATES_EARLY
+} GeneratorDates;
+
+// The settings of a material generator. Start from 'matGen_defaultConfig' and change what is needed.
+// Names are picked from 'nameCount' distinct names and suppliers from 'supplierCount' distinct suppliers (both at least 1),
+// expiration dates from the 'dateSpan' days (at least 1) starting with 'firstDate' (a valid date), and quantities from the smallest step up to 'maxQuantity' (at least 1, see 'Quantity').
+// The same settings always generate the same materials.
+typedef struct {
+	unsigned long long seed;
+	size_t nameCount;
+	size_t supplierCount;
+	Date firstDate;
+	long dateSpan;
+	GeneratorDates dates;
+	Quantity maxQuantity;
+} GeneratorConfig;
+
+// The internal data for a deterministic generator of synthetic bakery materials, used by the benchmarks.
+// Do not use struct members directly. Use only methods that start with 'matGen_'.
+// The generator must be initialized with 'matGen_create' and destroyed with 'matGen_destroy'.
+// If not specified otherwise, generator pointer cannot be NULL in generator methods.
+typedef struct {
+	GeneratorConfig config;
+	unsigned long long state;
+	DateSerial firstDay;
+	char name[MAT_GEN_STRING];
+	char supplier[MAT_GEN_STRING];
+} MaterialGenerator;
+
+// Returns the default settings: seed 1, 1000 names, 100 suppliers, uniform dates over 10 years from 2020/01/01, quantities up to 100.
+GeneratorConfig matGen_defaultConfig();
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize a generator with the given settings (NULL means the default settings).
+// Returns NULL if the settings are invalid or the generator could not be allocated.
+MaterialGenerator* matGen_create(const GeneratorConfig* config);
+
+// Free the generator. If generator is NULL nothing happens.
+void matGen_destroy(MaterialGenerator* gen);
+
+// PROPERTIES.
+
+// Get the settings of the generator.
+const GeneratorConfig* matGen_config(const MaterialGenerator* gen);
+
+// METHODS.
+
+// Returns the next pseudo-random number of the generator.
+unsigned long long matGen_random(MaterialGenerator* gen);
+
+// Returns a pseudo-random number in [0, bound). Bound must be at least 1.
+size_t matGen_randomBelow(MaterialGenerator* gen, size_t bound);
+
+// Returns the name with the given index (less than 'nameCount'). The string is valid until the next call that returns a name.
+const char* matGen_name(MaterialGenerator* gen, size_t index);
+
+// Returns the supplier with the given index (less than 'supplierCount'). The string is valid until the next call that returns a supplier.
+const char* matGen_supplier(MaterialGenerator* gen, size_t index);
+
+// Sets the name, supplier, quantity and expiration date of the given material (cannot be NULL) to the next generated ones.
+// The id is set to -1 (an unused id is assigned when the material is added). Otherwise the material is valid; materials can repeat the same
+// name, supplier and expiration date, less often the more names, suppliers and days there are.
+void matGen_next(MaterialGenerator* gen, Material* mat);
+
+// Start again from the first material, so the same sequence is generated again.
+void matGen_rewind(MaterialGenerator* gen);
+
+#endif
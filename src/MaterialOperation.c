@@ -1,22 +1,40 @@
 #include "MaterialOperation.h"
 #include <stdlib.h>
 
+// Returns 1 if the type and the material are a valid combination, otherwise 0.
+static int matOp_isValid(OperationType type, const Material* mat)
+{
+	return (type == NONE) == (mat == NULL);
+}
+
+// Copies the material into the operation. Returns 0 if a string of the material could not be copied.
+static int matOp_copyMaterial(MaterialOperation* op, const Material* mat)
+{
+	material_set(&op->mat, mat);
+	return (material_name(mat) == NULL) == (material_name(&op->mat) == NULL)
+		&& (material_supplier(mat) == NULL) == (material_supplier(&op->mat) == NULL);
+}
+
 // Constructor / Destructor.
 MaterialOperation* matOp_create()
 {
-	return calloc(1, sizeof(MaterialOperation));
+	MaterialOperation* op = malloc(sizeof(MaterialOperation));
+	if (op)
+		matOp_initWith(op, NULL, NONE, NULL);
+	return op;
 }
 
 MaterialOperation* matOp_construct(OperationType type, const Material* mat)
 {
 	// Check for invalid type of operations.
-	if ((type == NONE && mat) || (type == ADD && !mat) || (type == UPDATE && !mat) || (type == REMOVE && !mat))
+	if (!matOp_isValid(type, mat))
 		return NULL;
 
-	MaterialOperation* op = calloc(1, sizeof(MaterialOperation));
-	if (op) {
-		op->type = type;
-		op->mat = material_duplicate(mat);
+	MaterialOperation* op = malloc(sizeof(MaterialOperation));
+	if (op && !matOp_init(op, type, mat)) {
+		matOp_release(op);
+		free(op);
+		return NULL;
 	}
 	return op;
 }
@@ -24,11 +42,34 @@ MaterialOperation* matOp_construct(OperationType type, const Material* mat)
 void matOp_destroy(MaterialOperation* op)
 {
 	if (op) {
-		material_destroy(op->mat);
+		matOp_release(op);
 		free(op);
 	}
 }
 
+int matOp_init(MaterialOperation* op, OperationType type, const Material* mat)
+{
+	return matOp_initWith(op, NULL, type, mat);
+}
+
+int matOp_initWith(MaterialOperation* op, const Allocator* allocator, OperationType type, const Material* mat)
+{
+	op->type = NONE;
+	op->allocator = allocator;
+	material_init(&op->mat, allocator);
+	if (!matOp_isValid(type, mat))
+		return 0;
+
+	op->type = type;
+	return mat == NULL || matOp_copyMaterial(op, mat);
+}
+
+void matOp_release(MaterialOperation* op)
+{
+	material_release(&op->mat);
+	op->type = NONE;
+}
+
 // Properties.
 OperationType matOp_type(const MaterialOperation* op)
 {
@@ -37,22 +78,22 @@ OperationType matOp_type(const MaterialOperation* op)
 
 const Material* matOp_material(const MaterialOperation* op)
 {
-	return op->mat;
+	return op->type == NONE ? NULL : &op->mat;
 }
 
 void matOp_setToNone(MaterialOperation* op)
 {
-	op->type = NONE;
-	material_destroy(op->mat);
-	op->mat = NULL;
+	matOp_release(op);
 }
 
 void matOp_setTypeAndMaterial(MaterialOperation* op, OperationType type, const Material* mat)
 {
-	if ((type == NONE && mat) || (type == ADD && !mat) || (type == UPDATE && !mat) || (type == REMOVE && !mat))
+	if (!matOp_isValid(type, mat))
 		return;
 
-	material_destroy(op->mat);
-	op->mat = material_duplicate(mat);
+	if (mat)
+		matOp_copyMaterial(op, mat);
+	else
+		material_release(&op->mat);
 	op->type = type;
 }
@@ -3,13 +3,20 @@
 
 #include "OperationType.h"
 #include "Material.h"
+#include "TypedVector.h"
 
 // Internal data used for a CRUD operation on a material data set. Do not use directly, use only 'matOp_*' methods.
+// The material is stored by value (see 'material_init'), so an operation with short strings takes no allocation of its own.
 typedef struct {
 	OperationType type;
-	Material* mat;
+	Material mat;
+	const Allocator* allocator;
 } MaterialOperation;
 
+// A vector of operations stored by value (see 'VECTOR_DEFINE'). Initialize the operations with 'matOp_init'
+// and release them with 'matOp_release' before they are removed.
+VECTOR_DEFINE(MaterialOperation, OperationVector, opVec)
+
 // CONSTRUCTOR / DESTRUCTOR.
 
 // Initialize an empty operation.
@@ -21,6 +28,17 @@ MaterialOperation* matOp_construct(OperationType type, const Material* mat);
 // Release all resources and free the operation itself.
 void matOp_destroy(MaterialOperation* op);
 
+// Initialize an operation stored by value (for example in an 'OperationVector'), like 'matOp_construct'.
+// Returns 1 on success, or 0 if the type and material are not a valid combination or the copy could not be allocated.
+int matOp_init(MaterialOperation* op, OperationType type, const Material* mat);
+
+// Initialize an operation stored by value like 'matOp_init', whose long strings of materials are taken from the given allocator
+// (NULL means the default allocator).
+int matOp_initWith(MaterialOperation* op, const Allocator* allocator, OperationType type, const Material* mat);
+
+// Release the resources of an operation stored by value, without freeing the operation itself.
+void matOp_release(MaterialOperation* op);
+
 // PROPERTIES.
 
 // Get the operation type of the material operation.
@@ -0,0 +1,939 @@
+#include "MaterialOracle.h"
+#include "MaterialGenerator.h"
+#include "MaterialValidator.h"
+#include <string.h>
+
+// Few names and suppliers sharing prefixes, so that writes collide and the prefix conditions and completions select several of them.
+static const char* const ORACLE_NAMES[] = { "Flour", "Flax", "Milk", "Malt", "Sugar" };
+static const char* const ORACLE_SUPPLIERS[] = { "Mill", "Mills", "Farm", "Dairy" };
+#define ORACLE_NAME_COUNT ((int)(sizeof(ORACLE_NAMES) / sizeof(ORACLE_NAMES[0])))
+#define ORACLE_SUPPLIER_COUNT ((int)(sizeof(ORACLE_SUPPLIERS) / sizeof(ORACLE_SUPPLIERS[0])))
+
+// The ids of the operations are below this, so they often hit existing materials.
+#define ORACLE_MAX_ID 40
+
+// The expiration dates are spread over this many days from the first day of 2020, and the clock of the candidate is in the middle.
+#define ORACLE_DAYS 1461
+
+// Half of the days are one of this many days half a year apart, so the writes by name, supplier and expiration date often hit
+// existing materials.
+#define ORACLE_COMMON_DAYS 8
+#define ORACLE_COMMON_DAY_STEP 183
+
+static const char* const ORACLE_OP_NAMES[ORACLE_OP_COUNT] = {
+	"add", "update", "remove", "add_or_update_by_nse", "update_by_nse", "remove_by_nse", "batch",
+	"undo", "redo", "query", "cursor_query", "expired", "low_stock", "stats", "complete"
+};
+
+// How often every kind of operation is generated, out of 100.
+static const int ORACLE_OP_WEIGHTS[ORACLE_OP_COUNT] = { 16, 8, 7, 8, 5, 5, 4, 6, 4, 12, 5, 4, 5, 5, 6 };
+
+static const char* const ORACLE_PREDICATE_NAMES[] = {
+	"name_contains", "name_starts_with", "supplier_is", "supplier_starts_with",
+	"quantity_at_most", "quantity_greater", "expires_before", "expires_from"
+};
+
+static const char* const ORACLE_SORT_NAMES[] = { "none", "quantity", "name", "exp_date" };
+
+// A service under test with its repository.
+typedef struct {
+	MaterialRepository* repository;
+	MaterialService* service;
+} OracleSide;
+
+// The model the candidate is checked against, written from the documented behavior of the service and sharing none of its code:
+// the materials in a plain vector, and the undo and redo stacks as vectors of operations. Every lookup walks all the materials.
+typedef struct {
+	Vector* materials;
+	Vector* undoStack;
+	Vector* redoStack;
+} OracleModel;
+
+// The clock of the candidate, and the day the model counts as today.
+static Date matOracle_today()
+{
+	return (Date) { 2022, 1, 1 };
+}
+
+static Date matOracle_date(int day)
+{
+	return date_addDays((Date) { 2020, 1, 1 }, day);
+}
+
+static int matOracle_sameDate(Date a, Date b)
+{
+	return a.year == b.year && a.month == b.month && a.day == b.day;
+}
+
+static int matOracle_sameMaterial(const Material* a, const Material* b)
+{
+	return material_id(a) == material_id(b) && strcmp(material_name(a), material_name(b)) == 0
+		&& strcmp(material_supplier(a), material_supplier(b)) == 0 && material_quantity(a) == material_quantity(b)
+		&& matOracle_sameDate(material_expDate(a), material_expDate(b));
+}
+
+static int matOracle_compareIds(void* context, const void* a, const void* b)
+{
+	(void)context;
+	int x = material_id(a), y = material_id(b);
+	return x < y ? -1 : x > y;
+}
+
+static int matOracle_compareStrings(void* context, const void* a, const void* b)
+{
+	(void)context;
+	return strcmp(a, b);
+}
+
+static int matOracle_compareQuery(void* context, const void* a, const void* b)
+{
+	return matQuery_compare(context, a, b);
+}
+
+// Fills the condition on the given index of the operation. The text goes to the buffer, which must hold 8 characters.
+static void matOracle_predicate(const OracleOp* op, size_t index, QueryPredicate* pred, char* text)
+{
+	const char* name = ORACLE_NAMES[op->name];
+	const char* supplier = ORACLE_SUPPLIERS[op->supplier];
+
+	pred->type = op->predicates[index];
+	pred->text = text;
+	pred->quantity = op->quantity;
+	pred->date = matOracle_date(op->day);
+	text[0] = '\0';
+
+	// The conditions of a query share the values of the operation, so they are derived differently to not cancel each other.
+	switch (pred->type) {
+	case NAME_CONTAINS:
+		strcpy(text, name + strlen(name) - 2);
+		break;
+	case NAME_STARTS_WITH:
+		strncat(text, name, 2);
+		break;
+	case SUPPLIER_IS:
+		strcpy(text, supplier);
+		break;
+	case SUPPLIER_STARTS_WITH:
+		strncat(text, supplier, 3);
+		break;
+	case QUANTITY_GREATER:
+		pred->quantity = op->quantity / 2;
+		break;
+	case EXPIRES_FROM:
+		pred->date = matOracle_date(op->day - 365);
+		break;
+	default:
+		break;
+	}
+}
+
+// Returns the query of a query operation, or NULL if the memory could not be allocated.
+static MaterialQuery* matOracle_query(const OracleOp* op)
+{
+	MaterialQuery* q = matQuery_create();
+	if (q == NULL)
+		return NULL;
+
+	for (size_t i = 0; i < op->predicateCount; ++i) {
+		QueryPredicate pred;
+		char text[8];
+		matOracle_predicate(op, i, &pred, text);
+
+		switch (pred.type) {
+		case NAME_CONTAINS: matQuery_whereNameContains(q, pred.text); break;
+		case NAME_STARTS_WITH: matQuery_whereNameStartsWith(q, pred.text); break;
+		case SUPPLIER_IS: matQuery_whereSupplierIs(q, pred.text); break;
+		case SUPPLIER_STARTS_WITH: matQuery_whereSupplierStartsWith(q, pred.text); break;
+		case QUANTITY_AT_MOST: matQuery_whereQuantityAtMost(q, pred.quantity); break;
+		case QUANTITY_GREATER: matQuery_whereQuantityGreater(q, pred.quantity); break;
+		case EXPIRES_BEFORE: matQuery_whereExpiresBefore(q, pred.date); break;
+		case EXPIRES_FROM: matQuery_whereExpiresFrom(q, pred.date); break;
+		}
+	}
+
+	matQuery_setLimit(matQuery_orderBy(q, op->sortKey, op->descending), op->limit);
+	if (op->hasAfter) {
+		Material* after = material_construct(op->id, ORACLE_NAMES[op->name], ORACLE_SUPPLIERS[op->supplier], op->quantity, matOracle_date(op->day));
+		if (after == NULL) {
+			matQuery_destroy(q);
+			return NULL;
+		}
+		matQuery_setAfter(q, after);
+		material_destroy(after);
+	}
+
+	return q;
+}
+
+static int matOracle_open(OracleSide* side, size_t shardCount, const Allocator* allocator)
+{
+	side->repository = matRepo_createWith(matValid_validate, shardCount, allocator);
+	side->service = side->repository ? matServ_createWith(side->repository, allocator) : NULL;
+	if (side->service == NULL)
+		return 0;
+
+	matServ_setClock(side->service, matOracle_today);
+	matServ_setLowStockThreshold(side->service, ORACLE_SUPPLIERS[ORACLE_LOW_STOCK_SUPPLIER], ORACLE_LOW_STOCK_THRESHOLD);
+	return 1;
+}
+
+static void matOracle_close(OracleSide* side)
+{
+	matServ_destroy(side->service);
+	matRepo_destroy(side->repository);
+}
+
+// The model.
+
+static int matOracle_modelOpen(OracleModel* model)
+{
+	model->materials = vector_create(16);
+	model->undoStack = vector_create(16);
+	model->redoStack = vector_create(16);
+	return model->materials != NULL && model->undoStack != NULL && model->redoStack != NULL;
+}
+
+static void matOracle_modelClearStack(Vector* stack)
+{
+	for (size_t i = 0; i < vector_length(stack); ++i)
+		matOp_destroy(vector_get(stack, i));
+	vector_clear(stack);
+}
+
+static void matOracle_modelClose(OracleModel* model)
+{
+	if (model->materials) {
+		for (size_t i = 0; i < vector_length(model->materials); ++i)
+			material_destroy(vector_get(model->materials, i));
+	}
+	if (model->undoStack)
+		matOracle_modelClearStack(model->undoStack);
+	if (model->redoStack)
+		matOracle_modelClearStack(model->redoStack);
+
+	vector_destroy(model->materials);
+	vector_destroy(model->undoStack);
+	vector_destroy(model->redoStack);
+}
+
+// Returns the index of the material with the id, or -1.
+static long matOracle_modelFindId(const OracleModel* model, int id)
+{
+	for (size_t i = 0; i < vector_length(model->materials); ++i) {
+		if (material_id(vector_get(model->materials, i)) == id)
+			return (long)i;
+	}
+
+	return -1;
+}
+
+// Returns the index of the first material with the name, supplier and expiration date, or -1, and counts them.
+static long matOracle_modelFindNSE(const OracleModel* model, const char* name, const char* supplier, Date date, size_t* count)
+{
+	long found = -1;
+	*count = 0;
+	for (size_t i = 0; i < vector_length(model->materials); ++i) {
+		const Material* mat = vector_get(model->materials, i);
+		if (strcmp(material_name(mat), name) == 0 && strcmp(material_supplier(mat), supplier) == 0
+			&& matOracle_sameDate(material_expDate(mat), date) && (*count)++ == 0)
+			found = (long)i;
+	}
+
+	return found;
+}
+
+// The names, suppliers and dates of the operations are valid, so only the quantity can fail the validation.
+static int matOracle_modelValid(Quantity quantity)
+{
+	return quantity > 0 && quantity <= QUANTITY_MAX;
+}
+
+// Records the operation that reverts a write, and forgets the writes that could be redone.
+static void matOracle_modelRecord(OracleModel* model, OperationType type, const Material* mat)
+{
+	matOracle_modelClearStack(model->redoStack);
+	vector_add(model->undoStack, matOp_construct(type, mat));
+}
+
+static int matOracle_modelAdd(OracleModel* model, int id, const char* name, const char* supplier, Quantity quantity, Date date, int undoable)
+{
+	size_t count;
+	if (matOracle_modelFindNSE(model, name, supplier, date, &count) >= 0)
+		return -5;
+
+	if (id == -1) {
+		id = 0;
+		for (size_t i = 0; i < vector_length(model->materials); ++i) {
+			if (material_id(vector_get(model->materials, i)) >= id)
+				id = material_id(vector_get(model->materials, i)) + 1;
+		}
+	}
+
+	if (!matOracle_modelValid(quantity))
+		return -1;
+	if (matOracle_modelFindId(model, id) >= 0)
+		return -2;
+
+	Material* mat = material_construct(id, name, supplier, quantity, date);
+	vector_add(model->materials, mat);
+	if (undoable)
+		matOracle_modelRecord(model, REMOVE, mat);
+	return id;
+}
+
+static int matOracle_modelUpdateById(OracleModel* model, int id, const char* name, const char* supplier, Quantity quantity, Date date, int undoable)
+{
+	long index = matOracle_modelFindId(model, id);
+	if (index < 0)
+		return -3;
+	if (!matOracle_modelValid(quantity))
+		return -1;
+
+	Material* mat = vector_get(model->materials, (size_t)index);
+	if (undoable)
+		matOracle_modelRecord(model, UPDATE, mat);
+	vector_set(model->materials, (size_t)index, material_construct(id, name, supplier, quantity, date));
+	material_destroy(mat);
+	return 0;
+}
+
+static int matOracle_modelRemoveById(OracleModel* model, int id, int undoable)
+{
+	long index = matOracle_modelFindId(model, id);
+	if (index < 0)
+		return -3;
+
+	Material* mat = vector_get(model->materials, (size_t)index);
+	if (undoable)
+		matOracle_modelRecord(model, ADD, mat);
+	vector_removeAt(model->materials, (size_t)index);
+	material_destroy(mat);
+	return 0;
+}
+
+static int matOracle_modelUpdateByNSE(OracleModel* model, const char* name, const char* supplier, Quantity quantity, Date date)
+{
+	size_t count;
+	long index = matOracle_modelFindNSE(model, name, supplier, date, &count);
+	if (index < 0)
+		return -4;
+
+	int id = material_id(vector_get(model->materials, (size_t)index));
+	int result = matOracle_modelUpdateById(model, id, name, supplier, quantity, date, 1);
+	return result < 0 ? result : id;
+}
+
+static int matOracle_modelAddOrUpdateByNSE(OracleModel* model, int id, const char* name, const char* supplier, Quantity quantity, Date date)
+{
+	size_t count;
+	long index = matOracle_modelFindNSE(model, name, supplier, date, &count);
+	if (index < 0)
+		return matOracle_modelAdd(model, id, name, supplier, quantity, date, 1);
+
+	// A quantity too big to be valid is not added, so the update fails the validation.
+	Quantity current = material_quantity(vector_get(model->materials, (size_t)index));
+	return matOracle_modelUpdateByNSE(model, name, supplier, quantity > QUANTITY_MAX ? quantity : current + quantity, date);
+}
+
+static int matOracle_modelRemoveByNSE(OracleModel* model, const char* name, const char* supplier, Date date)
+{
+	size_t count;
+	long index = matOracle_modelFindNSE(model, name, supplier, date, &count);
+	if (index < 0)
+		return -4;
+
+	int id = material_id(vector_get(model->materials, (size_t)index));
+	int result = matOracle_modelRemoveById(model, id, 1);
+	return result < 0 ? result : id;
+}
+
+// Pops an operation from one stack and applies it without recording it. If it succeeds, the operation that reverts it is pushed
+// on the other stack and 1 is returned, otherwise the operation is dropped and 0 is returned.
+static int matOracle_modelRevert(OracleModel* model, Vector* from, Vector* to)
+{
+	if (vector_length(from) == 0)
+		return 0;
+
+	MaterialOperation* op = vector_get(from, vector_length(from) - 1);
+	vector_removeAt(from, vector_length(from) - 1);
+	const Material* mat = matOp_material(op);
+	long index = matOracle_modelFindId(model, material_id(mat));
+	Material* current = index >= 0 ? material_duplicate(vector_get(model->materials, (size_t)index)) : NULL;
+	int result = -1;
+
+	if (matOp_type(op) == ADD) {
+		result = matOracle_modelAdd(model, material_id(mat), material_name(mat), material_supplier(mat), material_quantity(mat), material_expDate(mat), 0);
+		if (result >= 0)
+			vector_add(to, matOp_construct(REMOVE, mat));
+	}
+	else {
+		if (matOp_type(op) == UPDATE)
+			result = matOracle_modelUpdateById(model, material_id(mat), material_name(mat), material_supplier(mat), material_quantity(mat), material_expDate(mat), 0);
+		else
+			result = matOracle_modelRemoveById(model, material_id(mat), 0);
+		if (result >= 0)
+			vector_add(to, matOp_construct(matOp_type(op) == UPDATE ? UPDATE : ADD, current));
+	}
+
+	material_destroy(current);
+	matOp_destroy(op);
+	return result >= 0;
+}
+
+// The reference reads: every material of the model is visited, checked and, if needed, sorted, without any index or view.
+
+static void matOracle_referenceQuery(const OracleModel* model, const MaterialQuery* q, int filterOnly, Vector* v)
+{
+	const Material* after = filterOnly ? NULL : matQuery_after(q);
+	for (size_t i = 0; i < vector_length(model->materials); ++i) {
+		const Material* mat = vector_get(model->materials, i);
+		if (matQuery_matches(q, mat) && (after == NULL || matQuery_compare(q, mat, after) > 0))
+			vector_add(v, (void*)mat);
+	}
+
+	if (filterOnly)
+		return;
+
+	vector_sort(v, matOracle_compareQuery, (void*)q);
+	while (matQuery_limit(q) > 0 && vector_length(v) > matQuery_limit(q))
+		vector_removeAt(v, vector_length(v) - 1);
+}
+
+static void matOracle_referenceExpired(const OracleModel* model, Vector* v)
+{
+	DateSerial today = date_serial(matOracle_today());
+	for (size_t i = 0; i < vector_length(model->materials); ++i) {
+		const Material* mat = vector_get(model->materials, i);
+		if (material_expSerial(mat) < today)
+			vector_add(v, (void*)mat);
+	}
+}
+
+static void matOracle_referenceLowStock(const OracleModel* model, Vector* v)
+{
+	for (size_t i = 0; i < vector_length(model->materials); ++i) {
+		const Material* mat = vector_get(model->materials, i);
+		if (strcmp(material_supplier(mat), ORACLE_SUPPLIERS[ORACLE_LOW_STOCK_SUPPLIER]) == 0 && material_quantity(mat) <= ORACLE_LOW_STOCK_THRESHOLD)
+			vector_add(v, (void*)mat);
+	}
+}
+
+static void matOracle_referenceCompletions(const OracleModel* model, const char* prefix, int suppliers, Vector* v)
+{
+	for (size_t j = 0; j < vector_length(model->materials); ++j) {
+		const Material* mat = vector_get(model->materials, j);
+		const char* str = suppliers ? material_supplier(mat) : material_name(mat);
+		if (strncmp(str, prefix, strlen(prefix)) != 0)
+			continue;
+
+		size_t i = 0;
+		while (i < vector_length(v) && strcmp(vector_get(v, i), str) != 0)
+			++i;
+		if (i == vector_length(v))
+			vector_add(v, (void*)str);
+	}
+
+	vector_sort(v, matOracle_compareStrings, NULL);
+}
+
+// Comparisons. They return NULL if the results match, otherwise what differs.
+
+static const char* matOracle_compareSequences(const Vector* expected, const Vector* actual)
+{
+	if (vector_length(expected) != vector_length(actual))
+		return "the number of results differs";
+
+	for (size_t i = 0; i < vector_length(expected); ++i) {
+		if (!matOracle_sameMaterial(vector_get(expected, i), vector_get(actual, i)))
+			return "the results differ";
+	}
+
+	return NULL;
+}
+
+static const char* matOracle_compareSets(Vector* expected, Vector* actual)
+{
+	vector_sort(expected, matOracle_compareIds, NULL);
+	vector_sort(actual, matOracle_compareIds, NULL);
+	return matOracle_compareSequences(expected, actual);
+}
+
+// Compares the results of a query with a limit and without order: any of the matching materials can be returned.
+static const char* matOracle_compareSubset(Vector* expected, Vector* actual, size_t limit)
+{
+	if (vector_length(actual) != (vector_length(expected) < limit ? vector_length(expected) : limit))
+		return "the number of results differs";
+
+	vector_sort(expected, matOracle_compareIds, NULL);
+	for (size_t i = 0; i < vector_length(actual); ++i) {
+		size_t found = vector_bsearch(expected, vector_get(actual, i), matOracle_compareIds, NULL);
+		if (found >= vector_length(expected) || !matOracle_sameMaterial(vector_get(expected, found), vector_get(actual, i)))
+			return "a result does not match the query";
+	}
+
+	return NULL;
+}
+
+static const char* matOracle_compareCatalogs(const OracleModel* model, MaterialService* candidate)
+{
+	if (vector_length(model->materials) != matServ_matCount(candidate))
+		return "the number of materials differs";
+
+	for (size_t i = 0; i < vector_length(model->materials); ++i) {
+		const Material* mat = vector_get(model->materials, i);
+		const Material* other = matServ_findById(candidate, material_id(mat));
+		if (other == NULL || !matOracle_sameMaterial(mat, other))
+			return "the materials differ";
+	}
+
+	return NULL;
+}
+
+static const char* matOracle_compareStats(const OracleModel* model, const MaterialAggregate* agg, const OracleOp* op)
+{
+	size_t count = 0;
+	Quantity total = 0;
+	Date earliest = { 0 };
+	for (size_t i = 0; i < vector_length(model->materials); ++i) {
+		const Material* mat = vector_get(model->materials, i);
+		const char* str = op->id % 2 == 0 ? material_supplier(mat) : material_name(mat);
+		if (strcmp(str, op->id % 2 == 0 ? ORACLE_SUPPLIERS[op->supplier] : ORACLE_NAMES[op->name]) != 0)
+			continue;
+
+		if (count++ == 0 || material_expSerial(mat) < date_serial(earliest))
+			earliest = material_expDate(mat);
+		total += material_quantity(mat);
+	}
+
+	if ((agg ? matAgg_count(agg) : 0) != count)
+		return "the count differs";
+	if (count == 0)
+		return NULL;
+
+	if (matAgg_totalQuantity(agg) != total)
+		return "the total quantity differs";
+	if (!matOracle_sameDate(matAgg_earliestExpiry(agg), earliest))
+		return "the earliest expiration date differs";
+	return NULL;
+}
+
+// The type, name and id of the write on the given index of a batch operation.
+static OperationType matOracle_batchWrite(const OracleOp* op, size_t index, const char** name, int* id)
+{
+	static const OperationType types[3] = { ADD, UPDATE, REMOVE };
+	*name = ORACLE_NAMES[(op->name + index) % ORACLE_NAME_COUNT];
+	*id = op->id == -1 ? -1 : op->id + (int)index;
+	return types[(op->supplier + index) % 3];
+}
+
+// Returns 1 if the operation writes by a name, supplier and expiration date that several materials of the model share.
+static int matOracle_ambiguous(const OracleModel* model, const OracleOp* op)
+{
+	const char* supplier = ORACLE_SUPPLIERS[op->supplier];
+	Date date = matOracle_date(op->day);
+	size_t count = 0;
+	if (op->type == ORACLE_ADD_OR_UPDATE_BY_NSE || op->type == ORACLE_UPDATE_BY_NSE || op->type == ORACLE_REMOVE_BY_NSE)
+		matOracle_modelFindNSE(model, ORACLE_NAMES[op->name], supplier, date, &count);
+
+	for (size_t k = 0; op->type == ORACLE_BATCH && k < op->batchLength && count < 2; ++k) {
+		const char* name;
+		int id;
+		matOracle_batchWrite(op, k, &name, &id);
+		matOracle_modelFindNSE(model, name, supplier, date, &count);
+	}
+
+	return count > 1;
+}
+
+// Commits the writes of a batch operation on the model and the candidate and compares every result.
+static const char* matOracle_batch(OracleModel* model, MaterialService* c, const OracleOp* op)
+{
+	const char* supplier = ORACLE_SUPPLIERS[op->supplier];
+	Date date = matOracle_date(op->day);
+	MaterialBatch* batch = matBatch_create();
+	if (batch == NULL)
+		return "the batch could not be created";
+
+	int results[ORACLE_MAX_BATCH];
+	size_t succeeded = 0;
+	const char* error = NULL;
+	for (size_t k = 0; k < op->batchLength && error == NULL; ++k) {
+		const char* name;
+		int id;
+		OperationType type = matOracle_batchWrite(op, k, &name, &id);
+		if (type == ADD)
+			results[k] = matOracle_modelAddOrUpdateByNSE(model, id, name, supplier, op->quantity, date);
+		else if (type == UPDATE)
+			results[k] = matOracle_modelUpdateByNSE(model, name, supplier, op->quantity, date);
+		else
+			results[k] = matOracle_modelRemoveByNSE(model, name, supplier, date);
+		succeeded += results[k] >= 0;
+
+		Material* mat = material_construct(id, name, supplier, op->quantity, date);
+		if (mat == NULL || matBatch_enqueue(batch, type, mat) != (int)k)
+			error = "the batch could not be created";
+		material_destroy(mat);
+	}
+
+	if (error == NULL && matServ_commitBatch(c, batch) != succeeded)
+		error = "the number of writes that succeeded differs";
+	for (size_t k = 0; k < op->batchLength && error == NULL; ++k) {
+		if (matBatch_result(batch, k) != results[k])
+			error = "the return value of a write differs";
+	}
+
+	matBatch_destroy(batch);
+	return error;
+}
+
+// Runs the operation on the model and the candidate and compares the results. The vectors are for the results and must be empty.
+static const char* matOracle_step(OracleModel* model, const OracleSide* cand, const OracleOp* op, Vector* expected, Vector* actual)
+{
+	MaterialService* c = cand->service;
+	const char* name = ORACLE_NAMES[op->name];
+	const char* supplier = ORACLE_SUPPLIERS[op->supplier];
+	Date date = matOracle_date(op->day);
+	const char* error = NULL;
+	int written = 0, expectedResult = 0, actualResult = 0;
+
+	if (matOracle_ambiguous(model, op))
+		return NULL;
+
+	switch (op->type) {
+	case ORACLE_ADD:
+		expectedResult = matOracle_modelAdd(model, op->id, name, supplier, op->quantity, date, 1);
+		actualResult = matServ_add(c, op->id, name, supplier, op->quantity, date, 1);
+		written = 1;
+		break;
+	case ORACLE_UPDATE:
+		expectedResult = matOracle_modelUpdateById(model, op->id, name, supplier, op->quantity, date, 1);
+		actualResult = matServ_updateById(c, op->id, name, supplier, op->quantity, date, NULL, 1);
+		written = 1;
+		break;
+	case ORACLE_REMOVE:
+		expectedResult = matOracle_modelRemoveById(model, op->id, 1);
+		actualResult = matServ_removeById(c, op->id, NULL, 1);
+		written = 1;
+		break;
+	case ORACLE_ADD_OR_UPDATE_BY_NSE:
+		expectedResult = matOracle_modelAddOrUpdateByNSE(model, op->id, name, supplier, op->quantity, date);
+		actualResult = matServ_addOrUpdateByNSE(c, op->id, name, supplier, op->quantity, date, NULL);
+		written = 1;
+		break;
+	case ORACLE_UPDATE_BY_NSE:
+		expectedResult = matOracle_modelUpdateByNSE(model, name, supplier, op->quantity, date);
+		actualResult = matServ_updateByNSE(c, name, supplier, op->quantity, date, NULL);
+		written = 1;
+		break;
+	case ORACLE_REMOVE_BY_NSE:
+		expectedResult = matOracle_modelRemoveByNSE(model, name, supplier, date);
+		actualResult = matServ_removeByNSE(c, name, supplier, date, NULL);
+		written = 1;
+		break;
+	case ORACLE_BATCH:
+		error = matOracle_batch(model, c, op);
+		written = 1;
+		break;
+	case ORACLE_UNDO:
+		expectedResult = matOracle_modelRevert(model, model->undoStack, model->redoStack);
+		actualResult = matServ_undo(c);
+		written = 1;
+		break;
+	case ORACLE_REDO:
+		expectedResult = matOracle_modelRevert(model, model->redoStack, model->undoStack);
+		actualResult = matServ_redo(c);
+		written = 1;
+		break;
+	case ORACLE_QUERY:
+	case ORACLE_CURSOR_QUERY: {
+		MaterialQuery* q = matOracle_query(op);
+		if (q == NULL)
+			return "the query could not be created";
+
+		if (op->type == ORACLE_CURSOR_QUERY) {
+			matOracle_referenceQuery(model, q, 1, expected);
+			MaterialCursor cur = matServ_cursorQuery(c, q);
+			for (const Material* mat; (mat = matCursor_next(&cur)) != NULL;)
+				vector_add(actual, (void*)mat);
+			error = matOracle_compareSets(expected, actual);
+		}
+		else {
+			matOracle_referenceQuery(model, q, 0, expected);
+			matServ_query(c, q, actual);
+
+			// Without a sort key, the order is defined only when a page is selected after a material (then it is by id).
+			if (op->sortKey != SORT_NONE || (op->hasAfter && op->limit > 0))
+				error = matOracle_compareSequences(expected, actual);
+			else if (op->limit == 0)
+				error = matOracle_compareSets(expected, actual);
+			else {
+				vector_clear(expected);
+				matOracle_referenceQuery(model, q, 1, expected);
+				error = matOracle_compareSubset(expected, actual, op->limit);
+			}
+		}
+		matQuery_destroy(q);
+		break;
+	}
+	case ORACLE_EXPIRED:
+		matOracle_referenceExpired(model, expected);
+		matServ_getExpired(c, actual);
+		error = matOracle_compareSets(expected, actual);
+		break;
+	case ORACLE_LOW_STOCK:
+		matOracle_referenceLowStock(model, expected);
+		matServ_getLowStock(c, actual);
+		error = matOracle_compareSets(expected, actual);
+		break;
+	case ORACLE_STATS:
+		error = matOracle_compareStats(model, op->id % 2 == 0 ? matServ_statsBySupplier(c, supplier) : matServ_statsByName(c, name), op);
+		break;
+	case ORACLE_COMPLETE: {
+		char prefix[8] = "";
+		strncat(prefix, op->id % 2 == 0 ? supplier : name, (size_t)(op->id % 3));
+		matOracle_referenceCompletions(model, prefix, op->id % 2 == 0, expected);
+		if (op->id % 2 == 0)
+			matServ_completeSupplier(c, prefix, actual, 0);
+		else
+			matServ_completeName(c, prefix, actual, 0);
+
+		error = vector_length(expected) != vector_length(actual) ? "the number of completions differs" : NULL;
+		for (size_t i = 0; error == NULL && i < vector_length(expected); ++i) {
+			if (strcmp(vector_get(expected, i), vector_get(actual, i)) != 0)
+				error = "the completions differ";
+		}
+		break;
+	}
+	default:
+		return "the operation is invalid";
+	}
+
+	if (written && expectedResult != actualResult)
+		return "the return value differs";
+	if (written && error == NULL)
+		error = matOracle_compareCatalogs(model, c);
+	return error;
+}
+
+// Properties.
+const char* matOracle_name(int index)
+{
+	return index >= 0 && index < ORACLE_NAME_COUNT ? ORACLE_NAMES[index] : NULL;
+}
+
+const char* matOracle_supplier(int index)
+{
+	return index >= 0 && index < ORACLE_SUPPLIER_COUNT ? ORACLE_SUPPLIERS[index] : NULL;
+}
+
+// Methods.
+int matOracle_generate(unsigned long long seed, OracleOp* ops, size_t count)
+{
+	GeneratorConfig config = matGen_defaultConfig();
+	config.seed = seed;
+	MaterialGenerator* gen = matGen_create(&config);
+	if (gen == NULL)
+		return 0;
+
+	for (size_t i = 0; i < count; ++i) {
+		OracleOp* op = &ops[i];
+		memset(op, 0, sizeof(OracleOp));
+
+		int pick = (int)matGen_randomBelow(gen, 100);
+		op->type = 0;
+		while (pick >= ORACLE_OP_WEIGHTS[op->type])
+			pick -= ORACLE_OP_WEIGHTS[op->type++];
+
+		// A quarter of the writes that can add look for a free id; a quantity of 0 fails the validation.
+		int adds = op->type == ORACLE_ADD || op->type == ORACLE_ADD_OR_UPDATE_BY_NSE || op->type == ORACLE_BATCH;
+		op->id = adds && matGen_randomBelow(gen, 4) == 0 ? -1 : (int)matGen_randomBelow(gen, ORACLE_MAX_ID);
+		op->name = (int)matGen_randomBelow(gen, ORACLE_NAME_COUNT);
+		op->supplier = (int)matGen_randomBelow(gen, ORACLE_SUPPLIER_COUNT);
+		op->quantity = (Quantity)matGen_randomBelow(gen, 41) * QUANTITY_SCALE / 2;
+		op->day = matGen_randomBelow(gen, 2) == 0 ? (int)matGen_randomBelow(gen, ORACLE_COMMON_DAYS) * ORACLE_COMMON_DAY_STEP
+			: (int)matGen_randomBelow(gen, ORACLE_DAYS);
+		if (op->type == ORACLE_BATCH)
+			op->batchLength = 1 + matGen_randomBelow(gen, ORACLE_MAX_BATCH);
+
+		if (op->type == ORACLE_QUERY || op->type == ORACLE_CURSOR_QUERY) {
+			op->predicateCount = matGen_randomBelow(gen, ORACLE_MAX_PREDICATES + 1);
+			for (size_t j = 0; j < op->predicateCount; ++j)
+				op->predicates[j] = (QueryPredicateType)matGen_randomBelow(gen, EXPIRES_FROM + 1);
+		}
+
+		if (op->type == ORACLE_QUERY) {
+			op->sortKey = (QuerySortKey)matGen_randomBelow(gen, SORT_EXP_DATE + 1);
+			op->descending = (int)matGen_randomBelow(gen, 2);
+			op->limit = matGen_randomBelow(gen, 3) == 0 ? 0 : 1 + matGen_randomBelow(gen, 10);
+			op->hasAfter = matGen_randomBelow(gen, 4) == 0;
+		}
+	}
+
+	matGen_destroy(gen);
+	return 1;
+}
+
+size_t matOracle_run(const OracleBackend* candidate, const OracleOp* ops, size_t count, FILE* out)
+{
+	OracleModel model = { 0 };
+	OracleSide cand = { 0 };
+	Vector* expected = vector_create(16);
+	Vector* actual = vector_create(16);
+	size_t i = 0;
+
+	if (!matOracle_modelOpen(&model) || !matOracle_open(&cand, candidate->shardCount, candidate->allocator) || expected == NULL || actual == NULL) {
+		if (out)
+			fprintf(out, "The services could not be created.\n");
+	}
+	else {
+		if (candidate->setup)
+			candidate->setup(candidate->context, cand.service);
+
+		for (; i < count; ++i) {
+			const char* error = matOracle_step(&model, &cand, &ops[i], expected, actual);
+			vector_clear(expected);
+			vector_clear(actual);
+			if (error == NULL)
+				continue;
+
+			if (out) {
+				fprintf(out, "Operation %zu (", i);
+				matOracle_describe(&ops[i], out);
+				fprintf(out, "): %s.\n", error);
+			}
+			break;
+		}
+	}
+
+	vector_destroy(expected);
+	vector_destroy(actual);
+	matOracle_modelClose(&model);
+	matOracle_close(&cand);
+	return i;
+}
+
+size_t matOracle_shrink(const OracleBackend* candidate, OracleOp* ops, size_t count)
+{
+	size_t failed = matOracle_run(candidate, ops, count, NULL);
+	if (failed == count)
+		return count;
+
+	count = failed + 1;
+	OracleOp* trial = malloc(count * sizeof(OracleOp));
+	if (trial == NULL)
+		return count;
+
+	// Remove a chunk and keep the rest if it still fails (then cut after the new failing operation), otherwise try the next chunk.
+	for (size_t chunk = count / 2; chunk > 0; chunk /= 2) {
+		for (size_t start = 0; start + chunk <= count;) {
+			memcpy(trial, ops, start * sizeof(OracleOp));
+			memcpy(trial + start, ops + start + chunk, (count - start - chunk) * sizeof(OracleOp));
+
+			failed = matOracle_run(candidate, trial, count - chunk, NULL);
+			if (failed < count - chunk) {
+				count = failed + 1;
+				memcpy(ops, trial, count * sizeof(OracleOp));
+			}
+			else
+				start += chunk;
+		}
+	}
+
+	free(trial);
+	return count;
+}
+
+void matOracle_describe(const OracleOp* op, FILE* out)
+{
+	const char* name = matOracle_name(op->name);
+	const char* supplier = matOracle_supplier(op->supplier);
+	if (op->type < 0 || op->type >= ORACLE_OP_COUNT || name == NULL || supplier == NULL) {
+		fprintf(out, "invalid");
+		return;
+	}
+
+	Date date = matOracle_date(op->day);
+	fprintf(out, "%s", ORACLE_OP_NAMES[op->type]);
+
+	switch (op->type) {
+	case ORACLE_ADD:
+	case ORACLE_UPDATE:
+		fprintf(out, " %d \"%s\" \"%s\" %.3f %02d/%02d/%04d", op->id, name, supplier, quantity_toUnits(op->quantity), date.day, date.month, date.year);
+		break;
+	case ORACLE_REMOVE:
+		fprintf(out, " %d", op->id);
+		break;
+	case ORACLE_ADD_OR_UPDATE_BY_NSE:
+		fprintf(out, " %d \"%s\" \"%s\" %.3f %02d/%02d/%04d", op->id, name, supplier, quantity_toUnits(op->quantity), date.day, date.month, date.year);
+		break;
+	case ORACLE_UPDATE_BY_NSE:
+		fprintf(out, " \"%s\" \"%s\" %.3f %02d/%02d/%04d", name, supplier, quantity_toUnits(op->quantity), date.day, date.month, date.year);
+		break;
+	case ORACLE_REMOVE_BY_NSE:
+		fprintf(out, " \"%s\" \"%s\" %02d/%02d/%04d", name, supplier, date.day, date.month, date.year);
+		break;
+	case ORACLE_BATCH:
+		for (size_t k = 0; k < op->batchLength; ++k) {
+			const char* writeName;
+			int id;
+			OperationType type = matOracle_batchWrite(op, k, &writeName, &id);
+			fprintf(out, "%s %s %d \"%s\"", k == 0 ? "" : ",", type == ADD ? "add_or_update" : type == UPDATE ? "update" : "remove", id, writeName);
+		}
+		fprintf(out, " \"%s\" %.3f %02d/%02d/%04d", supplier, quantity_toUnits(op->quantity), date.day, date.month, date.year);
+		break;
+	case ORACLE_QUERY:
+	case ORACLE_CURSOR_QUERY:
+		for (size_t i = 0; i < op->predicateCount; ++i) {
+			QueryPredicate pred;
+			char text[8];
+			matOracle_predicate(op, i, &pred, text);
+			fprintf(out, "%s %s ", i == 0 ? " where" : " and", ORACLE_PREDICATE_NAMES[pred.type]);
+			if (pred.type <= SUPPLIER_STARTS_WITH)
+				fprintf(out, "\"%s\"", pred.text);
+			else if (pred.type <= QUANTITY_GREATER)
+				fprintf(out, "%.3f", quantity_toUnits(pred.quantity));
+			else
+				fprintf(out, "%02d/%02d/%04d", pred.date.day, pred.date.month, pred.date.year);
+		}
+		if (op->type == ORACLE_CURSOR_QUERY)
+			break;
+
+		fprintf(out, " order by %s%s", ORACLE_SORT_NAMES[op->sortKey], op->descending ? " descending" : "");
+		if (op->limit > 0)
+			fprintf(out, " limit %zu", op->limit);
+		if (op->hasAfter)
+			fprintf(out, " after %d \"%s\" \"%s\" %.3f %02d/%02d/%04d", op->id, name, supplier, quantity_toUnits(op->quantity), date.day, date.month, date.year);
+		break;
+	case ORACLE_STATS:
+		fprintf(out, op->id % 2 == 0 ? " supplier \"%s\"" : " name \"%s\"", op->id % 2 == 0 ? supplier : name);
+		break;
+	case ORACLE_COMPLETE:
+		fprintf(out, op->id % 2 == 0 ? " supplier \"%.*s\"" : " name \"%.*s\"", op->id % 3, op->id % 2 == 0 ? supplier : name);
+		break;
+	default:
+		break;
+	}
+}
+
+int matOracle_check(const OracleBackend* candidate, unsigned long long seed, size_t count, FILE* out)
+{
+	OracleOp* ops = malloc(count * sizeof(OracleOp));
+	if (ops == NULL || !matOracle_generate(seed, ops, count)) {
+		free(ops);
+		return 0;
+	}
+
+	int passed = matOracle_run(candidate, ops, count, out) == count;
+	if (!passed && out) {
+		size_t length = matOracle_shrink(candidate, ops, count);
+		fprintf(out, "Shrunk to %zu operations:\n", length);
+		for (size_t i = 0; i < length; ++i) {
+			fprintf(out, "%zu: ", i);
+			matOracle_describe(&ops[i], out);
+			fprintf(out, "\n");
+		}
+	}
+
+	free(ops);
+	return passed;
+}
@@ -0,0 +1,100 @@
+#ifndef MATERIAL_ORACLE
+#define MATERIAL_ORACLE
+
+#include "MaterialService.h"
+
+// The most conditions a random query has.
+#define ORACLE_MAX_PREDICATES 3
+
+// The most writes a random batch has.
+#define ORACLE_MAX_BATCH 4
+
+// The supplier whose low stock threshold is set in the candidate and used by the model, and the threshold.
+#define ORACLE_LOW_STOCK_SUPPLIER 0
+#define ORACLE_LOW_STOCK_THRESHOLD QUANTITY(5)
+
+// The kinds of random operations.
+typedef enum {
+	ORACLE_ADD,
+	ORACLE_UPDATE,
+	ORACLE_REMOVE,
+	ORACLE_ADD_OR_UPDATE_BY_NSE,
+	ORACLE_UPDATE_BY_NSE,
+	ORACLE_REMOVE_BY_NSE,
+	ORACLE_BATCH,
+	ORACLE_UNDO,
+	ORACLE_REDO,
+	ORACLE_QUERY,
+	ORACLE_CURSOR_QUERY,
+	ORACLE_EXPIRED,
+	ORACLE_LOW_STOCK,
+	ORACLE_STATS,
+	ORACLE_COMPLETE,
+	ORACLE_OP_COUNT
+} OracleOpType;
+
+// One random operation. The names and suppliers are indexes in small lists, so the operations often hit the same materials.
+// The name, supplier, quantity and day are the arguments of the writes, the values the conditions of a query compare with,
+// and, with the id, the material a query starts after (if 'hasAfter' is set). The day is counted from the first day of 2020.
+// ORACLE_STATS uses the supplier if the id is even and the name otherwise; ORACLE_COMPLETE completes the first letter of the name.
+// ORACLE_BATCH commits 'batchLength' writes by name, supplier and expiration date: write 'k' adds or updates, updates or removes
+// (for 'supplier + k' modulo 3 equal to 0, 1 and 2), with the name after 'k' more names, the id 'id + k' (or -1 if the id is -1),
+// and the supplier, quantity and day of the operation.
+typedef struct {
+	OracleOpType type;
+	int id;
+	int name;
+	int supplier;
+	Quantity quantity;
+	int day;
+	QueryPredicateType predicates[ORACLE_MAX_PREDICATES];
+	size_t predicateCount;
+	QuerySortKey sortKey;
+	int descending;
+	size_t limit;
+	int hasAfter;
+	size_t batchLength;
+} OracleOp;
+
+// The configuration of the service checked against the reference. The reference is a model that shares no code with the service:
+// the materials in a plain vector, with the writes, undo and redo written from the documented behavior of the service, and the reads
+// computed by walking every material and filtering and sorting them.
+// The candidate is a service over a repository with 'shardCount' shards, taken from 'allocator', that answers with its
+// query plans, indexes, views and running totals. 'setup' (can be NULL) is called with 'context' on every new candidate.
+typedef struct {
+	size_t shardCount;
+	const Allocator* allocator;
+	void(*setup)(void* context, MaterialService* serv);
+	void* context;
+} OracleBackend;
+
+// Get the name with the given index, as used by the operations, or NULL if the index is invalid.
+const char* matOracle_name(int index);
+
+// Get the supplier with the given index, as used by the operations, or NULL if the index is invalid.
+const char* matOracle_supplier(int index);
+
+// Generate 'count' random operations from the seed. The same seed always gives the same operations.
+// Returns 0 if the memory could not be allocated, otherwise 1.
+int matOracle_generate(unsigned long long seed, OracleOp* ops, size_t count);
+
+// Run the operations in order on a new reference model and a new candidate service, and compare every result:
+// the return value of the writes (of every write of a batch, and the number that succeeded), undo and redo, the whole catalog after
+// every write, and the results of every read (in order when the read defines the order). A write by name, supplier and expiration date
+// that several materials share (possible after an update by id) is skipped, since which of them the service picks is not defined. Returns the index of the first operation whose results differ, or 'count'
+// if all of them match (or 0 if the services could not be created). If 'out' is not NULL, the difference is described there.
+size_t matOracle_run(const OracleBackend* candidate, const OracleOp* ops, size_t count, FILE* out);
+
+// Shrink a sequence of operations that fails 'matOracle_run': the sequence is cut after the failing operation, then
+// operations are removed, in chunks of decreasing size, as long as the rest still fails. Returns the new length.
+// If the sequence does not fail, returns 'count' and the sequence is not changed.
+size_t matOracle_shrink(const OracleBackend* candidate, OracleOp* ops, size_t count);
+
+// Write the operation on a single line.
+void matOracle_describe(const OracleOp* op, FILE* out);
+
+// Generate 'count' operations from the seed and run them. If they fail and 'out' is not NULL, the shrunk sequence is written there.
+// Returns 1 if all the results match, 0 otherwise (or if the memory could not be allocated).
+int matOracle_check(const OracleBackend* candidate, unsigned long long seed, size_t count, FILE* out);
+
+#endif
@@ -0,0 +1,180 @@
+#include "MaterialPipeline.h"
+#include <stdlib.h>
+
+// The queue is an intrusive list with many producers and one consumer: writers swap themselves in as the head and then
+// link the previous head to them, the applier takes the writes from the tail. A stub write keeps the list from getting empty,
+// so a push never has to touch the tail.
+
+static void matPipe_push(MaterialPipeline* p, PipelineWrite* w)
+{
+	sync_storePointer((void* volatile*)&w->next, NULL);
+	PipelineWrite* previous = sync_exchangePointer((void* volatile*)&p->head, w);
+	sync_storePointer((void* volatile*)&previous->next, w);
+}
+
+// Returns the oldest write of the queue, or NULL if there is none, or the next one is still being linked by its writer.
+static PipelineWrite* matPipe_pop(MaterialPipeline* p)
+{
+	PipelineWrite* tail = p->tail;
+	PipelineWrite* next = sync_loadPointer((void* volatile*)&tail->next);
+	if (tail == &p->stub) {
+		if (next == NULL)
+			return NULL;
+		p->tail = tail = next;
+		next = sync_loadPointer((void* volatile*)&tail->next);
+	}
+
+	if (next) {
+		p->tail = next;
+		return tail;
+	}
+
+	// The tail is the last write: put the stub behind it, so it can be taken without leaving the list empty.
+	if (tail != sync_loadPointer((void* volatile*)&p->head))
+		return NULL;
+	matPipe_push(p, &p->stub);
+	next = sync_loadPointer((void* volatile*)&tail->next);
+	if (next == NULL)
+		return NULL;
+	p->tail = next;
+	return tail;
+}
+
+// Returns 1 if no write is queued, not even one still being linked, otherwise 0.
+static int matPipe_isEmpty(MaterialPipeline* p)
+{
+	return p->tail == &p->stub && sync_loadPointer((void* volatile*)&p->head) == &p->stub;
+}
+
+// Applies the writes and acknowledges them together.
+static void matPipe_apply(MaterialPipeline* p, PipelineWrite** queued, MaterialWrite* writes, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		writes[i] = queued[i]->write;
+	matServ_applyWrites(p->service, writes, count);
+
+	// A writer returns as soon as it sees its write done, so the write is not touched after that.
+	mutex_lock(&p->lock);
+	++p->batches;
+	p->writes += count;
+	for (size_t i = 0; i < count; ++i) {
+		queued[i]->write.result = writes[i].result;
+		queued[i]->done = 1;
+	}
+	cond_broadcast(&p->acknowledged);
+	mutex_unlock(&p->lock);
+}
+
+// The applier thread: takes batches of writes until the pipeline stops and the queue is empty.
+static void matPipe_run(void* argument)
+{
+	MaterialPipeline* p = argument;
+	PipelineWrite* queued[MAT_PIPE_MAX_BATCH];
+	MaterialWrite writes[MAT_PIPE_MAX_BATCH];
+
+	for (;;) {
+		size_t count = 0;
+		PipelineWrite* w;
+		while (count < MAT_PIPE_MAX_BATCH && (w = matPipe_pop(p)) != NULL)
+			queued[count++] = w;
+
+		if (count > 0) {
+			matPipe_apply(p, queued, writes, count);
+			continue;
+		}
+
+		// A writer is between swapping the head and linking it: it is about to finish.
+		if (!matPipe_isEmpty(p)) {
+			thread_yield();
+			continue;
+		}
+
+		if (sync_loadLong(&p->stopping))
+			return;
+
+		// Announce the sleep before looking at the queue again, so a writer either sees it and wakes the applier up,
+		// or pushed before the look.
+		mutex_lock(&p->lock);
+		sync_storeLong(&p->sleeping, 1);
+		while (matPipe_isEmpty(p) && !sync_loadLong(&p->stopping))
+			cond_wait(&p->queued, &p->lock);
+		sync_storeLong(&p->sleeping, 0);
+		mutex_unlock(&p->lock);
+	}
+}
+
+// Wakes the applier up if it sleeps.
+static void matPipe_wake(MaterialPipeline* p)
+{
+	if (sync_loadLong(&p->sleeping)) {
+		mutex_lock(&p->lock);
+		cond_signal(&p->queued);
+		mutex_unlock(&p->lock);
+	}
+}
+
+// Constructor / Destructor.
+MaterialPipeline* matPipe_create(MaterialService* serv)
+{
+	MaterialPipeline* p = calloc(1, sizeof(MaterialPipeline));
+	if (p == NULL)
+		return NULL;
+
+	p->service = serv;
+	p->head = p->tail = &p->stub;
+	mutex_init(&p->lock);
+	cond_init(&p->queued);
+	cond_init(&p->acknowledged);
+
+	if (!thread_start(&p->applier, matPipe_run, p)) {
+		cond_free(&p->acknowledged);
+		cond_free(&p->queued);
+		mutex_free(&p->lock);
+		free(p);
+		return NULL;
+	}
+
+	return p;
+}
+
+void matPipe_destroy(MaterialPipeline* p)
+{
+	if (p == NULL)
+		return;
+
+	mutex_lock(&p->lock);
+	sync_storeLong(&p->stopping, 1);
+	cond_signal(&p->queued);
+	mutex_unlock(&p->lock);
+	thread_join(&p->applier);
+
+	cond_free(&p->acknowledged);
+	cond_free(&p->queued);
+	mutex_free(&p->lock);
+	free(p);
+}
+
+// Properties.
+size_t matPipe_batchCount(const MaterialPipeline* p)
+{
+	return p->batches;
+}
+
+size_t matPipe_writeCount(const MaterialPipeline* p)
+{
+	return p->writes;
+}
+
+// Methods.
+int matPipe_submit(MaterialPipeline* p, OperationType type, const Material* mat)
+{
+	PipelineWrite w = { { type, mat, -1 }, NULL, 0 };
+	matPipe_push(p, &w);
+	matPipe_wake(p);
+
+	mutex_lock(&p->lock);
+	while (!w.done)
+		cond_wait(&p->acknowledged, &p->lock);
+	mutex_unlock(&p->lock);
+	return w.write.result;
+}
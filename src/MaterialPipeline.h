@@ -0,0 +1,65 @@
+#ifndef MATERIAL_PIPELINE
+#define MATERIAL_PIPELINE
+
+#include "MaterialService.h"
+#include "Thread.h"
+
+// The most writes the applier takes from the queue and applies together.
+#define MAT_PIPE_MAX_BATCH 256
+
+// A write waiting in the queue of a pipeline. It lives on the stack of the writer, which waits until it is acknowledged.
+typedef struct PipelineWrite {
+	MaterialWrite write;
+	struct PipelineWrite* volatile next;
+	int done;
+} PipelineWrite;
+
+// The internal data for a pipeline of the writes of many threads to a material service.
+// Writers push their writes to a lock-free queue with many producers and one consumer (a swap of the head pointer,
+// no lock), and wait. A single applier thread takes the queued writes in batches of up to MAT_PIPE_MAX_BATCH, applies each
+// batch to the service (see 'matServ_applyWrites'), which records an undo operation for every write, and then acknowledges
+// the whole batch at once: one lock and one wake up of the waiting writers, however many writes the batch has.
+// The more writers there are, the larger the batches get, so the writes pay for the service less often.
+// While the pipeline runs, the service must not be used by any other thread, not even to read, since the applier changes it.
+// Do not use struct members directly. Use only methods that start with 'matPipe_'.
+// The pipeline must be initialized with 'matPipe_create' and destroyed with 'matPipe_destroy'.
+// If not specified otherwise, pipeline pointer cannot be NULL in pipeline methods.
+typedef struct {
+	MaterialService* service;
+	PipelineWrite* volatile head;
+	PipelineWrite* tail;
+	PipelineWrite stub;
+	volatile long sleeping;
+	volatile long stopping;
+	Mutex lock;
+	Condition queued;
+	Condition acknowledged;
+	Thread applier;
+	size_t batches;
+	size_t writes;
+} MaterialPipeline;
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize a pipeline of the writes to the service and start its applier thread.
+// Returns NULL if the memory could not be allocated or the thread could not be started.
+MaterialPipeline* matPipe_create(MaterialService* serv);
+
+// Apply the writes still queued, stop the applier thread and free the pipeline. No write can be submitted any more.
+// If pipeline is NULL nothing happens.
+void matPipe_destroy(MaterialPipeline* p);
+
+// PROPERTIES.
+
+// Get the number of batches and writes applied. Read them only once the writes counted are acknowledged.
+size_t matPipe_batchCount(const MaterialPipeline* p);
+size_t matPipe_writeCount(const MaterialPipeline* p);
+
+// METHODS.
+
+// Queue the write and wait until the applier applied it, then returns its result. Can be called from any number of threads.
+// ADD adds or updates by NSE, UPDATE updates by NSE and REMOVE removes by NSE, and the result is the one of the matching
+// 'matServ_*ByNSE' method. The material is not copied: it must stay unchanged until the call returns.
+int matPipe_submit(MaterialPipeline* p, OperationType type, const Material* mat);
+
+#endif
@@ -0,0 +1,240 @@
+#include "MaterialQuery.h"
+#include <string.h>
+
+// Adds a condition and returns it, or NULL if it could not be added (then the query fails).
+static QueryPredicate* matQuery_addPredicate(MaterialQuery* q, QueryPredicateType type, const char* text)
+{
+	if (q->predicateCount == q->predicateCapacity) {
+		size_t newCapacity = (q->predicateCount + 1) * 2;
+		QueryPredicate* newPredicates = realloc(q->predicates, newCapacity * sizeof(QueryPredicate));
+		if (newPredicates == NULL) {
+			q->failed = 1;
+			return NULL;
+		}
+		q->predicates = newPredicates;
+		q->predicateCapacity = newCapacity;
+	}
+
+	QueryPredicate* pred = &q->predicates[q->predicateCount];
+	memset(pred, 0, sizeof(QueryPredicate));
+	pred->type = type;
+
+	if (text) {
+		if ((pred->text = calloc(strlen(text) + 1, sizeof(char))) == NULL) {
+			q->failed = 1;
+			return NULL;
+		}
+		strcpy(pred->text, text);
+	}
+
+	++q->predicateCount;
+	return pred;
+}
+
+// Constructor / Destructor.
+MaterialQuery* matQuery_create()
+{
+	return calloc(1, sizeof(MaterialQuery));
+}
+
+void matQuery_destroy(MaterialQuery* q)
+{
+	if (q == NULL)
+		return;
+
+	for (size_t i = 0; i < q->predicateCount; ++i)
+		free(q->predicates[i].text);
+
+	free(q->predicates);
+	material_destroy(q->after);
+	free(q);
+}
+
+// Properties.
+size_t matQuery_predicateCount(const MaterialQuery* q)
+{
+	return q->predicateCount;
+}
+
+const QueryPredicate* matQuery_predicate(const MaterialQuery* q, size_t index)
+{
+	if (index >= q->predicateCount)
+		return NULL;
+
+	return &q->predicates[index];
+}
+
+QuerySortKey matQuery_sortKey(const MaterialQuery* q)
+{
+	return q->sortKey;
+}
+
+int matQuery_descending(const MaterialQuery* q)
+{
+	return q->descending;
+}
+
+size_t matQuery_limit(const MaterialQuery* q)
+{
+	return q->limit;
+}
+
+const Material* matQuery_after(const MaterialQuery* q)
+{
+	return q->after;
+}
+
+int matQuery_failed(const MaterialQuery* q)
+{
+	return q->failed;
+}
+
+// Conditions.
+MaterialQuery* matQuery_whereNameContains(MaterialQuery* q, const char* str)
+{
+	// An empty string matches everything, so no condition is needed.
+	if (str != NULL && str[0] != '\0')
+		matQuery_addPredicate(q, NAME_CONTAINS, str);
+	return q;
+}
+
+MaterialQuery* matQuery_whereSupplierIs(MaterialQuery* q, const char* supplier)
+{
+	matQuery_addPredicate(q, SUPPLIER_IS, supplier ? supplier : "");
+	return q;
+}
+
+MaterialQuery* matQuery_whereNameStartsWith(MaterialQuery* q, const char* prefix)
+{
+	if (prefix != NULL && prefix[0] != '\0')
+		matQuery_addPredicate(q, NAME_STARTS_WITH, prefix);
+	return q;
+}
+
+MaterialQuery* matQuery_whereSupplierStartsWith(MaterialQuery* q, const char* prefix)
+{
+	if (prefix != NULL && prefix[0] != '\0')
+		matQuery_addPredicate(q, SUPPLIER_STARTS_WITH, prefix);
+	return q;
+}
+
+MaterialQuery* matQuery_whereQuantityAtMost(MaterialQuery* q, Quantity quantity)
+{
+	QueryPredicate* pred = matQuery_addPredicate(q, QUANTITY_AT_MOST, NULL);
+	if (pred)
+		pred->quantity = quantity;
+	return q;
+}
+
+MaterialQuery* matQuery_whereQuantityGreater(MaterialQuery* q, Quantity quantity)
+{
+	QueryPredicate* pred = matQuery_addPredicate(q, QUANTITY_GREATER, NULL);
+	if (pred)
+		pred->quantity = quantity;
+	return q;
+}
+
+MaterialQuery* matQuery_whereExpiresBefore(MaterialQuery* q, Date date)
+{
+	QueryPredicate* pred = matQuery_addPredicate(q, EXPIRES_BEFORE, NULL);
+	if (pred) {
+		pred->date = date;
+		pred->serial = date_serialCeil(date);
+	}
+	return q;
+}
+
+MaterialQuery* matQuery_whereExpiresFrom(MaterialQuery* q, Date date)
+{
+	QueryPredicate* pred = matQuery_addPredicate(q, EXPIRES_FROM, NULL);
+	if (pred) {
+		pred->date = date;
+		pred->serial = date_serialCeil(date);
+	}
+	return q;
+}
+
+// Order / Limit.
+MaterialQuery* matQuery_orderBy(MaterialQuery* q, QuerySortKey key, int descending)
+{
+	q->sortKey = key;
+	q->descending = descending != 0;
+	return q;
+}
+
+MaterialQuery* matQuery_setLimit(MaterialQuery* q, size_t limit)
+{
+	q->limit = limit;
+	return q;
+}
+
+MaterialQuery* matQuery_setAfter(MaterialQuery* q, const Material* mat)
+{
+	material_destroy(q->after);
+	q->after = mat ? material_duplicate(mat) : NULL;
+	if (mat && q->after == NULL)
+		q->failed = 1;
+	return q;
+}
+
+// Methods.
+int matQuery_matches(const MaterialQuery* q, const Material* mat)
+{
+	if (q->failed)
+		return 0;
+
+	for (size_t i = 0; i < q->predicateCount; ++i) {
+		if (!matQuery_predicateMatches(&q->predicates[i], mat))
+			return 0;
+	}
+
+	return 1;
+}
+
+int matQuery_predicateMatches(const QueryPredicate* pred, const Material* mat)
+{
+	switch (pred->type) {
+	case NAME_CONTAINS:
+		return strstr(material_name(mat), pred->text) != NULL;
+	case NAME_STARTS_WITH:
+		return strncmp(material_name(mat), pred->text, strlen(pred->text)) == 0;
+	case SUPPLIER_IS:
+		return strcmp(material_supplier(mat), pred->text) == 0;
+	case SUPPLIER_STARTS_WITH:
+		return strncmp(material_supplier(mat), pred->text, strlen(pred->text)) == 0;
+	case QUANTITY_AT_MOST:
+		return material_quantity(mat) <= pred->quantity;
+	case QUANTITY_GREATER:
+		return material_quantity(mat) > pred->quantity;
+	case EXPIRES_BEFORE:
+		return material_expSerial(mat) < pred->serial;
+	case EXPIRES_FROM:
+		return material_expSerial(mat) >= pred->serial;
+	}
+
+	return 0;
+}
+
+int matQuery_compare(const MaterialQuery* q, const Material* a, const Material* b)
+{
+	int result = 0;
+
+	if (q->sortKey == SORT_QUANTITY) {
+		if (material_quantity(a) != material_quantity(b))
+			result = material_quantity(a) < material_quantity(b) ? -1 : 1;
+	}
+	else if (q->sortKey == SORT_NAME)
+		result = strcmp(material_name(a), material_name(b));
+	else if (q->sortKey == SORT_EXP_DATE) {
+		if (material_expSerial(a) != material_expSerial(b))
+			result = material_expSerial(a) < material_expSerial(b) ? -1 : 1;
+	}
+
+	if (q->descending)
+		result = -result;
+
+	if (result == 0 && material_id(a) != material_id(b))
+		result = material_id(a) < material_id(b) ? -1 : 1;
+
+	return result;
+}
@@ -0,0 +1,143 @@
+#ifndef MATERIAL_QUERY
+#define MATERIAL_QUERY
+
+#include "Material.h"
+#include <stdlib.h>
+
+// The conditions a material can be filtered by.
+typedef enum {
+	NAME_CONTAINS,
+	NAME_STARTS_WITH,
+	SUPPLIER_IS,
+	SUPPLIER_STARTS_WITH,
+	QUANTITY_AT_MOST,
+	QUANTITY_GREATER,
+	EXPIRES_BEFORE,
+	EXPIRES_FROM,
+} QueryPredicateType;
+
+// The keys materials can be sorted by. Materials with equal keys are ordered by id.
+typedef enum {
+	SORT_NONE,
+	SORT_QUANTITY,
+	SORT_NAME,
+	SORT_EXP_DATE,
+} QuerySortKey;
+
+// The ways a material service can run a query.
+typedef enum {
+	FULL_SCAN,
+	SHARD_SCAN,
+	COLUMN_SCAN,
+} QueryPlan;
+
+// A single condition of a query. Only the member matching the type is used. The date conditions keep the date as given
+// and the serial they compare with (see 'date_serialCeil').
+typedef struct {
+	QueryPredicateType type;
+	char* text;
+	Quantity quantity;
+	Date date;
+	DateSerial serial;
+} QueryPredicate;
+
+// The internal data for a query over materials: a list of conditions that must all hold, a sort order and a limit.
+// Do not use struct members directly. Use only methods that start with 'matQuery_'.
+// The query must be initialized with 'matQuery_create' and destroyed with 'matQuery_destroy'. Run it with 'matServ_query'.
+// If not specified otherwise, query pointer cannot be NULL in query methods.
+typedef struct {
+	QueryPredicate* predicates;
+	size_t predicateCount;
+	size_t predicateCapacity;
+	QuerySortKey sortKey;
+	int descending;
+	size_t limit;
+	Material* after;
+	int failed;
+} MaterialQuery;
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize a query without conditions, order or limit (it selects all the materials).
+MaterialQuery* matQuery_create();
+
+// Release all query resources and free the query itself. If query is NULL nothing happens.
+void matQuery_destroy(MaterialQuery* q);
+
+// PROPERTIES.
+
+// Returns the number of conditions.
+size_t matQuery_predicateCount(const MaterialQuery* q);
+
+// Returns the condition on the specified index, or NULL if the index is invalid.
+const QueryPredicate* matQuery_predicate(const MaterialQuery* q, size_t index);
+
+// Returns the key the results are sorted by.
+QuerySortKey matQuery_sortKey(const MaterialQuery* q);
+
+// Returns 1 if the results are sorted descending, 0 otherwise.
+int matQuery_descending(const MaterialQuery* q);
+
+// Returns the maximum number of results, 0 means no limit.
+size_t matQuery_limit(const MaterialQuery* q);
+
+// Returns the cursor the results start after, or NULL if there is none.
+const Material* matQuery_after(const MaterialQuery* q);
+
+// Returns 1 if a condition or the cursor could not be added (the memory could not be allocated), otherwise 0.
+// A failed query matches no material, so it never returns rows one of its conditions should have filtered out.
+int matQuery_failed(const MaterialQuery* q);
+
+// CONDITIONS.
+// Each method adds a condition (the strings are copied) and returns the query, so calls can be chained.
+// If the condition cannot be added, the query fails (see 'matQuery_failed').
+
+// The name of the material contains the given string. NULL or an empty string matches all materials.
+MaterialQuery* matQuery_whereNameContains(MaterialQuery* q, const char* str);
+
+// The material is from the given supplier. Lets the service search only the supplier's shard.
+MaterialQuery* matQuery_whereSupplierIs(MaterialQuery* q, const char* supplier);
+
+// The name of the material starts with the given prefix. NULL or an empty string matches all materials.
+MaterialQuery* matQuery_whereNameStartsWith(MaterialQuery* q, const char* prefix);
+
+// The supplier of the material starts with the given prefix. NULL or an empty string matches all materials.
+MaterialQuery* matQuery_whereSupplierStartsWith(MaterialQuery* q, const char* prefix);
+
+// The quantity of the material is less or equal to the given value.
+MaterialQuery* matQuery_whereQuantityAtMost(MaterialQuery* q, Quantity quantity);
+
+// The quantity of the material is greater than the given value.
+MaterialQuery* matQuery_whereQuantityGreater(MaterialQuery* q, Quantity quantity);
+
+// The material expires before the given date.
+MaterialQuery* matQuery_whereExpiresBefore(MaterialQuery* q, Date date);
+
+// The material expires on the given date or after it.
+MaterialQuery* matQuery_whereExpiresFrom(MaterialQuery* q, Date date);
+
+// ORDER / LIMIT.
+
+// Sort the results by the given key, ascending or descending.
+MaterialQuery* matQuery_orderBy(MaterialQuery* q, QuerySortKey key, int descending);
+
+// Return at most 'limit' results, 0 means no limit.
+MaterialQuery* matQuery_setLimit(MaterialQuery* q, size_t limit);
+
+// Return only the materials that come after the given material in the order of the query (keyset pagination).
+// Pass the last material of the previous page to get the next one. A copy of the material is saved, NULL removes the cursor.
+MaterialQuery* matQuery_setAfter(MaterialQuery* q, const Material* mat);
+
+// METHODS.
+
+// Returns 1 if the material satisfies all the conditions, 0 otherwise (always 0 if the query failed).
+int matQuery_matches(const MaterialQuery* q, const Material* mat);
+
+// Returns 1 if the predicate holds for the material, 0 otherwise.
+int matQuery_predicateMatches(const QueryPredicate* pred, const Material* mat);
+
+// Compares two materials by the sort key and direction of the query (ties are broken by id, ascending).
+// Returns a negative number if 'a' comes first, a positive one if 'b' comes first and 0 if they are the same material.
+int matQuery_compare(const MaterialQuery* q, const Material* a, const Material* b);
+
+#endif
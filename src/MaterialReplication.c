@@ -0,0 +1,523 @@
+#include "MaterialReplication.h"
+#include "LatencyRecorder.h"
+#include <string.h>
+
+// The first bytes of a log: a magic number and the version of the format.
+static const unsigned char LOG_HEADER[5] = { 'M', 'L', 'O', 'G', 2 };
+
+// Writing. A record is its type, the number of bytes after it, then its sequence number, time and contents, so a follower
+// can wait until the whole record arrived before it applies any of it. The values are encoded with the codec (see 'Codec.h').
+
+// Starts a record in the shipper's body: the sequence number and time every record has.
+static void logShipper_start(LogShipper* s, unsigned long long lsn, long long time)
+{
+	codecWriter_clear(&s->body);
+	codecWriter_writeNumber(&s->body, lsn);
+	codecWriter_writeSigned(&s->body, time);
+}
+
+// Frames the record in the shipper's body with its type and length. Returns 0 if the memory could not be allocated.
+static int logShipper_finish(LogShipper* s, LogRecordType type)
+{
+	codecWriter_clear(&s->record);
+	codecWriter_writeByte(&s->record, (unsigned char)type);
+	codecWriter_writeNumber(&s->record, codecWriter_length(&s->body));
+	codecWriter_writeBytes(&s->record, codecWriter_bytes(&s->body), codecWriter_length(&s->body));
+	return !codecWriter_failed(&s->body) && !codecWriter_failed(&s->record);
+}
+
+// Adds the framed record to the follower's buffer and counts it. A record that could not be encoded or buffered is lost,
+// so the follower cannot go on and is dropped by the next flush.
+static void logShipper_ship(LogShipper* s, LogFollowerStream* follower, int encoded)
+{
+	if (follower->failed)
+		return;
+
+	codecWriter_writeBytes(&follower->pending, codecWriter_bytes(&s->record), codecWriter_length(&s->record));
+	if (!encoded || codecWriter_failed(&follower->pending))
+		follower->failed = 1;
+	else
+		++follower->records;
+}
+
+// Sends what the follower's connection takes of its buffer. Marks the follower to be dropped if its connection is closed
+// or failed, or if it fell more than LOG_MAX_PENDING bytes behind.
+static void logShipper_send(LogFollowerStream* follower)
+{
+	while (!follower->failed && codecWriter_length(&follower->pending) > 0) {
+		long long sent = localSocket_send(&follower->connection, codecWriter_bytes(&follower->pending), codecWriter_length(&follower->pending));
+		if (sent < 0)
+			follower->failed = 1;
+		else if (sent == 0)
+			break;
+		else
+			codecWriter_discard(&follower->pending, (size_t)sent);
+	}
+
+	// A follower sends nothing, so bytes to receive mean its connection was closed.
+	unsigned char unused[16];
+	if (localSocket_receive(&follower->connection, unused, sizeof(unused)) < 0 || codecWriter_length(&follower->pending) > LOG_MAX_PENDING)
+		follower->failed = 1;
+}
+
+static void logShipper_freeFollower(LogFollowerStream* follower)
+{
+	localSocket_close(&follower->connection);
+	codecWriter_free(&follower->pending);
+}
+
+// Ships every change of the service as the next record of the log. The record is encoded once for all the followers and
+// only goes to their buffers, it is sent by the next flush (see 'logShipper_flush').
+static void logShipper_onChange(void* context, const Material* oldMat, const Material* newMat)
+{
+	LogShipper* s = context;
+	LogRecordType type = oldMat == NULL ? (matServ_isLoading(s->service) ? LOG_LOAD : LOG_ADD)
+		: newMat == NULL ? LOG_REMOVE : LOG_UPDATE;
+	long long time = latency_now();
+	++s->lsn;
+	s->lastRecord = time;
+	if (s->followerCount == 0)
+		return;
+
+	logShipper_start(s, s->lsn, time);
+	if (type == LOG_REMOVE)
+		codecWriter_writeSigned(&s->body, material_id(oldMat));
+	else
+		codecWriter_writeMaterial(&s->body, newMat);
+	int encoded = logShipper_finish(s, type);
+
+	for (size_t i = 0; i < s->followerCount; ++i)
+		logShipper_ship(s, &s->followers[i], encoded);
+}
+
+// Applies a change read into the follower's material. Returns 1 on success, otherwise 0.
+static int logFollower_perform(LogFollower* f, OperationType type)
+{
+	MaterialOperation op;
+	if (!matOp_init(&op, type, f->mat)) {
+		matOp_release(&op);
+		return 0;
+	}
+
+	int result = matServ_performOperation(f->service, &op, NULL);
+	matOp_release(&op);
+	return result >= 0;
+}
+
+// Removes every material from the service, before a snapshot is loaded. Returns 1 on success, otherwise 0.
+static int logFollower_clear(LogFollower* f)
+{
+	IntVector ids;
+	intVec_init(&ids);
+	MaterialCursor cur = matServ_cursorAll(f->service);
+	for (const Material* mat; (mat = matCursor_next(&cur)) != NULL;) {
+		if (!intVec_add(&ids, material_id(mat))) {
+			intVec_free(&ids);
+			return 0;
+		}
+	}
+
+	int succeeded = 1;
+	for (size_t i = 0; i < intVec_length(&ids); ++i)
+		succeeded &= matServ_removeById(f->service, *intVec_at(&ids, i), NULL, 0) == 0;
+	intVec_free(&ids);
+	return succeeded;
+}
+
+// Reads a material into the follower's material.
+static void logFollower_readMaterial(LogFollower* f, int* ok)
+{
+	codecReader_readMaterial(&f->reader, f->mat, f->strings, f->capacities, ok);
+}
+
+// Replaces the catalog with the snapshot that follows. Returns 1 on success, otherwise 0.
+static int logFollower_loadSnapshot(LogFollower* f, int* ok)
+{
+	unsigned long long count = codecReader_readNumber(&f->reader, ok);
+	if (!*ok || !logFollower_clear(f))
+		return 0;
+
+	for (unsigned long long i = 0; i < count && *ok; ++i) {
+		logFollower_readMaterial(f, ok);
+		if (*ok && matServ_load(f->service, f->mat) < 0)
+			return 0;
+	}
+
+	return *ok;
+}
+
+// The serving thread: ticks the shipper when a follower connects, and at least every LOG_SERVE_INTERVAL, until it stops.
+static void logShipper_run(void* argument)
+{
+	LogShipper* s = argument;
+	while (!sync_loadLong(&s->stopping)) {
+		localSocket_wait(&s->listener, LOG_SERVE_INTERVAL);
+		mutex_lock(&s->lock);
+		logShipper_tick(s);
+		mutex_unlock(&s->lock);
+	}
+}
+
+// Reads the bytes that arrived on the follower's connection. Remembers when the primary closed it.
+static size_t logFollower_receive(void* source, unsigned char* bytes, size_t size)
+{
+	LogFollower* f = source;
+	long long received = localSocket_receive(&f->connection, bytes, size);
+	if (received < 0) {
+		f->closed = 1;
+		return 0;
+	}
+	return (size_t)received;
+}
+
+// Returns a follower of the service that does not read anything yet, or NULL if the memory could not be allocated.
+static LogFollower* logFollower_allocate(MaterialService* serv)
+{
+	LogFollower* f = calloc(1, sizeof(LogFollower));
+	if (f == NULL)
+		return NULL;
+
+	if ((f->mat = material_create()) == NULL) {
+		free(f);
+		return NULL;
+	}
+
+	f->service = serv;
+	localSocket_init(&f->connection);
+	hist_clear(&f->lag);
+	return f;
+}
+
+// Constructor / Destructor.
+LogShipper* logShipper_create(MaterialService* serv)
+{
+	LogShipper* s = calloc(1, sizeof(LogShipper));
+	if (s == NULL)
+		return NULL;
+
+	s->service = serv;
+	localSocket_init(&s->listener);
+	codecWriter_init(&s->body);
+	codecWriter_init(&s->record);
+	mutex_init(&s->lock);
+	matServ_addObserver(serv, logShipper_onChange, s);
+	return s;
+}
+
+void logShipper_destroy(LogShipper* s)
+{
+	if (s == NULL)
+		return;
+
+	if (s->serving) {
+		sync_storeLong(&s->stopping, 1);
+		thread_join(&s->server);
+	}
+
+	matServ_removeObserver(s->service, logShipper_onChange, s);
+	for (size_t i = 0; i < s->followerCount; ++i) {
+		logShipper_send(&s->followers[i]);
+		logShipper_freeFollower(&s->followers[i]);
+	}
+	localSocket_close(&s->listener);
+	mutex_free(&s->lock);
+	codecWriter_free(&s->record);
+	codecWriter_free(&s->body);
+	free(s);
+}
+
+LogFollower* logFollower_connect(MaterialService* serv, unsigned short port)
+{
+	LogFollower* f = logFollower_allocate(serv);
+	if (f == NULL)
+		return NULL;
+
+	if (!localSocket_connect(&f->connection, port)) {
+		logFollower_destroy(f);
+		return NULL;
+	}
+
+	codecReader_init(&f->reader, logFollower_receive, f);
+	return f;
+}
+
+LogFollower* logFollower_create(MaterialService* serv, FILE* in)
+{
+	LogFollower* f = logFollower_allocate(serv);
+	if (f)
+		codecReader_initFile(&f->reader, in);
+	return f;
+}
+
+void logFollower_destroy(LogFollower* f)
+{
+	if (f == NULL)
+		return;
+
+	free(f->strings[0]);
+	free(f->strings[1]);
+	codecReader_free(&f->reader);
+	localSocket_close(&f->connection);
+	material_destroy(f->mat);
+	free(f);
+}
+
+// Properties.
+unsigned long long logShipper_lsn(const LogShipper* s)
+{
+	return s->lsn;
+}
+
+unsigned short logShipper_port(const LogShipper* s)
+{
+	return localSocket_port(&s->listener);
+}
+
+size_t logShipper_followerCount(const LogShipper* s)
+{
+	return s->followerCount;
+}
+
+size_t logShipper_shipped(const LogShipper* s, size_t index)
+{
+	return index < s->followerCount ? s->followers[index].records : 0;
+}
+
+size_t logShipper_pending(const LogShipper* s, size_t index)
+{
+	return index < s->followerCount ? codecWriter_length(&s->followers[index].pending) : 0;
+}
+
+MaterialService* logFollower_service(LogFollower* f)
+{
+	return f->service;
+}
+
+unsigned long long logFollower_appliedLsn(const LogFollower* f)
+{
+	return f->appliedLsn;
+}
+
+unsigned long long logFollower_lagRecords(const LogFollower* f)
+{
+	return f->primaryLsn > f->appliedLsn ? f->primaryLsn - f->appliedLsn : 0;
+}
+
+long long logFollower_lastLag(const LogFollower* f)
+{
+	return f->lastLag;
+}
+
+const Histogram* logFollower_lag(const LogFollower* f)
+{
+	return &f->lag;
+}
+
+long long logFollower_staleness(const LogFollower* f)
+{
+	return f->records > 0 ? latency_now() - f->primaryTime : -1;
+}
+
+size_t logFollower_records(const LogFollower* f)
+{
+	return f->records;
+}
+
+size_t logFollower_snapshots(const LogFollower* f)
+{
+	return f->snapshots;
+}
+
+int logFollower_closed(const LogFollower* f)
+{
+	return f->closed;
+}
+
+// Methods.
+int logShipper_listen(LogShipper* s, unsigned short port)
+{
+	localSocket_close(&s->listener);
+	return localSocket_listen(&s->listener, port);
+}
+
+int logShipper_serve(LogShipper* s)
+{
+	if (s->serving || !localSocket_isOpen(&s->listener))
+		return s->serving;
+
+	s->stopping = 0;
+	s->serving = thread_start(&s->server, logShipper_run, s);
+	return s->serving;
+}
+
+void logShipper_lock(LogShipper* s)
+{
+	mutex_lock(&s->lock);
+}
+
+void logShipper_unlock(LogShipper* s)
+{
+	mutex_unlock(&s->lock);
+}
+
+size_t logShipper_accept(LogShipper* s)
+{
+	size_t accepted = 0;
+	LocalSocket connection;
+	while (localSocket_isOpen(&s->listener) && localSocket_accept(&s->listener, &connection) > 0) {
+		if (s->followerCount == LOG_MAX_FOLLOWERS) {
+			localSocket_close(&connection);
+			continue;
+		}
+
+		LogFollowerStream* follower = &s->followers[s->followerCount++];
+		follower->connection = connection;
+		codecWriter_init(&follower->pending);
+		follower->records = 0;
+		follower->failed = 0;
+
+		logShipper_start(s, s->lsn, latency_now());
+		codecWriter_writeNumber(&s->body, matServ_matCount(s->service));
+		MaterialCursor cur = matServ_cursorAll(s->service);
+		for (const Material* mat; (mat = matCursor_next(&cur)) != NULL;)
+			codecWriter_writeMaterial(&s->body, mat);
+		int encoded = logShipper_finish(s, LOG_SNAPSHOT);
+
+		codecWriter_writeBytes(&follower->pending, LOG_HEADER, sizeof(LOG_HEADER));
+		logShipper_ship(s, follower, encoded);
+		++accepted;
+	}
+
+	return accepted;
+}
+
+void logShipper_heartbeat(LogShipper* s)
+{
+	long long time = latency_now();
+	s->lastRecord = time;
+	logShipper_start(s, s->lsn, time);
+	int encoded = logShipper_finish(s, LOG_HEARTBEAT);
+	for (size_t i = 0; i < s->followerCount; ++i)
+		logShipper_ship(s, &s->followers[i], encoded);
+
+	logShipper_flush(s);
+}
+
+void logShipper_flush(LogShipper* s)
+{
+	size_t kept = 0;
+	for (size_t i = 0; i < s->followerCount; ++i) {
+		logShipper_send(&s->followers[i]);
+		if (s->followers[i].failed)
+			logShipper_freeFollower(&s->followers[i]);
+		else
+			s->followers[kept++] = s->followers[i];
+	}
+	s->followerCount = kept;
+}
+
+void logShipper_tick(LogShipper* s)
+{
+	logShipper_accept(s);
+	if (latency_now() - s->lastRecord >= LOG_HEARTBEAT_INTERVAL)
+		logShipper_heartbeat(s);
+	else
+		logShipper_flush(s);
+}
+
+int logFollower_applyNext(LogFollower* f)
+{
+	if (f->failed)
+		return -1;
+
+	// A record whose bytes have not all arrived yet is read again from its start by the next call.
+	int ok = 1;
+	codecReader_mark(&f->reader);
+	if (!f->started) {
+		unsigned char header[sizeof(LOG_HEADER)];
+		codecReader_readBytes(&f->reader, header, sizeof(header), &ok);
+		if (!ok && codecReader_starved(&f->reader)) {
+			codecReader_rewind(&f->reader);
+			return 0;
+		}
+		if (!ok || memcmp(header, LOG_HEADER, sizeof(header)) != 0) {
+			f->failed = 1;
+			return -1;
+		}
+		f->started = 1;
+		codecReader_mark(&f->reader);
+	}
+
+	if (!codecReader_hasMore(&f->reader))
+		return 0;
+
+	LogRecordType type = (LogRecordType)codecReader_readByte(&f->reader, &ok);
+	unsigned long long length = codecReader_readNumber(&f->reader, &ok);
+	if (ok && !codecReader_ensure(&f->reader, (size_t)length))
+		ok = 0;
+	if (!ok && codecReader_starved(&f->reader)) {
+		codecReader_rewind(&f->reader);
+		return 0;
+	}
+
+	unsigned long long lsn = codecReader_readNumber(&f->reader, &ok);
+	long long time = codecReader_readSigned(&f->reader, &ok);
+
+	// The log must start with a snapshot, and the changes must follow each other without gaps.
+	if (type == LOG_SNAPSHOT)
+		ok = ok && logFollower_loadSnapshot(f, &ok);
+	else if (type == LOG_ADD || type == LOG_UPDATE || type == LOG_REMOVE || type == LOG_LOAD) {
+		ok = ok && f->snapshots > 0 && lsn == f->appliedLsn + 1;
+		if (ok && type == LOG_REMOVE)
+			material_id_set(f->mat, (int)codecReader_readSigned(&f->reader, &ok));
+		else if (ok)
+			logFollower_readMaterial(f, &ok);
+		if (type == LOG_LOAD)
+			ok = ok && matServ_load(f->service, f->mat) >= 0;
+		else
+			ok = ok && logFollower_perform(f, (OperationType)type);
+	}
+	else if (type == LOG_HEARTBEAT)
+		ok = ok && f->snapshots > 0 && lsn >= f->appliedLsn;
+	else
+		ok = 0;
+
+	if (!ok) {
+		f->failed = 1;
+		return -1;
+	}
+
+	++f->records;
+	f->primaryTime = time;
+	if (type != LOG_HEARTBEAT)
+		f->appliedLsn = lsn;
+	if (lsn > f->primaryLsn || type == LOG_SNAPSHOT)
+		f->primaryLsn = lsn;
+	if (type == LOG_SNAPSHOT)
+		++f->snapshots;
+	else if (type != LOG_HEARTBEAT) {
+		f->lastLag = latency_now() - time;
+		hist_record(&f->lag, f->lastLag > 0 ? f->lastLag : 0);
+	}
+
+	return 1;
+}
+
+long long logFollower_applyAll(LogFollower* f)
+{
+	long long applied = 0;
+	int status;
+	while ((status = logFollower_applyNext(f)) > 0)
+		++applied;
+
+	return status < 0 ? -1 : applied;
+}
+
+int logFollower_wait(LogFollower* f, long long timeout)
+{
+	if (!localSocket_isOpen(&f->connection))
+		return 1;
+	if (f->closed)
+		return -1;
+	return localSocket_wait(&f->connection, timeout);
+}
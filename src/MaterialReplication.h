@@ -0,0 +1,218 @@
+#ifndef MATERIAL_REPLICATION
+#define MATERIAL_REPLICATION
+
+#include "MaterialService.h"
+#include "Histogram.h"
+#include "Codec.h"
+#include "LocalSocket.h"
+#include "Thread.h"
+#include <stdio.h>
+
+// The most followers a shipper streams to. The followers that connect when there are already that many are turned away.
+#define LOG_MAX_FOLLOWERS 8
+
+// The longest time in nanoseconds 'logShipper_tick' lets the followers go without a record, so they can tell how stale they are.
+#define LOG_HEARTBEAT_INTERVAL 1000000000LL
+
+// The most bytes shipped to a follower but not sent yet. A follower that falls further behind is dropped, so it does
+// not hold back the primary; it can connect again for a new snapshot.
+#define LOG_MAX_PENDING 0x4000000
+
+// The longest time in nanoseconds the serving thread waits between two ticks (see 'logShipper_serve').
+#define LOG_SERVE_INTERVAL 50000000LL
+
+// The records of a shipped log. The changes use the values of 'OperationType', except the materials stored by 'matServ_load',
+// which are LOAD records.
+typedef enum {
+	LOG_ADD = ADD,
+	LOG_UPDATE = UPDATE,
+	LOG_REMOVE = REMOVE,
+	LOG_SNAPSHOT,
+	LOG_HEARTBEAT,
+	LOG_LOAD,
+	LOG_RECORD_COUNT
+} LogRecordType;
+
+// A follower a shipper streams to: its connection and the records shipped to it but not sent yet.
+typedef struct {
+	LocalSocket connection;
+	CodecWriter pending;
+	size_t records;
+	int failed;
+} LogFollowerStream;
+
+// The internal data for a shipper of the changes of a primary service to follower processes, which connect to the port
+// it listens on (see 'logShipper_listen') at any time. Every change made through the service, including undo and redo,
+// gets the next log sequence number and is shipped to every follower as an ADD, UPDATE or REMOVE record with the whole
+// material (only the id for REMOVE) and the time it was made at (see 'latency_now'). A material stored by 'matServ_load'
+// is a LOAD record, which the follower stores the same trusted way. A record is encoded once (see 'Codec.h'), whatever
+// the number of followers.
+// A change only goes to the buffers of the followers, so shipping it does not wait for them: the buffered records are sent
+// by 'logShipper_tick', which the primary calls off the write path, for example every time it waits for the next command,
+// or which a thread of the shipper calls in the background (see 'logShipper_serve'). Sending never waits for a follower
+// either: what its connection does not take stays buffered, up to LOG_MAX_PENDING bytes.
+// A follower starts with a snapshot of the catalog when it connects, and catches up from there.
+// Do not use struct members directly. Use only methods that start with 'logShipper_'.
+// The shipper must be initialized with 'logShipper_create' and destroyed with 'logShipper_destroy'.
+// If not specified otherwise, shipper pointer cannot be NULL in shipper methods.
+typedef struct {
+	MaterialService* service;
+	unsigned long long lsn;
+	LocalSocket listener;
+	LogFollowerStream followers[LOG_MAX_FOLLOWERS];
+	size_t followerCount;
+	long long lastRecord;
+	CodecWriter body;
+	CodecWriter record;
+	Mutex lock;
+	Thread server;
+	int serving;
+	volatile long stopping;
+} LogShipper;
+
+// The internal data for a follower that applies the log of a 'LogShipper' to its own service, and so to its repository,
+// views and running totals. It reads the log from a connection to the primary, or from a file the log was saved to.
+// The service serves read-only queries: it must not be modified except by the follower.
+// Do not use struct members directly. Use only methods that start with 'logFollower_'.
+// The follower must be initialized with 'logFollower_connect' or 'logFollower_create' and destroyed with 'logFollower_destroy'.
+// If not specified otherwise, follower pointer cannot be NULL in follower methods.
+typedef struct {
+	MaterialService* service;
+	LocalSocket connection;
+	int closed;
+	CodecReader reader;
+	int started;
+	int failed;
+	Material* mat;
+	char* strings[2];
+	size_t capacities[2];
+	unsigned long long appliedLsn;
+	unsigned long long primaryLsn;
+	long long primaryTime;
+	size_t records;
+	size_t snapshots;
+	long long lastLag;
+	Histogram lag;
+} LogFollower;
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize a shipper of the changes of the given service, starting at log sequence number 0. It does not listen yet.
+// Returns NULL if the memory could not be allocated.
+LogShipper* logShipper_create(MaterialService* serv);
+
+// Stop serving and shipping, send what the connections take of the buffered records, close them and free the shipper.
+// If shipper is NULL nothing happens.
+void logShipper_destroy(LogShipper* s);
+
+// Initialize a follower connected to the shipper listening on the given port of this machine, which applies the log to
+// the service. The service should start empty. Nothing is read yet.
+// Returns NULL if the connection could not be made or the memory could not be allocated.
+LogFollower* logFollower_connect(MaterialService* serv, unsigned short port);
+
+// Initialize a follower that reads the log from the given stream (a file the bytes of a connection were saved to,
+// opened in binary mode) and applies it to the service, which should start empty. Nothing is read yet.
+// The end of the stream is not the end of the log: the records appended to it later are read too.
+// Returns NULL if the memory could not be allocated.
+LogFollower* logFollower_create(MaterialService* serv, FILE* in);
+
+// Close the connection and free the follower. A stream is not closed and the service is not destroyed.
+// If follower is NULL nothing happens.
+void logFollower_destroy(LogFollower* f);
+
+// PROPERTIES.
+
+// Get the log sequence number of the last change (0 if there was none).
+unsigned long long logShipper_lsn(const LogShipper* s);
+
+// Get the port the shipper listens on, or 0 if it does not listen.
+unsigned short logShipper_port(const LogShipper* s);
+
+// Get the number of connected followers.
+size_t logShipper_followerCount(const LogShipper* s);
+
+// Get the number of records shipped to the follower on the given index (the followers are in the order they connected),
+// or 0 if the index is invalid.
+size_t logShipper_shipped(const LogShipper* s, size_t index);
+
+// Get the number of bytes shipped to the follower on the given index but not sent yet, or 0 if the index is invalid.
+size_t logShipper_pending(const LogShipper* s, size_t index);
+
+// Get the service the log is applied to.
+MaterialService* logFollower_service(LogFollower* f);
+
+// Get the log sequence number of the last change applied (0 before the first snapshot).
+unsigned long long logFollower_appliedLsn(const LogFollower* f);
+
+// Get the number of changes the follower is known to be behind the primary: the last sequence number the primary announced
+// (with a change, a snapshot or a heartbeat) minus the applied one.
+unsigned long long logFollower_lagRecords(const LogFollower* f);
+
+// Get the time in nanoseconds from when the last applied change was made on the primary to when it was applied.
+long long logFollower_lastLag(const LogFollower* f);
+
+// Get the times from when the changes were made on the primary to when they were applied, one value per change.
+const Histogram* logFollower_lag(const LogFollower* f);
+
+// Get the time in nanoseconds since the primary made the last record read (a change, snapshot or heartbeat),
+// which is how stale the catalog can be. Returns -1 before the first record.
+long long logFollower_staleness(const LogFollower* f);
+
+// Get the number of records read and the number of them that were snapshots.
+size_t logFollower_records(const LogFollower* f);
+size_t logFollower_snapshots(const LogFollower* f);
+
+// Returns 1 if the primary closed the connection, so no more records will come, otherwise 0.
+int logFollower_closed(const LogFollower* f);
+
+// METHODS.
+
+// Listen for followers on the given port of this machine (0 picks a free one, see 'logShipper_port').
+// Returns 1 on success, otherwise 0.
+int logShipper_listen(LogShipper* s, unsigned short port);
+
+// Start a thread that ticks the shipper (see 'logShipper_tick') as soon as a follower connects, and at least every
+// LOG_SERVE_INTERVAL, so followers are taken and kept up to date at any time, even while the primary does not call it.
+// The thread ticks while it holds the lock of the shipper (see 'logShipper_lock'), and the tick reads the service for the
+// snapshots, so from now on the service must be used only by threads that hold the lock.
+// Returns 1 on success, and 0 if the shipper does not listen or the thread could not be started.
+int logShipper_serve(LogShipper* s);
+
+// Lock or unlock the shipper, and so the service while the shipper serves (see 'logShipper_serve').
+void logShipper_lock(LogShipper* s);
+void logShipper_unlock(LogShipper* s);
+
+// Take the followers waiting to connect: each one gets the log header and a snapshot of the whole catalog at the current
+// sequence number, then every change after it. Returns the number of followers taken.
+size_t logShipper_accept(LogShipper* s);
+
+// Ship a heartbeat with the current sequence number and time to every follower, so idle followers know they are up to date,
+// then send the buffered records (see 'logShipper_flush').
+void logShipper_heartbeat(LogShipper* s);
+
+// Send the buffered records to all followers, as far as their connections take them. The followers whose connection
+// is closed or failed, or who fell more than LOG_MAX_PENDING bytes behind, are dropped.
+void logShipper_flush(LogShipper* s);
+
+// Take the followers waiting to connect, then send the buffered records, with a heartbeat if LOG_HEARTBEAT_INTERVAL passed
+// since the last record. Call it periodically, outside of the changes, so the followers get the changes soon and can tell
+// an idle primary from a stalled one.
+void logShipper_tick(LogShipper* s);
+
+// Read the next record of the log and apply it. A snapshot replaces the whole catalog of the service, and is loaded
+// like the primary stored it (see 'matServ_load'), like a LOAD record.
+// Returns 1 if a record was applied, 0 if no whole record arrived yet (the next call reads it once it did, see
+// 'logFollower_wait'), and -1 if the log is corrupt or out of order, or a change could not be applied (the follower then
+// stops and should connect again for a new snapshot).
+int logFollower_applyNext(LogFollower* f);
+
+// Apply records until the stream has no whole record left for now, or an error.
+// Returns the number of records applied, or -1 on an error.
+long long logFollower_applyAll(LogFollower* f);
+
+// Wait at most the given time in nanoseconds until more of the log arrives from the primary.
+// Returns 1 if it did (or the follower reads a stream, which is not waited for), 0 on timeout, and -1 if the connection
+// is closed or failed.
+int logFollower_wait(LogFollower* f, long long timeout);
+
+#endif
@@ -1,12 +1,246 @@
 #include "MaterialRepository.h"
+#include "SpanTracer.h"
+
+// The operations whose latencies are recorded while tracking is on (see 'matRepo_setLatencyTracking'), also traced as spans.
+typedef enum {
+	REPO_SAVE,
+	REPO_GET_BY_ID,
+	REPO_UPDATE_BY_ID,
+	REPO_DELETE_BY_ID,
+	REPO_COMPLETE_NAME,
+	REPO_COMPLETE_SUPPLIER,
+	REPO_GET_FREE_ID,
+	REPO_OPERATION_COUNT
+} RepositoryOperation;
+
+static const char* const REPO_OPERATION_NAMES[REPO_OPERATION_COUNT] = {
+	"repo_save",
+	"repo_get_by_id",
+	"repo_update_by_id",
+	"repo_delete_by_id",
+	"repo_complete_name",
+	"repo_complete_supplier",
+	"repo_get_free_id",
+};
+
+// Starts the span of an operation and returns the time it started, for 'matRepo_end' (0 if latencies are not tracked).
+static long long matRepo_begin(MaterialRepository* rep, RepositoryOperation op)
+{
+	// The operation only names the span, which is not compiled in without MAT_SPANS.
+	(void)op;
+	SPAN_BEGIN(REPO_OPERATION_NAMES[op]);
+	return latency_start(rep->latency);
+}
+
+// Records the latency of an operation started by 'matRepo_begin' and ends its span.
+static void matRepo_end(MaterialRepository* rep, RepositoryOperation op, long long started)
+{
+	latency_stop(rep->latency, op, started);
+	SPAN_END();
+}
+
+// Ends an operation like 'matRepo_end' and returns its result.
+static size_t matRepo_timed(MaterialRepository* rep, RepositoryOperation op, long long started, size_t result)
+{
+	matRepo_end(rep, op, started);
+	return result;
+}
+
+// Returns the shard of the supplier.
+static MaterialShard* matRepo_shard(MaterialRepository* rep, const char* supplier)
+{
+	return &rep->shards[matRepo_shardOf(rep, supplier)];
+}
+
+// Finds the material with the id: returns its shard and saves its position in the shard, or returns NULL if it is not found.
+static MaterialShard* matRepo_find(MaterialRepository* rep, int id, size_t* position)
+{
+	for (size_t i = 0; i < rep->shardCount; ++i) {
+		if (intMap_get(&rep->shards[i].positions, id, position))
+			return &rep->shards[i];
+	}
+
+	return NULL;
+}
+
+// Adds the material with the given repository index to the shard. The shard must be locked.
+// Returns 0 if the memory could not be allocated (then the shard is not changed).
+static int matRepo_addToShard(MaterialShard* shard, Material* mat, size_t index)
+{
+	size_t position = vector_length(shard->materials);
+	vector_add(shard->materials, mat);
+	if (vector_length(shard->materials) == position)
+		return 0;
+
+	if (!indexVec_add(&shard->indexes, index)) {
+		vector_removeAt(shard->materials, position);
+		return 0;
+	}
+
+	if (!intMap_put(&shard->positions, material_id(mat), position)) {
+		indexVec_removeLast(&shard->indexes);
+		vector_removeAt(shard->materials, position);
+		return 0;
+	}
+
+	if (material_id(mat) > shard->maxId)
+		shard->maxId = material_id(mat);
+	return 1;
+}
+
+// Removes the material on the position from the shard (the last material of the shard takes its place). The shard must be locked.
+static void matRepo_removeFromShard(MaterialShard* shard, size_t position)
+{
+	int id = material_id(vector_get(shard->materials, position));
+	intMap_remove(&shard->positions, id);
+	vector_removeFastAt(shard->materials, position);
+	indexVec_removeFastAt(&shard->indexes, position);
+
+	// The key of the moved material is still in the map, so this cannot allocate.
+	if (position < vector_length(shard->materials))
+		intMap_put(&shard->positions, material_id(vector_get(shard->materials, position)), position);
+
+	// Only the removal of the biggest id needs a look at the remaining ids of the shard.
+	if (id == shard->maxId) {
+		shard->maxId = -1;
+		for (size_t i = 0; i < vector_length(shard->materials); ++i) {
+			if (material_id(vector_get(shard->materials, i)) > shard->maxId)
+				shard->maxId = material_id(vector_get(shard->materials, i));
+		}
+	}
+}
+
+// Locks the two shards (which can be the same one), always in the order of their indexes, so two threads cannot wait for each other.
+static void matRepo_lockPair(MaterialShard* first, MaterialShard* second)
+{
+	if (first > second) {
+		MaterialShard* swap = first;
+		first = second;
+		second = swap;
+	}
+
+	mutex_lock(&first->lock);
+	if (second != first)
+		mutex_lock(&second->lock);
+}
+
+static void matRepo_unlockPair(MaterialShard* first, MaterialShard* second)
+{
+	if (second != first)
+		mutex_unlock(&second->lock);
+	mutex_unlock(&first->lock);
+}
+
+// Adds the name and supplier of the material to the prefix tries.
+static void matRepo_indexStrings(MaterialRepository* rep, const Material* mat)
+{
+	if (material_name(mat))
+		trie_insert(rep->names, material_name(mat));
+	if (material_supplier(mat))
+		trie_insert(rep->suppliers, material_supplier(mat));
+}
+
+// Removes the name and supplier of the material from the prefix tries.
+static void matRepo_unindexStrings(MaterialRepository* rep, const Material* mat)
+{
+	if (material_name(mat))
+		trie_remove(rep->names, material_name(mat));
+	if (material_supplier(mat))
+		trie_remove(rep->suppliers, material_supplier(mat));
+}
+
+// Stores the columns of the material on the specified index (at most the number of materials, to append them).
+// Returns 0 if the columns could not be grown.
+static int matRepo_setColumns(MaterialRepository* rep, size_t index, const Material* mat)
+{
+	if (index == quantityVec_length(&rep->quantities)) {
+		if (!quantityVec_add(&rep->quantities, 0))
+			return 0;
+		if (!intVec_add(&rep->expSerials, 0)) {
+			quantityVec_removeLast(&rep->quantities);
+			return 0;
+		}
+	}
+
+	*quantityVec_at(&rep->quantities, index) = material_quantity(mat);
+	*intVec_at(&rep->expSerials, index) = material_expSerial(mat);
+	return 1;
+}
+
+// Adds a copy of the material at the end of the repository, its columns and its shard, and returns the index,
+// or -1 if the memory could not be allocated (then nothing is changed).
+static size_t matRepo_append(MaterialRepository* rep, const Material* mat)
+{
+	// Copy the material first, so nothing is changed if the copy cannot be allocated.
+	Material* newMat = material_duplicateWith(rep->allocator, mat);
+	if (newMat == NULL)
+		return -1;
+
+	size_t index = vector_length(rep->materials);
+	if (!matRepo_setColumns(rep, index, newMat)) {
+		material_destroy(newMat);
+		return -1;
+	}
+
+	vector_add(rep->materials, newMat);
+	MaterialShard* shard = matRepo_shard(rep, material_supplier(newMat));
+	int added = 0;
+	if (vector_length(rep->materials) > index) {
+		mutex_lock(&shard->lock);
+		added = matRepo_addToShard(shard, newMat, index);
+		mutex_unlock(&shard->lock);
+		if (!added)
+			vector_removeAt(rep->materials, index);
+	}
+
+	if (!added) {
+		quantityVec_removeLast(&rep->quantities);
+		intVec_removeLast(&rep->expSerials);
+		material_destroy(newMat);
+		return -1;
+	}
+
+	matRepo_indexStrings(rep, newMat);
+	return index;
+}
 
 // Constructor / Destructor.
 MaterialRepository* matRepo_create(int(*validator)(const Material* mat))
 {
-	MaterialRepository* rep = calloc(1, sizeof(MaterialRepository));
+	return matRepo_createSharded(validator, MAT_REPO_DEFAULT_SHARDS);
+}
+
+MaterialRepository* matRepo_createSharded(int(*validator)(const Material* mat), size_t shardCount)
+{
+	return matRepo_createWith(validator, shardCount, NULL);
+}
+
+MaterialRepository* matRepo_createWith(int(*validator)(const Material* mat), size_t shardCount, const Allocator* allocator)
+{
+	if (shardCount < 1)
+		shardCount = 1;
+
+	MaterialRepository* rep = allocator_calloc(allocator, 1, sizeof(MaterialRepository));
 	if (rep) {
-		rep->materials = vector_create(0);
+		rep->allocator = allocator;
+		rep->materials = vector_createWith(allocator, 0);
 		rep->validator = validator;
+		quantityVec_initWith(&rep->quantities, allocator);
+		intVec_initWith(&rep->expSerials, allocator);
+		rep->names = trie_createWith(allocator);
+		rep->suppliers = trie_createWith(allocator);
+
+		if ((rep->shards = allocator_calloc(allocator, shardCount, sizeof(MaterialShard))) != NULL) {
+			rep->shardCount = shardCount;
+			for (size_t i = 0; i < shardCount; ++i) {
+				MaterialShard* shard = &rep->shards[i];
+				shard->materials = vector_createWith(allocator, 0);
+				indexVec_initWith(&shard->indexes, allocator);
+				intMap_initWith(&shard->positions, allocator);
+				shard->maxId = -1;
+				mutex_init(&shard->lock);
+			}
+		}
 	}
 
 	return rep;
@@ -17,11 +251,26 @@ void matRepo_destroy(MaterialRepository* rep)
 	if (rep == NULL)
 		return;
 
-	for (size_t i = 0; i < vector_length(rep->materials); ++i)
-		material_destroy(vector_get(rep->materials, i));
+	// The shards own the materials.
+	for (size_t i = 0; i < rep->shardCount; ++i) {
+		MaterialShard* shard = &rep->shards[i];
+		for (size_t j = 0; j < vector_length(shard->materials); ++j)
+			material_destroy(vector_get(shard->materials, j));
 
+		vector_destroy(shard->materials);
+		indexVec_free(&shard->indexes);
+		intMap_free(&shard->positions);
+		mutex_free(&shard->lock);
+	}
+
+	allocator_free(rep->allocator, rep->shards);
+	quantityVec_free(&rep->quantities);
+	intVec_free(&rep->expSerials);
+	trie_destroy(rep->names);
+	trie_destroy(rep->suppliers);
 	vector_destroy(rep->materials);
-	free(rep);
+	latency_destroy(rep->latency);
+	allocator_free(rep->allocator, rep);
 }
 
 // Properties.
@@ -30,31 +279,75 @@ size_t matRepo_matCount(MaterialRepository* rep)
 	return vector_length(rep->materials);
 }
 
+const Quantity* matRepo_quantities(MaterialRepository* rep)
+{
+	return quantityVec_array(&rep->quantities);
+}
+
+const DateSerial* matRepo_expSerials(MaterialRepository* rep)
+{
+	return intVec_array(&rep->expSerials);
+}
+
+size_t matRepo_shardCount(MaterialRepository* rep)
+{
+	return rep->shardCount;
+}
+
+size_t matRepo_shardLength(MaterialRepository* rep, size_t shard)
+{
+	return shard < rep->shardCount ? vector_length(rep->shards[shard].materials) : 0;
+}
+
+int matRepo_setLatencyTracking(MaterialRepository* rep, int enabled)
+{
+	if (!enabled) {
+		latency_destroy(rep->latency);
+		rep->latency = NULL;
+	}
+	else if (rep->latency == NULL)
+		rep->latency = latency_create(REPO_OPERATION_NAMES, REPO_OPERATION_COUNT);
+
+	return !enabled || rep->latency != NULL;
+}
+
+const LatencyRecorder* matRepo_latency(MaterialRepository* rep)
+{
+	return rep->latency;
+}
+
 // Methods.
 size_t matRepo_save(MaterialRepository* rep, const Material* mat)
 {
+	long long started = matRepo_begin(rep, REPO_SAVE);
 	if (mat == NULL || (rep->validator != NULL && !rep->validator(mat)))
-		return -1;
+		return matRepo_timed(rep, REPO_SAVE, started, -1);
 
-	for (size_t i = 0; i < vector_length(rep->materials); ++i) {
-		const Material* curMat = vector_get(rep->materials, i);
-		if (material_id(curMat) == material_id(mat))
-			return -2;
-	}
+	size_t position;
+	if (matRepo_find(rep, material_id(mat), &position))
+		return matRepo_timed(rep, REPO_SAVE, started, -2);
+
+	return matRepo_timed(rep, REPO_SAVE, started, matRepo_append(rep, mat));
+}
 
-	vector_add(rep->materials, material_duplicate(mat));
-	return vector_length(rep->materials) - 1;
+size_t matRepo_saveTrusted(MaterialRepository* rep, const Material* mat)
+{
+	long long started = matRepo_begin(rep, REPO_SAVE);
+	if (mat == NULL || (rep->validator != NULL && !rep->validator(mat)))
+		return matRepo_timed(rep, REPO_SAVE, started, -1);
+
+	return matRepo_timed(rep, REPO_SAVE, started, matRepo_append(rep, mat));
 }
 
 const Material* matRepo_getById(MaterialRepository* rep, int id)
 {
-	for (size_t i = 0; i < vector_length(rep->materials); ++i) {
-		const Material* curMat = vector_get(rep->materials, i);
-		if (material_id(curMat) == id)
-			return curMat;
-	}
+	long long started = matRepo_begin(rep, REPO_GET_BY_ID);
+	size_t position;
+	MaterialShard* shard = matRepo_find(rep, id, &position);
+	const Material* found = shard ? vector_get(shard->materials, position) : NULL;
 
-	return NULL;
+	matRepo_end(rep, REPO_GET_BY_ID, started);
+	return found;
 }
 
 const Material* matRepo_getByIndex(MaterialRepository* rep, size_t index)
@@ -64,43 +357,122 @@ const Material* matRepo_getByIndex(MaterialRepository* rep, size_t index)
 
 size_t matRepo_updateById(MaterialRepository* rep, const Material* newMat)
 {
+	long long started = matRepo_begin(rep, REPO_UPDATE_BY_ID);
 	if (newMat == NULL || (rep->validator != NULL && !rep->validator(newMat)))
-		return -1;
+		return matRepo_timed(rep, REPO_UPDATE_BY_ID, started, -1);
+
+	size_t position;
+	MaterialShard* oldShard = matRepo_find(rep, material_id(newMat), &position);
+	if (oldShard == NULL)
+		return matRepo_timed(rep, REPO_UPDATE_BY_ID, started, -3);
+
+	Material* curMat = vector_get(oldShard->materials, position);
+	size_t index = *indexVec_at(&oldShard->indexes, position);
+	MaterialShard* newShard = matRepo_shard(rep, material_supplier(newMat));
+	matRepo_lockPair(oldShard, newShard);
 
-	for (size_t i = 0; i < vector_length(rep->materials); ++i) {
-		Material* curMat = vector_get(rep->materials, i);
-		if (material_id(curMat) == material_id(newMat)) {
-			material_destroy(curMat);
-			vector_set(rep->materials, i, material_duplicate(newMat));
-			return i;
+	// Add the material to its new shard before it leaves the old one, so a failed allocation changes nothing.
+	if (newShard != oldShard) {
+		if (!matRepo_addToShard(newShard, curMat, index)) {
+			matRepo_unlockPair(oldShard, newShard);
+			return matRepo_timed(rep, REPO_UPDATE_BY_ID, started, -1);
 		}
+		matRepo_removeFromShard(oldShard, position);
 	}
 
-	return -3;
+	// Update in place, so pointers to the material stay valid.
+	matRepo_unindexStrings(rep, curMat);
+	material_set(curMat, newMat);
+	matRepo_setColumns(rep, index, curMat);
+	matRepo_indexStrings(rep, curMat);
+	matRepo_unlockPair(oldShard, newShard);
+	return matRepo_timed(rep, REPO_UPDATE_BY_ID, started, index);
 }
 
 size_t matRepo_deleteById(MaterialRepository* rep, int id)
 {
-	for (size_t i = 0; i < vector_length(rep->materials); ++i) {
-		Material* curMat = vector_get(rep->materials, i);
-		if (material_id(curMat) == id) {
-			material_destroy(curMat);
-			vector_removeFastAt(rep->materials, i);
-			return i;
-		}
+	long long started = matRepo_begin(rep, REPO_DELETE_BY_ID);
+	size_t position;
+	MaterialShard* shard = matRepo_find(rep, id, &position);
+	if (shard == NULL)
+		return matRepo_timed(rep, REPO_DELETE_BY_ID, started, -3);
+
+	Material* curMat = vector_get(shard->materials, position);
+	size_t index = *indexVec_at(&shard->indexes, position);
+	matRepo_unindexStrings(rep, curMat);
+	mutex_lock(&shard->lock);
+	matRepo_removeFromShard(shard, position);
+	material_destroy(curMat);
+	mutex_unlock(&shard->lock);
+
+	// Mirror the fast removal in the columns, and tell the shard of the moved material its new index.
+	vector_removeFastAt(rep->materials, index);
+	quantityVec_removeFastAt(&rep->quantities, index);
+	intVec_removeFastAt(&rep->expSerials, index);
+	if (index < vector_length(rep->materials)) {
+		const Material* moved = vector_get(rep->materials, index);
+		MaterialShard* movedShard = matRepo_shard(rep, material_supplier(moved));
+		mutex_lock(&movedShard->lock);
+		intMap_get(&movedShard->positions, material_id(moved), &position);
+		*indexVec_at(&movedShard->indexes, position) = index;
+		mutex_unlock(&movedShard->lock);
+	}
+
+	return matRepo_timed(rep, REPO_DELETE_BY_ID, started, index);
+}
+
+size_t matRepo_shardOf(MaterialRepository* rep, const char* supplier)
+{
+	if (supplier == NULL)
+		return 0;
+
+	// FNV-1a hash of the supplier.
+	unsigned long hash = 2166136261ul;
+	for (size_t i = 0; supplier[i] != '\0'; ++i) {
+		hash ^= (unsigned char)supplier[i];
+		hash = (hash * 16777619ul) & 0xFFFFFFFFul;
 	}
 
-	return -3;
+	return hash % rep->shardCount;
+}
+
+const Vector* matRepo_getShardBySupplier(MaterialRepository* rep, const char* supplier)
+{
+	return matRepo_shard(rep, supplier)->materials;
+}
+
+void matRepo_lockShard(MaterialRepository* rep, size_t shard)
+{
+	mutex_lock(&rep->shards[shard].lock);
+}
+
+void matRepo_unlockShard(MaterialRepository* rep, size_t shard)
+{
+	mutex_unlock(&rep->shards[shard].lock);
+}
+
+size_t matRepo_completeName(MaterialRepository* rep, const char* prefix, Vector* v, size_t maxResults)
+{
+	long long started = matRepo_begin(rep, REPO_COMPLETE_NAME);
+	return matRepo_timed(rep, REPO_COMPLETE_NAME, started, trie_complete(rep->names, prefix ? prefix : "", v, maxResults));
+}
+
+size_t matRepo_completeSupplier(MaterialRepository* rep, const char* prefix, Vector* v, size_t maxResults)
+{
+	long long started = matRepo_begin(rep, REPO_COMPLETE_SUPPLIER);
+	return matRepo_timed(rep, REPO_COMPLETE_SUPPLIER, started, trie_complete(rep->suppliers, prefix ? prefix : "", v, maxResults));
 }
 
 int matRepo_getFreeid(MaterialRepository* rep)
 {
+	long long started = matRepo_begin(rep, REPO_GET_FREE_ID);
 	int id = 0;
-	for (size_t i = 0; i < vector_length(rep->materials); ++i) {
-		const Material* curMat = vector_get(rep->materials, i);
-		if (material_id(curMat) >= id)
-			id = material_id(curMat) + 1;
+	for (size_t i = 0; i < rep->shardCount; ++i) {
+		if (rep->shards[i].maxId >= id)
+			id = rep->shards[i].maxId + 1;
 	}
 
+	matRepo_end(rep, REPO_GET_FREE_ID, started);
 	return id;
 }
+
@@ -3,15 +3,55 @@
 
 #include "Material.h"
 #include "Vector.h"
+#include "StringTrie.h"
+#include "TypedVector.h"
+#include "LatencyRecorder.h"
+#include "IntMap.h"
+#include "Thread.h"
 #include <stdlib.h>
 
+// The number of supplier shards used by 'matRepo_create'.
+#define MAT_REPO_DEFAULT_SHARDS 16
+
+// A column of quantities (see 'VECTOR_DEFINE').
+VECTOR_DEFINE(Quantity, QuantityVector, quantityVec)
+
+// A list of indexes of the repository (see 'VECTOR_DEFINE').
+VECTOR_DEFINE(size_t, IndexVector, indexVec)
+
+// A supplier shard of a repository. It owns the materials of its suppliers, remembers the repository index of each of them,
+// and finds them by id through a map from ids to their positions in the shard.
+// The lock guards the shard and its materials (see 'matRepo_lockShard').
+typedef struct {
+	Vector* materials;
+	IndexVector indexes;
+	IntMap positions;
+	int maxId;
+	Mutex lock;
+} MaterialShard;
+
 // The internal data for a material repository.
 // Do not use the struct members directly. Instead, use only the methods that start with 'matRepo_'.
 // The repository must be initialized with 'matRepo_create' and destroyed with 'matRepo_destroy'.
 // If not specified otherwise, material repository pointer cannot be NULL in material repository methods.
+// Every material is owned by one of the supplier shards, chosen by hashing its supplier, so that queries scoped to a supplier
+// only go through the materials of that shard, and the lookups by id only ask the id map of each shard.
+// The main container keeps the materials in the order of their indexes, for the lookups by index and the columns.
+// The quantities and expiration date serials are also stored in contiguous columns, in the same order as the materials,
+// so that they can be scanned without touching the materials.
+// The distinct names and suppliers are kept in prefix tries, for autocomplete and prefix queries.
+// All of it (including the copies of the materials) is taken from the allocator given to 'matRepo_createWith'.
 typedef struct {
 	Vector* materials;
+	MaterialShard* shards;
+	size_t shardCount;
+	QuantityVector quantities;
+	IntVector expSerials;
+	StringTrie* names;
+	StringTrie* suppliers;
 	int(*validator)(const Material* mat);
+	const Allocator* allocator;
+	LatencyRecorder* latency;
 } MaterialRepository;
 
 // CONSTRUCTOR / DESTRUCTOR.
@@ -20,6 +60,12 @@ typedef struct {
 // The validator can be NULL (materials won't be validated), or a function returning 0 for failure.
 MaterialRepository* matRepo_create(int(*validator)(const Material* mat));
 
+// Initialize a repository that splits its materials in the given number of supplier shards (at least 1).
+MaterialRepository* matRepo_createSharded(int(*validator)(const Material* mat), size_t shardCount);
+
+// Initialize a sharded repository whose memory is taken from the given allocator (NULL means the default allocator).
+MaterialRepository* matRepo_createWith(int(*validator)(const Material* mat), size_t shardCount, const Allocator* allocator);
+
 // Release all repository resources and free the repository itself.
 // If repository is NULL, nothing happens.
 void matRepo_destroy(MaterialRepository* rep);
@@ -29,14 +75,40 @@ void matRepo_destroy(MaterialRepository* rep);
 // Returns the number of materials in the repository.
 size_t matRepo_matCount(MaterialRepository* rep);
 
+// Returns the quantities of the materials, in the order of their indexes. Valid until the repository is modified.
+const Quantity* matRepo_quantities(MaterialRepository* rep);
+
+// Returns the expiration dates of the materials as serial day numbers (see 'material_expSerial'), in the order of their indexes.
+// Valid until the repository is modified.
+const DateSerial* matRepo_expSerials(MaterialRepository* rep);
+
+// Returns the number of supplier shards.
+size_t matRepo_shardCount(MaterialRepository* rep);
+
+// Returns the number of materials in the shard with the given index, or 0 if the index is invalid.
+size_t matRepo_shardLength(MaterialRepository* rep, size_t shard);
+
+// Start (enabled 1) or stop (enabled 0) recording the latency of the saves, lookups and updates by id, deletions, completions
+// and free id searches, each in its own histogram. Stopping drops the recorded latencies. Returns 0 if tracking could not be started.
+// While tracking is off, every operation pays only for a pointer check.
+int matRepo_setLatencyTracking(MaterialRepository* rep, int enabled);
+
+// Returns the latencies recorded since tracking was started, or NULL if it is off.
+const LatencyRecorder* matRepo_latency(MaterialRepository* rep);
+
 // METHODS.
 
 // Saves a copy of the given material to the repository and returns the index.
 // If the operation fails, the return value is negative and the material is not saved.
-// If validation fails or material is NULL, the return value is -1.
+// If validation fails, material is NULL or the memory could not be allocated, the return value is -1.
 // If a material with the same id is found, returns -2.
 size_t matRepo_save(MaterialRepository* rep, const Material* mat);
 
+// Saves a copy of the given material like 'matRepo_save', but without looking for a material with the same id, so a bulk
+// load takes constant time per material. The caller must guarantee that the id is not in the repository yet.
+// If validation fails, material is NULL or the memory could not be allocated, the return value is -1.
+size_t matRepo_saveTrusted(MaterialRepository* rep, const Material* mat);
+
 // Returns the material with the specified id, or NULL if the material is not found.
 const Material* matRepo_getById(MaterialRepository* rep, int id);
 
@@ -44,8 +116,9 @@ const Material* matRepo_getById(MaterialRepository* rep, int id);
 const Material* matRepo_getByIndex(MaterialRepository* rep, size_t index);
 
 // Replaces the material with the same id with a copy of the new material and returns the index.
+// The material is updated in place: pointers to it (for example returned by 'matRepo_getById') stay valid.
 // If the operation fails, the return value is negative and the material is not updated.
-// If validation fails or material is NULL, the return value is -1.
+// If validation fails, material is NULL or the memory could not be allocated, the return value is -1.
 // If no material with the same id is found, returns -3.
 size_t matRepo_updateById(MaterialRepository* rep, const Material* newMat);
 
@@ -53,6 +126,28 @@ size_t matRepo_updateById(MaterialRepository* rep, const Material* newMat);
 // If the material is found, returns the old index, otherwise returns -3 and no deletion is performed.
 size_t matRepo_deleteById(MaterialRepository* rep, int id);
 
+// Returns the index of the shard holding the materials of the given supplier (supplier can be NULL).
+size_t matRepo_shardOf(MaterialRepository* rep, const char* supplier);
+
+// Returns the shard holding the materials of the given supplier. Do not modify the shard or its materials.
+// The shard might also contain materials of other suppliers, so check the supplier of each material.
+const Vector* matRepo_getShardBySupplier(MaterialRepository* rep, const char* supplier);
+
+// Lock or unlock the shard with the given index (see 'matRepo_shardOf').
+// The methods that change the repository lock the shards they change, so a thread holding the lock of a shard can read
+// the shard and its materials while another thread changes the repository. Nothing else is safe to read meanwhile:
+// the main container, the columns, the tries and the other shards are still changed without a lock.
+// The lock is not recursive: do not call the methods that change the repository while holding it.
+void matRepo_lockShard(MaterialRepository* rep, size_t shard);
+void matRepo_unlockShard(MaterialRepository* rep, size_t shard);
+
+// Saves in the given vector the distinct names (const char*) starting with the prefix, in alphabetical order, at most
+// 'maxResults' of them (0 means no limit), and returns how many were saved. Valid until the repository is modified.
+size_t matRepo_completeName(MaterialRepository* rep, const char* prefix, Vector* v, size_t maxResults);
+
+// Same as 'matRepo_completeName', but for suppliers.
+size_t matRepo_completeSupplier(MaterialRepository* rep, const char* prefix, Vector* v, size_t maxResults);
+
 // Returns an unused id.
 int matRepo_getFreeid(MaterialRepository* rep);
 
@@ -1,15 +1,261 @@
 #include "MaterialService.h"
+#include "Scan.h"
+#include "SpanTracer.h"
 #include <string.h>
-#include <time.h>
+
+// The operations whose latencies are recorded while tracking is on (see 'matServ_setLatencyTracking'), also traced as spans.
+typedef enum {
+	SERV_ADD,
+	SERV_UPDATE_BY_ID,
+	SERV_REMOVE_BY_ID,
+	SERV_GET_ALL,
+	SERV_UNDO,
+	SERV_REDO,
+	SERV_ADD_OR_UPDATE_BY_NSE,
+	SERV_FIND_BY_NSE,
+	SERV_UPDATE_BY_NSE,
+	SERV_REMOVE_BY_NSE,
+	SERV_COMMIT_BATCH,
+	SERV_QUERY,
+	SERV_FUZZY_SEARCH,
+	SERV_TICK,
+	SERV_GET_EXPIRED,
+	SERV_GET_LOW_STOCK,
+	SERV_PAST_EXP,
+	SERV_OPERATION_COUNT
+} ServiceOperation;
+
+static const char* const SERV_OPERATION_NAMES[SERV_OPERATION_COUNT] = {
+	"add",
+	"update_by_id",
+	"remove_by_id",
+	"get_all",
+	"undo",
+	"redo",
+	"add_or_update_by_nse",
+	"find_by_nse",
+	"update_by_nse",
+	"remove_by_nse",
+	"commit_batch",
+	"query",
+	"fuzzy_search",
+	"tick",
+	"get_expired",
+	"get_low_stock",
+	"past_exp",
+};
+
+// A registered observer.
+typedef struct {
+	MaterialObserver callback;
+	void* context;
+} MaterialObserverEntry;
+
+// Writes the call to the trace, if one is set.
+static void matServ_record(MaterialService* serv, const TraceRecord* rec)
+{
+	if (serv->trace)
+		traceWriter_write(serv->trace, rec);
+}
+
+// Stops recording until the caller sets 'serv->trace' back to the returned writer,
+// so the public methods used by a recorded call are not recorded again.
+static TraceWriter* matServ_pauseTrace(MaterialService* serv)
+{
+	TraceWriter* trace = serv->trace;
+	serv->trace = NULL;
+	return trace;
+}
+
+// Starts the span of an operation and returns the time it started, for 'matServ_end' (0 if latencies are not tracked).
+static long long matServ_begin(MaterialService* serv, ServiceOperation op)
+{
+	// The operation only names the span, which is not compiled in without MAT_SPANS.
+	(void)op;
+	SPAN_BEGIN(SERV_OPERATION_NAMES[op]);
+	return latency_start(serv->latency);
+}
+
+// Records the latency of an operation started by 'matServ_begin' and ends its span.
+static void matServ_end(MaterialService* serv, ServiceOperation op, long long started)
+{
+	latency_stop(serv->latency, op, started);
+	SPAN_END();
+}
+
+// Ends an operation like 'matServ_end' and returns its result.
+static int matServ_timed(MaterialService* serv, ServiceOperation op, long long started, int result)
+{
+	matServ_end(serv, op, started);
+	return result;
+}
+
+// Calls all the observers after a change of the repository.
+static void matServ_notify(MaterialService* serv, const Material* oldMat, const Material* newMat)
+{
+	for (size_t i = 0; i < vector_length(serv->observers); ++i) {
+		MaterialObserverEntry* entry = vector_get(serv->observers, i);
+		entry->callback(entry->context, oldMat, newMat);
+	}
+}
+
+// Returns 1 if the predicate can be evaluated on the columns of the repository, 0 otherwise.
+static int matServ_isColumnPredicate(const QueryPredicate* pred)
+{
+	return pred->type == QUANTITY_AT_MOST || pred->type == QUANTITY_GREATER || pred->type == EXPIRES_BEFORE || pred->type == EXPIRES_FROM;
+}
+
+// Returns 1 if the prefix tries show that no material can satisfy one of the string conditions of the query.
+// Temporaries are allocated from the given arena (can be NULL).
+static int matServ_isEmptyQuery(MaterialService* serv, const MaterialQuery* q, Arena* arena)
+{
+	Vector* found = vector_createInArena(arena, 1);
+	int empty = 0;
+	for (size_t i = 0; i < matQuery_predicateCount(q) && !empty; ++i) {
+		const QueryPredicate* pred = matQuery_predicate(q, i);
+		if (pred->type == NAME_STARTS_WITH)
+			empty = matRepo_completeName(serv->repository, pred->text, found, 1) == 0;
+		else if (pred->type == SUPPLIER_STARTS_WITH)
+			empty = matRepo_completeSupplier(serv->repository, pred->text, found, 1) == 0;
+		vector_clear(found);
+	}
+
+	vector_destroy(found);
+	return empty;
+}
+
+// Cursor filter accepting the materials whose name contains the string given as context.
+static int matServ_nameContains(void* context, const Material* mat)
+{
+	return strstr(material_name(mat), context) != NULL;
+}
+
+// A material found by the fuzzy search, with its distance and position, so that results can be sorted.
+typedef struct {
+	const Material* mat;
+	int distance;
+	size_t index;
+} FuzzyResult;
+
+VECTOR_DEFINE(FuzzyResult, FuzzyResultVector, fuzzyVec)
+
+// Compares two fuzzy results (FuzzyResult*) by distance, then by index.
+static int matServ_compareFuzzyResults(void* context, const void* a, const void* b)
+{
+	(void)context;
+	const FuzzyResult* x = a;
+	const FuzzyResult* y = b;
+	if (x->distance != y->distance)
+		return x->distance < y->distance ? -1 : 1;
+	return (x->index > y->index) - (x->index < y->index);
+}
+
+// Swaps two elements of the vector.
+static void matServ_swapResults(Vector* v, size_t i, size_t j)
+{
+	void* temp = vector_get(v, i);
+	vector_set(v, i, vector_get(v, j));
+	vector_set(v, j, temp);
+}
+
+// Moves the element on the specified index down the heap of the first 'length' results.
+// The heap keeps on top the result that comes last in the order of the query.
+static void matServ_heapSiftDown(const MaterialQuery* q, Vector* v, size_t index, size_t length)
+{
+	for (;;) {
+		size_t last = index, left = 2 * index + 1, right = 2 * index + 2;
+		if (left < length && matQuery_compare(q, vector_get(v, left), vector_get(v, last)) > 0)
+			last = left;
+		if (right < length && matQuery_compare(q, vector_get(v, right), vector_get(v, last)) > 0)
+			last = right;
+		if (last == index)
+			return;
+
+		matServ_swapResults(v, index, last);
+		index = last;
+	}
+}
+
+// Moves the last result up the heap of results.
+static void matServ_heapSiftUp(const MaterialQuery* q, Vector* v)
+{
+	for (size_t index = vector_length(v) - 1; index > 0; ) {
+		size_t parent = (index - 1) / 2;
+		if (matQuery_compare(q, vector_get(v, index), vector_get(v, parent)) <= 0)
+			return;
+
+		matServ_swapResults(v, index, parent);
+		index = parent;
+	}
+}
+
+// Returns 1 if the results are collected in a bounded heap (the query is ordered or paginated and has a limit).
+static int matServ_collectsInHeap(const MaterialQuery* q)
+{
+	return matQuery_limit(q) > 0 && (matQuery_sortKey(q) != SORT_NONE || matQuery_after(q) != NULL);
+}
+
+// Adds a material that passed the filters of the query to the results, keeping only the best ones when there is a limit.
+// Returns 0 if no other material can change the results, so the scan can stop, 1 otherwise.
+static int matServ_collect(const MaterialQuery* q, Vector* v, const Material* mat)
+{
+	size_t limit = matQuery_limit(q);
+
+	if (matQuery_after(q) != NULL && matQuery_compare(q, mat, matQuery_after(q)) <= 0)
+		return 1;
+
+	if (!matServ_collectsInHeap(q)) {
+		vector_add(v, (void*)mat);
+		return limit == 0 || vector_length(v) < limit;
+	}
+
+	// Keep the best 'limit' results in a heap, with the worst of them on top: O(n log limit) for the whole scan.
+	if (vector_length(v) < limit) {
+		vector_add(v, (void*)mat);
+		matServ_heapSiftUp(q, v);
+	}
+	else if (matQuery_compare(q, mat, vector_get(v, 0)) < 0) {
+		vector_set(v, 0, (void*)mat);
+		matServ_heapSiftDown(q, v, 0, limit);
+	}
+
+	return 1;
+}
+
+// Compares two results by the order of the query given as context. Used with 'vector_sort'.
+static int matServ_compareResults(void* context, const void* a, const void* b)
+{
+	return matQuery_compare(context, a, b);
+}
 
 // Constructor / Destructor.
 MaterialService* matServ_create(MaterialRepository* repository)
 {
-	MaterialService* serv = calloc(1, sizeof(MaterialService));
+	return matServ_createWith(repository, NULL);
+}
+
+MaterialService* matServ_createWith(MaterialRepository* repository, const Allocator* allocator)
+{
+	MaterialService* serv = allocator_calloc(allocator, 1, sizeof(MaterialService));
 	if (serv) {
 		serv->repository = repository;
-		serv->undoStack = vector_create(0);
-		serv->redoStack = vector_create(0);
+		serv->allocator = allocator;
+		opVec_initWith(&serv->undoStack, allocator);
+		opVec_initWith(&serv->redoStack, allocator);
+		serv->observers = vector_createWith(allocator, 0);
+		serv->views = matViews_create(repository);
+		serv->stats = matStats_create();
+		serv->clock = date_today;
+		serv->expiry = matExpiry_create(serv->clock());
+		matServ_addObserver(serv, matViews_onChange, serv->views);
+		matServ_addObserver(serv, matStats_onChange, serv->stats);
+		matServ_addObserver(serv, matExpiry_onChange, serv->expiry);
+
+		// Count and schedule the materials already in the repository.
+		for (size_t i = 0; i < matRepo_matCount(repository); ++i) {
+			matStats_onChange(serv->stats, NULL, matRepo_getByIndex(repository, i));
+			matExpiry_onChange(serv->expiry, NULL, matRepo_getByIndex(repository, i));
+		}
 	}
 
 	return serv;
@@ -20,15 +266,23 @@ void matServ_destroy(MaterialService* serv)
 	if (serv == NULL)
 		return;
 
-	for (size_t i = 0; i < vector_length(serv->undoStack); ++i)
-		matOp_destroy(vector_get(serv->undoStack, i));
+	for (size_t i = 0; i < opVec_length(&serv->undoStack); ++i)
+		matOp_release(opVec_at(&serv->undoStack, i));
 
-	for (size_t i = 0; i < vector_length(serv->redoStack); ++i)
-		matOp_destroy(vector_get(serv->redoStack, i));
+	for (size_t i = 0; i < opVec_length(&serv->redoStack); ++i)
+		matOp_release(opVec_at(&serv->redoStack, i));
 
-	vector_destroy(serv->undoStack);
-	vector_destroy(serv->redoStack);
-	free(serv);
+	for (size_t i = 0; i < vector_length(serv->observers); ++i)
+		allocator_free(serv->allocator, vector_get(serv->observers, i));
+
+	opVec_free(&serv->undoStack);
+	opVec_free(&serv->redoStack);
+	vector_destroy(serv->observers);
+	matViews_destroy(serv->views);
+	matStats_destroy(serv->stats);
+	matExpiry_destroy(serv->expiry);
+	latency_destroy(serv->latency);
+	allocator_free(serv->allocator, serv);
 }
 
 // Properties.
@@ -37,11 +291,84 @@ size_t matServ_matCount(MaterialService* serv)
 	return matRepo_matCount(serv->repository);
 }
 
+int matServ_isLoading(const MaterialService* serv)
+{
+	return serv->loading;
+}
+
+void matServ_setClock(MaterialService* serv, Date(*clock)())
+{
+	serv->clock = clock;
+
+	// The scheduler starts again from the day of the new clock.
+	matExpiry_reset(serv->expiry, serv->repository, clock());
+}
+
+void matServ_setTrace(MaterialService* serv, TraceWriter* trace)
+{
+	serv->trace = trace;
+}
+
+int matServ_setLatencyTracking(MaterialService* serv, int enabled)
+{
+	if (!enabled) {
+		latency_destroy(serv->latency);
+		serv->latency = NULL;
+	}
+	else if (serv->latency == NULL)
+		serv->latency = latency_create(SERV_OPERATION_NAMES, SERV_OPERATION_COUNT);
+
+	int started = !enabled || serv->latency != NULL;
+	return matRepo_setLatencyTracking(serv->repository, enabled) && started;
+}
+
+const LatencyRecorder* matServ_latency(MaterialService* serv)
+{
+	return serv->latency;
+}
+
+int matServ_writeLatency(MaterialService* serv, FILE* out)
+{
+	if (serv->latency == NULL)
+		return 0;
+
+	latency_write(serv->latency, out, "Service operations:");
+	if (matRepo_latency(serv->repository) != NULL) {
+		fprintf(out, "\n");
+		latency_write(matRepo_latency(serv->repository), out, "Repository operations:");
+	}
+	return 1;
+}
+
+// Observers.
+void matServ_addObserver(MaterialService* serv, MaterialObserver observer, void* context)
+{
+	MaterialObserverEntry* entry = allocator_calloc(serv->allocator, 1, sizeof(MaterialObserverEntry));
+	if (entry) {
+		entry->callback = observer;
+		entry->context = context;
+		vector_add(serv->observers, entry);
+	}
+}
+
+void matServ_removeObserver(MaterialService* serv, MaterialObserver observer, void* context)
+{
+	for (size_t i = 0; i < vector_length(serv->observers); ++i) {
+		MaterialObserverEntry* entry = vector_get(serv->observers, i);
+		if (entry->callback == observer && entry->context == context) {
+			vector_removeAt(serv->observers, i);
+			allocator_free(serv->allocator, entry);
+			return;
+		}
+	}
+}
+
 // CRUD Operations.
-int matServ_add(MaterialService* serv, int id, const char* name, const char* supplier, float quantity, Date exp_date, int undoable)
+int matServ_add(MaterialService* serv, int id, const char* name, const char* supplier, Quantity quantity, Date exp_date, int undoable)
 {
+	long long started = matServ_begin(serv, SERV_ADD);
 	if (matServ_findByNSE(serv, name, supplier, exp_date) != NULL)
-		return -5;
+		return matServ_timed(serv, SERV_ADD, started, -5);
 
 	if (id == -1)
 		id = matRepo_getFreeid(serv->repository);
@@ -50,11 +377,26 @@ int matServ_add(MaterialService* serv, int id, const char* name, const char* sup
 	int res = (int)matRepo_save(serv->repository, mat);
 	if (res >= 0 && undoable)
 		matServ_addUndoOperation(serv, REMOVE, mat);
+	if (res >= 0)
+		matServ_notify(serv, NULL, matRepo_getByIndex(serv->repository, res));
 	material_destroy(mat);
 
 	if (res < 0)
-		return res;
-	return id;
+		return matServ_timed(serv, SERV_ADD, started, res);
+	return matServ_timed(serv, SERV_ADD, started, id);
+}
+
+int matServ_load(MaterialService* serv, const Material* mat)
+{
+	long long started = matServ_begin(serv, SERV_ADD);
+	int res = (int)matRepo_saveTrusted(serv->repository, mat);
+	if (res < 0)
+		return matServ_timed(serv, SERV_ADD, started, res);
+
+	serv->loading = 1;
+	matServ_notify(serv, NULL, matRepo_getByIndex(serv->repository, res));
+	serv->loading = 0;
+	return matServ_timed(serv, SERV_ADD, started, material_id(mat));
 }
 
 const Material* matServ_findById(MaterialService* serv, int id)
@@ -62,16 +404,19 @@ const Material* matServ_findById(MaterialService* serv, int id)
 	return matRepo_getById(serv->repository, id);
 }
 
-int matServ_updateById(MaterialService* serv, int id, const char* name, const char* supplier, float quantity, Date exp_date, Material* oldMat, int undoable)
+int matServ_updateById(MaterialService* serv, int id, const char* name, const char* supplier, Quantity quantity, Date exp_date, Material* oldMat, int undoable)
 {
+	long long started = matServ_begin(serv, SERV_UPDATE_BY_ID);
 	const Material *curMat = matServ_findById(serv, id);
 	if (curMat == NULL)
-		return -3;
+		return matServ_timed(serv, SERV_UPDATE_BY_ID, started, -3);
 	
 	Material* curMatCopy = material_duplicate(curMat);
 	Material* newMat = material_construct(id, name, supplier, quantity, exp_date);
 
 	int res = (int)matRepo_updateById(serv->repository, newMat);
+	if (res >= 0)
+		matServ_notify(serv, curMatCopy, matRepo_getByIndex(serv->repository, res));
 	if (res > 0)
 		res = 0;
 
@@ -83,21 +428,28 @@ int matServ_updateById(MaterialService* serv, int id, const char* name, const ch
 
 	material_destroy(curMatCopy);
 	material_destroy(newMat);
-	return res;
+	return matServ_timed(serv, SERV_UPDATE_BY_ID, started, res);
 }
 
 int matServ_removeById(MaterialService* serv, int id, Material* remMat, int undoable)
 {
+	long long started = matServ_begin(serv, SERV_REMOVE_BY_ID);
 	const Material* mat = matServ_findById(serv, id);
 	if (mat == NULL)
-		return -3;
+		return matServ_timed(serv, SERV_REMOVE_BY_ID, started, -3);
 
+	// The copy outlives the stored material: the observers and the undo operation get it.
 	Material* matCopy = material_duplicate(mat);
+	if (matCopy == NULL)
+		return matServ_timed(serv, SERV_REMOVE_BY_ID, started, -1);
 
 	int res = (int)matRepo_deleteById(serv->repository, id);
 	if (res > 0)
 		res = 0;
 
+	if (res >= 0)
+		matServ_notify(serv, matCopy, NULL);
+
 	if (res >= 0 && undoable)
 		matServ_addUndoOperation(serv, ADD, matCopy);
 
@@ -105,28 +457,67 @@ int matServ_removeById(MaterialService* serv, int id, Material* remMat, int undo
 		material_set(remMat, matCopy);
 
 	material_destroy(matCopy);
-	return res;
+	return matServ_timed(serv, SERV_REMOVE_BY_ID, started, res);
 }
 
 void matServ_getAll(MaterialService* serv, Vector* v)
 {
-	for (size_t i = 0; i < matRepo_matCount(serv->repository); ++i) {
-		const Material* mat = matRepo_getByIndex(serv->repository, i);
+	matServ_record(serv, &(TraceRecord) { .call = TRACE_GET_ALL });
+	TraceWriter* trace = matServ_pauseTrace(serv);
+	long long started = matServ_begin(serv, SERV_GET_ALL);
+	vector_reserve(v, vector_length(v) + matRepo_matCount(serv->repository));
+
+	MaterialCursor cur = matServ_cursorAll(serv);
+	for (const Material* mat = matCursor_next(&cur); mat != NULL; mat = matCursor_next(&cur))
 		vector_add(v, (void*)mat);
+	matServ_end(serv, SERV_GET_ALL, started);
+	serv->trace = trace;
+}
+
+// Cursors.
+MaterialCursor matServ_cursorAll(MaterialService* serv)
+{
+	matServ_record(serv, &(TraceRecord) { .call = TRACE_CURSOR_ALL });
+	return matCursor_overRepository(serv->repository);
+}
+
+MaterialCursor matServ_cursorExpired(MaterialService* serv, const char* optStr)
+{
+	matServ_record(serv, &(TraceRecord) { .call = TRACE_CURSOR_EXPIRED, .text = optStr });
+	MaterialCursor cur = matCursor_overVector(matViews_expired(serv->views, serv->clock()));
+	if (optStr != NULL && optStr[0] != '\0')
+		matCursor_filter(&cur, matServ_nameContains, (void*)optStr);
+	return cur;
+}
+
+MaterialCursor matServ_cursorQuery(MaterialService* serv, const MaterialQuery* q)
+{
+	matServ_record(serv, &(TraceRecord) { .call = TRACE_CURSOR_QUERY, .query = q });
+	MaterialCursor cur = matCursor_overRepository(serv->repository);
+	for (size_t i = 0; i < matQuery_predicateCount(q); ++i) {
+		const QueryPredicate* pred = matQuery_predicate(q, i);
+		if (pred->type == SUPPLIER_IS) {
+			cur = matCursor_overVector(matRepo_getShardBySupplier(serv->repository, pred->text));
+			break;
+		}
 	}
+
+	matCursor_where(&cur, q);
+	return cur;
 }
 
 // Undo / Redo.
 void matServ_addUndoOperation(MaterialService* serv, OperationType type, const Material* mat)
 {
 	// Clear redo stack.
-	for (size_t i = 0; i < vector_length(serv->redoStack); ++i)
-		matOp_destroy(vector_get(serv->redoStack, i));
-	vector_clear(serv->redoStack);
+	for (size_t i = 0; i < opVec_length(&serv->redoStack); ++i)
+		matOp_release(opVec_at(&serv->redoStack, i));
+	opVec_clear(&serv->redoStack);
 
 	// Add the undo operation.
-	MaterialOperation* op = matOp_construct(type, mat);
-	vector_add(serv->undoStack, op);
+	MaterialOperation op;
+	if (!matOp_initWith(&op, serv->allocator, type, mat) || !opVec_add(&serv->undoStack, op))
+		matOp_release(&op);
 }
 
 int matServ_performOperation(MaterialService* serv, const MaterialOperation* op, MaterialOperation* revOp)
@@ -134,187 +525,532 @@ int matServ_performOperation(MaterialService* serv, const MaterialOperation* op,
 	OperationType type = matOp_type(op);
 	const Material* mat = matOp_material(op);
 
-	MaterialOperation* result = matOp_create();
-	Material* revOpMat = material_create();
+	// The reverse operation is built on the stack; only strings too long to be stored inline are allocated.
+	Material revOpMat;
+	material_init(&revOpMat, serv->allocator);
+	OperationType revType = NONE;
+	const Material* revMat = NULL;
 	int exCode = 0;
 
 	if (type == ADD) {
 		exCode = matServ_add(serv, material_id(mat), material_name(mat), material_supplier(mat), material_quantity(mat), material_expDate(mat), 0);
-		matOp_setTypeAndMaterial(result, REMOVE, mat);
+		revType = REMOVE;
+		revMat = mat;
 	}
 	else if (type == UPDATE) {
-		exCode = matServ_updateById(serv, material_id(mat), material_name(mat), material_supplier(mat), material_quantity(mat), material_expDate(mat), revOpMat, 0);
-		matOp_setTypeAndMaterial(result, UPDATE, revOpMat);
+		exCode = matServ_updateById(serv, material_id(mat), material_name(mat), material_supplier(mat), material_quantity(mat), material_expDate(mat), &revOpMat, 0);
+		revType = UPDATE;
+		revMat = &revOpMat;
 	}
 	else if (type == REMOVE) {
-		exCode = matServ_removeById(serv, material_id(mat), revOpMat, 0);
-		matOp_setTypeAndMaterial(result, ADD, revOpMat);
+		exCode = matServ_removeById(serv, material_id(mat), &revOpMat, 0);
+		revType = ADD;
+		revMat = &revOpMat;
 	}
 
-	if (revOp)
-		matOp_setTypeAndMaterial(revOp, matOp_type(result), matOp_material(result));
+	if (revOp && exCode >= 0)
+		matOp_setTypeAndMaterial(revOp, revType, revMat);
+	else if (revOp)
+		matOp_setToNone(revOp);
 
-	material_destroy(revOpMat);
-	matOp_destroy(result);
+	material_release(&revOpMat);
 	return exCode;
 }
 
 int matServ_undo(MaterialService* serv)
 {
-	if (vector_length(serv->undoStack) == 0)
-		return 0;
+	matServ_record(serv, &(TraceRecord) { .call = TRACE_UNDO });
+	long long started = matServ_begin(serv, SERV_UNDO);
+	if (opVec_length(&serv->undoStack) == 0)
+		return matServ_timed(serv, SERV_UNDO, started, 0);
 
-	MaterialOperation* op = vector_get(serv->undoStack, vector_length(serv->undoStack) - 1);
-	MaterialOperation* revOp = matOp_create();
-	matServ_performOperation(serv, op, revOp);
-	vector_add(serv->redoStack, revOp);
-	vector_removeAt(serv->undoStack, vector_length(serv->undoStack) - 1);
-	matOp_destroy(op);
-	return 1;
+	MaterialOperation op = opVec_removeLast(&serv->undoStack);
+	MaterialOperation revOp;
+	matOp_initWith(&revOp, serv->allocator, NONE, NULL);
+	int result = matServ_performOperation(serv, &op, &revOp);
+	if (matOp_type(&revOp) == NONE || !opVec_add(&serv->redoStack, revOp))
+		matOp_release(&revOp);
+	matOp_release(&op);
+	return matServ_timed(serv, SERV_UNDO, started, result >= 0);
 }
 
 int matServ_redo(MaterialService* serv)
 {
-	if (vector_length(serv->redoStack) == 0)
-		return 0;
+	matServ_record(serv, &(TraceRecord) { .call = TRACE_REDO });
+	long long started = matServ_begin(serv, SERV_REDO);
+	if (opVec_length(&serv->redoStack) == 0)
+		return matServ_timed(serv, SERV_REDO, started, 0);
 
-	MaterialOperation* op = vector_get(serv->redoStack, vector_length(serv->redoStack) - 1);
-	MaterialOperation* revOp = matOp_create();
-	matServ_performOperation(serv, op, revOp);
-	vector_add(serv->undoStack, revOp);
-	vector_removeAt(serv->redoStack, vector_length(serv->redoStack) - 1);
-	matOp_destroy(op);
-	return 1;
+	MaterialOperation op = opVec_removeLast(&serv->redoStack);
+	MaterialOperation revOp;
+	matOp_initWith(&revOp, serv->allocator, NONE, NULL);
+	int result = matServ_performOperation(serv, &op, &revOp);
+	if (matOp_type(&revOp) == NONE || !opVec_add(&serv->undoStack, revOp))
+		matOp_release(&revOp);
+	matOp_release(&op);
+	return matServ_timed(serv, SERV_REDO, started, result >= 0);
 }
 
 // Methods.
-int matServ_addOrUpdateByNSE(MaterialService* serv, int id, const char* name, const char* supplier, float quantity, Date exp_date, Material* oldMat)
+int matServ_addOrUpdateByNSE(MaterialService* serv, int id, const char* name, const char* supplier, Quantity quantity, Date exp_date, Material* oldMat)
 {
+	matServ_record(serv, &(TraceRecord) { .call = TRACE_ADD_OR_UPDATE, .id = id, .name = name, .supplier = supplier, .quantity = quantity, .date = exp_date });
+	TraceWriter* trace = matServ_pauseTrace(serv);
+	long long started = matServ_begin(serv, SERV_ADD_OR_UPDATE_BY_NSE);
 	const Material* curMat = matServ_findByNSE(serv, name, supplier, exp_date);
+	int result;
 
 	if (curMat == NULL) {
 		if (oldMat != NULL)
 			material_id_set(oldMat, -1);
-		return matServ_add(serv, id, name, supplier, quantity, exp_date, 1);
+		result = matServ_add(serv, id, name, supplier, quantity, exp_date, 1);
 	}
-	else
-		return matServ_updateByNSE(serv, name, supplier, material_quantity(curMat) + quantity, exp_date, oldMat);
+	else {
+		// A quantity too big to be valid is kept as it is, so that the sum cannot overflow and the update fails the validation.
+		Quantity total = quantity > QUANTITY_MAX ? quantity : material_quantity(curMat) + quantity;
+		result = matServ_updateByNSE(serv, name, supplier, total, exp_date, oldMat);
+	}
+
+	serv->trace = trace;
+	return matServ_timed(serv, SERV_ADD_OR_UPDATE_BY_NSE, started, result);
 }
 
 const Material* matServ_findByNSE(MaterialService* serv, const char* name, const char* supplier, Date exp_date)
 {
-	for (size_t i = 0; i < matRepo_matCount(serv->repository); ++i) {
-		const Material* mat = matRepo_getByIndex(serv->repository, i);
+	long long started = matServ_begin(serv, SERV_FIND_BY_NSE);
+	const Material* found = NULL;
+	DateSerial serial = date_serial(exp_date);
+	const Vector* shard = matRepo_getShardBySupplier(serv->repository, supplier);
+	for (size_t i = 0; i < vector_length(shard) && found == NULL; ++i) {
+		const Material* mat = vector_get(shard, i);
 		if (strcmp(material_name(mat), name) == 0 &&
 			strcmp(material_supplier(mat), supplier) == 0 &&
-			material_expDate(mat).year == exp_date.year &&
-			material_expDate(mat).month == exp_date.month &&
-			material_expDate(mat).day == exp_date.day)
+			material_expSerial(mat) == serial)
 		{
-			return mat;
+			found = mat;
 		}
 	}
 
-	return NULL;
+	matServ_end(serv, SERV_FIND_BY_NSE, started);
+	return found;
 }
 
-int matServ_updateByNSE(MaterialService* serv, const char* name, const char* supplier, float quantity, Date exp_date, Material* oldMat)
+int matServ_updateByNSE(MaterialService* serv, const char* name, const char* supplier, Quantity quantity, Date exp_date, Material* oldMat)
 {
+	matServ_record(serv, &(TraceRecord) { .call = TRACE_UPDATE, .name = name, .supplier = supplier, .quantity = quantity, .date = exp_date });
+	long long started = matServ_begin(serv, SERV_UPDATE_BY_NSE);
 	const Material* curMat = matServ_findByNSE(serv, name, supplier, exp_date);
 	if (curMat == NULL)
-		return -4;
+		return matServ_timed(serv, SERV_UPDATE_BY_NSE, started, -4);
 
 	int oldId = material_id(curMat);
 	int result = matServ_updateById(serv, material_id(curMat), name, supplier, quantity, exp_date, oldMat, 1);
 
 	if (result < 0)
-		return result;
-	return oldId;
+		return matServ_timed(serv, SERV_UPDATE_BY_NSE, started, result);
+	return matServ_timed(serv, SERV_UPDATE_BY_NSE, started, oldId);
 }
 
 int matServ_removeByNSE(MaterialService* serv, const char* name, const char* supplier, Date exp_date, Material* remMat)
 {
+	matServ_record(serv, &(TraceRecord) { .call = TRACE_REMOVE, .name = name, .supplier = supplier, .date = exp_date });
+	long long started = matServ_begin(serv, SERV_REMOVE_BY_NSE);
 	const Material* curMat = matServ_findByNSE(serv, name, supplier, exp_date);
 	if (curMat == NULL)
-		return -4;
+		return matServ_timed(serv, SERV_REMOVE_BY_NSE, started, -4);
 
 	int remId = material_id(curMat);
 	int result = matServ_removeById(serv, material_id(curMat), remMat, 1);
 
 	if (result < 0)
-		return result;
-	return remId;
+		return matServ_timed(serv, SERV_REMOVE_BY_NSE, started, result);
+	return matServ_timed(serv, SERV_REMOVE_BY_NSE, started, remId);
 }
 
-void matServ_get_materials_past_exp(MaterialService* serv, Vector* v, const char* optStr)
+// Applies a write of a batch like the matching 'matServ_*ByNSE' method and returns its result.
+static int matServ_applyWrite(MaterialService* serv, OperationType type, const Material* mat)
 {
-	if (vector_length(v) > 0)
-		return;
+	if (type == ADD)
+		return matServ_addOrUpdateByNSE(serv, material_id(mat), material_name(mat), material_supplier(mat), material_quantity(mat), material_expDate(mat), NULL);
+	if (type == UPDATE)
+		return matServ_updateByNSE(serv, material_name(mat), material_supplier(mat), material_quantity(mat), material_expDate(mat), NULL);
+	if (type == REMOVE)
+		return matServ_removeByNSE(serv, material_name(mat), material_supplier(mat), material_expDate(mat), NULL);
+	return -1;
+}
 
-	time_t seconds = time(NULL);
-	struct tm* current_time = localtime(&seconds);
-	int curYear = current_time->tm_year + 1900;
-	int curMonth = current_time->tm_mon + 1;
-	int curDay = current_time->tm_mday;
+size_t matServ_commitBatch(MaterialService* serv, MaterialBatch* batch)
+{
+	size_t pending = matBatch_pendingCount(batch);
+	if (pending == 0)
+		return 0;
 
-	if (optStr != NULL && strlen(optStr) == 0)
-		optStr = NULL;
+	long long started = matServ_begin(serv, SERV_COMMIT_BATCH);
+	// Make room for the undo operations of the whole batch at once, instead of growing the undo stack for each write.
+	opVec_reserve(&serv->undoStack, opVec_length(&serv->undoStack) + pending);
+
+	size_t succeeded = 0;
+	for (size_t i = matBatch_length(batch) - pending; i < matBatch_length(batch); ++i) {
+		const MaterialOperation* op = matBatch_operation(batch, i);
+		int result = matServ_applyWrite(serv, matOp_type(op), matOp_material(op));
+		matBatch_acknowledge(batch, result);
+		if (result >= 0)
+			++succeeded;
+	}
 
-	matServ_getAll(serv, v);
+	matServ_end(serv, SERV_COMMIT_BATCH, started);
+	return succeeded;
+}
 
-	for (size_t i = vector_length(v); i-- > 0; ) {
-		const Material* mat = vector_get(v, i);
-		int expYear = material_expDate(mat).year, expMonth = material_expDate(mat).month, expDay = material_expDate(mat).day;
+size_t matServ_applyWrites(MaterialService* serv, MaterialWrite* writes, size_t count)
+{
+	if (count == 0)
+		return 0;
 
-		int expired = (expYear < curYear || (expYear == curYear && expMonth < curMonth) || (expYear == curYear && expMonth == curMonth && expDay < curDay));
-		int containsString = (optStr == NULL || strstr(material_name(mat), optStr) != NULL);
+	long long started = matServ_begin(serv, SERV_COMMIT_BATCH);
+	opVec_reserve(&serv->undoStack, opVec_length(&serv->undoStack) + count);
 
-		if (!expired || !containsString)
-			vector_removeFastAt(v, i);
+	size_t succeeded = 0;
+	for (size_t i = 0; i < count; ++i) {
+		writes[i].result = matServ_applyWrite(serv, writes[i].type, writes[i].mat);
+		if (writes[i].result >= 0)
+			++succeeded;
 	}
+
+	matServ_end(serv, SERV_COMMIT_BATCH, started);
+	return succeeded;
 }
 
-void matServ_getMaterialsSortedByQuantity(MaterialService* serv, Vector* v)
+void matServ_selectExpired(MaterialService* serv, Bitmap* result)
 {
-	matServ_getAll(serv, v);
+	MaterialRepository* repo = serv->repository;
+	scan_intsLess(matRepo_expSerials(repo), matRepo_matCount(repo), date_serialCeil(serv->clock()), result);
+}
 
-	for (size_t i = 1; i < vector_length(v); ++i) {
-		for (size_t j = i; j >= 1; --j) {
-			const Material* leftMat = vector_get(v, j - 1);
-			const Material* rightMat = vector_get(v, j);
+void matServ_selectQuantityAtMost(MaterialService* serv, Quantity max_quantity, Bitmap* result)
+{
+	MaterialRepository* repo = serv->repository;
+	scan_longsAtMost(matRepo_quantities(repo), matRepo_matCount(repo), max_quantity, result);
+}
 
-			if (material_quantity(leftMat) > material_quantity(rightMat)) {
-				void* temp = vector_get(v, j);
-				vector_set(v, j, vector_get(v, j - 1));
-				vector_set(v, j - 1, temp);
-			}
-			else break;
-		}
+QueryPlan matServ_planQuery(MaterialService* serv, const MaterialQuery* q)
+{
+	// The plan depends only on the query for now; the service is there for plans that look at the catalog.
+	(void)serv;
+	QueryPlan plan = FULL_SCAN;
+	for (size_t i = 0; i < matQuery_predicateCount(q); ++i) {
+		const QueryPredicate* pred = matQuery_predicate(q, i);
+		if (pred->type == SUPPLIER_IS)
+			return SHARD_SCAN;
+		if (matServ_isColumnPredicate(pred))
+			plan = COLUMN_SCAN;
 	}
+
+	return plan;
 }
 
-void matServ_getMaterialsFromSupplierInShortSupply(MaterialService* serv, Vector* v, const char* supplier, float max_quantity)
+// Runs the query for 'matServ_query'.
+static void matServ_runQuery(MaterialService* serv, const MaterialQuery* q, Vector* v)
 {
-	matServ_getAll(serv, v);
+	if (vector_length(v) > 0 || matQuery_failed(q))
+		return;
 
-	for (size_t i = vector_length(v); i-- > 0; ) {
-		const Material* mat = matRepo_getByIndex(serv->repository, i);
-		if (strcmp(material_supplier(mat), supplier) != 0 || material_quantity(mat) > max_quantity)
-			vector_removeFastAt(v, i);
+	MaterialRepository* repo = serv->repository;
+	QueryPlan plan = matServ_planQuery(serv, q);
+	if (matServ_isEmptyQuery(serv, q, vector_arena(v)))
+		return;
+
+	if (plan == SHARD_SCAN) {
+		const char* supplier = NULL;
+		for (size_t i = 0; supplier == NULL; ++i) {
+			if (matQuery_predicate(q, i)->type == SUPPLIER_IS)
+				supplier = matQuery_predicate(q, i)->text;
+		}
+
+		const Vector* shard = matRepo_getShardBySupplier(repo, supplier);
+		for (size_t i = 0; i < vector_length(shard); ++i) {
+			const Material* mat = vector_get(shard, i);
+			if (matQuery_matches(q, mat) && !matServ_collect(q, v, mat))
+				break;
+		}
 	}
+	else if (plan == COLUMN_SCAN) {
+		size_t count = matRepo_matCount(repo);
+		Bitmap* selection = bitmap_createInArena(vector_arena(v), count);
+		Bitmap* predSelection = bitmap_createInArena(vector_arena(v), count);
+		if (selection == NULL || predSelection == NULL) {
+			bitmap_destroy(selection);
+			bitmap_destroy(predSelection);
+			return;
+		}
+
+		// Evaluate the conditions on the columns with the vector kernels, and the others only on the selected materials.
+		bitmap_fill(selection, 1);
+		for (size_t i = 0; i < matQuery_predicateCount(q); ++i) {
+			const QueryPredicate* pred = matQuery_predicate(q, i);
+			if (pred->type == QUANTITY_AT_MOST)
+				scan_longsAtMost(matRepo_quantities(repo), count, pred->quantity, predSelection);
+			else if (pred->type == QUANTITY_GREATER)
+				scan_longsGreater(matRepo_quantities(repo), count, pred->quantity, predSelection);
+			else if (pred->type == EXPIRES_BEFORE)
+				scan_intsLess(matRepo_expSerials(repo), count, pred->serial, predSelection);
+			else if (pred->type == EXPIRES_FROM)
+				scan_intsAtLeast(matRepo_expSerials(repo), count, pred->serial, predSelection);
+			else
+				continue;
+			bitmap_and(selection, predSelection);
+		}
 
-	for (size_t i = 1; i < vector_length(v); ++i) {
-		for (size_t j = i; j >= 1; --j) {
-			const Material* leftMat = vector_get(v, j - 1);
-			const Material* rightMat = vector_get(v, j);
+		for (size_t i = bitmap_next(selection, 0); i < count; i = bitmap_next(selection, i + 1)) {
+			const Material* mat = matRepo_getByIndex(repo, i);
 
-			if (material_quantity(leftMat) > material_quantity(rightMat)) {
-				void* temp = vector_get(v, j);
-				vector_set(v, j, vector_get(v, j - 1));
-				vector_set(v, j - 1, temp);
+			int matches = 1;
+			for (size_t j = 0; j < matQuery_predicateCount(q) && matches; ++j) {
+				const QueryPredicate* pred = matQuery_predicate(q, j);
+				matches = matServ_isColumnPredicate(pred) || matQuery_predicateMatches(pred, mat);
 			}
-			else
+
+			if (matches && !matServ_collect(q, v, mat))
 				break;
 		}
+
+		bitmap_destroy(selection);
+		bitmap_destroy(predSelection);
 	}
+	else {
+		for (size_t i = 0; i < matRepo_matCount(repo); ++i) {
+			const Material* mat = matRepo_getByIndex(repo, i);
+			if (matQuery_matches(q, mat) && !matServ_collect(q, v, mat))
+				break;
+		}
+	}
+
+	// The bounded heap, or all the results when there is no limit, still have to be put in order.
+	if (matServ_collectsInHeap(q) || (matQuery_limit(q) == 0 && matQuery_sortKey(q) != SORT_NONE))
+		vector_sort(v, matServ_compareResults, (void*)q);
+}
+
+void matServ_query(MaterialService* serv, const MaterialQuery* q, Vector* v)
+{
+	matServ_record(serv, &(TraceRecord) { .call = TRACE_QUERY, .query = q });
+	long long started = matServ_begin(serv, SERV_QUERY);
+	matServ_runQuery(serv, q, v);
+	matServ_end(serv, SERV_QUERY, started);
+}
+
+size_t matServ_completeName(MaterialService* serv, const char* prefix, Vector* v, size_t maxResults)
+{
+	matServ_record(serv, &(TraceRecord) { .call = TRACE_COMPLETE_NAME, .text = prefix, .count = maxResults });
+	return matRepo_completeName(serv->repository, prefix, v, maxResults);
+}
+
+size_t matServ_completeSupplier(MaterialService* serv, const char* prefix, Vector* v, size_t maxResults)
+{
+	matServ_record(serv, &(TraceRecord) { .call = TRACE_COMPLETE_SUPPLIER, .text = prefix, .count = maxResults });
+	return matRepo_completeSupplier(serv->repository, prefix, v, maxResults);
+}
+
+void matServ_fuzzySearch(MaterialService* serv, const char* pattern, int maxDistance, Vector* v)
+{
+	matServ_record(serv, &(TraceRecord) { .call = TRACE_FUZZY_SEARCH, .text = pattern, .count = (size_t)maxDistance });
+	FuzzyPattern* p = allocator_alloc(serv->allocator, sizeof(FuzzyPattern));
+	if (vector_length(v) > 0 || p == NULL || pattern == NULL || !fuzzy_compile(p, pattern, maxDistance)) {
+		allocator_free(serv->allocator, p);
+		return;
+	}
+
+	long long started = matServ_begin(serv, SERV_FUZZY_SEARCH);
+	FuzzyResultVector results;
+	fuzzyVec_initWith(&results, serv->allocator);
+	for (size_t i = 0; i < matRepo_matCount(serv->repository); ++i) {
+		const Material* mat = matRepo_getByIndex(serv->repository, i);
+		int nameDistance = fuzzy_distance(p, material_name(mat));
+		int supplierDistance = fuzzy_distance(p, material_supplier(mat));
+		if (nameDistance < 0 && supplierDistance < 0)
+			continue;
+
+		FuzzyResult result;
+		result.mat = mat;
+		result.distance = nameDistance < 0 || (supplierDistance >= 0 && supplierDistance < nameDistance) ? supplierDistance : nameDistance;
+		result.index = i;
+		if (!fuzzyVec_add(&results, result))
+			break;
+	}
+
+	// Sort pointers to the results in the output vector, then replace each one with its material.
+	size_t count = fuzzyVec_length(&results);
+	vector_reserve(v, count);
+	for (size_t i = 0; i < count; ++i)
+		vector_add(v, fuzzyVec_at(&results, i));
+	vector_sort(v, matServ_compareFuzzyResults, NULL);
+	for (size_t i = 0; i < vector_length(v); ++i)
+		vector_set(v, i, (void*)((const FuzzyResult*)vector_get(v, i))->mat);
+
+	fuzzyVec_free(&results);
+	allocator_free(serv->allocator, p);
+	matServ_end(serv, SERV_FUZZY_SEARCH, started);
+}
+
+void matServ_setExpiryCallback(MaterialService* serv, ExpiryCallback callback, void* context)
+{
+	matExpiry_setCallback(serv->expiry, callback, context);
+}
+
+size_t matServ_tick(MaterialService* serv)
+{
+	long long started = matServ_begin(serv, SERV_TICK);
+	size_t expired = matExpiry_advance(serv->expiry, serv->clock());
+	matServ_end(serv, SERV_TICK, started);
+	return expired;
+}
+
+const MaterialAggregate* matServ_statsBySupplier(MaterialService* serv, const char* supplier)
+{
+	matServ_record(serv, &(TraceRecord) { .call = TRACE_STATS_BY_SUPPLIER, .text = supplier });
+	return matStats_bySupplier(serv->stats, supplier);
+}
+
+const MaterialAggregate* matServ_statsByName(MaterialService* serv, const char* name)
+{
+	matServ_record(serv, &(TraceRecord) { .call = TRACE_STATS_BY_NAME, .text = name });
+	return matStats_byName(serv->stats, name);
+}
+
+void matServ_getExpired(MaterialService* serv, Vector* v)
+{
+	matServ_record(serv, &(TraceRecord) { .call = TRACE_EXPIRED });
+	long long started = matServ_begin(serv, SERV_GET_EXPIRED);
+	const Vector* expired = matViews_expired(serv->views, serv->clock());
+	for (size_t i = 0; i < vector_length(expired); ++i)
+		vector_add(v, vector_get(expired, i));
+	matServ_end(serv, SERV_GET_EXPIRED, started);
+}
+
+void matServ_setLowStockThreshold(MaterialService* serv, const char* supplier, Quantity threshold)
+{
+	matViews_setLowStockThreshold(serv->views, supplier, threshold);
+}
+
+void matServ_getLowStock(MaterialService* serv, Vector* v)
+{
+	matServ_record(serv, &(TraceRecord) { .call = TRACE_LOW_STOCK });
+	long long started = matServ_begin(serv, SERV_GET_LOW_STOCK);
+	const Vector* lowStock = matViews_lowStock(serv->views);
+	for (size_t i = 0; i < vector_length(lowStock); ++i)
+		vector_add(v, vector_get(lowStock, i));
+	matServ_end(serv, SERV_GET_LOW_STOCK, started);
+}
+
+void matServ_get_materials_past_exp(MaterialService* serv, Vector* v, const char* optStr)
+{
+	if (vector_length(v) > 0)
+		return;
+
+	matServ_record(serv, &(TraceRecord) { .call = TRACE_PAST_EXP, .text = optStr });
+	TraceWriter* trace = matServ_pauseTrace(serv);
+	long long started = matServ_begin(serv, SERV_PAST_EXP);
+	MaterialCursor cur = matServ_cursorExpired(serv, optStr);
+	for (const Material* mat = matCursor_next(&cur); mat != NULL; mat = matCursor_next(&cur))
+		vector_add(v, (void*)mat);
+	matServ_end(serv, SERV_PAST_EXP, started);
+	serv->trace = trace;
+}
+
+void matServ_getMaterialsSortedByQuantity(MaterialService* serv, Vector* v)
+{
+	MaterialQuery* q = matQuery_create();
+	if (q == NULL)
+		return;
+
+	matQuery_orderBy(q, SORT_QUANTITY, 0);
+	matServ_query(serv, q, v);
+	matQuery_destroy(q);
+}
+
+void matServ_getMaterialsFromSupplierInShortSupply(MaterialService* serv, Vector* v, const char* supplier, Quantity max_quantity)
+{
+	matServ_getMaterialsFromSupplierInShortSupplyPage(serv, v, supplier, max_quantity, NULL, 0);
+}
+
+void matServ_getMaterialsSortedByQuantityPage(MaterialService* serv, Vector* v, const Material* after, size_t pageSize)
+{
+	MaterialQuery* q = matQuery_create();
+	if (q == NULL)
+		return;
+
+	matQuery_setAfter(matQuery_setLimit(matQuery_orderBy(q, SORT_QUANTITY, 0), pageSize), after);
+	matServ_query(serv, q, v);
+	matQuery_destroy(q);
+}
+
+void matServ_getMaterialsFromSupplierInShortSupplyPage(MaterialService* serv, Vector* v, const char* supplier, Quantity max_quantity, const Material* after, size_t pageSize)
+{
+	MaterialQuery* q = matQuery_create();
+	if (q == NULL)
+		return;
+
+	matQuery_orderBy(matQuery_whereQuantityAtMost(matQuery_whereSupplierIs(q, supplier), max_quantity), SORT_QUANTITY, 0);
+	matQuery_setAfter(matQuery_setLimit(q, pageSize), after);
+	matServ_query(serv, q, v);
+	matQuery_destroy(q);
+}
+
+// Replay.
+int matServ_replay(MaterialService* serv, const TraceRecord* rec, Vector* v)
+{
+	MaterialCursor cur;
+	switch (rec->call) {
+	case TRACE_ADD_OR_UPDATE:
+		return matServ_addOrUpdateByNSE(serv, rec->id, rec->name, rec->supplier, rec->quantity, rec->date, NULL);
+	case TRACE_UPDATE:
+		return matServ_updateByNSE(serv, rec->name, rec->supplier, rec->quantity, rec->date, NULL);
+	case TRACE_REMOVE:
+		return matServ_removeByNSE(serv, rec->name, rec->supplier, rec->date, NULL);
+	case TRACE_UNDO:
+		return matServ_undo(serv);
+	case TRACE_REDO:
+		return matServ_redo(serv);
+	case TRACE_GET_ALL:
+		matServ_getAll(serv, v);
+		break;
+	case TRACE_PAST_EXP:
+		matServ_get_materials_past_exp(serv, v, rec->text);
+		break;
+	case TRACE_EXPIRED:
+		matServ_getExpired(serv, v);
+		break;
+	case TRACE_LOW_STOCK:
+		matServ_getLowStock(serv, v);
+		break;
+	case TRACE_QUERY:
+		matServ_query(serv, rec->query, v);
+		break;
+	case TRACE_COMPLETE_NAME:
+		return (int)matServ_completeName(serv, rec->text, v, rec->count);
+	case TRACE_COMPLETE_SUPPLIER:
+		return (int)matServ_completeSupplier(serv, rec->text, v, rec->count);
+	case TRACE_FUZZY_SEARCH:
+		matServ_fuzzySearch(serv, rec->text, (int)rec->count, v);
+		break;
+	case TRACE_STATS_BY_SUPPLIER:
+		return matServ_statsBySupplier(serv, rec->text) != NULL;
+	case TRACE_STATS_BY_NAME:
+		return matServ_statsByName(serv, rec->text) != NULL;
+	case TRACE_CURSOR_ALL:
+	case TRACE_CURSOR_EXPIRED:
+	case TRACE_CURSOR_QUERY:
+		if (rec->call == TRACE_CURSOR_ALL)
+			cur = matServ_cursorAll(serv);
+		else if (rec->call == TRACE_CURSOR_EXPIRED)
+			cur = matServ_cursorExpired(serv, rec->text);
+		else
+			cur = matServ_cursorQuery(serv, rec->query);
+		for (const Material* mat = matCursor_next(&cur); mat != NULL; mat = matCursor_next(&cur))
+			vector_add(v, (void*)mat);
+		break;
+	default:
+		return -1;
+	}
+
+	return (int)vector_length(v);
 }
@@ -4,15 +4,41 @@
 #include "MaterialRepository.h"
 #include "Material.h"
 #include "MaterialOperation.h"
+#include "MaterialBatch.h"
+#include "Bitmap.h"
+#include "MaterialQuery.h"
+#include "MaterialCursor.h"
+#include "FuzzyMatch.h"
+#include "MaterialViews.h"
+#include "MaterialStats.h"
+#include "MaterialExpiry.h"
+#include "MaterialTrace.h"
+
+// A function called for every change of the repository made through the service, including undo and redo.
+// Additions and updates are reported after the change: 'oldMat' is a copy of the material before the change (NULL if it was added),
+// valid only during the call, and 'newMat' is the material now stored in the repository, valid until it is removed.
+// Removals are reported after the material is removed: 'oldMat' is a copy of the removed material, valid only during the call,
+// and 'newMat' is NULL.
+typedef void(*MaterialObserver)(void* context, const Material* oldMat, const Material* newMat);
 
 // The internal data for a material service.
 // Do not use struct members directly. Use only methods that start with 'matServ_'.
 // The service must be initialized with 'matServ_create' and destroyed with 'matServ_destroy'.
+// The service, its observers and the undo / redo history are taken from the allocator given to 'matServ_createWith'.
 // If not specified otherwise, material service pointer cannot be NULL in material service methods.
 typedef struct {
 	MaterialRepository* repository;
-	Vector* undoStack;
-	Vector* redoStack;
+	OperationVector undoStack;
+	OperationVector redoStack;
+	Vector* observers;
+	MaterialViews* views;
+	MaterialStats* stats;
+	MaterialExpiry* expiry;
+	Date(*clock)();
+	const Allocator* allocator;
+	TraceWriter* trace;
+	LatencyRecorder* latency;
+	int loading;
 } MaterialService;
 
 // CONSTRUCTOR / DESTRUCTOR.
@@ -20,6 +46,9 @@ typedef struct {
 // Initialize a material service that will use a given repository.
 MaterialService* matServ_create(MaterialRepository* repository);
 
+// Initialize a material service whose memory is taken from the given allocator (NULL means the default allocator).
+MaterialService* matServ_createWith(MaterialRepository* repository, const Allocator* allocator);
+
 // Release all service resources and free the service itself.
 // If service is NULL, nothing happens.
 void matServ_destroy(MaterialService* serv);
@@ -29,6 +58,38 @@ void matServ_destroy(MaterialService* serv);
 // Returns the number of materials in the underlying repository.
 size_t matServ_matCount(MaterialService* serv);
 
+// Returns 1 while the observers are told about a material stored by 'matServ_load', otherwise 0.
+int matServ_isLoading(const MaterialService* serv);
+
+// Set the function the service uses to get the current date (the default is 'date_today').
+// The expiry scheduler is restarted from the day of the new clock.
+void matServ_setClock(MaterialService* serv, Date(*clock)());
+
+// Record the public calls listed in 'TraceCall' to the given writer, in the order they are made (NULL stops recording).
+// Calls made by the service itself, like the update done by 'matServ_addOrUpdateByNSE', are not recorded separately.
+// The getters built on 'matServ_query' are recorded as the query they run. The writer is not destroyed by the service.
+void matServ_setTrace(MaterialService* serv, TraceWriter* trace);
+
+// Start (enabled 1) or stop (enabled 0) recording the latency of every public operation of the service and of its repository
+// (see 'matRepo_setLatencyTracking'), one histogram per operation. An operation made by another one is recorded in both histograms,
+// and the getters built on 'matServ_query' are recorded as queries. Stopping drops the recorded latencies.
+// Returns 0 if tracking could not be started. While tracking is off, every operation pays only for a pointer check.
+int matServ_setLatencyTracking(MaterialService* serv, int enabled);
+
+// Returns the latencies of the service operations recorded since tracking was started, or NULL if it is off.
+const LatencyRecorder* matServ_latency(MaterialService* serv);
+
+// Write the latency tables of the service and of its repository (see 'latency_write'). Returns 0 if tracking is off.
+int matServ_writeLatency(MaterialService* serv, FILE* out);
+
+// OBSERVERS.
+
+// Register a function to be called with the given context after every change of the repository.
+void matServ_addObserver(MaterialService* serv, MaterialObserver observer, void* context);
+
+// Unregister a function registered with the same context. If it is not found nothing happens.
+void matServ_removeObserver(MaterialService* serv, MaterialObserver observer, void* context);
+
 // CRUD OPERATIONS.
 
 // Add a material to the repository and return its id. Use id -1 to find an unused id.
@@ -36,7 +97,13 @@ size_t matServ_matCount(MaterialService* serv);
 // If material failed validation, returns -1.
 // If a material with the same id exists, returns -2.
 // If a material with the same name, supplier and expiration date exists, returns -5.
-int matServ_add(MaterialService* serv, int id, const char* name, const char* supplier, float quantity, Date exp_date, int undoable);
+int matServ_add(MaterialService* serv, int id, const char* name, const char* supplier, Quantity quantity, Date exp_date, int undoable);
+
+// Add a copy of a material known to be new, for example when loading a generated catalog or a snapshot, and return its id.
+// Nothing looks for a material with the same id or the same name, supplier and expiration date, so a bulk load takes
+// constant time per material: the caller must guarantee both are unique. The observers are notified, and it cannot be undone.
+// If material failed validation or could not be stored, returns -1.
+int matServ_load(MaterialService* serv, const Material* mat);
 
 // Returns the material with the specified id if any, otherwise NULL.
 const Material* matServ_findById(MaterialService* serv, int id);
@@ -46,30 +113,49 @@ const Material* matServ_findById(MaterialService* serv, int id);
 // Set 'undoable' to 0 if you don't want to undo this operation (this is dangerous). Recommended to keep it 1.
 // If validation fails returns -1.
 // If no material with the specified id is found, returns -3.
-int matServ_updateById(MaterialService* serv, int id, const char* name, const char* supplier, float quantity, Date exp_date, Material* oldMat, int undoable);
+int matServ_updateById(MaterialService* serv, int id, const char* name, const char* supplier, Quantity quantity, Date exp_date, Material* oldMat, int undoable);
 
 // Deletes the material with the specified id and returns 0 on success.
 // If 'remMat' is not null saves the removed material there.
 // Set 'undoable' to 0 if you don't want to undo this operation (this is dangerous). Recommended to keep it 1.
 // If no material with the specified id is found, returns -3.
+// If the memory could not be allocated, returns -1 and the material is not removed.
 int matServ_removeById(MaterialService* serv, int id, Material* remMat, int undoable);
 
 // Saves in the given vector all materials. Do not destroy or modify the materials.
+// Prefer 'matServ_cursorAll' when the materials are only walked once.
 void matServ_getAll(MaterialService* serv, Vector* v);
 
+// CURSORS.
+// Cursors yield the materials one at a time without copying them (see 'matCursor_next').
+// They must not be used after the service is modified.
+
+// Returns a cursor over all materials.
+MaterialCursor matServ_cursorAll(MaterialService* serv);
+
+// Returns a cursor over the materials past their expiration date that contain the optional string in their name
+// (NULL or an empty string selects all of them). The string is not copied and must stay valid while the cursor is used.
+MaterialCursor matServ_cursorExpired(MaterialService* serv, const char* optStr);
+
+// Returns a cursor over the materials matching the conditions of the query (order and limit are ignored).
+// If the query has a supplier condition, only the shard of the supplier is walked. The query must stay valid while the cursor is used.
+MaterialCursor matServ_cursorQuery(MaterialService* serv, const MaterialQuery* q);
+
 // UNDO / REDO.
 
 // Adds an undoable operation to the undo stack and clears the redos. Not recommended to use outside the service.
 void matServ_addUndoOperation(MaterialService* serv, OperationType type, const Material* mat);
 
 // Perform a given operation and return the return value for the specific operation. Not recommended to use outside the service.
-// If 'revOp' is not null it saves the reverse operation there.
+// If 'revOp' is not null it saves the reverse operation there, or NONE if the operation failed.
 int matServ_performOperation(MaterialService* serv, const MaterialOperation* op, MaterialOperation* revOp);
 
 // Undo the last operation. Returns 0 for failure, 1 for success.
+// An operation that cannot be applied any more (for example re-adding a removed material after an update by id gave another
+// material its name, supplier and expiration date) is dropped, and 0 is returned.
 int matServ_undo(MaterialService* serv);
 
-// Redo the last operation. Returns 0 for failure, 1 for success.
+// Redo the last operation. Returns 0 for failure, 1 for success. An operation that cannot be applied any more is dropped, like in 'matServ_undo'.
 int matServ_redo(MaterialService* serv);
 
 // METHODS.
@@ -80,7 +166,7 @@ int matServ_redo(MaterialService* serv);
 // If 'oldMat' is not null: If the material is being updated, saves the old material in 'oldMat', if it is added, sets its id to -1.
 // If the material fails validation, returns -1.
 // If the material is being added, but the id already exists, returns -2.
-int matServ_addOrUpdateByNSE(MaterialService* serv, int id, const char* name, const char* supplier, float quantity, Date exp_date, Material* oldMat);
+int matServ_addOrUpdateByNSE(MaterialService* serv, int id, const char* name, const char* supplier, Quantity quantity, Date exp_date, Material* oldMat);
 
 // Returns the material with the specified name, supplier and expiration date or NULL if not found.
 const Material* matServ_findByNSE(MaterialService* serv, const char* name, const char* supplier, Date exp_date);
@@ -89,14 +175,83 @@ const Material* matServ_findByNSE(MaterialService* serv, const char* name, const
 // If 'oldMat' is not null saves the old material there.
 // If the new material fails validation returns -1.
 // If the NSE is not found returns -4.
-int matServ_updateByNSE(MaterialService* serv, const char* name, const char* supplier, float quantity, Date exp_date, Material* oldMat);
+int matServ_updateByNSE(MaterialService* serv, const char* name, const char* supplier, Quantity quantity, Date exp_date, Material* oldMat);
 
 // Deletes the material with the specified name, supplier and expiration date and returns its id on success.
 // If 'remMat' is not null, saves the removed material there.
 // If the specified NSE is not found returns -4.
 int matServ_removeByNSE(MaterialService* serv, const char* name, const char* supplier, Date exp_date, Material* remMat);
 
+// Applies all the pending operations of the batch in order, records their undo operations and stores their results in the batch.
+// Each operation behaves like its matching 'matServ_*ByNSE' method and can be undone separately.
+// Returns the number of operations that succeeded.
+size_t matServ_commitBatch(MaterialService* serv, MaterialBatch* batch);
+
+// Applies the writes in order like 'matServ_commitBatch', storing the result of each one in it. The materials are not copied:
+// they are read only while the writes are applied. Used by the applier of a 'MaterialPipeline'.
+// Returns the number of writes that succeeded.
+size_t matServ_applyWrites(MaterialService* serv, MaterialWrite* writes, size_t count);
+
+// Selects the materials past their expiration date: bit 'i' of the result is set if the material on index 'i' of the repository
+// (see 'matRepo_getByIndex') is expired. The result is resized to the number of materials. Selections can be combined with
+// the 'bitmap_*' methods as long as the repository is not modified.
+void matServ_selectExpired(MaterialService* serv, Bitmap* result);
+
+// Selects the materials which have the quantity less or equal to the given number, like 'matServ_selectExpired'.
+void matServ_selectQuantityAtMost(MaterialService* serv, Quantity max_quantity, Bitmap* result);
+
+// Returns the way 'matServ_query' will run the given query: searching only the shard of a supplier if the query has a supplier
+// condition, scanning the quantity and expiration date columns if it has conditions on them, or going through all materials.
+QueryPlan matServ_planQuery(MaterialService* serv, const MaterialQuery* q);
+
+// Saves in the given vector the materials selected by the query, in its order and limited to its limit. Don't modify the materials.
+// Filtering, sorting and limiting are done in a single pass; if there is a limit only the best results are kept while scanning,
+// in a bounded heap. If the vector lives in an arena (see 'vector_createInArena'), the temporaries of the query are allocated
+// from the same arena, so a warm arena makes the query run without 'malloc' or 'free'.
+// The given vector must be empty. A failed query (see 'matQuery_failed') selects nothing.
+void matServ_query(MaterialService* serv, const MaterialQuery* q, Vector* v);
+
+// Saves in the given vector the distinct material names (const char*) starting with the prefix, in alphabetical order,
+// at most 'maxResults' of them (0 means no limit), and returns how many were saved. Valid until the next change.
+// Only the names under the prefix are visited, so it is fast enough to run on every keystroke.
+size_t matServ_completeName(MaterialService* serv, const char* prefix, Vector* v, size_t maxResults);
+
+// Same as 'matServ_completeName', but for suppliers.
+size_t matServ_completeSupplier(MaterialService* serv, const char* prefix, Vector* v, size_t maxResults);
+
+// Saves in the given vector the materials whose name or supplier is within 'maxDistance' edits of the pattern (see 'FuzzyPattern'),
+// closest first (materials at the same distance keep the order of the repository). Don't modify the materials.
+// If the pattern is longer than FUZZY_MAX_PATTERN or the distance is negative, nothing is saved. The given vector must be empty.
+void matServ_fuzzySearch(MaterialService* serv, const char* pattern, int maxDistance, Vector* v);
+
+// Set the function called for every material that expires while the service is running (see 'matServ_tick').
+void matServ_setExpiryCallback(MaterialService* serv, ExpiryCallback callback, void* context);
+
+// Move the expiry scheduler to the current day of the clock and call the expiry callback for every material that crossed
+// its expiration date since the previous tick. Returns the number of such materials. The cost is the number of materials
+// that expired (and the days passed), not the number of materials: the scheduler is updated on every change.
+size_t matServ_tick(MaterialService* serv);
+
+// Returns the running totals (count, total quantity, earliest expiration date) of the materials from the given supplier,
+// or NULL if there are none. O(1): the totals are kept up to date on every change. Valid until the next change.
+const MaterialAggregate* matServ_statsBySupplier(MaterialService* serv, const char* supplier);
+
+// Returns the running totals of the materials with the given name, or NULL if there are none. Like 'matServ_statsBySupplier'.
+const MaterialAggregate* matServ_statsByName(MaterialService* serv, const char* name);
+
+// Saves in the given vector all materials past their expiration date. They are read from a view kept up to date on every change,
+// so the cost is the number of expired materials (the view is rebuilt once when the day changes). Don't modify the materials.
+void matServ_getExpired(MaterialService* serv, Vector* v);
+
+// Set the low stock threshold of a supplier (a threshold of 0 or less removes it). See 'matViews_setLowStockThreshold'.
+void matServ_setLowStockThreshold(MaterialService* serv, const char* supplier, Quantity threshold);
+
+// Saves in the given vector all the materials in low stock: with the quantity less or equal to the threshold of their supplier.
+// They are read from a view kept up to date on every change. Don't modify the materials.
+void matServ_getLowStock(MaterialService* serv, Vector* v);
+
 // Saves in the given vector all materials past their expiration date that contain a given optional string. Don't modify the materials.
+// Only the expired materials are checked for the string (see 'matServ_getExpired').
 // The given vector must be empty.
 void matServ_get_materials_past_exp(MaterialService* serv, Vector* v, const char* optStr);
 
@@ -104,8 +259,27 @@ void matServ_get_materials_past_exp(MaterialService* serv, Vector* v, const char
 // The given vector must be empty.
 void matServ_getMaterialsSortedByQuantity(MaterialService* serv, Vector* v);
 
-// Saves in the given vector all materials which have the quantity less than a given number. Don't modify the materials.
+// Saves in the given vector all materials from the given supplier which have the quantity less than a given number, sorted by quantity.
+// Only the supplier's shard of the repository is searched. Don't modify the materials.
 // The given vector must be empty.
-void matServ_getMaterialsFromSupplierInShortSupply(MaterialService* serv, Vector* v, const char* supplier, float max_quantity);
+void matServ_getMaterialsFromSupplierInShortSupply(MaterialService* serv, Vector* v, const char* supplier, Quantity max_quantity);
+
+// Saves in the given vector one page of the materials sorted by quantity: at most 'pageSize' materials (0 means no limit)
+// coming after the material 'after' (use NULL for the first page, or the last material of the previous page).
+// The first page holds the 'pageSize' materials with the lowest quantities and costs O(n log pageSize), without sorting everything.
+// Don't modify the materials. The given vector must be empty.
+void matServ_getMaterialsSortedByQuantityPage(MaterialService* serv, Vector* v, const Material* after, size_t pageSize);
+
+// Saves in the given vector one page of the materials from the given supplier in short supply, sorted by quantity.
+// The page is selected like in 'matServ_getMaterialsSortedByQuantityPage'. The given vector must be empty.
+void matServ_getMaterialsFromSupplierInShortSupplyPage(MaterialService* serv, Vector* v, const char* supplier, Quantity max_quantity, const Material* after, size_t pageSize);
+
+// REPLAY.
+
+// Make the call of a recorded record (see 'traceReader_next') on the service. The materials, or the names for the completions,
+// returned by a read are saved in the given vector (cursors are walked to the end), which must be empty.
+// Returns the result of a write, undo or redo, the number of results of a read, 1 or 0 for the statistics (found or not)
+// and -1 if the call is not valid.
+int matServ_replay(MaterialService* serv, const TraceRecord* rec, Vector* v);
 
 #endif
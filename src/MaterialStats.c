@@ -0,0 +1,214 @@
+#include "MaterialStats.h"
+#include <limits.h>
+#include <string.h>
+
+// Returns the index of the first expiry that is not before the date (the expiries are sorted by date).
+static size_t matAgg_findExpiry(const MaterialAggregate* agg, DateSerial date)
+{
+	size_t left = 0, right = agg->expiryLength;
+	while (left < right) {
+		size_t middle = left + (right - left) / 2;
+		if (agg->expiries[middle].date < date)
+			left = middle + 1;
+		else
+			right = middle;
+	}
+
+	return left;
+}
+
+// Adds the quantity to the total (or subtracts it if 'sign' is negative). Both parts are split by MAT_AGG_TOTAL_BASE first,
+// so no sum goes past twice the base.
+static void matAgg_addToTotal(MaterialAggregate* agg, Quantity quantity, int sign)
+{
+	long long carry = quantity / MAT_AGG_TOTAL_BASE;
+	long long rest = quantity % MAT_AGG_TOTAL_BASE;
+	if (rest < 0) {
+		rest += MAT_AGG_TOTAL_BASE;
+		--carry;
+	}
+
+	agg->totalCarry += sign < 0 ? -carry : carry;
+	agg->totalQuantity += sign < 0 ? -rest : rest;
+	if (agg->totalQuantity >= MAT_AGG_TOTAL_BASE) {
+		agg->totalQuantity -= MAT_AGG_TOTAL_BASE;
+		++agg->totalCarry;
+	}
+	else if (agg->totalQuantity < 0) {
+		agg->totalQuantity += MAT_AGG_TOTAL_BASE;
+		--agg->totalCarry;
+	}
+}
+
+// Adds the material to the aggregate. The material is always counted, like 'matAgg_remove' always uncounts it,
+// even if the expiry list cannot grow (then only its expiration date is missing from the list).
+static void matAgg_add(MaterialAggregate* agg, const Material* mat)
+{
+	++agg->count;
+	matAgg_addToTotal(agg, material_quantity(mat), 1);
+
+	DateSerial date = material_expSerial(mat);
+	size_t index = matAgg_findExpiry(agg, date);
+
+	if (index == agg->expiryLength || agg->expiries[index].date != date) {
+		if (agg->expiryLength == agg->expiryCapacity) {
+			size_t newCapacity = (agg->expiryLength + 1) * 2;
+			ExpiryCount* newExpiries = realloc(agg->expiries, newCapacity * sizeof(ExpiryCount));
+			if (newExpiries == NULL)
+				return;
+			agg->expiries = newExpiries;
+			agg->expiryCapacity = newCapacity;
+		}
+
+		memmove(agg->expiries + index + 1, agg->expiries + index, (agg->expiryLength - index) * sizeof(ExpiryCount));
+		agg->expiries[index].date = date;
+		agg->expiries[index].count = 0;
+		++agg->expiryLength;
+	}
+
+	++agg->expiries[index].count;
+}
+
+// Removes the material from the aggregate.
+static void matAgg_remove(MaterialAggregate* agg, const Material* mat)
+{
+	DateSerial date = material_expSerial(mat);
+	size_t index = matAgg_findExpiry(agg, date);
+	if (index < agg->expiryLength && agg->expiries[index].date == date && --agg->expiries[index].count == 0) {
+		memmove(agg->expiries + index, agg->expiries + index + 1, (agg->expiryLength - index - 1) * sizeof(ExpiryCount));
+		--agg->expiryLength;
+	}
+
+	--agg->count;
+	matAgg_addToTotal(agg, material_quantity(mat), -1);
+}
+
+static void matAgg_destroy(MaterialAggregate* agg)
+{
+	if (agg) {
+		free(agg->expiries);
+		free(agg);
+	}
+}
+
+// Adds the material to the aggregate of the key, creating it if needed.
+static void matStats_addTo(HashMap* map, const char* key, const Material* mat)
+{
+	MaterialAggregate* agg = hashMap_get(map, key);
+	if (agg == NULL) {
+		if ((agg = calloc(1, sizeof(MaterialAggregate))) == NULL)
+			return;
+		if (!hashMap_put(map, key, agg)) {
+			free(agg);
+			return;
+		}
+	}
+
+	matAgg_add(agg, mat);
+}
+
+// Removes the material from the aggregate of the key, destroying it when it becomes empty.
+static void matStats_removeFrom(HashMap* map, const char* key, const Material* mat)
+{
+	MaterialAggregate* agg = hashMap_get(map, key);
+	if (agg == NULL)
+		return;
+
+	matAgg_remove(agg, mat);
+	if (agg->count == 0)
+		matAgg_destroy(hashMap_remove(map, key));
+}
+
+// Destroys all the aggregates of the map and the map itself.
+static void matStats_destroyMap(HashMap* map)
+{
+	if (map == NULL)
+		return;
+
+	for (size_t i = 0; i < hashMap_capacity(map); ++i) {
+		const HashMapEntry* entry = hashMap_entryAt(map, i);
+		if (entry)
+			matAgg_destroy(entry->value);
+	}
+
+	hashMap_destroy(map);
+}
+
+// Aggregate properties.
+size_t matAgg_count(const MaterialAggregate* agg)
+{
+	return agg->count;
+}
+
+Quantity matAgg_totalQuantity(const MaterialAggregate* agg)
+{
+	if (matAgg_totalOverflows(agg))
+		return agg->totalCarry < 0 ? LLONG_MIN : LLONG_MAX;
+	return agg->totalCarry * MAT_AGG_TOTAL_BASE + agg->totalQuantity;
+}
+
+int matAgg_totalOverflows(const MaterialAggregate* agg)
+{
+	// The total fits from -2 * MAT_AGG_TOTAL_BASE (LLONG_MIN) up to 2 * MAT_AGG_TOTAL_BASE - 1 (LLONG_MAX).
+	return agg->totalCarry < -2 || agg->totalCarry > 1;
+}
+
+double matAgg_totalUnits(const MaterialAggregate* agg)
+{
+	return ((double)agg->totalCarry * (double)MAT_AGG_TOTAL_BASE + (double)agg->totalQuantity) / QUANTITY_SCALE;
+}
+
+Date matAgg_earliestExpiry(const MaterialAggregate* agg)
+{
+	Date none = { 0 };
+	return agg->expiryLength > 0 ? date_fromSerial(agg->expiries[0].date) : none;
+}
+
+// Constructor / Destructor.
+MaterialStats* matStats_create()
+{
+	MaterialStats* stats = calloc(1, sizeof(MaterialStats));
+	if (stats) {
+		stats->bySupplier = hashMap_create();
+		stats->byName = hashMap_create();
+	}
+
+	return stats;
+}
+
+void matStats_destroy(MaterialStats* stats)
+{
+	if (stats == NULL)
+		return;
+
+	matStats_destroyMap(stats->bySupplier);
+	matStats_destroyMap(stats->byName);
+	free(stats);
+}
+
+// Properties.
+const MaterialAggregate* matStats_bySupplier(const MaterialStats* stats, const char* supplier)
+{
+	return hashMap_get(stats->bySupplier, supplier);
+}
+
+const MaterialAggregate* matStats_byName(const MaterialStats* stats, const char* name)
+{
+	return hashMap_get(stats->byName, name);
+}
+
+// Changes.
+void matStats_onChange(void* context, const Material* oldMat, const Material* newMat)
+{
+	MaterialStats* stats = context;
+
+	if (oldMat) {
+		matStats_removeFrom(stats->bySupplier, material_supplier(oldMat), oldMat);
+		matStats_removeFrom(stats->byName, material_name(oldMat), oldMat);
+	}
+
+	if (newMat) {
+		matStats_addTo(stats->bySupplier, material_supplier(newMat), newMat);
+		matStats_addTo(stats->byName, material_name(newMat), newMat);
+	}
+}
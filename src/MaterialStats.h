@@ -0,0 +1,78 @@
+#ifndef MATERIAL_STATS
+#define MATERIAL_STATS
+
+#include "Material.h"
+#include "HashMap.h"
+
+// The total quantity of a group is 'totalCarry' times MAT_AGG_TOTAL_BASE plus 'totalQuantity' (from 0 to MAT_AGG_TOTAL_BASE - 1),
+// so adding or removing any quantity never overflows, however many materials the group has.
+#define MAT_AGG_TOTAL_BASE (1LL << 62)
+
+// How many materials of a group expire on a given date.
+typedef struct {
+	DateSerial date;
+	size_t count;
+} ExpiryCount;
+
+// The running totals of a group of materials (all the materials of a supplier, or with a name).
+// Do not use struct members directly. Use only methods that start with 'matAgg_'.
+typedef struct {
+	size_t count;
+	Quantity totalQuantity;
+	long long totalCarry;
+	ExpiryCount* expiries;
+	size_t expiryLength;
+	size_t expiryCapacity;
+} MaterialAggregate;
+
+// The internal data for the aggregates of a repository, grouped by supplier and by name.
+// The aggregates must be told about every change of the repository (see 'matStats_onChange'), so that reading them is O(1).
+// Do not use struct members directly. Use only methods that start with 'matStats_'.
+// The stats must be initialized with 'matStats_create' and destroyed with 'matStats_destroy'.
+// If not specified otherwise, stats pointer cannot be NULL in stats methods.
+typedef struct {
+	HashMap* bySupplier;
+	HashMap* byName;
+} MaterialStats;
+
+// AGGREGATE PROPERTIES.
+
+// Returns the number of materials in the group.
+size_t matAgg_count(const MaterialAggregate* agg);
+
+// Returns the sum of the quantities of the materials in the group. It is exact: the quantities are integers.
+// If the sum does not fit in a Quantity (see 'matAgg_totalOverflows'), returns LLONG_MAX, or LLONG_MIN for a negative sum.
+Quantity matAgg_totalQuantity(const MaterialAggregate* agg);
+
+// Returns 1 if the sum of the quantities of the materials in the group does not fit in a Quantity, otherwise 0.
+int matAgg_totalOverflows(const MaterialAggregate* agg);
+
+// Returns the sum of the quantities of the materials in the group as a number of units, for printing. It is rounded only if it is huge.
+double matAgg_totalUnits(const MaterialAggregate* agg);
+
+// Returns the earliest expiration date of the materials in the group.
+Date matAgg_earliestExpiry(const MaterialAggregate* agg);
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize empty stats.
+MaterialStats* matStats_create();
+
+// Release all stats resources and free the stats. If stats is NULL nothing happens.
+void matStats_destroy(MaterialStats* stats);
+
+// PROPERTIES.
+
+// Returns the aggregate of the materials from the given supplier, or NULL if there are none. Valid until the next change.
+const MaterialAggregate* matStats_bySupplier(const MaterialStats* stats, const char* supplier);
+
+// Returns the aggregate of the materials with the given name, or NULL if there are none. Valid until the next change.
+const MaterialAggregate* matStats_byName(const MaterialStats* stats, const char* name);
+
+// CHANGES.
+
+// Update the aggregates for a change of the repository, reported like for a 'MaterialObserver' (the stats are the context):
+// 'oldMat' is the material before the change (NULL if it was added) and 'newMat' the stored material (NULL if it is removed).
+void matStats_onChange(void* stats, const Material* oldMat, const Material* newMat);
+
+#endif
@@ -0,0 +1,270 @@
+#include "MaterialTrace.h"
+#include <string.h>
+
+// The first bytes of a trace: a magic number and the version of the format.
+static const unsigned char TRACE_HEADER[5] = { 'M', 'T', 'R', 'C', 2 };
+
+// The arguments a call has, in the order they are written.
+#define TRACE_ID 0x01
+#define TRACE_NAME 0x02
+#define TRACE_SUPPLIER 0x04
+#define TRACE_TEXT 0x08
+#define TRACE_QUANTITY 0x10
+#define TRACE_DATE 0x20
+#define TRACE_COUNT 0x40
+#define TRACE_QUERY_ARG 0x80
+
+static const struct {
+	const char* name;
+	int args;
+} TRACE_CALLS[TRACE_CALL_COUNT] = {
+	{ NULL, 0 },
+	{ "add_or_update", TRACE_ID | TRACE_NAME | TRACE_SUPPLIER | TRACE_QUANTITY | TRACE_DATE },
+	{ "update", TRACE_NAME | TRACE_SUPPLIER | TRACE_QUANTITY | TRACE_DATE },
+	{ "remove", TRACE_NAME | TRACE_SUPPLIER | TRACE_DATE },
+	{ "undo", 0 },
+	{ "redo", 0 },
+	{ "get_all", 0 },
+	{ "cursor_all", 0 },
+	{ "past_exp", TRACE_TEXT },
+	{ "cursor_expired", TRACE_TEXT },
+	{ "expired", 0 },
+	{ "low_stock", 0 },
+	{ "query", TRACE_QUERY_ARG },
+	{ "cursor_query", TRACE_QUERY_ARG },
+	{ "complete_name", TRACE_TEXT | TRACE_COUNT },
+	{ "complete_supplier", TRACE_TEXT | TRACE_COUNT },
+	{ "fuzzy_search", TRACE_TEXT | TRACE_COUNT },
+	{ "stats_by_supplier", TRACE_TEXT },
+	{ "stats_by_name", TRACE_TEXT },
+};
+
+// Writing. The record is encoded in the buffer of the writer (see 'CodecWriter'), then written to the file at once.
+
+static void trace_writeQuery(TraceWriter* w, const MaterialQuery* q)
+{
+	codecWriter_writeNumber(&w->record, matQuery_predicateCount(q));
+	for (size_t i = 0; i < matQuery_predicateCount(q); ++i) {
+		const QueryPredicate* pred = matQuery_predicate(q, i);
+		codecWriter_writeByte(&w->record, (unsigned char)pred->type);
+		if (pred->type == QUANTITY_AT_MOST || pred->type == QUANTITY_GREATER)
+			codecWriter_writeSigned(&w->record, pred->quantity);
+		else if (pred->type == EXPIRES_BEFORE || pred->type == EXPIRES_FROM)
+			codecWriter_writeDate(&w->record, pred->date);
+		else
+			codecWriter_writeString(&w->record, pred->text);
+	}
+
+	codecWriter_writeByte(&w->record, (unsigned char)matQuery_sortKey(q));
+	codecWriter_writeByte(&w->record, (unsigned char)(matQuery_descending(q) != 0));
+	codecWriter_writeNumber(&w->record, matQuery_limit(q));
+	codecWriter_writeByte(&w->record, matQuery_after(q) != NULL);
+	if (matQuery_after(q))
+		codecWriter_writeMaterial(&w->record, matQuery_after(q));
+}
+
+// Reading. Errors are remembered in 'ok' (see 'CodecReader').
+
+// Reads a string into the reader's buffer with the given index (the strings of a record use different buffers).
+static const char* trace_readString(TraceReader* r, size_t buffer, int* ok)
+{
+	return codecReader_readString(&r->reader, &r->strings[buffer], &r->capacities[buffer], ok);
+}
+
+static MaterialQuery* trace_readQuery(TraceReader* r, int* ok)
+{
+	matQuery_destroy(r->query);
+	if ((r->query = matQuery_create()) == NULL) {
+		*ok = 0;
+		return NULL;
+	}
+
+	unsigned long long count = codecReader_readNumber(&r->reader, ok);
+	for (unsigned long long i = 0; i < count && *ok; ++i) {
+		QueryPredicateType type = (QueryPredicateType)codecReader_readByte(&r->reader, ok);
+		if (type == NAME_CONTAINS)
+			matQuery_whereNameContains(r->query, trace_readString(r, 2, ok));
+		else if (type == NAME_STARTS_WITH)
+			matQuery_whereNameStartsWith(r->query, trace_readString(r, 2, ok));
+		else if (type == SUPPLIER_IS)
+			matQuery_whereSupplierIs(r->query, trace_readString(r, 2, ok));
+		else if (type == SUPPLIER_STARTS_WITH)
+			matQuery_whereSupplierStartsWith(r->query, trace_readString(r, 2, ok));
+		else if (type == QUANTITY_AT_MOST)
+			matQuery_whereQuantityAtMost(r->query, codecReader_readSigned(&r->reader, ok));
+		else if (type == QUANTITY_GREATER)
+			matQuery_whereQuantityGreater(r->query, codecReader_readSigned(&r->reader, ok));
+		else if (type == EXPIRES_BEFORE)
+			matQuery_whereExpiresBefore(r->query, codecReader_readDate(&r->reader, ok));
+		else if (type == EXPIRES_FROM)
+			matQuery_whereExpiresFrom(r->query, codecReader_readDate(&r->reader, ok));
+		else
+			*ok = 0;
+	}
+
+	QuerySortKey key = (QuerySortKey)codecReader_readByte(&r->reader, ok);
+	int descending = codecReader_readByte(&r->reader, ok);
+	if (key > SORT_EXP_DATE)
+		*ok = 0;
+	matQuery_orderBy(r->query, key, descending);
+	matQuery_setLimit(r->query, (size_t)codecReader_readNumber(&r->reader, ok));
+
+	if (codecReader_readByte(&r->reader, ok)) {
+		if (r->after == NULL && (r->after = material_create()) == NULL)
+			*ok = 0;
+		else {
+			codecReader_readMaterial(&r->reader, r->after, r->strings, r->capacities, ok);
+			matQuery_setAfter(r->query, r->after);
+		}
+	}
+
+	return r->query;
+}
+
+const char* trace_callName(TraceCall call)
+{
+	return call > 0 && call < TRACE_CALL_COUNT ? TRACE_CALLS[call].name : NULL;
+}
+
+// Constructor / Destructor.
+TraceWriter* traceWriter_create(FILE* out)
+{
+	if (fwrite(TRACE_HEADER, 1, sizeof(TRACE_HEADER), out) != sizeof(TRACE_HEADER))
+		return NULL;
+
+	TraceWriter* w = calloc(1, sizeof(TraceWriter));
+	if (w) {
+		w->out = out;
+		codecWriter_init(&w->record);
+	}
+	return w;
+}
+
+void traceWriter_destroy(TraceWriter* w)
+{
+	if (w == NULL)
+		return;
+
+	fflush(w->out);
+	codecWriter_free(&w->record);
+	free(w);
+}
+
+TraceReader* traceReader_create(FILE* in)
+{
+	TraceReader* r = calloc(1, sizeof(TraceReader));
+	if (r == NULL)
+		return NULL;
+
+	codecReader_initFile(&r->reader, in);
+	unsigned char header[sizeof(TRACE_HEADER)];
+	int ok = 1;
+	codecReader_readBytes(&r->reader, header, sizeof(header), &ok);
+	if (!ok || memcmp(header, TRACE_HEADER, sizeof(header)) != 0) {
+		traceReader_destroy(r);
+		return NULL;
+	}
+
+	return r;
+}
+
+void traceReader_destroy(TraceReader* r)
+{
+	if (r == NULL)
+		return;
+
+	codecReader_free(&r->reader);
+	for (size_t i = 0; i < 3; ++i)
+		free(r->strings[i]);
+	matQuery_destroy(r->query);
+	material_destroy(r->after);
+	free(r);
+}
+
+// Properties.
+size_t traceWriter_count(const TraceWriter* w)
+{
+	return w->records;
+}
+
+int traceWriter_failed(const TraceWriter* w)
+{
+	return w->failed;
+}
+
+size_t traceReader_count(const TraceReader* r)
+{
+	return r->records;
+}
+
+// Methods.
+int traceWriter_write(TraceWriter* w, const TraceRecord* rec)
+{
+	const char* name = trace_callName(rec->call);
+	int args = name ? TRACE_CALLS[rec->call].args : 0;
+	if (name == NULL || ((args & TRACE_QUERY_ARG) && rec->query == NULL))
+		return 0;
+
+	codecWriter_clear(&w->record);
+	codecWriter_writeByte(&w->record, (unsigned char)rec->call);
+	if (args & TRACE_ID)
+		codecWriter_writeSigned(&w->record, rec->id);
+	if (args & TRACE_NAME)
+		codecWriter_writeString(&w->record, rec->name);
+	if (args & TRACE_SUPPLIER)
+		codecWriter_writeString(&w->record, rec->supplier);
+	if (args & TRACE_TEXT)
+		codecWriter_writeString(&w->record, rec->text);
+	if (args & TRACE_QUANTITY)
+		codecWriter_writeSigned(&w->record, rec->quantity);
+	if (args & TRACE_DATE)
+		codecWriter_writeDate(&w->record, rec->date);
+	if (args & TRACE_COUNT)
+		codecWriter_writeNumber(&w->record, rec->count);
+	if (args & TRACE_QUERY_ARG)
+		trace_writeQuery(w, rec->query);
+
+
+	size_t length = codecWriter_length(&w->record);
+	if (codecWriter_failed(&w->record) || fwrite(codecWriter_bytes(&w->record), 1, length, w->out) != length)
+		w->failed = 1;
+	++w->records;
+	return !w->failed;
+}
+
+int traceReader_next(TraceReader* r, TraceRecord* rec)
+{
+	codecReader_mark(&r->reader);
+	if (!codecReader_hasMore(&r->reader))
+		return 0;
+
+	int ok = 1;
+	memset(rec, 0, sizeof(TraceRecord));
+	rec->call = (TraceCall)codecReader_readByte(&r->reader, &ok);
+	if (trace_callName(rec->call) == NULL)
+		return -1;
+
+	int args = TRACE_CALLS[rec->call].args;
+	if (args & TRACE_ID)
+		rec->id = (int)codecReader_readSigned(&r->reader, &ok);
+	if (args & TRACE_NAME)
+		rec->name = trace_readString(r, 0, &ok);
+	if (args & TRACE_SUPPLIER)
+		rec->supplier = trace_readString(r, 1, &ok);
+	if (args & TRACE_TEXT)
+		rec->text = trace_readString(r, 2, &ok);
+	if (args & TRACE_QUANTITY)
+		rec->quantity = codecReader_readSigned(&r->reader, &ok);
+	if (args & TRACE_DATE)
+		rec->date = codecReader_readDate(&r->reader, &ok);
+	if (args & TRACE_COUNT)
+		rec->count = (size_t)codecReader_readNumber(&r->reader, &ok);
+	if (args & TRACE_QUERY_ARG)
+		rec->query = trace_readQuery(r, &ok);
+
+	if (!ok)
+		return -1;
+
+	++r->records;
+	return 1;
+}
@@ -0,0 +1,112 @@
+#ifndef MATERIAL_TRACE
+#define MATERIAL_TRACE
+
+#include "MaterialQuery.h"
+#include "Codec.h"
+#include <stdio.h>
+
+// The public calls of a material service that are recorded in a trace.
+typedef enum {
+	TRACE_ADD_OR_UPDATE = 1,
+	TRACE_UPDATE,
+	TRACE_REMOVE,
+	TRACE_UNDO,
+	TRACE_REDO,
+	TRACE_GET_ALL,
+	TRACE_CURSOR_ALL,
+	TRACE_PAST_EXP,
+	TRACE_CURSOR_EXPIRED,
+	TRACE_EXPIRED,
+	TRACE_LOW_STOCK,
+	TRACE_QUERY,
+	TRACE_CURSOR_QUERY,
+	TRACE_COMPLETE_NAME,
+	TRACE_COMPLETE_SUPPLIER,
+	TRACE_FUZZY_SEARCH,
+	TRACE_STATS_BY_SUPPLIER,
+	TRACE_STATS_BY_NAME,
+	TRACE_CALL_COUNT
+} TraceCall;
+
+// One recorded call with its arguments. Only the members used by the call are set:
+// TRACE_ADD_OR_UPDATE: id, name, supplier, quantity, date. TRACE_UPDATE: name, supplier, quantity, date.
+// TRACE_REMOVE: name, supplier, date. TRACE_PAST_EXP and TRACE_CURSOR_EXPIRED: text (can be NULL).
+// TRACE_QUERY and TRACE_CURSOR_QUERY: query. TRACE_COMPLETE_NAME and TRACE_COMPLETE_SUPPLIER: text, count (the maximum results).
+// TRACE_FUZZY_SEARCH: text, count (the maximum distance). TRACE_STATS_BY_SUPPLIER and TRACE_STATS_BY_NAME: text.
+typedef struct {
+	TraceCall call;
+	int id;
+	const char* name;
+	const char* supplier;
+	const char* text;
+	Quantity quantity;
+	Date date;
+	size_t count;
+	const MaterialQuery* query;
+} TraceRecord;
+
+// The internal data for a writer of a binary trace: a short header, then one record per call, each a call byte followed by
+// its arguments (integers, quantities and dates as variable length numbers, strings prefixed by their length, see 'CodecWriter').
+// Do not use struct members directly. Use only methods that start with 'traceWriter_'.
+// The writer must be initialized with 'traceWriter_create' and destroyed with 'traceWriter_destroy'.
+// If not specified otherwise, writer pointer cannot be NULL in writer methods.
+typedef struct {
+	FILE* out;
+	CodecWriter record;
+	size_t records;
+	int failed;
+} TraceWriter;
+
+// The internal data for a reader of a binary trace written by a 'TraceWriter'.
+// Do not use struct members directly. Use only methods that start with 'traceReader_'.
+// The reader must be initialized with 'traceReader_create' and destroyed with 'traceReader_destroy'.
+// If not specified otherwise, reader pointer cannot be NULL in reader methods.
+typedef struct {
+	CodecReader reader;
+	char* strings[3];
+	size_t capacities[3];
+	MaterialQuery* query;
+	Material* after;
+	size_t records;
+} TraceReader;
+
+// Returns the name of the call (for example "add_or_update"), or NULL if the call is not valid.
+const char* trace_callName(TraceCall call);
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize a writer that appends the trace to the given file (opened in binary mode), and write the header.
+// Returns NULL if the header could not be written or the writer could not be allocated. The file is not closed by the writer.
+TraceWriter* traceWriter_create(FILE* out);
+
+// Flush the file and free the writer. If writer is NULL nothing happens.
+void traceWriter_destroy(TraceWriter* w);
+
+// Initialize a reader of the trace in the given file (opened in binary mode), positioned after the header.
+// Returns NULL if the file does not start with a trace header or the reader could not be allocated.
+TraceReader* traceReader_create(FILE* in);
+
+// Free the reader. If reader is NULL nothing happens. The file is not closed by the reader.
+void traceReader_destroy(TraceReader* r);
+
+// PROPERTIES.
+
+// Get the number of records written.
+size_t traceWriter_count(const TraceWriter* w);
+
+// Returns 1 if a write failed (the trace is incomplete), otherwise 0.
+int traceWriter_failed(const TraceWriter* w);
+
+// Get the number of records read.
+size_t traceReader_count(const TraceReader* r);
+
+// METHODS.
+
+// Append the record to the trace. Returns 1 on success, 0 if the record is not valid or could not be written.
+int traceWriter_write(TraceWriter* w, const TraceRecord* rec);
+
+// Read the next record of the trace. The strings and the query of the record are valid until the next call.
+// Returns 1 if a record was read, 0 at the end of the trace and -1 if the trace is corrupt.
+int traceReader_next(TraceReader* r, TraceRecord* rec);
+
+#endif
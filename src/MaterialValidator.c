@@ -1,48 +1,123 @@
 #include "MaterialValidator.h"
 #include <string.h>
-#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MAT_VALID_SSE2
+#include <emmintrin.h>
+#endif
+
+#define MAX_STRING_LENGTH 100
 
 const char* VALID_CHARS = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 `~!@#$%^&*()-_=+[{]}\\|;:'\",<.>/?";
 
+// Lookup table built from VALID_CHARS: 1 if the character is valid, 0 otherwise.
+static unsigned char validTable[256];
+static int validTableReady = 0;
+
+// 1 if the valid characters are exactly the printable ASCII range [0x20, 0x7E], which the vector kernel checks with two compares.
+static int validCharsArePrintable = 0;
+
+static void matValid_initTable()
+{
+	if (validTableReady)
+		return;
+
+	for (size_t i = 0; VALID_CHARS[i] != '\0'; ++i)
+		validTable[(unsigned char)VALID_CHARS[i]] = 1;
+
+	validCharsArePrintable = 1;
+	for (int c = 0; c < 256; ++c) {
+		if (validTable[c] != (c >= 0x20 && c <= 0x7E))
+			validCharsArePrintable = 0;
+	}
+
+	validTableReady = 1;
+}
+
+// Returns 1 if all the 'length' characters of the string are valid, 0 otherwise.
+static int matValid_validChars(const char* str, size_t length)
+{
+	size_t i = 0;
+
+#ifdef MAT_VALID_SSE2
+	// Check 16 characters per step: as signed bytes, the valid ones are greater than 0x1F and less than 0x7F.
+	if (validCharsArePrintable) {
+		const __m128i low = _mm_set1_epi8(0x1F), high = _mm_set1_epi8(0x7F);
+		for (; i + 16 <= length; i += 16) {
+			__m128i chunk = _mm_loadu_si128((const __m128i*)(str + i));
+			__m128i valid = _mm_and_si128(_mm_cmpgt_epi8(chunk, low), _mm_cmplt_epi8(chunk, high));
+			if (_mm_movemask_epi8(valid) != 0xFFFF)
+				return 0;
+		}
+	}
+#endif
+
+	unsigned char allValid = 1;
+	for (; i < length; ++i)
+		allValid &= validTable[(unsigned char)str[i]];
+
+	return allValid;
+}
+
+// Returns 1 if the string is not NULL, has a valid length and only valid characters, 0 otherwise.
+static int matValid_validString(const char* str)
+{
+	if (str == NULL)
+		return 0;
+
+	size_t length = strlen(str);
+	if (length < 1 || length > MAX_STRING_LENGTH)
+		return 0;
+
+	return matValid_validChars(str, length);
+}
+
 int matValid_validate(const Material* mat)
 {
 	if (mat == NULL)
 		return 0;
 
+	matValid_initTable();
+
 	// Id.
 	if (material_id(mat) < 0)
 		return 0;
 
 	// Name.
-	const char* name = material_name(mat);
-	if (name == NULL || strlen(name) < 1 || strlen(name) > 100)
+	if (!matValid_validString(material_name(mat)))
 		return 0;
 
-	for (size_t i = 0; name[i] != '\0'; ++i) {
-		if (!strchr(VALID_CHARS, name[i]))
-			return 0;
-	}
-
 	// Supplier.
-	const char* supplier = material_supplier(mat);
-	if (supplier == NULL || strlen(supplier) < 1 || strlen(supplier) > 100)
+	if (!matValid_validString(material_supplier(mat)))
 		return 0;
 
-	for (size_t i = 0; supplier[i] != '\0'; ++i) {
-		if (!strchr(VALID_CHARS, supplier[i]))
-			return 0;
-	}
-
 	// Quantity.
-	float quantity = material_quantity(mat);
-	if (isnan(quantity) || quantity <= 0.0f || isinf(quantity))
+	Quantity quantity = material_quantity(mat);
+	if (quantity <= 0 || quantity > QUANTITY_MAX)
 		return 0;
 
-	// Expiration date.
-	Date exp_date = material_expDate(mat);
-	int year = exp_date.year, month = exp_date.month, day = exp_date.day;
-	if (year < 1 || month < 1 || month > 12 || day < 1 || day > 31)
+	// Expiration date. Invalid dates (such as 31 February) are stored as not set.
+	if (material_expSerial(mat) == DATE_SERIAL_NONE)
 		return 0;
 
 	return 1;
 }
+
+size_t matValid_validateAll(const Material* const* mats, size_t count, int* results)
+{
+	size_t validCount = 0;
+	for (size_t i = 0; i < count; ++i) {
+		int valid = matValid_validate(mats[i]);
+		if (results)
+			results[i] = valid;
+		validCount += valid;
+	}
+
+	return validCount;
+}
+
+int matValid_validChar(char c)
+{
+	matValid_initTable();
+	return validTable[(unsigned char)c];
+}
@@ -2,8 +2,16 @@
 #define MATERIAL_VALIDATOR
 
 #include "Material.h"
+#include <stdlib.h>
 
 // Validate a given material (can be NULL). Returns 1 if valid, 0 otherwise.
 int matValid_validate(const Material* mat);
 
+// Validate the first 'count' materials of the given array (the materials can be NULL) and returns the number of valid ones.
+// If 'results' is not NULL, it must have room for 'count' values, and the result of each validation is saved there.
+size_t matValid_validateAll(const Material* const* mats, size_t count, int* results);
+
+// Returns 1 if the character is allowed in names and suppliers, 0 otherwise.
+int matValid_validChar(char c);
+
 #endif
@@ -0,0 +1,191 @@
+#include "MaterialViews.h"
+#include "Scan.h"
+#include <string.h>
+
+// Adds the material at the end of the view and maps its id to its position. Nothing is added if the memory could not be allocated.
+static void matViews_add(Vector* view, IntMap* positions, const Material* mat)
+{
+	size_t position = vector_length(view);
+	if (!intMap_put(positions, material_id(mat), position))
+		return;
+
+	vector_add(view, (void*)mat);
+	if (vector_length(view) == position)
+		intMap_remove(positions, material_id(mat));
+}
+
+// Removes the material with the specified id from the view, if it is there, without reading it.
+static void matViews_removeId(Vector* view, IntMap* positions, int id)
+{
+	size_t position;
+	if (!intMap_get(positions, id, &position))
+		return;
+
+	intMap_remove(positions, id);
+	vector_removeFastAt(view, position);
+
+	// The last material took the place of the removed one. Its id is still in the map, so this cannot allocate.
+	if (position < vector_length(view))
+		intMap_put(positions, material_id(vector_get(view, position)), position);
+}
+
+// Returns the threshold of the supplier, or NULL if it has none.
+static LowStockThreshold* matViews_findThreshold(MaterialViews* views, const char* supplier)
+{
+	for (size_t i = 0; i < vector_length(views->thresholds); ++i) {
+		LowStockThreshold* threshold = vector_get(views->thresholds, i);
+		if (strcmp(threshold->supplier, supplier) == 0)
+			return threshold;
+	}
+
+	return NULL;
+}
+
+// Returns 1 if the material belongs in the low stock view.
+static int matViews_isLowStock(MaterialViews* views, const Material* mat)
+{
+	LowStockThreshold* threshold = matViews_findThreshold(views, material_supplier(mat));
+	return threshold != NULL && material_quantity(mat) <= threshold->threshold;
+}
+
+// Constructor / Destructor.
+MaterialViews* matViews_create(MaterialRepository* repository)
+{
+	MaterialViews* views = calloc(1, sizeof(MaterialViews));
+	if (views) {
+		views->repository = repository;
+		views->expired = vector_create(0);
+		intMap_init(&views->expiredPositions);
+		views->lowStock = vector_create(0);
+		intMap_init(&views->lowStockPositions);
+		views->thresholds = vector_create(0);
+	}
+
+	return views;
+}
+
+void matViews_destroy(MaterialViews* views)
+{
+	if (views == NULL)
+		return;
+
+	for (size_t i = 0; i < vector_length(views->thresholds); ++i) {
+		LowStockThreshold* threshold = vector_get(views->thresholds, i);
+		free(threshold->supplier);
+		free(threshold);
+	}
+
+	vector_destroy(views->thresholds);
+	vector_destroy(views->lowStock);
+	intMap_free(&views->lowStockPositions);
+	vector_destroy(views->expired);
+	intMap_free(&views->expiredPositions);
+	free(views);
+}
+
+// Expired view.
+const Vector* matViews_expired(MaterialViews* views, Date today)
+{
+	DateSerial day = date_serialCeil(today);
+	if (views->expiredReady && views->expiredDay == day)
+		return views->expired;
+
+	// A new day: rebuild the view once, with a scan of the expiration dates column.
+	MaterialRepository* repo = views->repository;
+	size_t count = matRepo_matCount(repo);
+	Bitmap* expired = bitmap_create(0);
+	if (expired == NULL)
+		return views->expired;
+
+	scan_intsLess(matRepo_expSerials(repo), count, day, expired);
+
+	vector_clear(views->expired);
+	intMap_free(&views->expiredPositions);
+	vector_reserve(views->expired, bitmap_count(expired));
+	for (size_t i = bitmap_next(expired, 0); i < count; i = bitmap_next(expired, i + 1))
+		matViews_add(views->expired, &views->expiredPositions, matRepo_getByIndex(repo, i));
+
+	bitmap_destroy(expired);
+	views->expiredDay = day;
+	views->expiredReady = 1;
+	return views->expired;
+}
+
+// Low stock view.
+void matViews_setLowStockThreshold(MaterialViews* views, const char* supplier, Quantity threshold)
+{
+	LowStockThreshold* supplierThreshold = matViews_findThreshold(views, supplier);
+
+	if (supplierThreshold == NULL && threshold > 0) {
+		if ((supplierThreshold = calloc(1, sizeof(LowStockThreshold))) == NULL)
+			return;
+		if ((supplierThreshold->supplier = calloc(strlen(supplier) + 1, sizeof(char))) == NULL) {
+			free(supplierThreshold);
+			return;
+		}
+		strcpy(supplierThreshold->supplier, supplier);
+		vector_add(views->thresholds, supplierThreshold);
+	}
+	else if (supplierThreshold != NULL && threshold <= 0) {
+		for (size_t i = 0; i < vector_length(views->thresholds); ++i) {
+			if (vector_get(views->thresholds, i) == supplierThreshold) {
+				vector_removeFastAt(views->thresholds, i);
+				break;
+			}
+		}
+		free(supplierThreshold->supplier);
+		free(supplierThreshold);
+		supplierThreshold = NULL;
+	}
+
+	if (supplierThreshold != NULL)
+		supplierThreshold->threshold = threshold;
+
+	// Drop the materials of the supplier and add back the ones under the new threshold, from the supplier's shard only.
+	for (size_t i = vector_length(views->lowStock); i-- > 0; ) {
+		const Material* mat = vector_get(views->lowStock, i);
+		if (strcmp(material_supplier(mat), supplier) == 0)
+			matViews_removeId(views->lowStock, &views->lowStockPositions, material_id(mat));
+	}
+
+	if (supplierThreshold == NULL)
+		return;
+
+	const Vector* shard = matRepo_getShardBySupplier(views->repository, supplier);
+	for (size_t i = 0; i < vector_length(shard); ++i) {
+		const Material* mat = vector_get(shard, i);
+		if (strcmp(material_supplier(mat), supplier) == 0 && material_quantity(mat) <= threshold)
+			matViews_add(views->lowStock, &views->lowStockPositions, mat);
+	}
+}
+
+Quantity matViews_lowStockThreshold(MaterialViews* views, const char* supplier)
+{
+	LowStockThreshold* threshold = matViews_findThreshold(views, supplier);
+	return threshold ? threshold->threshold : 0;
+}
+
+const Vector* matViews_lowStock(MaterialViews* views)
+{
+	return views->lowStock;
+}
+
+// Changes.
+void matViews_onChange(void* context, const Material* oldMat, const Material* newMat)
+{
+	MaterialViews* views = context;
+
+	if (oldMat) {
+		if (views->expiredReady)
+			matViews_removeId(views->expired, &views->expiredPositions, material_id(oldMat));
+		if (matViews_isLowStock(views, oldMat))
+			matViews_removeId(views->lowStock, &views->lowStockPositions, material_id(oldMat));
+	}
+
+	if (newMat) {
+		if (views->expiredReady && material_expSerial(newMat) < views->expiredDay)
+			matViews_add(views->expired, &views->expiredPositions, newMat);
+		if (matViews_isLowStock(views, newMat))
+			matViews_add(views->lowStock, &views->lowStockPositions, newMat);
+	}
+}
@@ -0,0 +1,63 @@
+#ifndef MATERIAL_VIEWS
+#define MATERIAL_VIEWS
+
+#include "MaterialRepository.h"
+
+// A low stock threshold of a supplier.
+typedef struct {
+	char* supplier;
+	Quantity threshold;
+} LowStockThreshold;
+
+// The internal data for the materialized views of a repository: the expired materials and the materials in low stock.
+// The views hold pointers to the materials of the repository and must be told about every change of the repository
+// (see 'matViews_onChange'), so that reading them costs only the size of the result.
+// Each view maps the ids of its materials to their positions in it, so a change finds them without reading the stored
+// materials, which are already gone when their removal is reported.
+// Do not use struct members directly. Use only methods that start with 'matViews_'.
+// The views must be initialized with 'matViews_create' and destroyed with 'matViews_destroy'.
+// If not specified otherwise, views pointer cannot be NULL in views methods.
+typedef struct {
+	MaterialRepository* repository;
+	Vector* expired;
+	IntMap expiredPositions;
+	DateSerial expiredDay;
+	int expiredReady;
+	Vector* lowStock;
+	IntMap lowStockPositions;
+	Vector* thresholds;
+} MaterialViews;
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize empty views over the given repository.
+MaterialViews* matViews_create(MaterialRepository* repository);
+
+// Release all views resources and free the views. If views is NULL nothing happens.
+void matViews_destroy(MaterialViews* views);
+
+// EXPIRED VIEW.
+
+// Returns the materials that expired before the given day. Don't modify the vector or the materials.
+// The view is rebuilt only when the day differs from the day of the previous call, otherwise it is up to date already.
+const Vector* matViews_expired(MaterialViews* views, Date today);
+
+// LOW STOCK VIEW.
+
+// Set the low stock threshold of a supplier: its materials with the quantity less or equal to it are in low stock.
+// Materials of suppliers without a threshold are never in low stock. A threshold of 0 or less removes the supplier from the view.
+void matViews_setLowStockThreshold(MaterialViews* views, const char* supplier, Quantity threshold);
+
+// Returns the threshold of the supplier, or 0 if it has none.
+Quantity matViews_lowStockThreshold(MaterialViews* views, const char* supplier);
+
+// Returns all the materials in low stock. Don't modify the vector or the materials.
+const Vector* matViews_lowStock(MaterialViews* views);
+
+// CHANGES.
+
+// Update the views for a change of the repository, reported like for a 'MaterialObserver' (the views are the context):
+// 'oldMat' is the material before the change (NULL if it was added) and 'newMat' the stored material (NULL if it is removed).
+void matViews_onChange(void* views, const Material* oldMat, const Material* newMat);
+
+#endif
@@ -0,0 +1,142 @@
+#include "MemoryTracker.h"
+#include <string.h>
+
+// The size of the header that stores the size of a block, keeping the block aligned for any type.
+#define MEM_TRACKER_HEADER 16
+
+// The events counted by a tracker.
+typedef enum { MEM_ALLOC, MEM_REALLOC, MEM_FREE, MEM_FAILURE } MemoryEvent;
+
+static void memTracker_update(MemoryStats* s, MemoryEvent event, size_t oldSize, size_t newSize)
+{
+	if (event == MEM_FAILURE) {
+		++s->failures;
+		return;
+	}
+
+	if (event == MEM_ALLOC) {
+		++s->allocations;
+		++s->blocks;
+	}
+	else if (event == MEM_REALLOC)
+		++s->reallocations;
+	else {
+		++s->frees;
+		--s->blocks;
+	}
+
+	s->bytes = s->bytes - oldSize + newSize;
+	if (s->bytes > s->peakBytes)
+		s->peakBytes = s->bytes;
+}
+
+// Counts the event both in the account and in the total of the tracker.
+static void memTracker_record(MemoryAccount* acc, MemoryEvent event, size_t oldSize, size_t newSize)
+{
+	memTracker_update(&acc->stats, event, oldSize, newSize);
+	memTracker_update(&acc->tracker->total, event, oldSize, newSize);
+}
+
+static void* memTracker_alloc(void* context, size_t size)
+{
+	MemoryAccount* acc = context;
+	if (size > (size_t)-1 - MEM_TRACKER_HEADER) {
+		memTracker_record(acc, MEM_FAILURE, 0, 0);
+		return NULL;
+	}
+
+	char* header = allocator_alloc(acc->tracker->parent, MEM_TRACKER_HEADER + size);
+	if (header == NULL) {
+		memTracker_record(acc, MEM_FAILURE, 0, 0);
+		return NULL;
+	}
+
+	*(size_t*)header = size;
+	memTracker_record(acc, MEM_ALLOC, 0, size);
+	return header + MEM_TRACKER_HEADER;
+}
+
+static void* memTracker_realloc(void* context, void* block, size_t size)
+{
+	MemoryAccount* acc = context;
+	if (block == NULL)
+		return memTracker_alloc(context, size);
+
+	char* header = (char*)block - MEM_TRACKER_HEADER;
+	size_t oldSize = *(size_t*)header;
+	char* newHeader = NULL;
+	if (size <= (size_t)-1 - MEM_TRACKER_HEADER)
+		newHeader = allocator_realloc(acc->tracker->parent, header, MEM_TRACKER_HEADER + size);
+	if (newHeader == NULL) {
+		memTracker_record(acc, MEM_FAILURE, 0, 0);
+		return NULL;
+	}
+
+	*(size_t*)newHeader = size;
+	memTracker_record(acc, MEM_REALLOC, oldSize, size);
+	return newHeader + MEM_TRACKER_HEADER;
+}
+
+static void memTracker_free(void* context, void* block)
+{
+	MemoryAccount* acc = context;
+	char* header = (char*)block - MEM_TRACKER_HEADER;
+	memTracker_record(acc, MEM_FREE, *(size_t*)header, 0);
+	allocator_free(acc->tracker->parent, header);
+}
+
+// Constructor / Destructor.
+MemoryTracker* memTracker_create(const Allocator* parent)
+{
+	MemoryTracker* t = calloc(1, sizeof(MemoryTracker));
+	if (t) {
+		t->parent = parent;
+		t->total.name = "total";
+	}
+
+	return t;
+}
+
+void memTracker_destroy(MemoryTracker* t)
+{
+	free(t);
+}
+
+// Properties.
+size_t memTracker_accountCount(const MemoryTracker* t)
+{
+	return t->accountCount;
+}
+
+const MemoryStats* memTracker_stats(const MemoryTracker* t, size_t index)
+{
+	return index < t->accountCount ? &t->accounts[index].stats : NULL;
+}
+
+const MemoryStats* memTracker_total(const MemoryTracker* t)
+{
+	return &t->total;
+}
+
+// Methods.
+const Allocator* memTracker_allocator(MemoryTracker* t, const char* name)
+{
+	if (name == NULL)
+		return NULL;
+
+	for (size_t i = 0; i < t->accountCount; ++i)
+		if (strcmp(t->accounts[i].stats.name, name) == 0)
+			return &t->accounts[i].allocator;
+
+	if (t->accountCount == MEM_TRACKER_MAX_ACCOUNTS)
+		return NULL;
+
+	MemoryAccount* acc = &t->accounts[t->accountCount++];
+	acc->stats.name = name;
+	acc->tracker = t;
+	acc->allocator.alloc = memTracker_alloc;
+	acc->allocator.realloc = memTracker_realloc;
+	acc->allocator.free = memTracker_free;
+	acc->allocator.context = acc;
+	return &acc->allocator;
+}
@@ -0,0 +1,68 @@
+#ifndef MEMORY_TRACKER
+#define MEMORY_TRACKER
+
+#include "Allocator.h"
+
+// The maximum number of subsystems a tracker accounts for.
+#define MEM_TRACKER_MAX_ACCOUNTS 16
+
+// The memory usage of a subsystem (or of all of them). Sizes are the sizes requested, without the tracking headers.
+typedef struct {
+	const char* name;
+	size_t bytes;
+	size_t peakBytes;
+	size_t blocks;
+	size_t allocations;
+	size_t reallocations;
+	size_t frees;
+	size_t failures;
+} MemoryStats;
+
+struct MemoryTracker;
+
+// An account of a tracker: the allocator handed to a subsystem, and the usage of the memory taken through it.
+typedef struct {
+	Allocator allocator;
+	MemoryStats stats;
+	struct MemoryTracker* tracker;
+} MemoryAccount;
+
+// The internal data for a tracking allocator adapter: every subsystem gets its own allocator (an account, see 'memTracker_allocator'),
+// which takes the memory from the parent allocator and counts the bytes, the live blocks, the allocations and the peak usage.
+// Every block gets a small header with its size, so the tracker must outlive all the memory taken through it.
+// Do not use struct members directly. Use only methods that start with 'memTracker_'.
+// The tracker must be initialized with 'memTracker_create' and destroyed with 'memTracker_destroy'.
+// If not specified otherwise, tracker pointer cannot be NULL in tracker methods.
+typedef struct MemoryTracker {
+	const Allocator* parent;
+	MemoryAccount accounts[MEM_TRACKER_MAX_ACCOUNTS];
+	size_t accountCount;
+	MemoryStats total;
+} MemoryTracker;
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize a tracker without accounts that takes the memory from the given allocator (NULL means the default allocator).
+MemoryTracker* memTracker_create(const Allocator* parent);
+
+// Free the tracker. The memory taken through its allocators must have been given back. If tracker is NULL nothing happens.
+void memTracker_destroy(MemoryTracker* t);
+
+// PROPERTIES.
+
+// Get the number of accounts of the tracker.
+size_t memTracker_accountCount(const MemoryTracker* t);
+
+// Get the usage of the account on the given index, or NULL if the index is invalid.
+const MemoryStats* memTracker_stats(const MemoryTracker* t, size_t index);
+
+// Get the usage of all the accounts together. The peak is the peak of the sum, not the sum of the peaks.
+const MemoryStats* memTracker_total(const MemoryTracker* t);
+
+// METHODS.
+
+// Get the allocator of the account with the given name (the string must stay valid while the tracker is used),
+// adding the account if there is none. Returns NULL if the name is NULL or there are already MEM_TRACKER_MAX_ACCOUNTS accounts.
+const Allocator* memTracker_allocator(MemoryTracker* t, const char* name);
+
+#endif
@@ -0,0 +1,50 @@
+#include "Quantity.h"
+#include <ctype.h>
+
+double quantity_toUnits(Quantity quantity)
+{
+	return (double)quantity / QUANTITY_SCALE;
+}
+
+int quantity_parse(const char* str, Quantity* result)
+{
+	while (isspace((unsigned char)*str))
+		++str;
+
+	int negative = *str == '-';
+	if (*str == '-' || *str == '+')
+		++str;
+
+	Quantity units = 0, fraction = 0;
+	int digits = 0;
+	for (; isdigit((unsigned char)*str); ++str, ++digits) {
+		if (units > QUANTITY_MAX / QUANTITY_SCALE)
+			return 0;
+		units = units * 10 + (*str - '0');
+	}
+
+	// The decimals after the precision of a quantity can only be zeros.
+	int decimals = 0;
+	if (*str == '.') {
+		for (++str; isdigit((unsigned char)*str); ++str, ++digits) {
+			if (decimals < QUANTITY_DECIMALS) {
+				fraction = fraction * 10 + (*str - '0');
+				++decimals;
+			}
+			else if (*str != '0')
+				return 0;
+		}
+	}
+
+	for (; decimals < QUANTITY_DECIMALS; ++decimals)
+		fraction *= 10;
+
+	while (isspace((unsigned char)*str))
+		++str;
+
+	if (digits == 0 || *str != '\0' || units > QUANTITY_MAX / QUANTITY_SCALE || units * QUANTITY_SCALE + fraction > QUANTITY_MAX)
+		return 0;
+
+	*result = negative ? -(units * QUANTITY_SCALE + fraction) : units * QUANTITY_SCALE + fraction;
+	return 1;
+}
@@ -0,0 +1,28 @@
+#ifndef MATERIAL_QUANTITY
+#define MATERIAL_QUANTITY
+
+// A quantity of a material, as a whole number of thousandths of its unit (for example grams of a material counted in kilograms).
+// Integer quantities add up exactly, so repeated additions do not drift and totals are exact, and the columns of quantities
+// are compared with integer instructions. It is a plain number: it does not have an initializer or destructor.
+typedef long long Quantity;
+
+// The number of decimals of a quantity in units, and the number of quantity steps in one unit.
+#define QUANTITY_DECIMALS 3
+#define QUANTITY_SCALE 1000
+
+// The biggest valid quantity (10^12 units). A Quantity holds the total of only about 9200 such materials, so running totals
+// of many materials must be kept wider (see 'MaterialAggregate').
+#define QUANTITY_MAX (1000000000000LL * QUANTITY_SCALE)
+
+// The quantity of the given number of units, rounded to the closest step. Meant for constants: QUANTITY(2.5) is 2500.
+#define QUANTITY(units) ((Quantity)((units) * QUANTITY_SCALE + ((units) < 0 ? -0.5 : 0.5)))
+
+// Returns the quantity as a number of units, for printing.
+double quantity_toUnits(Quantity quantity);
+
+// Parse a decimal number of units with at most QUANTITY_DECIMALS significant decimals (like "12", "-0.5" or "3.125") exactly,
+// and save it in 'result'. Spaces around the number are skipped. Returns 1 on success, or 0 if the string is not such a number
+// or its absolute value is bigger than QUANTITY_MAX (then 'result' is not changed).
+int quantity_parse(const char* str, Quantity* result);
+
+#endif
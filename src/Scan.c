@@ -0,0 +1,103 @@
+#include "Scan.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCAN_SSE2
+#include <emmintrin.h>
+#endif
+
+// Every vector step produces 16 bits, so a step never crosses a word of the bitmap.
+#define SCAN_STEP 16
+
+#ifdef SCAN_SSE2
+// Compares the two 64-bit lanes: a lane is all ones if 'a' is greater. SSE2 has no 64-bit compare, so the high halves are compared
+// as signed numbers and, where they are equal, the low halves as unsigned numbers (by flipping their sign bits).
+static __m128i scan_greater64(__m128i a, __m128i b)
+{
+	const __m128i lowSigns = _mm_set_epi32(0, (int)0x80000000, 0, (int)0x80000000);
+	a = _mm_xor_si128(a, lowSigns);
+	b = _mm_xor_si128(b, lowSigns);
+
+	__m128i greater = _mm_cmpgt_epi32(a, b);
+	__m128i equal = _mm_cmpeq_epi32(a, b);
+	__m128i highGreater = _mm_shuffle_epi32(greater, _MM_SHUFFLE(3, 3, 1, 1));
+	__m128i highEqual = _mm_shuffle_epi32(equal, _MM_SHUFFLE(3, 3, 1, 1));
+	__m128i lowGreater = _mm_shuffle_epi32(greater, _MM_SHUFFLE(2, 2, 0, 0));
+	return _mm_or_si128(highGreater, _mm_and_si128(highEqual, lowGreater));
+}
+#endif
+
+static void scan_longs(const long long* values, size_t count, long long threshold, int greater, Bitmap* result)
+{
+	if (!bitmap_reset(result, count))
+		return;
+
+	unsigned long long* words = bitmap_wordsMutable(result);
+	size_t i = 0;
+
+#ifdef SCAN_SSE2
+	const __m128i t = _mm_set1_epi64x(threshold);
+	const int flip = greater ? 0 : 0x3;
+	for (; i + SCAN_STEP <= count; i += SCAN_STEP) {
+		unsigned long long bits = 0;
+		for (int lane = 0; lane < SCAN_STEP; lane += 2) {
+			__m128i v = _mm_loadu_si128((const __m128i*)(values + i + lane));
+			int above = _mm_movemask_pd(_mm_castsi128_pd(scan_greater64(v, t)));
+			bits |= (unsigned long long)(above ^ flip) << lane;
+		}
+		words[i / BITMAP_WORD_BITS] |= bits << (i % BITMAP_WORD_BITS);
+	}
+#endif
+
+	for (; i < count; ++i) {
+		unsigned long long bit = greater ? values[i] > threshold : values[i] <= threshold;
+		words[i / BITMAP_WORD_BITS] |= bit << (i % BITMAP_WORD_BITS);
+	}
+}
+
+static void scan_ints(const int* values, size_t count, int threshold, int atLeast, Bitmap* result)
+{
+	if (!bitmap_reset(result, count))
+		return;
+
+	unsigned long long* words = bitmap_wordsMutable(result);
+	size_t i = 0;
+
+#ifdef SCAN_SSE2
+	const __m128i t = _mm_set1_epi32(threshold);
+	const int flip = atLeast ? 0xF : 0;
+	for (; i + SCAN_STEP <= count; i += SCAN_STEP) {
+		unsigned long long bits = 0;
+		for (int lane = 0; lane < SCAN_STEP; lane += 4) {
+			__m128i v = _mm_loadu_si128((const __m128i*)(values + i + lane));
+			int less = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(v, t)));
+			bits |= (unsigned long long)(less ^ flip) << lane;
+		}
+		words[i / BITMAP_WORD_BITS] |= bits << (i % BITMAP_WORD_BITS);
+	}
+#endif
+
+	for (; i < count; ++i) {
+		unsigned long long bit = atLeast ? values[i] >= threshold : values[i] < threshold;
+		words[i / BITMAP_WORD_BITS] |= bit << (i % BITMAP_WORD_BITS);
+	}
+}
+
+void scan_longsAtMost(const long long* values, size_t count, long long threshold, Bitmap* result)
+{
+	scan_longs(values, count, threshold, 0, result);
+}
+
+void scan_longsGreater(const long long* values, size_t count, long long threshold, Bitmap* result)
+{
+	scan_longs(values, count, threshold, 1, result);
+}
+
+void scan_intsLess(const int* values, size_t count, int threshold, Bitmap* result)
+{
+	scan_ints(values, count, threshold, 0, result);
+}
+
+void scan_intsAtLeast(const int* values, size_t count, int threshold, Bitmap* result)
+{
+	scan_ints(values, count, threshold, 1, result);
+}
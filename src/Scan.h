@@ -0,0 +1,22 @@
+#ifndef SCAN
+#define SCAN
+
+#include "Bitmap.h"
+
+// Vectorized kernels comparing a contiguous array of values with a threshold.
+// Bit 'i' of the result is set if 'values[i]' matches the comparison. The result is resized to 'count' bits.
+// The values can be NULL only if count is 0.
+
+// Select the values less or equal to the threshold.
+void scan_longsAtMost(const long long* values, size_t count, long long threshold, Bitmap* result);
+
+// Select the values greater than the threshold.
+void scan_longsGreater(const long long* values, size_t count, long long threshold, Bitmap* result);
+
+// Select the values less than the threshold.
+void scan_intsLess(const int* values, size_t count, int threshold, Bitmap* result);
+
+// Select the values greater or equal to the threshold.
+void scan_intsAtLeast(const int* values, size_t count, int threshold, Bitmap* result);
+
+#endif
@@ -0,0 +1,269 @@
+#include "SpanTracer.h"
+#include "LatencyRecorder.h"
+
+// The tracer SPAN_BEGIN and SPAN_END record to.
+static SpanTracer* spanTracer_current = NULL;
+
+// Writes the string as a JSON string.
+static void spanTracer_writeString(SpanTracer* t, const char* str)
+{
+	putc('"', t->out);
+	for (; *str != '\0'; ++str) {
+		if (*str == '"' || *str == '\\')
+			putc('\\', t->out);
+		if ((unsigned char)*str >= 0x20)
+			putc(*str, t->out);
+	}
+	putc('"', t->out);
+}
+
+// Writes the events of the block. Only the writer thread writes, so the file needs no lock.
+static void spanTracer_writeBlock(SpanTracer* t, const SpanBlock* block)
+{
+	// Every event is on its own line; the times are in microseconds, as the format expects.
+	for (size_t i = 0; i < block->length; ++i) {
+		const SpanEvent* e = &block->events[i];
+		fprintf(t->out, "%s\n{", t->written + i > 0 ? "," : "");
+		if (e->name) {
+			fprintf(t->out, "\"name\": ");
+			spanTracer_writeString(t, e->name);
+			fprintf(t->out, ", ");
+		}
+		fprintf(t->out, "\"ph\": \"%c\", \"ts\": %lld.%03lld, \"pid\": 1, \"tid\": %zu}", e->name ? 'B' : 'E', e->time / 1000,
+			e->time % 1000, block->thread + 1);
+	}
+
+	if (ferror(t->out))
+		sync_storeLong(&t->failed, 1);
+}
+
+static void spanTracer_freeBlock(SpanBlock* block)
+{
+	if (block) {
+		free(block->events);
+		free(block);
+	}
+}
+
+// Returns an empty block for the thread: a spare one, or a new one. Returns NULL if the memory could not be allocated.
+// The tracer must be locked.
+static SpanBlock* spanTracer_takeBlock(SpanTracer* t, size_t thread)
+{
+	SpanBlock* block = t->spare;
+	if (block)
+		t->spare = block->next;
+	else if ((block = calloc(1, sizeof(SpanBlock))) != NULL && (block->events = malloc(t->capacity * sizeof(SpanEvent))) == NULL) {
+		free(block);
+		block = NULL;
+	}
+
+	if (block) {
+		block->length = 0;
+		block->thread = thread;
+		block->next = NULL;
+	}
+	return block;
+}
+
+// Queues the block for the writer. The tracer must be locked.
+static void spanTracer_queue(SpanTracer* t, SpanBlock* block)
+{
+	block->next = NULL;
+	if (t->queuedTail)
+		t->queuedTail->next = block;
+	else
+		t->queued = block;
+	t->queuedTail = block;
+	t->handed += block->length;
+	cond_signal(&t->filled);
+}
+
+// Queues the block of the calling thread if it has events and gives the thread an empty one.
+static void spanTracer_handOver(SpanTracer* t, size_t thread)
+{
+	SpanBlock* block = sync_loadPointer((void* volatile*)&t->threads[thread]);
+	if (block && block->length == 0)
+		return;
+
+	mutex_lock(&t->lock);
+	if (block)
+		spanTracer_queue(t, block);
+	SpanBlock* empty = spanTracer_takeBlock(t, thread);
+	mutex_unlock(&t->lock);
+	sync_storePointer((void* volatile*)&t->threads[thread], empty);
+}
+
+// Waits until the writer wrote all the queued blocks.
+static void spanTracer_drain(SpanTracer* t)
+{
+	mutex_lock(&t->lock);
+	while (t->queued || t->writing)
+		cond_wait(&t->emptied, &t->lock);
+	mutex_unlock(&t->lock);
+}
+
+// The writer thread: writes the queued blocks until the tracer stops, and keeps the written blocks for reuse.
+static void spanTracer_run(void* argument)
+{
+	SpanTracer* t = argument;
+	mutex_lock(&t->lock);
+	for (;;) {
+		while (t->queued == NULL && !t->stopping)
+			cond_wait(&t->filled, &t->lock);
+		if (t->queued == NULL)
+			break;
+
+		SpanBlock* block = t->queued;
+		if ((t->queued = block->next) == NULL)
+			t->queuedTail = NULL;
+		t->writing = 1;
+		mutex_unlock(&t->lock);
+
+		spanTracer_writeBlock(t, block);
+
+		mutex_lock(&t->lock);
+		t->written += block->length;
+		block->next = t->spare;
+		t->spare = block;
+		t->writing = 0;
+		cond_broadcast(&t->emptied);
+	}
+	mutex_unlock(&t->lock);
+}
+
+static void spanTracer_record(SpanTracer* t, const char* name)
+{
+	size_t thread = thread_index();
+	if (thread >= SPAN_MAX_THREADS)
+		return;
+
+	SpanBlock* block = sync_loadPointer((void* volatile*)&t->threads[thread]);
+	if (block == NULL) {
+		spanTracer_handOver(t, thread);
+		if ((block = sync_loadPointer((void* volatile*)&t->threads[thread])) == NULL) {
+			sync_storeLong(&t->failed, 1);
+			return;
+		}
+	}
+
+	block->events[block->length].name = name;
+	block->events[block->length].time = latency_now() - t->origin;
+	if (++block->length == t->capacity)
+		spanTracer_handOver(t, thread);
+}
+
+// Constructor / Destructor.
+SpanTracer* spanTracer_create(FILE* out, size_t bufferEvents)
+{
+	SpanTracer* t = calloc(1, sizeof(SpanTracer));
+	if (t == NULL)
+		return NULL;
+
+	t->capacity = bufferEvents > 0 ? bufferEvents : SPAN_DEFAULT_BUFFER;
+	t->out = out;
+	t->origin = latency_now();
+	mutex_init(&t->lock);
+	cond_init(&t->filled);
+	cond_init(&t->emptied);
+
+	if (fprintf(out, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [") < 0)
+		t->failed = 1;
+
+	if (!thread_start(&t->writer, spanTracer_run, t)) {
+		cond_free(&t->emptied);
+		cond_free(&t->filled);
+		mutex_free(&t->lock);
+		free(t);
+		return NULL;
+	}
+
+	return t;
+}
+
+void spanTracer_destroy(SpanTracer* t)
+{
+	if (t == NULL)
+		return;
+
+	if (spanTracer_current == t)
+		spanTracer_current = NULL;
+
+	// No thread records any more: queue the blocks of all of them, in the order they were recorded per thread.
+	mutex_lock(&t->lock);
+	for (size_t i = 0; i < SPAN_MAX_THREADS; ++i) {
+		SpanBlock* block = t->threads[i];
+		t->threads[i] = NULL;
+		if (block && block->length > 0)
+			spanTracer_queue(t, block);
+		else
+			spanTracer_freeBlock(block);
+	}
+	t->stopping = 1;
+	cond_signal(&t->filled);
+	mutex_unlock(&t->lock);
+	thread_join(&t->writer);
+
+	if (fprintf(t->out, "\n]}\n") < 0 || fflush(t->out) != 0)
+		t->failed = 1;
+
+	while (t->spare) {
+		SpanBlock* next = t->spare->next;
+		spanTracer_freeBlock(t->spare);
+		t->spare = next;
+	}
+	cond_free(&t->emptied);
+	cond_free(&t->filled);
+	mutex_free(&t->lock);
+	free(t);
+}
+
+// Properties.
+size_t spanTracer_count(const SpanTracer* t)
+{
+	mutex_lock((Mutex*)&t->lock);
+	size_t count = t->handed;
+	mutex_unlock((Mutex*)&t->lock);
+
+	for (size_t i = 0; i < SPAN_MAX_THREADS; ++i) {
+		const SpanBlock* block = sync_loadPointer((void* volatile*)&t->threads[i]);
+		if (block)
+			count += block->length;
+	}
+	return count;
+}
+
+int spanTracer_failed(const SpanTracer* t)
+{
+	return sync_loadLong((volatile long*)&t->failed) != 0;
+}
+
+void spanTracer_install(SpanTracer* t)
+{
+	spanTracer_current = t;
+}
+
+SpanTracer* spanTracer_installed()
+{
+	return spanTracer_current;
+}
+
+// Methods.
+void spanTracer_begin(SpanTracer* t, const char* name)
+{
+	if (t)
+		spanTracer_record(t, name ? name : "");
+}
+
+void spanTracer_end(SpanTracer* t)
+{
+	if (t)
+		spanTracer_record(t, NULL);
+}
+
+void spanTracer_flush(SpanTracer* t)
+{
+	size_t thread = thread_index();
+	if (thread < SPAN_MAX_THREADS)
+		spanTracer_handOver(t, thread);
+	spanTracer_drain(t);
+}
@@ -0,0 +1,105 @@
+#ifndef SPAN_TRACER
+#define SPAN_TRACER
+
+#include "Thread.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// The number of events a thread keeps in a block before handing it to the writer, if not specified otherwise.
+#define SPAN_DEFAULT_BUFFER 0x4000
+
+// The number of threads a tracer records. The spans of the threads with a bigger index (see 'thread_index') are not recorded.
+#define SPAN_MAX_THREADS 64
+
+// Spans are compiled in only if MAT_SPANS is defined (for example with '/D MAT_SPANS'). Otherwise the macros are empty,
+// so the instrumented code costs nothing. When compiled in, they record to the installed tracer (see 'spanTracer_install'),
+// and cost a pointer check while no tracer is installed.
+// Every SPAN_BEGIN must be matched by a SPAN_END on every path out of the span. The name must be a string that stays valid
+// until the tracer is destroyed, usually a literal.
+#ifdef MAT_SPANS
+#define SPAN_BEGIN(name) spanTracer_begin(spanTracer_installed(), (name))
+#define SPAN_END() spanTracer_end(spanTracer_installed())
+#else
+#define SPAN_BEGIN(name) ((void)0)
+#define SPAN_END() ((void)0)
+#endif
+
+// A begin or end of a span, as kept in the buffer of a tracer.
+typedef struct {
+	const char* name;
+	long long time;
+} SpanEvent;
+
+// A block of the events of one thread.
+typedef struct SpanBlock {
+	SpanEvent* events;
+	size_t length;
+	size_t thread;
+	struct SpanBlock* next;
+} SpanBlock;
+
+// The internal data for a writer of nested spans (the time a call took, inside the calls it was made from) as a Chrome
+// trace event file, which can be opened in Perfetto or chrome://tracing. Each thread records to its own block of events,
+// without a lock. A full block is queued for a background writer thread and the recording thread goes on with an empty
+// block, so recording a span never waits for the file; it takes a lock only once per block.
+// Every thread is a track of its own in the file.
+// Do not use struct members directly. Use only methods that start with 'spanTracer_'.
+// The tracer must be initialized with 'spanTracer_create' and destroyed with 'spanTracer_destroy', which completes the file.
+// If not specified otherwise, tracer pointer cannot be NULL in tracer methods.
+typedef struct {
+	FILE* out;
+	size_t capacity;
+	long long origin;
+	SpanBlock* volatile threads[SPAN_MAX_THREADS];
+	SpanBlock* queued;
+	SpanBlock* queuedTail;
+	SpanBlock* spare;
+	int writing;
+	int stopping;
+	Mutex lock;
+	Condition filled;
+	Condition emptied;
+	Thread writer;
+	size_t handed;
+	size_t written;
+	volatile long failed;
+} SpanTracer;
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize a tracer that writes to the given file, handing the events of a thread to the writer in blocks of 'bufferEvents'
+// (0 means SPAN_DEFAULT_BUFFER), and start its writer thread. The times are measured from the creation of the tracer.
+// Returns NULL if the memory could not be allocated or the thread could not be started.
+SpanTracer* spanTracer_create(FILE* out, size_t bufferEvents);
+
+// Write the buffered events of all the threads and the end of the file, stop the writer thread, uninstall the tracer if it
+// is installed and free it. No other thread can record meanwhile. The file is not closed. If tracer is NULL nothing happens.
+void spanTracer_destroy(SpanTracer* t);
+
+// PROPERTIES.
+
+// Get the number of events recorded (buffered or written). Exact only while no other thread records.
+size_t spanTracer_count(const SpanTracer* t);
+
+// Returns 1 if a write failed or an event could not be buffered (the file is incomplete), otherwise 0.
+int spanTracer_failed(const SpanTracer* t);
+
+// Make the tracer the one SPAN_BEGIN and SPAN_END record to (NULL stops recording). The tracer is not destroyed when replaced.
+// Install it before the threads that record start, and uninstall it after they stop.
+void spanTracer_install(SpanTracer* t);
+
+// Get the installed tracer, or NULL if there is none.
+SpanTracer* spanTracer_installed();
+
+// METHODS.
+
+// Record the start of a span with the given name. If tracer is NULL nothing happens.
+void spanTracer_begin(SpanTracer* t, const char* name);
+
+// Record the end of the last span that was started and not ended yet. If tracer is NULL nothing happens.
+void spanTracer_end(SpanTracer* t);
+
+// Hand the buffered events of the calling thread to the writer and wait until it wrote all the queued events.
+void spanTracer_flush(SpanTracer* t);
+
+#endif
@@ -0,0 +1,300 @@
+#include "StringTrie.h"
+#include <string.h>
+
+// Returns a copy of the first 'length' characters of the string, or NULL on failure.
+static char* trie_copy(const Allocator* a, const char* str, size_t length)
+{
+	char* copy = allocator_calloc(a, length + 1, sizeof(char));
+	if (copy)
+		memcpy(copy, str, length);
+	return copy;
+}
+
+static TrieNode* trie_createNode(const Allocator* a, const char* label, size_t length)
+{
+	TrieNode* node = allocator_calloc(a, 1, sizeof(TrieNode));
+	if (node && (node->label = trie_copy(a, label, length)) == NULL) {
+		allocator_free(a, node);
+		node = NULL;
+	}
+
+	return node;
+}
+
+static void trie_destroyNode(const Allocator* a, TrieNode* node)
+{
+	if (node == NULL)
+		return;
+
+	for (size_t i = 0; i < node->childCount; ++i)
+		trie_destroyNode(a, node->children[i]);
+
+	allocator_free(a, node->children);
+	allocator_free(a, node->label);
+	allocator_free(a, node->value);
+	allocator_free(a, node);
+}
+
+// Returns the index of the child whose label starts with the character, or where such a child would be inserted.
+static size_t trie_findChild(const TrieNode* node, char c)
+{
+	size_t left = 0, right = node->childCount;
+	while (left < right) {
+		size_t middle = left + (right - left) / 2;
+		if ((unsigned char)node->children[middle]->label[0] < (unsigned char)c)
+			left = middle + 1;
+		else
+			right = middle;
+	}
+
+	return left;
+}
+
+// Returns 1 if the node has a child on the index that starts with the character.
+static int trie_hasChild(const TrieNode* node, size_t index, char c)
+{
+	return index < node->childCount && node->children[index]->label[0] == c;
+}
+
+static int trie_insertChild(const Allocator* a, TrieNode* node, size_t index, TrieNode* child)
+{
+	if (node->childCount == node->childCapacity) {
+		size_t newCapacity = node->childCapacity ? node->childCapacity * 2 : 2;
+		TrieNode** newChildren = allocator_realloc(a, node->children, newCapacity * sizeof(TrieNode*));
+		if (newChildren == NULL)
+			return 0;
+		node->children = newChildren;
+		node->childCapacity = newCapacity;
+	}
+
+	memmove(node->children + index + 1, node->children + index, (node->childCount - index) * sizeof(TrieNode*));
+	node->children[index] = child;
+	++node->childCount;
+	return 1;
+}
+
+// Merges a node without a value and with a single child into that child.
+static void trie_mergeWithChild(const Allocator* a, TrieNode* node)
+{
+	TrieNode* child = node->children[0];
+	size_t nodeLength = strlen(node->label), childLength = strlen(child->label);
+
+	char* label = allocator_calloc(a, nodeLength + childLength + 1, sizeof(char));
+	if (label == NULL)
+		return;
+	memcpy(label, node->label, nodeLength);
+	memcpy(label + nodeLength, child->label, childLength);
+
+	allocator_free(a, node->label);
+	allocator_free(a, node->children);
+	node->label = label;
+	node->value = child->value;
+	node->count = child->count;
+	node->children = child->children;
+	node->childCount = child->childCount;
+	node->childCapacity = child->childCapacity;
+
+	allocator_free(a, child->label);
+	allocator_free(a, child);
+}
+
+// Removes the string from the subtree of the node ('rest' is the part of the string after the node). Returns 1 if removed.
+static int trie_removeFrom(StringTrie* t, TrieNode* node, const char* rest)
+{
+	size_t index = trie_findChild(node, rest[0]);
+	if (!trie_hasChild(node, index, rest[0]))
+		return 0;
+
+	TrieNode* child = node->children[index];
+	size_t labelLength = strlen(child->label);
+	if (strncmp(child->label, rest, labelLength) != 0)
+		return 0;
+
+	rest += labelLength;
+	if (rest[0] != '\0') {
+		if (!trie_removeFrom(t, child, rest))
+			return 0;
+	}
+	else {
+		if (child->count == 0)
+			return 0;
+		if (--child->count > 0)
+			return 1;
+
+		allocator_free(t->allocator, child->value);
+		child->value = NULL;
+		--t->size;
+	}
+
+	// Keep the tree compressed: drop empty leaves and merge nodes left with a single child.
+	if (child->value == NULL && child->childCount == 0) {
+		trie_destroyNode(t->allocator, child);
+		memmove(node->children + index, node->children + index + 1, (node->childCount - index - 1) * sizeof(TrieNode*));
+		--node->childCount;
+	}
+	else if (child->value == NULL && child->childCount == 1)
+		trie_mergeWithChild(t->allocator, child);
+
+	return 1;
+}
+
+// Saves the values of the subtree in alphabetical order until the vector has 'maxResults' strings (0 means no limit).
+static void trie_collect(const TrieNode* node, Vector* v, size_t maxResults, size_t* saved)
+{
+	if (maxResults > 0 && *saved >= maxResults)
+		return;
+
+	if (node->value) {
+		vector_add(v, node->value);
+		++*saved;
+	}
+
+	for (size_t i = 0; i < node->childCount; ++i)
+		trie_collect(node->children[i], v, maxResults, saved);
+}
+
+// Constructor / Destructor.
+StringTrie* trie_create()
+{
+	return trie_createWith(NULL);
+}
+
+StringTrie* trie_createWith(const Allocator* allocator)
+{
+	StringTrie* t = allocator_calloc(allocator, 1, sizeof(StringTrie));
+	if (t) {
+		t->allocator = allocator;
+		if ((t->root = trie_createNode(allocator, "", 0)) == NULL) {
+			allocator_free(allocator, t);
+			t = NULL;
+		}
+	}
+
+	return t;
+}
+
+void trie_destroy(StringTrie* t)
+{
+	if (t == NULL)
+		return;
+
+	trie_destroyNode(t->allocator, t->root);
+	allocator_free(t->allocator, t);
+}
+
+// Properties.
+size_t trie_size(const StringTrie* t)
+{
+	return t->size;
+}
+
+size_t trie_count(const StringTrie* t, const char* str)
+{
+	const TrieNode* node = t->root;
+	while (str[0] != '\0') {
+		size_t index = trie_findChild(node, str[0]);
+		if (!trie_hasChild(node, index, str[0]))
+			return 0;
+
+		node = node->children[index];
+		size_t labelLength = strlen(node->label);
+		if (strncmp(node->label, str, labelLength) != 0)
+			return 0;
+		str += labelLength;
+	}
+
+	return node->count;
+}
+
+// Methods.
+const char* trie_insert(StringTrie* t, const char* str)
+{
+	const char* rest = str;
+	TrieNode* node = t->root;
+
+	while (rest[0] != '\0') {
+		size_t index = trie_findChild(node, rest[0]);
+		if (!trie_hasChild(node, index, rest[0])) {
+			TrieNode* leaf = trie_createNode(t->allocator, rest, strlen(rest));
+			if (leaf == NULL || !trie_insertChild(t->allocator, node, index, leaf)) {
+				trie_destroyNode(t->allocator, leaf);
+				return NULL;
+			}
+			node = leaf;
+			break;
+		}
+
+		TrieNode* child = node->children[index];
+		size_t common = 0;
+		while (child->label[common] != '\0' && child->label[common] == rest[common])
+			++common;
+
+		// Split the edge where the string leaves it.
+		if (child->label[common] != '\0') {
+			TrieNode* middle = trie_createNode(t->allocator, child->label, common);
+			char* childLabel = trie_copy(t->allocator, child->label + common, strlen(child->label + common));
+			if (middle == NULL || childLabel == NULL || !trie_insertChild(t->allocator, middle, 0, child)) {
+				trie_destroyNode(t->allocator, middle);
+				allocator_free(t->allocator, childLabel);
+				return NULL;
+			}
+
+			allocator_free(t->allocator, child->label);
+			child->label = childLabel;
+			node->children[index] = middle;
+			child = middle;
+		}
+
+		node = child;
+		rest += common;
+	}
+
+	if (node->value == NULL) {
+		if ((node->value = trie_copy(t->allocator, str, strlen(str))) == NULL)
+			return NULL;
+		++t->size;
+	}
+
+	++node->count;
+	return node->value;
+}
+
+void trie_remove(StringTrie* t, const char* str)
+{
+	if (str[0] == '\0') {
+		if (t->root->count > 0 && --t->root->count == 0) {
+			allocator_free(t->allocator, t->root->value);
+			t->root->value = NULL;
+			--t->size;
+		}
+		return;
+	}
+
+	trie_removeFrom(t, t->root, str);
+}
+
+size_t trie_complete(const StringTrie* t, const char* prefix, Vector* v, size_t maxResults)
+{
+	const TrieNode* node = t->root;
+	const char* rest = prefix;
+
+	// Walk down while the prefix continues; it may end in the middle of an edge.
+	while (rest[0] != '\0') {
+		size_t index = trie_findChild(node, rest[0]);
+		if (!trie_hasChild(node, index, rest[0]))
+			return 0;
+
+		node = node->children[index];
+		size_t common = 0;
+		while (node->label[common] != '\0' && node->label[common] == rest[common])
+			++common;
+
+		if (rest[common] != '\0' && node->label[common] != '\0')
+			return 0;
+		rest += common;
+	}
+
+	size_t saved = 0;
+	trie_collect(node, v, maxResults, &saved);
+	return saved;
+}
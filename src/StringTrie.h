@@ -0,0 +1,59 @@
+#ifndef STRING_TRIE
+#define STRING_TRIE
+
+#include "Vector.h"
+
+// A node of the trie. The label is the part of the key on the edge from the parent to the node.
+typedef struct TrieNode {
+	char* label;
+	char* value;
+	size_t count;
+	struct TrieNode** children;
+	size_t childCount;
+	size_t childCapacity;
+} TrieNode;
+
+// The internal data used to represent a set of strings with reference counts, stored in a radix tree (compressed trie),
+// used to find the strings starting with a given prefix. Every distinct string is stored once (interned).
+// Do not use struct members directly. Use only methods that start with 'trie_'.
+// You need to initialize the trie with 'trie_create', and destroy it with 'trie_destroy' when you are done.
+// If not specified otherwise, trie pointer and strings cannot be NULL in trie methods.
+typedef struct {
+	TrieNode* root;
+	size_t size;
+	const Allocator* allocator;
+} StringTrie;
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize an empty trie.
+StringTrie* trie_create();
+
+// Initialize an empty trie whose nodes and strings are taken from the given allocator (NULL means the default allocator).
+StringTrie* trie_createWith(const Allocator* allocator);
+
+// Destroy the trie and all its strings. If pointer is NULL nothing happens.
+void trie_destroy(StringTrie* t);
+
+// PROPERTIES.
+
+// Get the number of distinct strings in the trie.
+size_t trie_size(const StringTrie* t);
+
+// Get how many times the string was inserted and not removed (0 if it is not in the trie).
+size_t trie_count(const StringTrie* t, const char* str);
+
+// METHODS.
+
+// Insert the string (or increase its count if it is already in the trie) and return the interned copy, or NULL on failure.
+// The interned copy is valid until the string is removed as many times as it was inserted.
+const char* trie_insert(StringTrie* t, const char* str);
+
+// Decrease the count of the string, removing it when the count reaches 0. If the string is not in the trie nothing happens.
+void trie_remove(StringTrie* t, const char* str);
+
+// Saves in the given vector the interned strings starting with the prefix, in alphabetical order, at most 'maxResults' of them
+// (0 means no limit), and returns how many were saved. Only the part of the trie under the prefix is visited.
+size_t trie_complete(const StringTrie* t, const char* prefix, Vector* v, size_t maxResults);
+
+#endif
@@ -0,0 +1,236 @@
+#include "Thread.h"
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+// The number of threads that asked for their index, and the index of the calling thread plus 1 (0 until it asks).
+static volatile long threadCount = 0;
+static THREAD_LOCAL size_t threadIndex = 0;
+
+size_t thread_index()
+{
+	if (threadIndex == 0)
+		threadIndex = (size_t)sync_addLong(&threadCount, 1);
+	return threadIndex - 1;
+}
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <process.h>
+
+static unsigned __stdcall thread_run(void* argument)
+{
+	Thread* t = argument;
+	t->function(t->argument);
+	return 0;
+}
+
+// Threads.
+int thread_start(Thread* t, ThreadFunction function, void* argument)
+{
+	t->function = function;
+	t->argument = argument;
+	t->handle = (void*)_beginthreadex(NULL, 0, thread_run, t, 0, NULL);
+	return t->handle != NULL;
+}
+
+void thread_join(Thread* t)
+{
+	WaitForSingleObject((HANDLE)t->handle, INFINITE);
+	CloseHandle((HANDLE)t->handle);
+}
+
+void thread_yield()
+{
+	SwitchToThread();
+}
+
+// Locks.
+void mutex_init(Mutex* m)
+{
+	InitializeSRWLock((PSRWLOCK)&m->lock);
+}
+
+void mutex_free(Mutex* m)
+{
+	// A slim lock holds no resources.
+	(void)m;
+}
+
+void mutex_lock(Mutex* m)
+{
+	AcquireSRWLockExclusive((PSRWLOCK)&m->lock);
+}
+
+void mutex_unlock(Mutex* m)
+{
+	ReleaseSRWLockExclusive((PSRWLOCK)&m->lock);
+}
+
+void cond_init(Condition* c)
+{
+	InitializeConditionVariable((PCONDITION_VARIABLE)&c->cond);
+}
+
+void cond_free(Condition* c)
+{
+	// A condition variable holds no resources.
+	(void)c;
+}
+
+void cond_wait(Condition* c, Mutex* m)
+{
+	SleepConditionVariableSRW((PCONDITION_VARIABLE)&c->cond, (PSRWLOCK)&m->lock, INFINITE, 0);
+}
+
+void cond_signal(Condition* c)
+{
+	WakeConditionVariable((PCONDITION_VARIABLE)&c->cond);
+}
+
+void cond_broadcast(Condition* c)
+{
+	WakeAllConditionVariable((PCONDITION_VARIABLE)&c->cond);
+}
+
+// Atomic operations.
+void* sync_exchangePointer(void* volatile* target, void* value)
+{
+	return InterlockedExchangePointer(target, value);
+}
+
+void* sync_loadPointer(void* volatile* target)
+{
+	return InterlockedCompareExchangePointer(target, NULL, NULL);
+}
+
+void sync_storePointer(void* volatile* target, void* value)
+{
+	InterlockedExchangePointer(target, value);
+}
+
+long sync_loadLong(volatile long* target)
+{
+	return InterlockedCompareExchange(target, 0, 0);
+}
+
+void sync_storeLong(volatile long* target, long value)
+{
+	InterlockedExchange(target, value);
+}
+
+long sync_addLong(volatile long* target, long value)
+{
+	return InterlockedExchangeAdd(target, value) + value;
+}
+
+#else
+#include <sched.h>
+
+static void* thread_run(void* argument)
+{
+	Thread* t = argument;
+	t->function(t->argument);
+	return NULL;
+}
+
+// Threads.
+int thread_start(Thread* t, ThreadFunction function, void* argument)
+{
+	t->function = function;
+	t->argument = argument;
+	return pthread_create(&t->handle, NULL, thread_run, t) == 0;
+}
+
+void thread_join(Thread* t)
+{
+	pthread_join(t->handle, NULL);
+}
+
+void thread_yield()
+{
+	sched_yield();
+}
+
+// Locks.
+void mutex_init(Mutex* m)
+{
+	pthread_mutex_init(&m->lock, NULL);
+}
+
+void mutex_free(Mutex* m)
+{
+	pthread_mutex_destroy(&m->lock);
+}
+
+void mutex_lock(Mutex* m)
+{
+	pthread_mutex_lock(&m->lock);
+}
+
+void mutex_unlock(Mutex* m)
+{
+	pthread_mutex_unlock(&m->lock);
+}
+
+void cond_init(Condition* c)
+{
+	pthread_cond_init(&c->cond, NULL);
+}
+
+void cond_free(Condition* c)
+{
+	pthread_cond_destroy(&c->cond);
+}
+
+void cond_wait(Condition* c, Mutex* m)
+{
+	pthread_cond_wait(&c->cond, &m->lock);
+}
+
+void cond_signal(Condition* c)
+{
+	pthread_cond_signal(&c->cond);
+}
+
+void cond_broadcast(Condition* c)
+{
+	pthread_cond_broadcast(&c->cond);
+}
+
+// Atomic operations.
+void* sync_exchangePointer(void* volatile* target, void* value)
+{
+	return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+void* sync_loadPointer(void* volatile* target)
+{
+	return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+}
+
+void sync_storePointer(void* volatile* target, void* value)
+{
+	__atomic_store_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+long sync_loadLong(volatile long* target)
+{
+	return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+}
+
+void sync_storeLong(volatile long* target, long value)
+{
+	__atomic_store_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+long sync_addLong(volatile long* target, long value)
+{
+	return __atomic_add_fetch(target, value, __ATOMIC_SEQ_CST);
+}
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef THREAD
+#define THREAD
+
+// Threads, locks and atomic operations: the Windows primitives (_beginthreadex, SRWLOCK, CONDITION_VARIABLE and the
+// Interlocked functions), or POSIX threads and the GCC atomic builtins elsewhere.
+// On Windows the handles are kept as pointers, the size of the Windows types, so that <windows.h> is not included here.
+#include <stdlib.h>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+// The function a thread runs, with the argument given to 'thread_start'.
+typedef void(*ThreadFunction)(void* argument);
+
+// A running thread. It must be started with 'thread_start' and joined with 'thread_join'.
+typedef struct {
+#ifdef _WIN32
+	void* handle;
+#else
+	pthread_t handle;
+#endif
+	ThreadFunction function;
+	void* argument;
+} Thread;
+
+// A lock that is not recursive. It must be initialized with 'mutex_init' and released with 'mutex_free'.
+typedef struct {
+#ifdef _WIN32
+	void* lock;
+#else
+	pthread_mutex_t lock;
+#endif
+} Mutex;
+
+// A condition threads wait for while holding a mutex. It must be initialized with 'cond_init' and released with 'cond_free'.
+typedef struct {
+#ifdef _WIN32
+	void* cond;
+#else
+	pthread_cond_t cond;
+#endif
+} Condition;
+
+// THREADS.
+
+// Start a thread that runs the function with the argument. The thread struct must stay valid until it is joined.
+// Returns 1 on success, otherwise 0.
+int thread_start(Thread* t, ThreadFunction function, void* argument);
+
+// Wait until the thread returns and release it.
+void thread_join(Thread* t);
+
+// Let the other threads run before the calling one goes on.
+void thread_yield();
+
+// Returns a small number that stays the same for the calling thread: 0 for the first thread that asks, 1 for the next one...
+// The numbers are not reused when threads end.
+size_t thread_index();
+
+// LOCKS.
+
+void mutex_init(Mutex* m);
+void mutex_free(Mutex* m);
+void mutex_lock(Mutex* m);
+void mutex_unlock(Mutex* m);
+
+void cond_init(Condition* c);
+void cond_free(Condition* c);
+
+// Unlock the mutex (locked by the calling thread), wait until the condition is signaled and lock the mutex again.
+// The wait can also end without a signal, so the waited state must be checked again in a loop.
+void cond_wait(Condition* c, Mutex* m);
+
+// Wake one of the threads waiting for the condition, or all of them.
+void cond_signal(Condition* c);
+void cond_broadcast(Condition* c);
+
+// ATOMIC OPERATIONS. All of them are full memory barriers.
+
+// Store the pointer and return the one stored before.
+void* sync_exchangePointer(void* volatile* target, void* value);
+
+// Load or store the pointer.
+void* sync_loadPointer(void* volatile* target);
+void sync_storePointer(void* volatile* target, void* value);
+
+// Load or store the number, or add to it and return the new value.
+long sync_loadLong(volatile long* target);
+void sync_storeLong(volatile long* target, long value);
+long sync_addLong(volatile long* target, long value);
+
+#endif
@@ -0,0 +1,153 @@
+#include "TimingWheel.h"
+
+#define WHEEL_BITS 6
+
+static void wheel_unlink(WheelTimer* t)
+{
+	t->prev->next = t->next;
+	t->next->prev = t->prev;
+	t->prev = t->next = t;
+}
+
+// Links the timer in the slot of its time: the lowest level where the time and the current time share the same block.
+// The time must not be before the current time.
+static void wheel_place(TimingWheel* w, WheelTimer* t)
+{
+	int level = 0;
+	while (level < WHEEL_LEVELS - 1 && (t->when >> (WHEEL_BITS * (level + 1))) != (w->now >> (WHEEL_BITS * (level + 1))))
+		++level;
+
+	WheelTimer* head = &w->slots[level][(t->when >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1)];
+	t->prev = head->prev;
+	t->next = head;
+	head->prev->next = t;
+	head->prev = t;
+}
+
+// Moves the timers of the slot to the slots matching the current time.
+static void wheel_cascade(TimingWheel* w, int level, size_t slot)
+{
+	WheelTimer* head = &w->slots[level][slot];
+	if (head->next == head)
+		return;
+
+	// Detach the list first, since timers can land in the same slot again.
+	WheelTimer* first = head->next;
+	head->prev->next = NULL;
+	head->prev = head->next = head;
+
+	while (first != NULL) {
+		WheelTimer* next = first->next;
+		wheel_place(w, first);
+		first = next;
+	}
+}
+
+// Constructor / Destructor.
+TimingWheel* wheel_create(long now)
+{
+	TimingWheel* w = calloc(1, sizeof(TimingWheel));
+	if (w == NULL)
+		return NULL;
+
+	w->now = now;
+	for (int level = 0; level < WHEEL_LEVELS; ++level) {
+		for (size_t slot = 0; slot < WHEEL_SLOTS; ++slot)
+			w->slots[level][slot].prev = w->slots[level][slot].next = &w->slots[level][slot];
+	}
+
+	return w;
+}
+
+void wheel_destroy(TimingWheel* w)
+{
+	if (w == NULL)
+		return;
+
+	for (int level = 0; level < WHEEL_LEVELS; ++level) {
+		for (size_t slot = 0; slot < WHEEL_SLOTS; ++slot) {
+			WheelTimer* head = &w->slots[level][slot];
+			while (head->next != head) {
+				WheelTimer* t = head->next;
+				wheel_unlink(t);
+				free(t);
+			}
+		}
+	}
+
+	free(w);
+}
+
+// Properties.
+long wheel_now(const TimingWheel* w)
+{
+	return w->now;
+}
+
+size_t wheel_count(const TimingWheel* w)
+{
+	return w->count;
+}
+
+// Methods.
+WheelTimer* wheel_schedule(TimingWheel* w, long when, void* item)
+{
+	WheelTimer* t = malloc(sizeof(WheelTimer));
+	if (t == NULL)
+		return NULL;
+
+	t->item = item;
+	t->when = when > w->now ? when : w->now + 1;
+	wheel_place(w, t);
+	++w->count;
+	return t;
+}
+
+void wheel_reschedule(TimingWheel* w, WheelTimer* t, long when)
+{
+	wheel_unlink(t);
+	t->when = when > w->now ? when : w->now + 1;
+	wheel_place(w, t);
+}
+
+void wheel_cancel(TimingWheel* w, WheelTimer* t)
+{
+	if (t == NULL)
+		return;
+
+	wheel_unlink(t);
+	free(t);
+	--w->count;
+}
+
+size_t wheel_advance(TimingWheel* w, long now, void(*fire)(void* context, void* item), void* context)
+{
+	size_t fired = 0;
+	while (w->now < now) {
+		// Nothing can fire, so jump straight to the end.
+		if (w->count == 0) {
+			w->now = now;
+			break;
+		}
+
+		++w->now;
+
+		// Bring down the timers of the higher levels whose block starts now, highest first.
+		for (int level = WHEEL_LEVELS - 1; level > 0; --level) {
+			if ((w->now & ((1L << (WHEEL_BITS * level)) - 1)) == 0)
+				wheel_cascade(w, level, (w->now >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1));
+		}
+
+		WheelTimer* head = &w->slots[0][w->now & (WHEEL_SLOTS - 1)];
+		while (head->next != head) {
+			WheelTimer* t = head->next;
+			wheel_unlink(t);
+			--w->count;
+			++fired;
+			fire(context, t->item);
+			free(t);
+		}
+	}
+
+	return fired;
+}
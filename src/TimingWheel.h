@@ -0,0 +1,65 @@
+#ifndef TIMING_WHEEL
+#define TIMING_WHEEL
+
+#include <stdlib.h>
+
+// The number of levels of the wheel, and the number of slots of a level.
+// Level 'L' covers 64^(L+1) ticks, so the wheel holds timers up to 2^24 ticks in the future.
+#define WHEEL_LEVELS 4
+#define WHEEL_SLOTS 64
+
+// A timer of a timing wheel, linked in the list of its slot. Do not modify it.
+typedef struct WheelTimer {
+	struct WheelTimer* prev;
+	struct WheelTimer* next;
+	long when;
+	void* item;
+} WheelTimer;
+
+// The internal data for a hierarchical timing wheel: timers are hashed into slots by the time they fire, so scheduling,
+// rescheduling and cancelling a timer are O(1), and advancing the time only touches the timers that are due (plus
+// moving the timers of a higher level slot down when the lower level wraps around).
+// Times are ticks (for example days), and the wheel only moves forward.
+// Do not use struct members directly. Use only methods that start with 'wheel_'.
+// The wheel must be initialized with 'wheel_create' and destroyed with 'wheel_destroy'.
+// If not specified otherwise, wheel and timer pointers cannot be NULL in wheel methods.
+typedef struct {
+	WheelTimer slots[WHEEL_LEVELS][WHEEL_SLOTS];
+	long now;
+	size_t count;
+} TimingWheel;
+
+// CONSTRUCTOR / DESTRUCTOR.
+
+// Initialize an empty wheel at the given time (not negative).
+TimingWheel* wheel_create(long now);
+
+// Release the wheel and all its timers (the items are not destroyed). If wheel is NULL nothing happens.
+void wheel_destroy(TimingWheel* w);
+
+// PROPERTIES.
+
+// Returns the current time of the wheel.
+long wheel_now(const TimingWheel* w);
+
+// Returns the number of scheduled timers.
+size_t wheel_count(const TimingWheel* w);
+
+// METHODS.
+
+// Schedule a timer for the item that fires when the wheel reaches the given time (a time not after the current one fires
+// on the next advance). Returns the timer, or NULL if the memory could not be allocated. O(1).
+WheelTimer* wheel_schedule(TimingWheel* w, long when, void* item);
+
+// Move the timer to the given time, like 'wheel_schedule'. O(1).
+void wheel_reschedule(TimingWheel* w, WheelTimer* t, long when);
+
+// Remove the timer without firing it and free it. If timer is NULL nothing happens. O(1).
+void wheel_cancel(TimingWheel* w, WheelTimer* t);
+
+// Move the wheel forward to the given time and fire the timers due until then, in time order: each timer is removed,
+// 'fire' is called with the context and the item of the timer, and the timer is freed.
+// 'fire' must not schedule, reschedule or cancel timers. Returns the number of timers fired.
+size_t wheel_advance(TimingWheel* w, long now, void(*fire)(void* context, void* item), void* context);
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef TYPED_VECTOR
+#define TYPED_VECTOR
+
+#include "Allocator.h"
+#include <stdlib.h>
+
+#if defined(_MSC_VER) && !defined(__cplusplus)
+#define VECTOR_INLINE static __inline
+#else
+#define VECTOR_INLINE static inline
+#endif
+
+// Defines a vector that stores elements of type 'T' by value, in one contiguous array: the struct 'Name' and its methods,
+// which start with 'prefix_' (for example 'VECTOR_DEFINE(int, IntVector, intVec)' defines 'IntVector' and 'intVec_add').
+// Unlike 'Vector', there is no allocation per element and no pointer to follow, and the methods are inline.
+// Do not use struct members directly. Use only the generated methods.
+// A vector is a plain value: initialize it with 'prefix_init' and release it with 'prefix_free' when you are done.
+// Elements are copied in and out with assignment, so a vector does not own what its elements point to.
+// Pointers to elements are valid until the vector grows. If not specified otherwise, vector pointer cannot be NULL.
+//
+// Generated methods:
+// void prefix_init(Name* v)                         Initialize an empty vector (no allocation).
+// void prefix_initWith(Name* v, const Allocator* a) Initialize an empty vector whose array is taken from the allocator.
+// void prefix_free(Name* v)                         Release the array; the vector is empty again and can be reused.
+// size_t prefix_length(const Name* v)               Get the number of elements.
+// size_t prefix_capacity(const Name* v)             Get the number of elements the array can store.
+// T* prefix_array(const Name* v)                    Get the array of elements (NULL if nothing was ever allocated).
+// T* prefix_get(const Name* v, size_t index)        Get the element on the index, or NULL if the index is invalid.
+// T* prefix_at(const Name* v, size_t index)         Get the element on the index without checking it (fast path).
+// int prefix_reserve(Name* v, size_t capacity)      Grow the array to the given capacity. Returns 0 if it can't be allocated.
+// int prefix_add(Name* v, T item)                   Add a copy of the item as the last element. Returns 0 if it can't grow.
+// T prefix_removeLast(Name* v)                      Remove and return the last element. The vector must not be empty.
+// void prefix_removeFastAt(Name* v, size_t index)   Remove the element on the index, the last element takes its place.
+// void prefix_clear(Name* v)                        Remove all elements, keeping the capacity.
+#define VECTOR_DEFINE(T, Name, prefix) \
+	typedef struct { \
+		T* array; \
+		size_t length; \
+		size_t capacity; \
+		const Allocator* allocator; \
+	} Name; \
+	\
+	VECTOR_INLINE void prefix##_initWith(Name* v, const Allocator* allocator) \
+	{ \
+		v->array = NULL; \
+		v->length = v->capacity = 0; \
+		v->allocator = allocator; \
+	} \
+	\
+	VECTOR_INLINE void prefix##_init(Name* v) \
+	{ \
+		prefix##_initWith(v, NULL); \
+	} \
+	\
+	VECTOR_INLINE void prefix##_free(Name* v) \
+	{ \
+		allocator_free(v->allocator, v->array); \
+		prefix##_initWith(v, v->allocator); \
+	} \
+	\
+	VECTOR_INLINE size_t prefix##_length(const Name* v) \
+	{ \
+		return v->length; \
+	} \
+	\
+	VECTOR_INLINE size_t prefix##_capacity(const Name* v) \
+	{ \
+		return v->capacity; \
+	} \
+	\
+	VECTOR_INLINE T* prefix##_array(const Name* v) \
+	{ \
+		return v->array; \
+	} \
+	\
+	VECTOR_INLINE T* prefix##_get(const Name* v, size_t index) \
+	{ \
+		return index < v->length ? &v->array[index] : NULL; \
+	} \
+	\
+	VECTOR_INLINE T* prefix##_at(const Name* v, size_t index) \
+	{ \
+		return &v->array[index]; \
+	} \
+	\
+	VECTOR_INLINE int prefix##_reserve(Name* v, size_t capacity) \
+	{ \
+		if (capacity <= v->capacity) \
+			return 1; \
+		T* newArray = (T*)allocator_realloc(v->allocator, v->array, capacity * sizeof(T)); \
+		if (newArray == NULL) \
+			return 0; \
+		v->array = newArray; \
+		v->capacity = capacity; \
+		return 1; \
+	} \
+	\
+	VECTOR_INLINE int prefix##_add(Name* v, T item) \
+	{ \
+		if (v->length == v->capacity && !prefix##_reserve(v, v->capacity ? v->capacity * 2 : 4)) \
+			return 0; \
+		v->array[v->length++] = item; \
+		return 1; \
+	} \
+	\
+	VECTOR_INLINE T prefix##_removeLast(Name* v) \
+	{ \
+		return v->array[--v->length]; \
+	} \
+	\
+	VECTOR_INLINE void prefix##_removeFastAt(Name* v, size_t index) \
+	{ \
+		if (index >= v->length) \
+			return; \
+		v->array[index] = v->array[--v->length]; \
+	} \
+	\
+	VECTOR_INLINE void prefix##_clear(Name* v) \
+	{ \
+		v->length = 0; \
+	}
+
+// Vectors of the basic types used by the columns of the repository.
+VECTOR_DEFINE(int, IntVector, intVec)
+
+#endif
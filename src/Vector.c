@@ -2,27 +2,178 @@
 // Normal capacity = Length * 2
 // Maximum capacity = Length * 4
 // If capacity out of bounds, reset to normal
+// Capacities up to VECTOR_MIN_SHRINK_CAPACITY are never shrinked by removals
 
 #include "Vector.h"
 #include "string.h"
 
+// Partitions smaller than this are sorted with insertion sort.
+#define VECTOR_INSERTION_SORT 16
+
+// Changes the capacity of the container. A container in an arena only grows: the memory can't be given back.
+// Returns 0 if the memory could not be allocated.
+static int vector_resize(Vector* v, size_t capacity)
+{
+	if (v->arena) {
+		if (capacity <= v->capacity)
+			return 1;
+
+		void** newArr = arena_alloc(v->arena, capacity * sizeof(void*));
+		if (newArr == NULL)
+			return 0;
+		if (v->length > 0)
+			memcpy(newArr, v->array, v->length * sizeof(void*));
+		v->array = newArr;
+	}
+	else if (capacity == 0) {
+		allocator_free(v->allocator, v->array);
+		v->array = NULL;
+	}
+	else {
+		void** newArr = allocator_realloc(v->allocator, v->array, capacity * sizeof(void*));
+		if (newArr == NULL)
+			return 0;
+		v->array = newArr;
+	}
+
+	v->capacity = capacity;
+	return 1;
+}
+
+// After a removal, if Capacity greater than Maximum capacity for the Length, reset to normal.
+static void vector_shrinkAfterRemove(Vector* v)
+{
+	if (v->capacity > VECTOR_MIN_SHRINK_CAPACITY && v->capacity > v->length * 4) {
+		size_t normal = v->length * 2;
+		vector_reserve(v, normal > VECTOR_MIN_SHRINK_CAPACITY ? normal : VECTOR_MIN_SHRINK_CAPACITY);
+	}
+}
+
+static void vector_swap(void** array, size_t i, size_t j)
+{
+	void* temp = array[i];
+	array[i] = array[j];
+	array[j] = temp;
+}
+
+static void vector_insertionSort(void** array, size_t length, VectorCompare compare, void* context)
+{
+	for (size_t i = 1; i < length; ++i) {
+		void* item = array[i];
+		size_t j = i;
+		for (; j > 0 && compare(context, item, array[j - 1]) < 0; --j)
+			array[j] = array[j - 1];
+		array[j] = item;
+	}
+}
+
+static void vector_siftDown(void** array, size_t index, size_t length, VectorCompare compare, void* context)
+{
+	for (;;) {
+		size_t largest = index, left = index * 2 + 1, right = left + 1;
+		if (left < length && compare(context, array[left], array[largest]) > 0)
+			largest = left;
+		if (right < length && compare(context, array[right], array[largest]) > 0)
+			largest = right;
+		if (largest == index)
+			return;
+
+		vector_swap(array, index, largest);
+		index = largest;
+	}
+}
+
+static void vector_heapSort(void** array, size_t length, VectorCompare compare, void* context)
+{
+	for (size_t i = length / 2; i-- > 0; )
+		vector_siftDown(array, i, length, compare, context);
+
+	for (size_t end = length; end-- > 1; ) {
+		vector_swap(array, 0, end);
+		vector_siftDown(array, 0, end, compare, context);
+	}
+}
+
+static void vector_introSort(void** array, size_t length, size_t depth, VectorCompare compare, void* context)
+{
+	while (length > VECTOR_INSERTION_SORT) {
+		// Too many unbalanced partitions: finish with the worst case O(n log n) heapsort.
+		if (depth-- == 0) {
+			vector_heapSort(array, length, compare, context);
+			return;
+		}
+
+		// Median of three as the pivot, moved to the end.
+		size_t middle = length / 2, last = length - 1;
+		if (compare(context, array[middle], array[0]) < 0)
+			vector_swap(array, middle, 0);
+		if (compare(context, array[last], array[0]) < 0)
+			vector_swap(array, last, 0);
+		if (compare(context, array[last], array[middle]) < 0)
+			vector_swap(array, last, middle);
+		vector_swap(array, middle, last);
+
+		void* pivot = array[last];
+		size_t store = 0;
+		for (size_t i = 0; i < last; ++i) {
+			if (compare(context, array[i], pivot) < 0)
+				vector_swap(array, i, store++);
+		}
+		vector_swap(array, store, last);
+
+		// Recurse into the smaller part and loop on the bigger one, so the stack stays O(log n).
+		if (store < length - store - 1) {
+			vector_introSort(array, store, depth, compare, context);
+			array += store + 1;
+			length -= store + 1;
+		}
+		else {
+			vector_introSort(array + store + 1, length - store - 1, depth, compare, context);
+			length = store;
+		}
+	}
+
+	vector_insertionSort(array, length, compare, context);
+}
+
 // Constructor / Destructor.
 Vector* vector_create(size_t capacity)
 {
-	Vector* v = calloc(1, sizeof(Vector));
-	if (v)
+	return vector_createWith(NULL, capacity);
+}
+
+Vector* vector_createWith(const Allocator* allocator, size_t capacity)
+{
+	Vector* v = allocator_calloc(allocator, 1, sizeof(Vector));
+	if (v) {
+		v->allocator = allocator;
+		vector_reserve(v, capacity);
+	}
+
+	return v;
+}
+
+Vector* vector_createInArena(Arena* arena, size_t capacity)
+{
+	if (arena == NULL)
+		return vector_create(capacity);
+
+	Vector* v = arena_calloc(arena, 1, sizeof(Vector));
+	if (v) {
+		v->arena = arena;
 		vector_reserve(v, capacity);
+	}
 
 	return v;
 }
 
 void vector_destroy(Vector* v)
 {
-	if (v == NULL)
+	if (v == NULL || v->arena)
 		return;
 
 	vector_clear(v);
-	free(v);
+	allocator_free(v->allocator, v);
 }
 
 // Properties.
@@ -31,6 +182,11 @@ const void** vector_array(const Vector* v)
 	return v->array;
 }
 
+Arena* vector_arena(const Vector* v)
+{
+	return v->arena;
+}
+
 size_t vector_length(const Vector* v)
 {
 	return v->length;
@@ -62,13 +218,8 @@ void vector_add(Vector* v, void* item)
 {
 	// If Capacity less than Minimum capacity for the new Length, reset to normal.
 	size_t newLen = v->length + 1;
-	if (v->capacity < newLen) {
-		void** newArr = realloc(v->array, newLen * 2 * sizeof(void*));
-		if (newArr) {
-			v->array = newArr;
-			v->capacity = newLen * 2;
-		}
-	}
+	if (v->capacity < newLen)
+		vector_resize(v, newLen * 2);
 
 	// If capacity is big enough, perform the addition.
 	if (v->capacity >= newLen) {
@@ -77,6 +228,38 @@ void vector_add(Vector* v, void* item)
 	}
 }
 
+void vector_insertAt(Vector* v, size_t index, void* item)
+{
+	if (index > v->length)
+		return;
+
+	size_t oldLen = v->length;
+	vector_add(v, item);
+	if (v->length == oldLen)
+		return;
+
+	// Shift all the items from the index to the right.
+	if (index < oldLen) {
+		memmove(v->array + index + 1, v->array + index, (oldLen - index) * sizeof(void*));
+		v->array[index] = item;
+	}
+}
+
+void vector_addRange(Vector* v, void* const* items, size_t count)
+{
+	if (count == 0)
+		return;
+
+	size_t newLen = v->length + count;
+	if (v->capacity < newLen)
+		vector_reserve(v, newLen * 2);
+	if (v->capacity < newLen)
+		return;
+
+	memcpy(v->array + v->length, items, count * sizeof(void*));
+	v->length = newLen;
+}
+
 void vector_removeAt(Vector* v, size_t index)
 {
 	if (index < 0 || index >= v->length)
@@ -87,9 +270,7 @@ void vector_removeAt(Vector* v, size_t index)
 		memmove(v->array + index, v->array + index + 1, (v->length - index - 1) * sizeof(void*));
 	--v->length;
 
-	// If Capacity greater than Maximum capacity for new Length, reset to normal.
-	if (v->capacity > v->length * 4)
-		vector_reserve(v, v->length * 2);
+	vector_shrinkAfterRemove(v);
 }
 
 void vector_removeFastAt(Vector* v, size_t index)
@@ -102,16 +283,30 @@ void vector_removeFastAt(Vector* v, size_t index)
 		v->array[index] = v->array[v->length - 1];
 	--v->length;
 
-	// If Capacity greater than Maximum capacity for new Length, reset to normal.
-	if (v->capacity > v->length * 4)
-		vector_reserve(v, v->length * 2);
+	vector_shrinkAfterRemove(v);
+}
+
+size_t vector_removeIf(Vector* v, int(*predicate)(void* context, const void* item), void* context)
+{
+	// Move the kept items over the removed ones, in one pass.
+	size_t kept = 0;
+	for (size_t i = 0; i < v->length; ++i) {
+		if (!predicate(context, v->array[i]))
+			v->array[kept++] = v->array[i];
+	}
+
+	size_t removed = v->length - kept;
+	v->length = kept;
+	if (removed > 0)
+		vector_shrinkAfterRemove(v);
+
+	return removed;
 }
 
 void vector_clear(Vector* v)
 {
-	free(v->array);
-	v->array = NULL;
-	v->length = v->capacity = 0;
+	v->length = 0;
+	vector_resize(v, 0);
 }
 
 void vector_shrinkToFit(Vector* v)
@@ -119,18 +314,7 @@ void vector_shrinkToFit(Vector* v)
 	if (v->capacity == v->length)
 		return;
 
-	if (v->length == 0) {
-		free(v->array);
-		v->array = NULL;
-		v->capacity = 0;
-	}
-	else {
-		void** newArr = realloc(v->array, v->length * sizeof(void*));
-		if (newArr) {
-			v->array = newArr;
-			v->capacity = v->length;
-		}
-	}
+	vector_resize(v, v->length);
 }
 
 void vector_reserve(Vector* v, size_t capacity)
@@ -138,16 +322,46 @@ void vector_reserve(Vector* v, size_t capacity)
 	if (capacity < v->length || capacity == v->capacity)
 		return;
 
-	if (capacity == 0) {
-		free(v->array);
-		v->array = NULL;
-		v->capacity = 0;
-	}
-	else {
-		void* newArr = realloc(v->array, capacity * sizeof(void*));
-		if (newArr) {
-			v->array = newArr;
-			v->capacity = capacity;
-		}
+	vector_resize(v, capacity);
+}
+
+// Algorithms.
+void vector_sort(Vector* v, VectorCompare compare, void* context)
+{
+	size_t depth = 0;
+	for (size_t length = v->length; length > 1; length /= 2)
+		depth += 2;
+
+	vector_introSort(v->array, v->length, depth, compare, context);
+}
+
+size_t vector_bsearch(const Vector* v, const void* key, VectorCompare compare, void* context)
+{
+	size_t left = 0, right = v->length;
+	while (left < right) {
+		size_t middle = left + (right - left) / 2;
+		if (compare(context, key, v->array[middle]) > 0)
+			left = middle + 1;
+		else
+			right = middle;
 	}
+
+	return left;
+}
+
+void vector_merge(Vector* v, const Vector* a, const Vector* b, VectorCompare compare, void* context)
+{
+	size_t newLen = v->length + a->length + b->length;
+	if (v->capacity < newLen)
+		vector_reserve(v, newLen);
+	if (v->capacity < newLen)
+		return;
+
+	size_t i = 0, j = 0;
+	while (i < a->length && j < b->length)
+		v->array[v->length++] = compare(context, b->array[j], a->array[i]) < 0 ? b->array[j++] : a->array[i++];
+	while (i < a->length)
+		v->array[v->length++] = a->array[i++];
+	while (j < b->length)
+		v->array[v->length++] = b->array[j++];
 }
@@ -1,16 +1,30 @@
 #ifndef VECTOR
 #define VECTOR
 
+#include "Allocator.h"
+#include "Arena.h"
 #include <stdlib.h>
 
+// The capacity a vector never shrinks below by itself, so that removing and adding a few items does not reallocate each time.
+#define VECTOR_MIN_SHRINK_CAPACITY 16
+
+// A function that compares two items of a vector (or a key and an item), with a user context.
+// Returns a negative number if 'a' comes first, a positive number if 'b' comes first and 0 if they are equivalent.
+typedef int(*VectorCompare)(void* context, const void* a, const void* b);
+
 // The internal data used to represent a vector of pointers.
 // Do not use struct members directly. Use only methods that start with 'vector_'.
 // You need to initialize the vector with 'vector_create', and destroy it with 'vector_destroy' when you are done.
+// The vector and its container are taken from the allocator given to 'vector_createWith' (the heap by default).
+// A vector can also live in an arena (see 'vector_createInArena'): then the vector and its container are allocated from the arena,
+// growing copies the items to a new container, and the memory is only given back when the arena is reset.
 // If not specified otherwise, vector pointer cannot be NULL in vector methods.
 typedef struct {
 	void** array;
 	size_t length;
 	size_t capacity;
+	Arena* arena;
+	const Allocator* allocator;
 } Vector;
 
 // CONSTRUCTOR / DESTRUCTOR.
@@ -18,6 +32,13 @@ typedef struct {
 // Initialize an empty vector with the given capacity.
 Vector* vector_create(size_t capacity);
 
+// Initialize an empty vector with the given capacity, allocated with the given allocator (NULL means the default allocator).
+Vector* vector_createWith(const Allocator* allocator, size_t capacity);
+
+// Initialize an empty vector with the given capacity, allocated from the arena. If arena is NULL, same as 'vector_create'.
+// The vector can still be destroyed with 'vector_destroy', which does nothing for a vector in an arena.
+Vector* vector_createInArena(Arena* arena, size_t capacity);
+
 // Destroy the vector. If pointer is NULL nothing happens.
 void vector_destroy(Vector* v);
 
@@ -25,6 +46,9 @@ void vector_destroy(Vector* v);
 
 const void** vector_array(const Vector* v);
 
+// Get the arena the vector lives in, or NULL if it lives on the heap.
+Arena* vector_arena(const Vector* v);
+
 // Get the number of elements in the vector.
 size_t vector_length(const Vector* v);
 
@@ -42,12 +66,25 @@ void vector_set(Vector* v, size_t index, void* newItem);
 // Add the item to the vector as the last element.
 void vector_add(Vector* v, void* item);
 
+// Insert the item on the specified index and shift all items from that index one position to the right.
+// If index is equal to the length, the item is added as the last element. If index is greater, nothing happens.
+void vector_insertAt(Vector* v, size_t index, void* item);
+
+// Add the given items (cannot be NULL if count is not 0) at the end of the vector, in order, growing the container only once.
+// If the container cannot grow, nothing is added.
+void vector_addRange(Vector* v, void* const* items, size_t count);
+
 // Remove the element on the specified index and shift all items behind the removed element with one position to the left.
+// The container shrinks only when it is more than 4 times bigger than needed (and not below VECTOR_MIN_SHRINK_CAPACITY).
 void vector_removeAt(Vector* v, size_t index);
 
 // Remove the element on the specified index. If it was not the last element, then the last element takes its place.
 void vector_removeFastAt(Vector* v, size_t index);
 
+// Remove all the elements for which the predicate returns non-zero, keeping the order of the others, in a single pass.
+// Returns the number of removed elements.
+size_t vector_removeIf(Vector* v, int(*predicate)(void* context, const void* item), void* context);
+
 // Removes all the elements.
 void vector_clear(Vector* v);
 
@@ -59,4 +96,19 @@ void vector_shrinkToFit(Vector* v);
 // If the capacity is less than the size, nothing happens.
 void vector_reserve(Vector* v, size_t capacity);
 
+// ALGORITHMS.
+
+// Sort the elements with the comparator, in O(n log n) (introsort: quicksort that falls back to heapsort when the partitions
+// are unbalanced, and insertion sort for small partitions). The sort is not stable.
+void vector_sort(Vector* v, VectorCompare compare, void* context);
+
+// Search the sorted vector for the key and return the index of the first element that does not come before it, or the length
+// if there is none (so the key is found if the element on the index compares equal, and the index is where it would be inserted).
+// The comparator is called with the key as 'a' and an element as 'b'.
+size_t vector_bsearch(const Vector* v, const void* key, VectorCompare compare, void* context);
+
+// Add to the vector the elements of the two sorted vectors (cannot be NULL, and cannot be the same as 'v'), in sorted order.
+// Equivalent elements of 'a' come before the ones of 'b'.
+void vector_merge(Vector* v, const Vector* a, const Vector* b, VectorCompare compare, void* context);
+
 #endif
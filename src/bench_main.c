@@ -0,0 +1,811 @@
+#include "domain.h"
+#include "repository.h"
+#include "service.h"
+#include "Benchmark.h"
+#include "MaterialGenerator.h"
+#include "MaterialPipeline.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The smallest and the biggest catalog measured by default. Every size is 10 times the previous one.
+#define BENCH_MIN_SIZE 1000
+#define BENCH_MAX_SIZE 10000000
+
+// The maximum number of single material operations (lookups, updates, removals, undo / redo) timed at each size.
+#define BENCH_OPS 100000
+
+// The number of materials the queries go through at each size: a query over the whole catalog runs
+// BENCH_QUERY_ROWS / size times, but at least BENCH_MIN_QUERIES and at most BENCH_MAX_QUERIES times.
+#define BENCH_QUERY_ROWS 10000000
+#define BENCH_MIN_QUERIES 5
+#define BENCH_MAX_QUERIES 1000
+
+// The number of threads writing through a pipeline at once.
+#define BENCH_PIPE_WRITERS 4
+
+// The default time budget of a single benchmark, in seconds.
+#define BENCH_BUDGET 10
+
+// The longest time in nanoseconds a follower waits for the primary at a time, before it checks the connection again.
+#define BENCH_FOLLOW_WAIT 100000000LL
+
+// The settings of a run, read from the command line.
+typedef struct {
+	size_t minSize;
+	size_t maxSize;
+	size_t ops;
+	long long budget;
+	GeneratorConfig generator;
+	const char* output;
+	const char* replay;
+	size_t repeat;
+	size_t copies;
+	const char* spans;
+	const char* follow;
+} BenchOptions;
+
+// A run: the settings and the file where the results are written.
+typedef struct {
+	BenchOptions options;
+	FILE* out;
+	size_t results;
+} BenchRun;
+
+// What a query benchmark works with. The results vector is cleared before every query.
+typedef struct {
+	MaterialService* serv;
+	MaterialGenerator* gen;
+	Vector* results;
+	Bitmap* bitmap;
+} BenchQueryContext;
+
+typedef struct {
+	const char* name;
+	void(*run)(BenchQueryContext* ctx);
+} BenchQuery;
+
+// The clock of the service: a fixed day, in the middle of the default date span, so every run sees the same expired materials.
+static Date bench_clock()
+{
+	return (Date) { 2025, 1, 1 };
+}
+
+// Writes the results of the benchmark to the output, releases it and reports the progress.
+static void bench_report(BenchRun* run, Benchmark* b)
+{
+	bench_end(b);
+	fprintf(run->out, "%s\n    ", run->results++ ? "," : "");
+	bench_writeJson(b, run->out);
+	fprintf(stderr, "%-28s size %9zu: %12.1f ops/s, p50 %9lld ns, p99 %9lld ns%s\n", b->name, b->size,
+		bench_opsPerSecond(b), bench_percentile(b, 0.50), bench_percentile(b, 0.99), bench_truncated(b) ? " (out of budget)" : "");
+	bench_free(b);
+}
+
+// Writes the string as a JSON string, for the paths given on the command line.
+static void bench_writeString(FILE* out, const char* str)
+{
+	putc('"', out);
+	for (; *str != '\0'; ++str) {
+		if (*str == '"' || *str == '\\')
+			putc('\\', out);
+		if ((unsigned char)*str < 0x20)
+			fprintf(out, "\\u%04x", (unsigned char)*str);
+		else
+			putc(*str, out);
+	}
+	putc('"', out);
+}
+
+static size_t bench_min(size_t a, size_t b)
+{
+	return a < b ? a : b;
+}
+
+// A set of the hashes of the name, supplier and expiration date of the loaded materials, so a bulk load can skip generated
+// repeats without searching the catalog. Two different materials with the same 64-bit hash are so rare that skipping one does
+// not matter. The slots use open addressing with linear probing, and 0 marks an empty slot.
+typedef struct {
+	unsigned long long* slots;
+	size_t capacity;
+} BenchKeySet;
+
+// Returns 0 if the memory for the keys of the given number of materials could not be allocated.
+static int bench_keySetInit(BenchKeySet* set, size_t size)
+{
+	set->capacity = 16;
+	while (set->capacity < size * 2)
+		set->capacity *= 2;
+	set->slots = calloc(set->capacity, sizeof(unsigned long long));
+	return set->slots != NULL;
+}
+
+// Returns the FNV-1a hash of the name, supplier and expiration date of the material (never 0).
+static unsigned long long bench_keyOf(const Material* mat)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	const char* strings[2] = { material_name(mat), material_supplier(mat) };
+	for (int i = 0; i < 2; ++i) {
+		for (const char* c = strings[i]; *c; ++c)
+			hash = (hash ^ (unsigned char)*c) * 1099511628211ULL;
+		hash = (hash ^ 0xFF) * 1099511628211ULL;
+	}
+
+	hash = (hash ^ (unsigned long long)(long long)material_expSerial(mat)) * 1099511628211ULL;
+	return hash ? hash : 1;
+}
+
+// Adds the key of the material. Returns 0 if it was already in the set. The set holds at most half of its capacity.
+static int bench_keySetAdd(BenchKeySet* set, const Material* mat)
+{
+	unsigned long long key = bench_keyOf(mat);
+	size_t i = (size_t)key & (set->capacity - 1);
+	for (; set->slots[i] != 0; i = (i + 1) & (set->capacity - 1))
+		if (set->slots[i] == key)
+			return 0;
+
+	set->slots[i] = key;
+	return 1;
+}
+
+// Queries.
+static void bench_getAll(BenchQueryContext* ctx)
+{
+	matServ_getAll(ctx->serv, ctx->results);
+}
+
+static void bench_pastExp(BenchQueryContext* ctx)
+{
+	matServ_get_materials_past_exp(ctx->serv, ctx->results, "");
+}
+
+static void bench_pastExpWithStr(BenchQueryContext* ctx)
+{
+	matServ_get_materials_past_exp(ctx->serv, ctx->results, "our 1");
+}
+
+static void bench_expired(BenchQueryContext* ctx)
+{
+	matServ_getExpired(ctx->serv, ctx->results);
+}
+
+static void bench_lowStock(BenchQueryContext* ctx)
+{
+	matServ_getLowStock(ctx->serv, ctx->results);
+}
+
+static void bench_sortedByQuantity(BenchQueryContext* ctx)
+{
+	matServ_getMaterialsSortedByQuantity(ctx->serv, ctx->results);
+}
+
+static void bench_sortedByQuantityPage(BenchQueryContext* ctx)
+{
+	matServ_getMaterialsSortedByQuantityPage(ctx->serv, ctx->results, NULL, 20);
+}
+
+static void bench_shortSupply(BenchQueryContext* ctx)
+{
+	const GeneratorConfig* config = matGen_config(ctx->gen);
+	const char* supplier = matGen_supplier(ctx->gen, matGen_randomBelow(ctx->gen, config->supplierCount));
+	matServ_getMaterialsFromSupplierInShortSupply(ctx->serv, ctx->results, supplier, config->maxQuantity / 10);
+}
+
+static void bench_shortSupplyPage(BenchQueryContext* ctx)
+{
+	const GeneratorConfig* config = matGen_config(ctx->gen);
+	const char* supplier = matGen_supplier(ctx->gen, matGen_randomBelow(ctx->gen, config->supplierCount));
+	matServ_getMaterialsFromSupplierInShortSupplyPage(ctx->serv, ctx->results, supplier, config->maxQuantity / 10, NULL, 20);
+}
+
+static void bench_queryNamePrefix(BenchQueryContext* ctx)
+{
+	MaterialQuery* q = matQuery_create();
+	matQuery_orderBy(matQuery_whereNameStartsWith(q, "Flour 1"), SORT_NAME, 0);
+	matServ_query(ctx->serv, q, ctx->results);
+	matQuery_destroy(q);
+}
+
+static void bench_queryExpiringSoon(BenchQueryContext* ctx)
+{
+	MaterialQuery* q = matQuery_create();
+	matQuery_whereExpiresFrom(q, (Date) { 2025, 1, 1 });
+	matQuery_setLimit(matQuery_orderBy(matQuery_whereExpiresBefore(q, (Date) { 2025, 2, 1 }), SORT_EXP_DATE, 0), 20);
+	matServ_query(ctx->serv, q, ctx->results);
+	matQuery_destroy(q);
+}
+
+static void bench_selectExpired(BenchQueryContext* ctx)
+{
+	matServ_selectExpired(ctx->serv, ctx->bitmap);
+}
+
+static void bench_completeName(BenchQueryContext* ctx)
+{
+	matServ_completeName(ctx->serv, "Flo", ctx->results, 10);
+}
+
+static void bench_fuzzySearch(BenchQueryContext* ctx)
+{
+	matServ_fuzzySearch(ctx->serv, "Fluor 1", 2, ctx->results);
+}
+
+static void bench_statsBySupplier(BenchQueryContext* ctx)
+{
+	const GeneratorConfig* config = matGen_config(ctx->gen);
+	matServ_statsBySupplier(ctx->serv, matGen_supplier(ctx->gen, matGen_randomBelow(ctx->gen, config->supplierCount)));
+}
+
+static const BenchQuery QUERIES[] = {
+	{ "get_all", bench_getAll },
+	{ "past_exp", bench_pastExp },
+	{ "past_exp_with_str", bench_pastExpWithStr },
+	{ "expired", bench_expired },
+	{ "low_stock", bench_lowStock },
+	{ "sorted_by_quantity", bench_sortedByQuantity },
+	{ "sorted_by_quantity_page", bench_sortedByQuantityPage },
+	{ "short_supply", bench_shortSupply },
+	{ "short_supply_page", bench_shortSupplyPage },
+	{ "query_name_prefix", bench_queryNamePrefix },
+	{ "query_expiring_soon", bench_queryExpiringSoon },
+	{ "select_expired", bench_selectExpired },
+	{ "complete_name", bench_completeName },
+	{ "fuzzy_search", bench_fuzzySearch },
+	{ "stats_by_supplier", bench_statsBySupplier },
+};
+
+// Benchmarks.
+
+// Adds 'size' generated materials with consecutive ids and returns how many were loaded before the budget ran out.
+// Generated materials that repeat the name, supplier and expiration date of a loaded one are rejected, and still count.
+// Loads the generated catalog through the trusted path of the service (see 'matServ_load'), with dense ids from 0.
+// Generated repeats of a name, supplier and expiration date are skipped, so the catalog has no duplicates to look for.
+static size_t bench_bulkLoad(BenchRun* run, MaterialService* serv, MaterialGenerator* gen, Material* mat, size_t size)
+{
+	Benchmark b;
+	bench_begin(&b, "bulk_load", size, size, run->options.budget);
+	BenchKeySet keys;
+	size_t loaded = 0;
+	if (bench_keySetInit(&keys, size)) {
+		while (loaded < size && !bench_overBudget(&b)) {
+			matGen_next(gen, mat);
+			if (!bench_keySetAdd(&keys, mat))
+				continue;
+
+			material_id_set(mat, (int)loaded);
+			bench_startOp(&b);
+			int id = matServ_load(serv, mat);
+			bench_stopOp(&b);
+			if (id < 0)
+				break;
+			++loaded;
+		}
+		free(keys.slots);
+	}
+
+	bench_report(run, &b);
+	return loaded;
+}
+
+static void bench_findByNSE(BenchRun* run, MaterialService* serv, MaterialGenerator* gen, Material* mat, size_t size)
+{
+	Benchmark b;
+	size_t ops = bench_min(run->options.ops, size);
+	bench_begin(&b, "find_by_nse", size, ops, run->options.budget);
+	matGen_rewind(gen);
+	for (size_t i = 0; i < ops && !bench_overBudget(&b); ++i) {
+		matGen_next(gen, mat);
+		bench_startOp(&b);
+		matServ_findByNSE(serv, material_name(mat), material_supplier(mat), material_expDate(mat));
+		bench_stopOp(&b);
+	}
+
+	bench_report(run, &b);
+}
+
+static void bench_findById(BenchRun* run, MaterialService* serv, MaterialGenerator* gen, size_t size)
+{
+	Benchmark b;
+	size_t ops = bench_min(run->options.ops, size);
+	bench_begin(&b, "find_by_id", size, ops, run->options.budget);
+	for (size_t i = 0; i < ops && !bench_overBudget(&b); ++i) {
+		int id = (int)matGen_randomBelow(gen, size);
+		bench_startOp(&b);
+		matServ_findById(serv, id);
+		bench_stopOp(&b);
+	}
+
+	bench_report(run, &b);
+}
+
+// Adds quantities to existing materials (each one can be undone) and returns how many operations were done.
+static size_t bench_addOrUpdate(BenchRun* run, MaterialService* serv, MaterialGenerator* gen, Material* mat, size_t size)
+{
+	Benchmark b;
+	size_t ops = bench_min(run->options.ops, size);
+	bench_begin(&b, "add_or_update_by_nse", size, ops, run->options.budget);
+	matGen_rewind(gen);
+	size_t done = 0;
+	for (; done < ops && !bench_overBudget(&b); ++done) {
+		matGen_next(gen, mat);
+		bench_startOp(&b);
+		matServ_addOrUpdateByNSE(serv, -1, material_name(mat), material_supplier(mat), QUANTITY(1), material_expDate(mat), NULL);
+		bench_stopOp(&b);
+	}
+
+	bench_report(run, &b);
+	return done;
+}
+
+// A thread writing through a pipeline, and the latencies of its writes.
+typedef struct {
+	MaterialPipeline* pipeline;
+	GeneratorConfig config;
+	size_t ops;
+	Histogram latencies;
+} BenchPipeWriter;
+
+static void bench_pipeWrite(void* argument)
+{
+	BenchPipeWriter* writer = argument;
+	MaterialGenerator* gen = matGen_create(&writer->config);
+	Material* mat = material_create();
+	for (size_t i = 0; i < writer->ops; ++i) {
+		matGen_next(gen, mat);
+		material_quantity_set(mat, QUANTITY(1));
+		long long start = latency_now();
+		matPipe_submit(writer->pipeline, ADD, mat);
+		hist_record(&writer->latencies, latency_now() - start);
+	}
+
+	material_destroy(mat);
+	matGen_destroy(gen);
+}
+
+// Adds quantities to existing materials from BENCH_PIPE_WRITERS threads at once through a pipeline (see 'MaterialPipeline'),
+// and returns how many operations were done. The results are the throughput of all the writers together and the latencies
+// of single writes, including the wait for their batch.
+static size_t bench_pipeline(BenchRun* run, MaterialService* serv, size_t size)
+{
+	BenchPipeWriter writers[BENCH_PIPE_WRITERS];
+	Thread threads[BENCH_PIPE_WRITERS];
+	size_t started = 0;
+	MaterialPipeline* p = matPipe_create(serv);
+	long long start = latency_now();
+	for (; p && started < BENCH_PIPE_WRITERS; ++started) {
+		writers[started].pipeline = p;
+		writers[started].config = run->options.generator;
+		writers[started].ops = bench_min(run->options.ops, size) / BENCH_PIPE_WRITERS;
+		hist_clear(&writers[started].latencies);
+		if (!thread_start(&threads[started], bench_pipeWrite, &writers[started]))
+			break;
+	}
+
+	Histogram latencies;
+	hist_clear(&latencies);
+	for (size_t i = 0; i < started; ++i) {
+		thread_join(&threads[i]);
+		hist_merge(&latencies, &writers[i].latencies);
+	}
+
+	long long elapsed = latency_now() - start;
+	size_t ops = p ? matPipe_writeCount(p) : 0;
+	size_t batches = p ? matPipe_batchCount(p) : 0;
+	matPipe_destroy(p);
+
+	double opsPerSecond = elapsed > 0 ? ops * 1e9 / elapsed : 0;
+	fprintf(run->out, "%s\n    {\"name\": \"pipeline_add_or_update\", \"size\": %zu, \"writers\": %zu, \"ops\": %zu, \"batches\": %zu, "
+		"\"opsPerSecond\": %.1f, \"p50Ns\": %lld, \"p99Ns\": %lld}", run->results++ ? "," : "", size, started, ops, batches,
+		opsPerSecond, hist_percentile(&latencies, 0.50), hist_percentile(&latencies, 0.99));
+	fprintf(stderr, "%-28s size %9zu: %12.1f ops/s, p50 %9lld ns, p99 %9lld ns, %zu writers, %.1f writes per batch\n", "pipeline_add_or_update",
+		size, opsPerSecond, hist_percentile(&latencies, 0.50), hist_percentile(&latencies, 0.99), started, batches ? (double)ops / batches : 0.0);
+	return ops;
+}
+
+// Undoes all the given operations, then redoes them.
+static void bench_undoRedo(BenchRun* run, MaterialService* serv, size_t size, size_t ops)
+{
+	const char* names[2] = { "undo", "redo" };
+	for (int redo = 0; redo < 2; ++redo) {
+		Benchmark b;
+		bench_begin(&b, names[redo], size, ops, run->options.budget);
+		for (size_t i = 0; i < ops && !bench_overBudget(&b); ++i) {
+			bench_startOp(&b);
+			if (redo)
+				matServ_redo(serv);
+			else
+				matServ_undo(serv);
+			bench_stopOp(&b);
+		}
+
+		bench_report(run, &b);
+	}
+}
+
+static void bench_queries(BenchRun* run, MaterialService* serv, MaterialGenerator* gen, size_t size)
+{
+	BenchQueryContext ctx = { serv, gen, vector_create(0), bitmap_create(size) };
+	size_t ops = BENCH_QUERY_ROWS / size;
+	ops = ops < BENCH_MIN_QUERIES ? BENCH_MIN_QUERIES : ops > BENCH_MAX_QUERIES ? BENCH_MAX_QUERIES : ops;
+
+	for (size_t q = 0; q < sizeof(QUERIES) / sizeof(QUERIES[0]); ++q) {
+		Benchmark b;
+		bench_begin(&b, QUERIES[q].name, size, ops, run->options.budget);
+		for (size_t i = 0; i < ops && !bench_overBudget(&b); ++i) {
+			vector_clear(ctx.results);
+			bench_startOp(&b);
+			QUERIES[q].run(&ctx);
+			bench_stopOp(&b);
+		}
+
+		bench_report(run, &b);
+	}
+
+	vector_destroy(ctx.results);
+	bitmap_destroy(ctx.bitmap);
+}
+
+static void bench_removeById(BenchRun* run, MaterialService* serv, MaterialGenerator* gen, size_t size)
+{
+	Benchmark b;
+	size_t ops = bench_min(run->options.ops, size / 2);
+	bench_begin(&b, "remove_by_id", size, ops, run->options.budget);
+	for (size_t i = 0; i < ops && !bench_overBudget(&b); ++i) {
+		int id = (int)matGen_randomBelow(gen, size);
+		bench_startOp(&b);
+		matServ_removeById(serv, id, NULL, 0);
+		bench_stopOp(&b);
+	}
+
+	bench_report(run, &b);
+}
+
+// Runs all the benchmarks on a catalog of the given size. Returns 0 if the catalog could not be loaded within the budget,
+// so the bigger sizes are not worth trying.
+static int bench_size(BenchRun* run, size_t size)
+{
+	MaterialRepository* repo = matRepo_create(matValid_validate);
+	MaterialService* serv = matServ_create(repo);
+	MaterialGenerator* gen = matGen_create(&run->options.generator);
+	Material* mat = material_create();
+	matServ_setClock(serv, bench_clock);
+	matServ_setLowStockThreshold(serv, matGen_supplier(gen, 0), run->options.generator.maxQuantity / 10);
+
+	size_t loaded = bench_bulkLoad(run, serv, gen, mat, size);
+	if (loaded == size) {
+		bench_findByNSE(run, serv, gen, mat, size);
+		bench_findById(run, serv, gen, size);
+		bench_undoRedo(run, serv, size, bench_addOrUpdate(run, serv, gen, mat, size));
+		bench_undoRedo(run, serv, size, bench_pipeline(run, serv, size));
+		bench_queries(run, serv, gen, size);
+		bench_removeById(run, serv, gen, size);
+	}
+	else
+		fprintf(stderr, "Only %zu of %zu materials were loaded within the budget, bigger sizes are skipped.\n", loaded, size);
+
+	material_destroy(mat);
+	matGen_destroy(gen);
+	matServ_destroy(serv);
+	matRepo_destroy(repo);
+	return loaded == size;
+}
+
+// Replay.
+
+// Returns 1 if the call changes the catalog or its history. These calls are made on every copy of the catalog.
+static int bench_isWrite(TraceCall call)
+{
+	return call == TRACE_ADD_OR_UPDATE || call == TRACE_UPDATE || call == TRACE_REMOVE || call == TRACE_UNDO || call == TRACE_REDO;
+}
+
+// Returns the string followed by " #copy" in the buffer (the string itself for copy 0 or NULL), growing the buffer when needed.
+static const char* bench_copyName(char** buffer, size_t* capacity, const char* str, size_t copy)
+{
+	if (str == NULL || copy == 0)
+		return str;
+
+	size_t needed = strlen(str) + 24;
+	if (needed > *capacity) {
+		char* newBuffer = realloc(*buffer, needed);
+		if (newBuffer == NULL)
+			return str;
+		*buffer = newBuffer;
+		*capacity = needed;
+	}
+
+	snprintf(*buffer, *capacity, "%s #%zu", str, copy);
+	return *buffer;
+}
+
+// Counts the records of every call in the trace. Returns the number of records, or -1 if the trace is not valid.
+static long long bench_countTrace(FILE* in, size_t* counts)
+{
+	TraceReader* r = traceReader_create(in);
+	if (r == NULL)
+		return -1;
+
+	TraceRecord rec;
+	int status;
+	while ((status = traceReader_next(r, &rec)) > 0)
+		++counts[rec.call];
+
+	long long records = status < 0 ? -1 : (long long)traceReader_count(r);
+	traceReader_destroy(r);
+	return records;
+}
+
+// Runs the recorded trace 'repeat' times against a fresh service, timing every call type separately.
+// With more than one copy, every write is made on each copy of the catalog (the copies differ by a " #n" suffix of the name
+// and the supplier), so the catalog grows 'copies' times while the reads stay the same. Returns 0 if the trace cannot be read.
+static int bench_replay(BenchRun* run)
+{
+	FILE* in = fopen(run->options.replay, "rb");
+	size_t counts[TRACE_CALL_COUNT] = { 0 };
+	long long records = in ? bench_countTrace(in, counts) : -1;
+	if (records < 0) {
+		fprintf(stderr, "Cannot read the trace %s.\n", run->options.replay);
+		if (in)
+			fclose(in);
+		return 0;
+	}
+
+	size_t repeat = run->options.repeat;
+	size_t copies = run->options.copies;
+	Benchmark calls[TRACE_CALL_COUNT];
+	Benchmark total;
+	size_t totalOps = 0;
+	for (int c = 1; c < TRACE_CALL_COUNT; ++c) {
+		size_t ops = counts[c] * repeat * (bench_isWrite((TraceCall)c) ? copies : 1);
+		bench_begin(&calls[c], trace_callName((TraceCall)c), (size_t)records, ops, 0);
+		totalOps += ops;
+	}
+	bench_begin(&total, "replay", (size_t)records, totalOps, run->options.budget);
+
+	// The spans of the replayed calls, if they are compiled in.
+	FILE* spansFile = run->options.spans ? fopen(run->options.spans, "w") : NULL;
+	SpanTracer* spans = spansFile ? spanTracer_create(spansFile, 0) : NULL;
+	spanTracer_install(spans);
+#ifndef MAT_SPANS
+	if (spans)
+		fprintf(stderr, "Spans are not compiled in (define MAT_SPANS), %s will be empty.\n", run->options.spans);
+#endif
+
+	MaterialRepository* repo = matRepo_create(matValid_validate);
+	MaterialService* serv = matServ_create(repo);
+	Vector* results = vector_create(0);
+	char* buffers[2] = { NULL, NULL };
+	size_t capacities[2] = { 0, 0 };
+
+	for (size_t i = 0; i < repeat && !bench_overBudget(&total); ++i) {
+		rewind(in);
+		TraceReader* r = traceReader_create(in);
+		TraceRecord rec;
+		while (r != NULL && !bench_overBudget(&total) && traceReader_next(r, &rec) > 0) {
+			const char* name = rec.name;
+			const char* supplier = rec.supplier;
+			size_t recCopies = bench_isWrite(rec.call) ? copies : 1;
+			for (size_t copy = 0; copy < recCopies; ++copy) {
+				rec.name = bench_copyName(&buffers[0], &capacities[0], name, copy);
+				rec.supplier = bench_copyName(&buffers[1], &capacities[1], supplier, copy);
+				vector_clear(results);
+				bench_startOp(&total);
+				bench_startOp(&calls[rec.call]);
+				matServ_replay(serv, &rec, results);
+				bench_stopOp(&calls[rec.call]);
+				bench_stopOp(&total);
+			}
+		}
+		traceReader_destroy(r);
+	}
+
+	fprintf(stderr, "Replayed %lld records %zu times on %zu copies, %zu materials at the end.\n", records, repeat, copies, matServ_matCount(serv));
+	for (int c = 1; c < TRACE_CALL_COUNT; ++c) {
+		if (counts[c] > 0)
+			bench_report(run, &calls[c]);
+		else
+			bench_free(&calls[c]);
+	}
+	bench_report(run, &total);
+
+	spanTracer_destroy(spans);
+	if (spansFile)
+		fclose(spansFile);
+	free(buffers[0]);
+	free(buffers[1]);
+	vector_destroy(results);
+	matServ_destroy(serv);
+	matRepo_destroy(repo);
+	fclose(in);
+	return 1;
+}
+
+// Applies the changes shipped by a primary (see 'LogShipper') to a fresh service until the primary closes the connection,
+// and reports how long after they were made on the primary the changes were applied. While no change arrives, the follower
+// waits for the next one. Like a read replica, the service serves the read-only queries in between: after every record
+// the next one of QUERIES runs, and its latency is reported too.
+// Returns 0 if the primary cannot be reached or its log cannot be read.
+static int bench_follow(BenchRun* run)
+{
+	MaterialRepository* repo = matRepo_create(matValid_validate);
+	MaterialService* serv = matServ_create(repo);
+	LogFollower* f = logFollower_connect(serv, (unsigned short)atoi(run->options.follow));
+	BenchQueryContext ctx = { serv, matGen_create(&run->options.generator), vector_create(0), bitmap_create(0) };
+	Histogram reads;
+	hist_clear(&reads);
+
+	int status = f ? 1 : -1;
+	for (size_t query = 0; status >= 0; query = (query + 1) % (sizeof(QUERIES) / sizeof(QUERIES[0]))) {
+		status = logFollower_applyNext(f);
+		while (status == 0 && !logFollower_closed(f) && logFollower_wait(f, BENCH_FOLLOW_WAIT) >= 0)
+			status = logFollower_applyNext(f);
+		if (status <= 0)
+			break;
+
+		vector_clear(ctx.results);
+		long long start = latency_now();
+		QUERIES[query].run(&ctx);
+		hist_record(&reads, latency_now() - start);
+	}
+
+	if (status == 0) {
+		const Histogram* lag = logFollower_lag(f);
+		fprintf(run->out, "%s\n    {\"name\": \"follow_lag\", \"records\": %zu, \"snapshots\": %zu, \"materials\": %zu, "
+			"\"lsn\": %llu, \"p50Ns\": %lld, \"p99Ns\": %lld, \"maxNs\": %lld}", run->results++ ? "," : "",
+			logFollower_records(f), logFollower_snapshots(f), matServ_matCount(serv), logFollower_appliedLsn(f),
+			hist_percentile(lag, 0.50), hist_percentile(lag, 0.99), hist_max(lag));
+		fprintf(run->out, ",\n    {\"name\": \"follow_reads\", \"ops\": %llu, \"p50Ns\": %lld, \"p99Ns\": %lld, \"maxNs\": %lld}",
+			hist_count(&reads), hist_percentile(&reads, 0.50), hist_percentile(&reads, 0.99), hist_max(&reads));
+		fprintf(stderr, "Applied %zu records up to change %llu, %zu materials at the end, lag p50 %lld ns, p99 %lld ns.\n",
+			logFollower_records(f), logFollower_appliedLsn(f), matServ_matCount(serv), hist_percentile(lag, 0.50), hist_percentile(lag, 0.99));
+		fprintf(stderr, "Served %llu queries while following, p50 %lld ns, p99 %lld ns.\n",
+			hist_count(&reads), hist_percentile(&reads, 0.50), hist_percentile(&reads, 0.99));
+	}
+	else
+		fprintf(stderr, "Cannot follow the primary on port %s (applied up to change %llu).\n", run->options.follow, f ? logFollower_appliedLsn(f) : 0ULL);
+
+	matGen_destroy(ctx.gen);
+	vector_destroy(ctx.results);
+	bitmap_destroy(ctx.bitmap);
+	logFollower_destroy(f);
+	matServ_destroy(serv);
+	matRepo_destroy(repo);
+	return status == 0;
+}
+
+// Command line.
+static void bench_usage()
+{
+	fprintf(stderr,
+		"Usage: bench [options]\n"
+		"  --min-size N     smallest catalog (default %d)\n"
+		"  --max-size N     biggest catalog (default %d), sizes grow 10 times\n"
+		"  --ops N          single material operations per benchmark (default %d)\n"
+		"  --budget S       seconds after which a benchmark stops (default %d, 0 for no limit)\n"
+		"  --seed N         seed of the generated catalog (default 1)\n"
+		"  --names N        distinct material names (default 1000)\n"
+		"  --suppliers N    distinct suppliers (default 100)\n"
+		"  --days N         days the expiration dates are spread over, from 2020/01/01 (default 3650)\n"
+		"  --dates D        'uniform' or 'early' expiration dates (default uniform)\n"
+		"  --output FILE    write the JSON results to the file instead of the standard output\n"
+		"  --replay FILE    replay a recorded session (see 'TraceWriter') instead of the generated catalogs\n"
+		"  --repeat N       times the session is replayed (default 1)\n"
+		"  --copies N       copies of the catalog every recorded write is made on (default 1)\n"
+		"  --spans FILE     write the spans of the replayed calls as Chrome trace events (needs MAT_SPANS)\n"
+		"  --follow PORT    apply the changes a console ships on the port (see 'LogShipper') while serving queries, until it exits, and report the lag\n",
+		BENCH_MIN_SIZE, BENCH_MAX_SIZE, BENCH_OPS, BENCH_BUDGET);
+}
+
+// Reads the options. Returns 0 if they are invalid.
+static int bench_parseOptions(int argc, char** argv, BenchOptions* options)
+{
+	options->minSize = BENCH_MIN_SIZE;
+	options->maxSize = BENCH_MAX_SIZE;
+	options->ops = BENCH_OPS;
+	options->budget = BENCH_BUDGET * 1000000000LL;
+	options->generator = matGen_defaultConfig();
+	options->output = NULL;
+	options->replay = NULL;
+	options->repeat = 1;
+	options->copies = 1;
+	options->spans = NULL;
+	options->follow = NULL;
+
+	for (int i = 1; i < argc; i += 2) {
+		if (i + 1 >= argc)
+			return 0;
+
+		const char* option = argv[i];
+		const char* value = argv[i + 1];
+		unsigned long long number = strtoull(value, NULL, 10);
+		if (strcmp(option, "--min-size") == 0)
+			options->minSize = (size_t)number;
+		else if (strcmp(option, "--max-size") == 0)
+			options->maxSize = (size_t)number;
+		else if (strcmp(option, "--ops") == 0)
+			options->ops = (size_t)number;
+		else if (strcmp(option, "--budget") == 0)
+			options->budget = (long long)number * 1000000000LL;
+		else if (strcmp(option, "--seed") == 0)
+			options->generator.seed = number;
+		else if (strcmp(option, "--names") == 0)
+			options->generator.nameCount = (size_t)number;
+		else if (strcmp(option, "--suppliers") == 0)
+			options->generator.supplierCount = (size_t)number;
+		else if (strcmp(option, "--days") == 0)
+			options->generator.dateSpan = (long)number;
+		else if (strcmp(option, "--dates") == 0 && strcmp(value, "uniform") == 0)
+			options->generator.dates = GEN_DATES_UNIFORM;
+		else if (strcmp(option, "--dates") == 0 && strcmp(value, "early") == 0)
+			options->generator.dates = GEN_DATES_EARLY;
+		else if (strcmp(option, "--output") == 0)
+			options->output = value;
+		else if (strcmp(option, "--replay") == 0)
+			options->replay = value;
+		else if (strcmp(option, "--repeat") == 0)
+			options->repeat = (size_t)number;
+		else if (strcmp(option, "--copies") == 0)
+			options->copies = (size_t)number;
+		else if (strcmp(option, "--spans") == 0)
+			options->spans = value;
+		else if (strcmp(option, "--follow") == 0)
+			options->follow = value;
+		else
+			return 0;
+	}
+
+	return options->repeat >= 1 && options->copies >= 1 && options->minSize >= 1 && options->minSize <= options->maxSize && options->maxSize <= 0x7FFFFFFF;
+}
+
+int main(int argc, char** argv)
+{
+	BenchRun run = { 0 };
+	if (!bench_parseOptions(argc, argv, &run.options)) {
+		bench_usage();
+		return 1;
+	}
+
+	MaterialGenerator* check = matGen_create(&run.options.generator);
+	if (check == NULL) {
+		fprintf(stderr, "Invalid catalog settings.\n");
+		return 1;
+	}
+	matGen_destroy(check);
+
+	run.out = run.options.output ? fopen(run.options.output, "w") : stdout;
+	if (run.out == NULL) {
+		fprintf(stderr, "Cannot open %s.\n", run.options.output);
+		return 1;
+	}
+
+	const GeneratorConfig* config = &run.options.generator;
+	int succeeded = 1;
+	if (run.options.follow) {
+		fprintf(run.out, "{\n  \"config\": {\"follow\": ");
+		bench_writeString(run.out, run.options.follow);
+		fprintf(run.out, "},\n  \"results\": [");
+		succeeded = bench_follow(&run);
+	}
+	else if (run.options.replay) {
+		fprintf(run.out, "{\n  \"config\": {\"replay\": ");
+		bench_writeString(run.out, run.options.replay);
+		fprintf(run.out, ", \"repeat\": %zu, \"copies\": %zu, \"budgetSeconds\": %lld},\n  \"results\": [",
+			run.options.repeat, run.options.copies, run.options.budget / 1000000000LL);
+		succeeded = bench_replay(&run);
+	}
+	else {
+		fprintf(run.out, "{\n  \"config\": {\"seed\": %llu, \"names\": %zu, \"suppliers\": %zu, \"days\": %ld, \"dates\": \"%s\", "
+			"\"ops\": %zu, \"budgetSeconds\": %lld},\n  \"results\": [",
+			config->seed, config->nameCount, config->supplierCount, config->dateSpan,
+			config->dates == GEN_DATES_EARLY ? "early" : "uniform", run.options.ops, run.options.budget / 1000000000LL);
+
+		for (size_t size = run.options.minSize; size <= run.options.maxSize; size *= 10)
+			if (!bench_size(&run, size))
+				break;
+	}
+
+	fprintf(run.out, "\n  ]\n}\n");
+	if (run.out != stdout)
+		fclose(run.out);
+
+	return succeeded ? 0 : 1;
+}
@@ -4,6 +4,20 @@
 #include "Material.h"
 #include "MaterialValidator.h"
 #include "Date.h"
+#include "Quantity.h"
 #include "Vector.h"
+#include "Arena.h"
+#include "Allocator.h"
+#include "MemoryTracker.h"
+#include "Histogram.h"
+#include "LatencyRecorder.h"
+#include "SpanTracer.h"
+#include "TypedVector.h"
+#include "IntMap.h"
+#include "StringTrie.h"
+#include "FuzzyMatch.h"
+#include "Thread.h"
+#include "Codec.h"
+#include "LocalSocket.h"
 
 #endif
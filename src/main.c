@@ -7,23 +7,68 @@
 
 #define SCAN_BUFFER_LENGTH 0x1000
 
+// The file the spans of the session are written to, when they are compiled in (see 'SPAN_BEGIN').
+#define SPANS_FILE "spans.json"
+
 void add_some_materials(MaterialService* matServ);
 
-int main()
+// Run the console. If a file name is given, the calls made to the service are recorded there (see 'TraceWriter'),
+// so the session can be replayed later with the benchmark ('--replay'). If a port is given after it, the changes are shipped
+// to the followers that connect to it on this machine at any time (see 'LogShipper'), for example the benchmark ('--follow').
+int main(int argc, char** argv)
 {
 	test_all();
 
+	// Every subsystem takes its memory through its own account of the tracker, so the console can show where it goes.
+	MemoryTracker* memoryTracker = memTracker_create(NULL);
+
 	int(*materialValidator)(const Material* mat) = matValid_validate;
-	MaterialRepository* materialRepository = matRepo_create(materialValidator);
-	MaterialService* materialService = matServ_create(materialRepository);
+	MaterialRepository* materialRepository = matRepo_createWith(materialValidator, MAT_REPO_DEFAULT_SHARDS, memTracker_allocator(memoryTracker, "repository"));
+	MaterialService* materialService = matServ_createWith(materialRepository, memTracker_allocator(memoryTracker, "service"));
 	Console* console = console_create(materialService, SCAN_BUFFER_LENGTH);
+	console_setMemoryTracker(console, memoryTracker);
+	if (!matServ_setLatencyTracking(materialService, 1))
+		printf("Operation latencies are not tracked.\n");
+
+	FILE* traceFile = argc > 1 ? fopen(argv[1], "wb") : NULL;
+	TraceWriter* trace = traceFile ? traceWriter_create(traceFile) : NULL;
+	if (argc > 1 && trace == NULL)
+		printf("Could not record the session to '%s'.\n", argv[1]);
+	matServ_setTrace(materialService, trace);
+
+	LogShipper* shipper = argc > 2 ? logShipper_create(materialService) : NULL;
+	if (argc > 2 && (shipper == NULL || !logShipper_listen(shipper, (unsigned short)atoi(argv[2]))))
+		printf("Could not ship the changes on port '%s'.\n", argv[2]);
+	console_setShipper(console, shipper);
+
+#ifdef MAT_SPANS
+	FILE* spansFile = fopen(SPANS_FILE, "w");
+	SpanTracer* spans = spansFile ? spanTracer_create(spansFile, 0) : NULL;
+	spanTracer_install(spans);
+#endif
 
 	add_some_materials(materialService);
+	if (shipper && logShipper_port(shipper) != 0 && !logShipper_serve(shipper))
+		printf("Followers are taken only while the console waits for input.\n");
 	console_run(console);
 
+#ifdef MAT_SPANS
+	spanTracer_destroy(spans);
+	if (spansFile)
+		fclose(spansFile);
+#endif
+
+	logShipper_destroy(shipper);
+
+	matServ_setTrace(materialService, NULL);
+	traceWriter_destroy(trace);
+	if (traceFile)
+		fclose(traceFile);
+
 	console_destroy(console);
 	matServ_destroy(materialService);
 	matRepo_destroy(materialRepository);
+	memTracker_destroy(memoryTracker);
 
 	_CrtDumpMemoryLeaks();
 
@@ -32,14 +77,14 @@ int main()
 
 void add_some_materials(MaterialService* matServ)
 {
-	matServ_addOrUpdateByNSE(matServ, -1, "Flour",		"Good Flour SRL",			11.0f, (Date) { 2022, 12, 13 }, NULL);
-	matServ_addOrUpdateByNSE(matServ, -1, "Milk",		"Cow inc",					12.1f, (Date) { 2000, 10, 11 }, NULL);
-	matServ_addOrUpdateByNSE(matServ, -1, "Raisins",	"Good Flour SRL",			13.4f, (Date) { 2000, 12, 12 }, NULL);
-	matServ_addOrUpdateByNSE(matServ, -1, "Water",		"Average Flour SRL",		14.4f, (Date) { 2022, 10, 13 }, NULL);
-	matServ_addOrUpdateByNSE(matServ, -1, "Sugar",		"Swweeeet inc",				15.0f, (Date) { 2022, 10, 14 }, NULL);
-	matServ_addOrUpdateByNSE(matServ, -1, "Flour",		"Bad Flour SRL",			16.9f, (Date) { 2022, 12, 15 }, NULL);
-	matServ_addOrUpdateByNSE(matServ, -1, "Milk",		"Best Cow inc",				17.0f, (Date) { 2022, 03, 13 }, NULL);
-	matServ_addOrUpdateByNSE(matServ, -1, "Cake Stuff",	"Rnd Bakery Stuff SRL",		18.0f, (Date) { 2022, 12, 17 }, NULL);
-	matServ_addOrUpdateByNSE(matServ, -1, "Flour",		"FLOOOOOOOOOOOOOOOOUR",		19.0f, (Date) { 2022, 10, 18 }, NULL);
-	matServ_addOrUpdateByNSE(matServ, -1, "Things",		"We sell stuff SRL",		20.0f, (Date) { 2022, 12, 19 }, NULL);
+	matServ_addOrUpdateByNSE(matServ, -1, "Flour",		"Good Flour SRL",			QUANTITY(11.0), (Date) { 2022, 12, 13 }, NULL);
+	matServ_addOrUpdateByNSE(matServ, -1, "Milk",		"Cow inc",					QUANTITY(12.1), (Date) { 2000, 10, 11 }, NULL);
+	matServ_addOrUpdateByNSE(matServ, -1, "Raisins",	"Good Flour SRL",			QUANTITY(13.4), (Date) { 2000, 12, 12 }, NULL);
+	matServ_addOrUpdateByNSE(matServ, -1, "Water",		"Average Flour SRL",		QUANTITY(14.4), (Date) { 2022, 10, 13 }, NULL);
+	matServ_addOrUpdateByNSE(matServ, -1, "Sugar",		"Swweeeet inc",				QUANTITY(15.0), (Date) { 2022, 10, 14 }, NULL);
+	matServ_addOrUpdateByNSE(matServ, -1, "Flour",		"Bad Flour SRL",			QUANTITY(16.9), (Date) { 2022, 12, 15 }, NULL);
+	matServ_addOrUpdateByNSE(matServ, -1, "Milk",		"Best Cow inc",				QUANTITY(17.0), (Date) { 2022, 03, 13 }, NULL);
+	matServ_addOrUpdateByNSE(matServ, -1, "Cake Stuff",	"Rnd Bakery Stuff SRL",		QUANTITY(18.0), (Date) { 2022, 12, 17 }, NULL);
+	matServ_addOrUpdateByNSE(matServ, -1, "Flour",		"FLOOOOOOOOOOOOOOOOUR",		QUANTITY(19.0), (Date) { 2022, 10, 18 }, NULL);
+	matServ_addOrUpdateByNSE(matServ, -1, "Things",		"We sell stuff SRL",		QUANTITY(20.0), (Date) { 2022, 12, 19 }, NULL);
 }
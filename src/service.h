@@ -2,5 +2,7 @@
 #define SERVICE
 
 #include "MaterialService.h"
+#include "MaterialReplication.h"
+#include "MaterialPipeline.h"
 
 #endif
@@ -3,11 +3,39 @@
 void test_all()
 {
 	test_material();
+	test_quantity();
+	test_date();
 	test_vector();
+	test_typed_vector();
+	test_int_map();
+	test_arena();
+	test_thread();
+	test_codec();
+	test_memory_tracker();
+	test_bitmap();
+	test_histogram();
+	test_latency_recorder();
+	test_span_tracer();
+	test_scan();
+	test_hash_map();
+	test_string_trie();
+	test_fuzzy_match();
+	test_timing_wheel();
 	test_material_validator();
 	test_material_operation();
+	test_material_batch();
+	test_material_pipeline();
+	test_material_generator();
 
 	test_material_repository();
 
 	test_material_service();
+	test_material_query();
+	test_material_cursor();
+	test_material_views();
+	test_material_stats();
+	test_material_expiry();
+	test_material_trace();
+	test_material_oracle();
+	test_material_replication();
 }
@@ -0,0 +1,82 @@
+#include "Arena.h"
+#include "Bitmap.h"
+#include "Vector.h"
+#include <assert.h>
+#include <string.h>
+
+void test_arena()
+{
+	Arena* a = arena_create(256);
+	assert(a != NULL);
+	assert(arena_used(a) == 0);
+	assert(arena_capacity(a) == 0);
+
+	// Blocks are aligned and do not overlap.
+	char* first = arena_alloc(a, 3);
+	char* second = arena_alloc(a, 5);
+	assert(first != NULL && second != NULL);
+	assert((size_t)first % 16 == 0 && (size_t)second % 16 == 0);
+	assert(second >= first + 3);
+	memset(first, 'a', 3);
+	memset(second, 'b', 5);
+	assert(first[2] == 'a');
+
+	int* zeros = arena_calloc(a, 10, sizeof(int));
+	for (int i = 0; i < 10; ++i)
+		assert(zeros[i] == 0);
+
+	char* copy = arena_strdup(a, "Flour");
+	assert(strcmp(copy, "Flour") == 0);
+
+	// Big blocks get a chunk of their own, more chunks are added when needed.
+	char* big = arena_alloc(a, 1000);
+	assert(big != NULL);
+	memset(big, 'c', 1000);
+	for (int i = 0; i < 20; ++i)
+		assert(arena_alloc(a, 100) != NULL);
+	size_t capacity = arena_capacity(a);
+	assert(capacity >= 1000 + 20 * 100);
+	assert(arena_used(a) > 0);
+
+	// After a reset the chunks are reused: the same requests don't allocate new chunks.
+	arena_reset(a);
+	assert(arena_used(a) == 0);
+	assert(arena_alloc(a, 3) == first);
+	arena_alloc(a, 5);
+	arena_calloc(a, 10, sizeof(int));
+	arena_strdup(a, "Flour");
+	arena_alloc(a, 1000);
+	for (int i = 0; i < 20; ++i)
+		arena_alloc(a, 100);
+	assert(arena_capacity(a) == capacity);
+
+	// Vectors and bitmaps in an arena.
+	arena_reset(a);
+	Vector* v = vector_createInArena(a, 0);
+	assert(v != NULL && vector_arena(v) == a);
+	for (size_t i = 0; i < 100; ++i)
+		vector_add(v, (void*)(i + 1));
+	assert(vector_length(v) == 100);
+	for (size_t i = 0; i < 100; ++i)
+		assert(vector_get(v, i) == (void*)(i + 1));
+	vector_removeAt(v, 0);
+	vector_shrinkToFit(v);
+	assert(vector_get(v, 0) == (void*)2);
+	vector_clear(v);
+	assert(vector_length(v) == 0);
+	vector_destroy(v);
+
+	Bitmap* b = bitmap_createInArena(a, 100);
+	assert(b != NULL && bitmap_count(b) == 0);
+	bitmap_set(b, 70, 1);
+	assert(bitmap_get(b, 70));
+	assert(bitmap_reset(b, 1000));
+	assert(bitmap_count(b) == 0);
+	bitmap_destroy(b);
+
+	Vector* heap = vector_createInArena(NULL, 1);
+	assert(heap != NULL && vector_arena(heap) == NULL);
+	vector_destroy(heap);
+
+	arena_destroy(a);
+}
@@ -0,0 +1,67 @@
+#include "Bitmap.h"
+#include <assert.h>
+
+void test_bitmap()
+{
+	Bitmap* b = bitmap_create(0);
+	assert(b != NULL);
+	assert(bitmap_length(b) == 0);
+	assert(bitmap_count(b) == 0);
+	assert(bitmap_next(b, 0) == 0);
+	assert(bitmap_get(b, 0) == 0);
+	bitmap_destroy(b);
+
+	b = bitmap_create(130);
+	assert(bitmap_length(b) == 130);
+	assert(bitmap_wordCount(b) == 3);
+	assert(bitmap_count(b) == 0);
+	assert(bitmap_next(b, 0) == 130);
+
+	bitmap_set(b, 0, 1);
+	bitmap_set(b, 63, 1);
+	bitmap_set(b, 64, 1);
+	bitmap_set(b, 129, 1);
+	bitmap_set(b, 130, 1);
+	assert(bitmap_count(b) == 4);
+	assert(bitmap_get(b, 63) == 1);
+	assert(bitmap_get(b, 62) == 0);
+	assert(bitmap_next(b, 0) == 0);
+	assert(bitmap_next(b, 1) == 63);
+	assert(bitmap_next(b, 64) == 64);
+	assert(bitmap_next(b, 65) == 129);
+	assert(bitmap_next(b, 130) == 130);
+
+	bitmap_set(b, 63, 0);
+	assert(bitmap_get(b, 63) == 0);
+	assert(bitmap_count(b) == 3);
+
+	Bitmap* other = bitmap_create(130);
+	bitmap_fill(other, 1);
+	assert(bitmap_count(other) == 130);
+	assert(bitmap_words(other)[2] == 3);
+
+	bitmap_set(other, 64, 0);
+	bitmap_and(other, b);
+	assert(bitmap_count(other) == 2);
+	assert(bitmap_get(other, 0) && bitmap_get(other, 129));
+
+	bitmap_set(other, 5, 1);
+	bitmap_or(b, other);
+	assert(bitmap_count(b) == 4);
+	assert(bitmap_get(b, 5));
+
+	bitmap_andNot(b, other);
+	assert(bitmap_count(b) == 1);
+	assert(bitmap_next(b, 0) == 64);
+
+	assert(bitmap_reset(b, 10));
+	assert(bitmap_length(b) == 10);
+	assert(bitmap_count(b) == 0);
+	bitmap_fill(b, 1);
+	assert(bitmap_count(b) == 10);
+	bitmap_fill(b, 0);
+	assert(bitmap_count(b) == 0);
+
+	bitmap_destroy(other);
+	bitmap_destroy(b);
+}
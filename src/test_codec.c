@@ -0,0 +1,111 @@
+#include "Codec.h"
+#include <assert.h>
+#include <string.h>
+
+// A source that hands out the bytes of a writer, but no more than 'available' of them.
+typedef struct {
+	const CodecWriter* w;
+	size_t read;
+	size_t available;
+} TestCodecSource;
+
+static size_t test_codec_fill(void* source, unsigned char* bytes, size_t size)
+{
+	TestCodecSource* s = source;
+	size_t count = s->available - s->read;
+	if (count > size)
+		count = size;
+	memcpy(bytes, codecWriter_bytes(s->w) + s->read, count);
+	s->read += count;
+	return count;
+}
+
+void test_codec()
+{
+	CodecWriter w;
+	codecWriter_init(&w);
+	assert(codecWriter_length(&w) == 0 && !codecWriter_failed(&w));
+
+	// Small numbers take one byte.
+	codecWriter_writeNumber(&w, 5);
+	codecWriter_writeSigned(&w, -1);
+	assert(codecWriter_length(&w) == 2);
+	assert(codecWriter_bytes(&w)[0] == 5 && codecWriter_bytes(&w)[1] == 1);
+	codecWriter_clear(&w);
+	assert(codecWriter_length(&w) == 0);
+
+	Material* mat = material_create();
+	material_id_set(mat, 42);
+	material_name_set(mat, "Flour");
+	material_supplier_set(mat, "sup1");
+	material_quantity_set(mat, QUANTITY(1.25));
+	material_expDate_set(mat, (Date) { 2024, 2, 29 });
+
+	codecWriter_writeByte(&w, 7);
+	codecWriter_writeNumber(&w, 0xFFFFFFFFFFFFFFFFULL);
+	codecWriter_writeSigned(&w, -123456789LL);
+	codecWriter_writeString(&w, NULL);
+	codecWriter_writeString(&w, "");
+	codecWriter_writeMaterial(&w, mat);
+	size_t firstEnd = codecWriter_length(&w);
+	codecWriter_writeBytes(&w, "end", 3);
+
+	// The first record arrives in two parts: reading it before the second part fails as starved, and it is read again
+	// from its start once the rest arrived.
+	TestCodecSource source = { &w, 0, firstEnd - 4 };
+	CodecReader r;
+	codecReader_init(&r, test_codec_fill, &source);
+	char* strings[2] = { NULL, NULL };
+	size_t capacities[2] = { 0, 0 };
+	Material* read = material_create();
+	int ok = 1;
+	codecReader_mark(&r);
+	assert(codecReader_readByte(&r, &ok) == 7);
+	assert(!codecReader_ensure(&r, firstEnd) && codecReader_starved(&r));
+	codecReader_readNumber(&r, &ok);
+	codecReader_readSigned(&r, &ok);
+	codecReader_readMaterial(&r, read, strings, capacities, &ok);
+	assert(!ok && codecReader_starved(&r));
+	codecReader_rewind(&r);
+	assert(!codecReader_starved(&r));
+
+	source.available = codecWriter_length(&w);
+	ok = 1;
+	assert(codecReader_ensure(&r, firstEnd));
+	assert(codecReader_readByte(&r, &ok) == 7);
+	assert(codecReader_readNumber(&r, &ok) == 0xFFFFFFFFFFFFFFFFULL);
+	assert(codecReader_readSigned(&r, &ok) == -123456789LL);
+	assert(codecReader_readString(&r, &strings[0], &capacities[0], &ok) == NULL && ok);
+	const char* empty = codecReader_readString(&r, &strings[0], &capacities[0], &ok);
+	assert(empty != NULL && empty[0] == '\0');
+	codecReader_readMaterial(&r, read, strings, capacities, &ok);
+	assert(ok);
+	assert(material_id(read) == 42 && strcmp(material_name(read), "Flour") == 0);
+	assert(strcmp(material_supplier(read), "sup1") == 0 && material_quantity(read) == QUANTITY(1.25));
+	assert(material_expSerial(read) == material_expSerial(mat));
+
+	char end[3];
+	codecReader_mark(&r);
+	codecReader_readBytes(&r, end, sizeof(end), &ok);
+	assert(ok && memcmp(end, "end", 3) == 0);
+	assert(!codecReader_hasMore(&r));
+	assert(codecReader_readByte(&r, &ok) == 0 && !ok && codecReader_starved(&r));
+
+	// A string longer than CODEC_MAX_STRING means the bytes are corrupt.
+	codecWriter_clear(&w);
+	codecWriter_writeNumber(&w, CODEC_MAX_STRING + 1);
+	source.read = 0;
+	source.available = codecWriter_length(&w);
+	codecReader_free(&r);
+	codecReader_init(&r, test_codec_fill, &source);
+	ok = 1;
+	assert(codecReader_readString(&r, &strings[0], &capacities[0], &ok) == NULL && !ok);
+	assert(!codecReader_starved(&r));
+
+	free(strings[0]);
+	free(strings[1]);
+	material_destroy(read);
+	material_destroy(mat);
+	codecReader_free(&r);
+	codecWriter_free(&w);
+}
@@ -0,0 +1,75 @@
+#include "Date.h"
+#include <assert.h>
+
+void test_date()
+{
+	// Leap years and month lengths.
+	assert(date_isLeapYear(2024) && date_isLeapYear(2000) && date_isLeapYear(4));
+	assert(!date_isLeapYear(2023) && !date_isLeapYear(1900) && !date_isLeapYear(2100));
+	assert(date_daysInMonth(2023, 2) == 28 && date_daysInMonth(2024, 2) == 29);
+	assert(date_daysInMonth(2023, 4) == 30 && date_daysInMonth(2023, 12) == 31);
+	assert(date_daysInMonth(2023, 0) == 0 && date_daysInMonth(2023, 13) == 0);
+
+	assert(date_isValid((Date) { 2024, 2, 29 }));
+	assert(!date_isValid((Date) { 2023, 2, 29 }));
+	assert(!date_isValid((Date) { 2023, 2, 31 }));
+	assert(!date_isValid((Date) { 2023, 4, 31 }));
+	assert(!date_isValid((Date) { 0, 1, 1 }) && !date_isValid((Date) { 10000, 1, 1 }));
+	assert(date_isValid((Date) { 1, 1, 1 }) && date_isValid((Date) { 9999, 12, 31 }));
+	assert(!date_isValid((Date) { 2023, 0, 1 }) && !date_isValid((Date) { 2023, 1, 0 }));
+
+	// Serials.
+	assert(sizeof(DateSerial) == 4);
+	assert(date_serial((Date) { 1, 1, 1 }) == 0);
+	assert(date_serial((Date) { 2023, 2, 29 }) == DATE_SERIAL_NONE);
+	assert(date_serial((Date) { 2024, 3, 1 }) == date_serial((Date) { 2024, 2, 29 }) + 1);
+	assert(date_serial((Date) { 2023, 3, 1 }) == date_serial((Date) { 2023, 2, 28 }) + 1);
+	assert(date_serial((Date) { 2024, 1, 1 }) == date_serial((Date) { 2023, 12, 31 }) + 1);
+	Date max = date_fromSerial(date_serial((Date) { 9999, 12, 31 }));
+	assert(max.year == 9999 && max.month == 12 && max.day == 31);
+
+	Date none = date_fromSerial(DATE_SERIAL_NONE);
+	assert(none.year == 0 && none.month == 0 && none.day == 0);
+	none = date_fromSerial(date_serial((Date) { 9999, 12, 31 }) + 1);
+	assert(none.year == 0);
+	none = date_fromSerial(-1);
+	assert(none.year == 0);
+
+	// Every valid date round trips, and the serials follow the calendar order.
+	DateSerial last = DATE_SERIAL_NONE;
+	for (int year = 1999; year <= 2101; ++year) {
+		for (int month = 1; month <= 12; ++month) {
+			for (int day = 1; day <= date_daysInMonth(year, month); ++day) {
+				DateSerial serial = date_serial((Date) { year, month, day });
+				assert(last == DATE_SERIAL_NONE || serial == last + 1);
+				Date d = date_fromSerial(serial);
+				assert(d.year == year && d.month == month && d.day == day);
+				last = serial;
+			}
+		}
+	}
+
+	// Invalid dates round up to the next valid one.
+	assert(date_serialCeil((Date) { 2023, 2, 31 }) == date_serial((Date) { 2023, 3, 1 }));
+	assert(date_serialCeil((Date) { 2024, 2, 30 }) == date_serial((Date) { 2024, 3, 1 }));
+	assert(date_serialCeil((Date) { 2023, 12, 32 }) == date_serial((Date) { 2024, 1, 1 }));
+	assert(date_serialCeil((Date) { 2023, 13, 5 }) == date_serial((Date) { 2024, 1, 1 }));
+	assert(date_serialCeil((Date) { 2023, 0, 5 }) == date_serial((Date) { 2023, 1, 1 }));
+	assert(date_serialCeil((Date) { 2023, 5, 0 }) == date_serial((Date) { 2023, 5, 1 }));
+	assert(date_serialCeil((Date) { 2023, 5, 9 }) == date_serial((Date) { 2023, 5, 9 }));
+	assert(date_serialCeil((Date) { 0, 0, 0 }) == 0);
+	assert(date_serialCeil((Date) { 10000, 1, 1 }) == date_serial((Date) { 9999, 12, 31 }) + 1);
+
+	// Adding and counting days.
+	Date d = date_addDays((Date) { 2024, 2, 28 }, 1);
+	assert(d.year == 2024 && d.month == 2 && d.day == 29);
+	d = date_addDays((Date) { 2023, 12, 31 }, 1);
+	assert(d.year == 2024 && d.month == 1 && d.day == 1);
+	d = date_addDays((Date) { 2024, 3, 1 }, -1);
+	assert(d.year == 2024 && d.month == 2 && d.day == 29);
+	d = date_addDays((Date) { 2023, 5, 9 }, 0);
+	assert(d.year == 2023 && d.month == 5 && d.day == 9);
+	assert(date_diffDays((Date) { 2023, 1, 1 }, (Date) { 2024, 1, 1 }) == 365);
+	assert(date_diffDays((Date) { 2024, 1, 1 }, (Date) { 2025, 1, 1 }) == 366);
+	assert(date_diffDays((Date) { 2024, 3, 1 }, (Date) { 2024, 2, 1 }) == -29);
+}
@@ -0,0 +1,87 @@
+#include "FuzzyMatch.h"
+#include <assert.h>
+#include <ctype.h>
+#include <string.h>
+
+// Edit distance computed with the full dynamic programming matrix, ignoring case.
+static int test_editDistance(const char* a, const char* b)
+{
+	size_t m = strlen(a), n = strlen(b);
+	int row[FUZZY_MAX_PATTERN + 1];
+	for (size_t i = 0; i <= m; ++i)
+		row[i] = (int)i;
+
+	for (size_t j = 1; j <= n; ++j) {
+		int diagonal = row[0];
+		row[0] = (int)j;
+		for (size_t i = 1; i <= m; ++i) {
+			int above = row[i];
+			int cost = tolower((unsigned char)a[i - 1]) != tolower((unsigned char)b[j - 1]);
+			int best = diagonal + cost;
+			if (row[i] + 1 < best)
+				best = row[i] + 1;
+			if (row[i - 1] + 1 < best)
+				best = row[i - 1] + 1;
+			row[i] = best;
+			diagonal = above;
+		}
+	}
+
+	return row[m];
+}
+
+void test_fuzzy_match()
+{
+	FuzzyPattern p;
+	assert(fuzzy_compile(&p, "Flour", 1));
+	assert(fuzzy_distance(&p, "Flour") == 0);
+	assert(fuzzy_distance(&p, "flour") == 0);
+	assert(fuzzy_distance(&p, "Flor") == 1);
+	assert(fuzzy_distance(&p, "Floor") == 1);
+	assert(fuzzy_distance(&p, "Fluor") == -1);
+	assert(fuzzy_distance(&p, "Milk") == -1);
+	assert(fuzzy_distance(&p, "") == -1);
+	assert(fuzzy_matches(&p, "Flours"));
+	assert(!fuzzy_matches(&p, "Flowers"));
+
+	assert(fuzzy_compile(&p, "", 2));
+	assert(fuzzy_distance(&p, "ab") == 2);
+	assert(fuzzy_distance(&p, "abc") == -1);
+
+	assert(!fuzzy_compile(&p, "a", -1));
+	char longPattern[FUZZY_MAX_PATTERN + 2];
+	memset(longPattern, 'a', FUZZY_MAX_PATTERN + 1);
+	longPattern[FUZZY_MAX_PATTERN + 1] = '\0';
+	assert(!fuzzy_compile(&p, longPattern, 1));
+	longPattern[FUZZY_MAX_PATTERN] = '\0';
+	assert(fuzzy_compile(&p, longPattern, 1));
+	assert(fuzzy_distance(&p, longPattern) == 0);
+	longPattern[10] = 'b';
+	assert(fuzzy_distance(&p, longPattern) == 1);
+
+	// Compare with the plain dynamic programming on pseudo random strings over a small alphabet.
+	unsigned int seed = 12345;
+	char a[16], b[16];
+	for (int test = 0; test < 5000; ++test) {
+		size_t m = 0, n = 0;
+		seed = seed * 1103515245u + 12345u;
+		m = (seed >> 16) % 12;
+		seed = seed * 1103515245u + 12345u;
+		n = (seed >> 16) % 12;
+		for (size_t i = 0; i < m; ++i) {
+			seed = seed * 1103515245u + 12345u;
+			a[i] = "abcAB"[(seed >> 16) % 5];
+		}
+		for (size_t i = 0; i < n; ++i) {
+			seed = seed * 1103515245u + 12345u;
+			b[i] = "abcAB"[(seed >> 16) % 5];
+		}
+		a[m] = b[n] = '\0';
+
+		int expected = test_editDistance(a, b);
+		for (int k = 0; k <= 4; ++k) {
+			assert(fuzzy_compile(&p, a, k));
+			assert(fuzzy_distance(&p, b) == (expected <= k ? expected : -1));
+		}
+	}
+}
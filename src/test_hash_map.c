@@ -0,0 +1,59 @@
+#include "HashMap.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+void test_hash_map()
+{
+	HashMap* map = hashMap_create();
+	assert(map != NULL);
+	assert(hashMap_count(map) == 0);
+	assert(hashMap_get(map, "a") == NULL);
+	assert(hashMap_remove(map, "a") == NULL);
+
+	assert(hashMap_put(map, "a", (void*)1));
+	assert(hashMap_put(map, "b", (void*)2));
+	assert(hashMap_count(map) == 2);
+	assert(hashMap_get(map, "a") == (void*)1);
+	assert(hashMap_get(map, "b") == (void*)2);
+	assert(hashMap_get(map, "c") == NULL);
+
+	assert(hashMap_put(map, "a", (void*)3));
+	assert(hashMap_count(map) == 2);
+	assert(hashMap_get(map, "a") == (void*)3);
+
+	// Grow, then remove every other key and check the rest can still be found.
+	char key[16];
+	for (size_t i = 0; i < 1000; ++i) {
+		sprintf(key, "key%zu", i);
+		assert(hashMap_put(map, key, (void*)(i + 1)));
+	}
+	assert(hashMap_count(map) == 1002);
+
+	for (size_t i = 0; i < 1000; i += 2) {
+		sprintf(key, "key%zu", i);
+		assert(hashMap_remove(map, key) == (void*)(i + 1));
+	}
+	assert(hashMap_count(map) == 502);
+
+	for (size_t i = 0; i < 1000; ++i) {
+		sprintf(key, "key%zu", i);
+		assert(hashMap_get(map, key) == (i % 2 ? (void*)(i + 1) : NULL));
+	}
+
+	size_t entries = 0;
+	for (size_t i = 0; i < hashMap_capacity(map); ++i) {
+		const HashMapEntry* entry = hashMap_entryAt(map, i);
+		if (entry) {
+			assert(hashMap_get(map, entry->key) == entry->value);
+			++entries;
+		}
+	}
+	assert(entries == 502);
+	assert(hashMap_entryAt(map, hashMap_capacity(map)) == NULL);
+
+	assert(hashMap_hashString("abc") == hashMap_hashString("abc"));
+	assert(hashMap_hashString("abc") != hashMap_hashString("abd"));
+
+	hashMap_destroy(map);
+}
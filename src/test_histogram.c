@@ -0,0 +1,60 @@
+#include "Histogram.h"
+#include <assert.h>
+
+void test_histogram()
+{
+	Histogram* h = malloc(sizeof(Histogram));
+	assert(h != NULL);
+	hist_clear(h);
+	assert(hist_count(h) == 0);
+	assert(hist_min(h) == 0 && hist_max(h) == 0);
+	assert(hist_mean(h) == 0.0);
+	assert(hist_percentile(h, 0.5) == 0);
+
+	// Small values are exact.
+	for (long long i = 1; i <= 10; ++i)
+		hist_record(h, i);
+	assert(hist_count(h) == 10);
+	assert(hist_min(h) == 1 && hist_max(h) == 10);
+	assert(hist_mean(h) == 5.5);
+	assert(hist_percentile(h, 0.0) == 1);
+	assert(hist_percentile(h, 0.5) == 5);
+	assert(hist_percentile(h, 0.9) == 9);
+	assert(hist_percentile(h, 1.0) == 10);
+	assert(hist_percentile(h, 2.0) == 10);
+
+	// Big values are known within 1 / HIST_SUB_BUCKETS of themselves.
+	hist_clear(h);
+	for (long long i = 1; i <= 1000; ++i)
+		hist_record(h, i * 1000);
+	long long p50 = hist_percentile(h, 0.5);
+	long long p99 = hist_percentile(h, 0.99);
+	assert(p50 >= 500000 && p50 <= 500000 + 500000 / HIST_SUB_BUCKETS);
+	assert(p99 >= 990000 && p99 <= 990000 + 990000 / HIST_SUB_BUCKETS);
+	assert(hist_percentile(h, 1.0) == 1000000);
+
+	// Extreme values.
+	hist_clear(h);
+	hist_record(h, -5);
+	hist_record(h, 0x7FFFFFFFFFFFFFFFLL);
+	assert(hist_min(h) == 0);
+	assert(hist_percentile(h, 0.5) == 0);
+	assert(hist_percentile(h, 1.0) == 0x7FFFFFFFFFFFFFFFLL);
+
+	// Merge.
+	Histogram* other = malloc(sizeof(Histogram));
+	assert(other != NULL);
+	hist_clear(other);
+	hist_merge(h, other);
+	assert(hist_count(h) == 2);
+	hist_record(other, 40);
+	hist_record(other, 20);
+	hist_merge(other, h);
+	assert(hist_count(other) == 4);
+	assert(hist_min(other) == 0 && hist_max(other) == 0x7FFFFFFFFFFFFFFFLL);
+	assert(hist_percentile(other, 0.5) == 20);
+	assert(hist_percentile(other, 0.75) == 40);
+
+	free(other);
+	free(h);
+}
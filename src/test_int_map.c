@@ -0,0 +1,39 @@
+#include "IntMap.h"
+#include <assert.h>
+
+void test_int_map()
+{
+	IntMap map;
+	intMap_init(&map);
+	size_t value = 0;
+	assert(intMap_count(&map) == 0);
+	assert(!intMap_get(&map, 1, &value));
+	assert(!intMap_remove(&map, 1));
+
+	assert(intMap_put(&map, 1, 10));
+	assert(intMap_put(&map, -1, 20));
+	assert(intMap_count(&map) == 2);
+	assert(intMap_get(&map, 1, &value) && value == 10);
+	assert(intMap_get(&map, -1, &value) && value == 20);
+	assert(!intMap_get(&map, 0, NULL));
+
+	assert(intMap_put(&map, 1, 30));
+	assert(intMap_count(&map) == 2);
+	assert(intMap_get(&map, 1, &value) && value == 30);
+
+	// Grow, then remove every other key and check the rest can still be found.
+	for (int i = 0; i < 1000; ++i)
+		assert(intMap_put(&map, i * 7, (size_t)i));
+	assert(intMap_count(&map) == 1002);
+	for (int i = 0; i < 1000; i += 2)
+		assert(intMap_remove(&map, i * 7));
+	assert(!intMap_remove(&map, 0));
+	assert(intMap_count(&map) == 502);
+	for (int i = 0; i < 1000; ++i)
+		assert(intMap_get(&map, i * 7, &value) == (i % 2 == 1) && (i % 2 == 0 || value == (size_t)i));
+	assert(intMap_get(&map, -1, &value) && value == 20);
+
+	intMap_free(&map);
+	assert(intMap_count(&map) == 0);
+	assert(!intMap_get(&map, 7, NULL));
+}
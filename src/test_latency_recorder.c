@@ -0,0 +1,69 @@
+#include "LatencyRecorder.h"
+#include <assert.h>
+#include <string.h>
+
+static const char* const TEST_OPERATIONS[] = { "first", "second" };
+
+#define TEST_LATENCY_THREADS 4
+#define TEST_LATENCY_RECORDS 1000
+
+static void test_latency_record(void* argument)
+{
+	LatencyRecorder* rec = argument;
+	for (int i = 0; i < TEST_LATENCY_RECORDS; ++i)
+		latency_stop(rec, 0, latency_start(rec));
+}
+
+void test_latency_recorder()
+{
+	// A NULL recorder does nothing.
+	assert(latency_start(NULL) == 0);
+	latency_stop(NULL, 0, 0);
+
+	LatencyRecorder* rec = latency_create(TEST_OPERATIONS, 2);
+	assert(rec != NULL);
+	assert(latency_count(rec) == 2);
+	assert(strcmp(latency_name(rec, 1), "second") == 0);
+	assert(latency_name(rec, 2) == NULL);
+	assert(latency_histogram(rec, 2) == NULL);
+	assert(hist_count(latency_histogram(rec, 0)) == 0);
+
+	long long started = latency_start(rec);
+	assert(started > 0);
+	latency_stop(rec, 1, started);
+	latency_stop(rec, 1, latency_now() - 5000);
+	latency_stop(rec, 2, started);
+	assert(hist_count(latency_histogram(rec, 0)) == 0);
+	assert(hist_count(latency_histogram(rec, 1)) == 2);
+	assert(hist_max(latency_histogram(rec, 1)) >= 5000);
+
+	// Only the operations that ran are written.
+	FILE* file = tmpfile();
+	assert(file != NULL);
+	latency_write(rec, file, "Title");
+	rewind(file);
+	char line[256];
+	assert(fgets(line, sizeof(line), file) && strcmp(line, "Title\n") == 0);
+	assert(fgets(line, sizeof(line), file) && strncmp(line, "operation", 9) == 0);
+	assert(fgets(line, sizeof(line), file) && strncmp(line, "second ", 7) == 0);
+	assert(fgets(line, sizeof(line), file) == NULL);
+	fclose(file);
+
+	latency_clear(rec);
+	assert(hist_count(latency_histogram(rec, 1)) == 0);
+
+	// The latencies recorded by every thread are merged when they are read.
+	Thread threads[TEST_LATENCY_THREADS];
+	for (int i = 0; i < TEST_LATENCY_THREADS; ++i)
+		assert(thread_start(&threads[i], test_latency_record, rec));
+	for (int i = 0; i < TEST_LATENCY_THREADS; ++i)
+		thread_join(&threads[i]);
+	latency_stop(rec, 0, latency_start(rec));
+	assert(hist_count(latency_histogram(rec, 0)) == TEST_LATENCY_THREADS * TEST_LATENCY_RECORDS + 1);
+
+	// The clock does not go back.
+	long long before = latency_now();
+	assert(latency_now() >= before);
+	latency_destroy(rec);
+	latency_destroy(NULL);
+}
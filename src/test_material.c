@@ -11,15 +11,13 @@ void test_material()
 	assert(cmat->id == 0);
 	assert(cmat->name == NULL);
 	assert(cmat->supplier == NULL);
-	assert(cmat->quantity == 0.0f);
-	assert(cmat->exp_date.year == 0);
-	assert(cmat->exp_date.month == 0);
-	assert(cmat->exp_date.day == 0);
+	assert(cmat->quantity == 0);
+	assert(cmat->exp_date == DATE_SERIAL_NONE);
 
 	assert(material_id(cmat) == 0);
 	assert(material_name(cmat) == NULL);
 	assert(material_supplier(cmat) == NULL);
-	assert(material_quantity(cmat) == 0.0f);
+	assert(material_quantity(cmat) == 0);
 	assert(material_expDate(cmat).year == 0);
 	assert(material_expDate(cmat).month == 0);
 	assert(material_expDate(cmat).day == 0);
@@ -36,8 +34,8 @@ void test_material()
 	material_name_set(mat, "hi");
 	assert(strcmp(material_name(cmat), "hi") == 0);
 
-	material_quantity_set(mat, 15.6f);
-	assert(material_quantity(cmat) == 15.6f);
+	material_quantity_set(mat, QUANTITY(15.6));
+	assert(material_quantity(cmat) == QUANTITY(15.6));
 
 	Date expDate = { .year = 1970, .month = 10, .day = 20 };
 	material_expDate_set(mat, expDate);
@@ -53,11 +51,48 @@ void test_material()
 	assert(material_id(dupeMat) == 68);
 	assert(strcmp(material_name(dupeMat), "hi") == 0);
 	assert(material_supplier(dupeMat) == NULL);
-	assert(material_quantity(dupeMat) == 15.6f);
+	assert(material_quantity(dupeMat) == QUANTITY(15.6));
 	assert(material_expDate(dupeMat).year == 1970);
 	assert(material_expDate(dupeMat).month == 10);
 	assert(material_expDate(dupeMat).day == 20);
 
+	// Short strings are stored inside the material, long ones separately.
+	const char* longName = "A name that does not fit in the inline buffer";
+	material_name_set(mat, "Flour");
+	assert((cmat->inlineStrings & MATERIAL_INLINE_NAME) && cmat->name == NULL);
+	material_name_set(mat, longName);
+	assert(!(cmat->inlineStrings & MATERIAL_INLINE_NAME) && cmat->name != NULL);
+	assert(strcmp(material_name(cmat), longName) == 0);
+	material_name_set(mat, material_name(cmat) + 30);
+	assert((cmat->inlineStrings & MATERIAL_INLINE_NAME) && cmat->name == NULL);
+	assert(strcmp(material_name(cmat), longName + 30) == 0);
+	material_name_set(mat, material_name(cmat) + 2);
+	assert(strcmp(material_name(cmat), longName + 32) == 0);
+	material_supplier_set(mat, longName);
+	material_set(mat, mat);
+	assert(strcmp(material_supplier(cmat), longName) == 0);
+
+	material_set(dupeMat, mat);
+	assert(dupeMat->inlineStrings == MATERIAL_INLINE_NAME);
+	assert(dupeMat->supplier != NULL && dupeMat->supplier != cmat->supplier);
+	assert(strcmp(material_supplier(dupeMat), longName) == 0);
+	material_name_set(dupeMat, NULL);
+	assert(material_name(dupeMat) == NULL);
+
 	material_destroy(mat);
 	material_destroy(dupeMat);
+
+	// A material stored by value can be moved, since it holds no pointer to itself.
+	Material values[2];
+	material_init(&values[0], NULL);
+	assert(material_name(&values[0]) == NULL && material_expSerial(&values[0]) == DATE_SERIAL_NONE);
+	material_name_set(&values[0], "Milk");
+	material_supplier_set(&values[0], longName);
+	values[1] = values[0];
+	material_init(&values[0], NULL);
+	assert(strcmp(material_name(&values[1]), "Milk") == 0);
+	assert(strcmp(material_supplier(&values[1]), longName) == 0);
+	material_release(&values[1]);
+	assert(material_name(&values[1]) == NULL && material_supplier(&values[1]) == NULL);
+	material_release(&values[0]);
 }
@@ -0,0 +1,72 @@
+#include "MaterialService.h"
+#include "MaterialBatch.h"
+#include "MaterialValidator.h"
+#include <assert.h>
+#include <string.h>
+
+void test_material_batch()
+{
+	MaterialBatch* batch = matBatch_create();
+	assert(batch != NULL);
+	assert(matBatch_length(batch) == 0);
+	assert(matBatch_pendingCount(batch) == 0);
+	assert(matBatch_result(batch, 0) == MAT_BATCH_PENDING);
+
+	Material* mat = material_construct(-1, "name1", "sup1", QUANTITY(10), (Date) { 2030, 1, 1 });
+	assert(matBatch_enqueue(batch, NONE, NULL) == -1);
+	assert(matBatch_enqueue(batch, ADD, NULL) == -1);
+	assert(matBatch_enqueue(batch, ADD, mat) == 0);
+	assert(matBatch_enqueue(batch, ADD, mat) == 1);
+
+	material_name_set(mat, "name2");
+	assert(matBatch_enqueue(batch, ADD, mat) == 2);
+	material_quantity_set(mat, QUANTITY(-5));
+	assert(matBatch_enqueue(batch, UPDATE, mat) == 3);
+	material_name_set(mat, "name1");
+	assert(matBatch_enqueue(batch, REMOVE, mat) == 4);
+	material_name_set(mat, "name3");
+	assert(matBatch_enqueue(batch, REMOVE, mat) == 5);
+
+	assert(matBatch_length(batch) == 6);
+	assert(matBatch_pendingCount(batch) == 6);
+	assert(matOp_type(matBatch_operation(batch, 3)) == UPDATE);
+	assert(strcmp(material_name(matOp_material(matBatch_operation(batch, 2))), "name2") == 0);
+	assert(matBatch_result(batch, 0) == MAT_BATCH_PENDING);
+
+	// Commit.
+	MaterialRepository* repo = matRepo_create(matValid_validate);
+	MaterialService* serv = matServ_create(repo);
+
+	assert(matServ_commitBatch(serv, batch) == 4);
+	assert(matBatch_pendingCount(batch) == 0);
+	assert(matBatch_result(batch, 0) == 0);
+	assert(matBatch_result(batch, 1) == 0);
+	assert(matBatch_result(batch, 2) == 1);
+	assert(matBatch_result(batch, 3) == -1);
+	assert(matBatch_result(batch, 4) == 0);
+	assert(matBatch_result(batch, 5) == -4);
+
+	assert(matServ_matCount(serv) == 1);
+	assert(strcmp(material_name(matServ_findById(serv, 1)), "name2") == 0);
+	assert(matServ_commitBatch(serv, batch) == 0);
+
+	// Every write of the batch is undone separately.
+	assert(matServ_undo(serv));
+	assert(matServ_matCount(serv) == 2);
+	assert(material_quantity(matServ_findById(serv, 0)) == QUANTITY(20));
+	assert(matServ_undo(serv));
+	assert(matServ_undo(serv));
+	assert(material_quantity(matServ_findById(serv, 0)) == QUANTITY(10));
+	assert(matServ_undo(serv));
+	assert(matServ_matCount(serv) == 0);
+	assert(!matServ_undo(serv));
+
+	matBatch_clear(batch);
+	assert(matBatch_length(batch) == 0);
+	assert(matBatch_result(batch, 0) == MAT_BATCH_PENDING);
+
+	material_destroy(mat);
+	matBatch_destroy(batch);
+	matServ_destroy(serv);
+	matRepo_destroy(repo);
+}
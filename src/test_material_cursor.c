@@ -0,0 +1,91 @@
+#include "MaterialService.h"
+#include "MaterialValidator.h"
+#include <assert.h>
+#include <string.h>
+
+static Date cursorToday = { 2022, 6, 15 };
+
+static Date test_cursorClock()
+{
+	return cursorToday;
+}
+
+static int test_quantityAbove(void* context, const Material* mat)
+{
+	return material_quantity(mat) > *(const Quantity*)context;
+}
+
+// Returns the number of materials left in the cursor.
+static size_t test_drain(MaterialCursor* cur)
+{
+	size_t count = 0;
+	while (matCursor_next(cur) != NULL)
+		++count;
+	return count;
+}
+
+void test_material_cursor()
+{
+	MaterialRepository* repo = matRepo_create(matValid_validate);
+	MaterialService* serv = matServ_create(repo);
+	matServ_setClock(serv, test_cursorClock);
+
+	MaterialCursor cur = matServ_cursorAll(serv);
+	assert(matCursor_next(&cur) == NULL);
+
+	const char* suppliers[] = { "sup1", "sup2" };
+	for (int i = 0; i < 40; ++i)
+		matServ_add(serv, -1, i % 4 ? "Flour" : "Milk", suppliers[i % 2], QUANTITY(i + 1), (Date) { 2021 + i % 3, 1 + i % 12, 1 + i / 12 }, 0);
+
+	assert(matServ_matCount(serv) == 40);
+
+	// The cursor yields the materials in the order of the repository.
+	cur = matServ_cursorAll(serv);
+	for (size_t i = 0; i < matServ_matCount(serv); ++i)
+		assert(matCursor_next(&cur) == matRepo_getByIndex(repo, i));
+	assert(matCursor_next(&cur) == NULL);
+	assert(matCursor_next(&cur) == NULL);
+
+	matCursor_rewind(&cur);
+	assert(test_drain(&cur) == 40);
+
+	// Expired materials, with and without a string.
+	Vector* v = vector_create(0);
+	matServ_get_materials_past_exp(serv, v, "");
+	cur = matServ_cursorExpired(serv, NULL);
+	for (size_t i = 0; i < vector_length(v); ++i)
+		assert(matCursor_next(&cur) == vector_get(v, i));
+	assert(matCursor_next(&cur) == NULL);
+	vector_destroy(v);
+
+	cur = matServ_cursorExpired(serv, "Mil");
+	for (const Material* mat = matCursor_next(&cur); mat != NULL; mat = matCursor_next(&cur)) {
+		assert(strcmp(material_name(mat), "Milk") == 0);
+		assert(material_expDate(mat).year < 2022 || (material_expDate(mat).year == 2022 && (material_expDate(mat).month < 6 || (material_expDate(mat).month == 6 && material_expDate(mat).day < 15))));
+	}
+
+	// A query cursor matches the conditions, and filters can be chained.
+	MaterialQuery* q = matQuery_create();
+	matQuery_whereNameContains(matQuery_whereSupplierIs(q, "sup1"), "Flo");
+	cur = matServ_cursorQuery(serv, q);
+	assert(test_drain(&cur) == 10);
+
+	matCursor_rewind(&cur);
+	Quantity minQuantity = QUANTITY(20);
+	MaterialCursor chained = matCursor_overCursor(&cur);
+	matCursor_filter(&chained, test_quantityAbove, &minQuantity);
+	size_t count = 0;
+	for (const Material* mat = matCursor_next(&chained); mat != NULL; mat = matCursor_next(&chained)) {
+		assert(matQuery_matches(q, mat));
+		assert(material_quantity(mat) > minQuantity);
+		++count;
+	}
+	assert(count == 5);
+
+	matCursor_rewind(&chained);
+	assert(test_drain(&chained) == 5);
+	matQuery_destroy(q);
+
+	matServ_destroy(serv);
+	matRepo_destroy(repo);
+}
@@ -0,0 +1,73 @@
+#include "MaterialService.h"
+#include "MaterialValidator.h"
+#include <assert.h>
+#include <string.h>
+
+static Date expiryToday = { 2022, 6, 15 };
+
+static Date test_expiryClock()
+{
+	return expiryToday;
+}
+
+static size_t expiredCount = 0;
+static int lastExpiredId = -1;
+
+static void test_onExpired(void* context, const Material* mat)
+{
+	assert(context == &expiredCount);
+	++expiredCount;
+	lastExpiredId = material_id(mat);
+}
+
+void test_material_expiry()
+{
+	MaterialRepository* repo = matRepo_create(matValid_validate);
+	Material* salt = material_construct(0, "Salt", "sup1", QUANTITY(1), (Date) { 2022, 6, 20 });
+	assert(matRepo_save(repo, salt) == 0);
+	material_destroy(salt);
+
+	MaterialService* serv = matServ_create(repo);
+	matServ_setClock(serv, test_expiryClock);
+	matServ_setExpiryCallback(serv, test_onExpired, &expiredCount);
+	assert(matExpiry_count(serv->expiry) == 1);
+
+	assert(matServ_add(serv, 1, "Milk", "sup1", QUANTITY(1), (Date) { 2022, 6, 16 }, 1) == 1);
+	assert(matServ_add(serv, 2, "Flour", "sup2", QUANTITY(1), (Date) { 2022, 7, 1 }, 1) == 2);
+	assert(matServ_add(serv, 3, "Eggs", "sup2", QUANTITY(1), (Date) { 2022, 6, 1 }, 1) == 3);
+	assert(matExpiry_count(serv->expiry) == 3);
+	assert(matServ_tick(serv) == 0);
+
+	// Milk expires once its date is over.
+	expiryToday = (Date) { 2022, 6, 16 };
+	assert(matServ_tick(serv) == 0);
+	expiryToday = (Date) { 2022, 6, 17 };
+	assert(matServ_tick(serv) == 1);
+	assert(expiredCount == 1 && lastExpiredId == 1);
+	assert(matServ_tick(serv) == 0);
+
+	// Updates move the expiration, removals cancel it, undo and redo follow.
+	assert(matServ_updateById(serv, 2, "Flour", "sup2", QUANTITY(1), (Date) { 2022, 6, 18 }, NULL, 1) == 0);
+	assert(matServ_removeById(serv, 0, NULL, 1) == 0);
+	assert(matExpiry_count(serv->expiry) == 1);
+	assert(matServ_undo(serv));
+	assert(matExpiry_count(serv->expiry) == 2);
+
+	expiryToday = (Date) { 2022, 6, 19 };
+	assert(matServ_tick(serv) == 1);
+	assert(lastExpiredId == 2);
+
+	assert(matServ_undo(serv));
+	assert(matExpiry_count(serv->expiry) == 2);
+	assert(matServ_redo(serv));
+	assert(matExpiry_count(serv->expiry) == 1);
+
+	expiryToday = (Date) { 2023, 1, 1 };
+	assert(matServ_tick(serv) == 1);
+	assert(lastExpiredId == 0);
+	assert(expiredCount == 3);
+	assert(matExpiry_count(serv->expiry) == 0);
+
+	matServ_destroy(serv);
+	matRepo_destroy(repo);
+}
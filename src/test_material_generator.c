@@ -0,0 +1,101 @@
+#include "MaterialGenerator.h"
+#include "MaterialValidator.h"
+#include <assert.h>
+#include <string.h>
+
+void test_material_generator()
+{
+	// Invalid settings.
+	GeneratorConfig config = matGen_defaultConfig();
+	config.nameCount = 0;
+	assert(matGen_create(&config) == NULL);
+	config = matGen_defaultConfig();
+	config.dateSpan = 0;
+	assert(matGen_create(&config) == NULL);
+	config = matGen_defaultConfig();
+	config.firstDate = (Date) { 2030, 2, 30 };
+	assert(matGen_create(&config) == NULL);
+
+	// Generated materials are valid, in range and deterministic.
+	config = matGen_defaultConfig();
+	config.seed = 7;
+	config.nameCount = 20;
+	config.supplierCount = 3;
+	config.firstDate = (Date) { 2030, 12, 30 };
+	config.dateSpan = 5;
+	config.maxQuantity = QUANTITY(2);
+	MaterialGenerator* gen = matGen_create(&config);
+	MaterialGenerator* same = matGen_create(&config);
+	assert(gen != NULL && same != NULL);
+	assert(matGen_config(gen)->nameCount == 20);
+
+	Material* mat = material_create();
+	Material* other = material_create();
+	DateSerial firstDay = date_serial(config.firstDate);
+	int seenSupplier[3] = { 0 };
+	for (int i = 0; i < 1000; ++i) {
+		matGen_next(gen, mat);
+		matGen_next(same, other);
+		assert(material_id(mat) == -1);
+		material_id_set(mat, i);
+		assert(matValid_validate(mat));
+		assert(material_quantity(mat) > 0 && material_quantity(mat) <= QUANTITY(2));
+		DateSerial day = material_expSerial(mat);
+		assert(day >= firstDay && day < firstDay + 5);
+
+		assert(strcmp(material_name(mat), material_name(other)) == 0);
+		assert(strcmp(material_supplier(mat), material_supplier(other)) == 0);
+		assert(material_quantity(mat) == material_quantity(other));
+		assert(material_expSerial(mat) == material_expSerial(other));
+
+		for (size_t s = 0; s < 3; ++s)
+			if (strcmp(material_supplier(mat), matGen_supplier(same, s)) == 0)
+				++seenSupplier[s];
+	}
+	assert(seenSupplier[0] > 0 && seenSupplier[1] > 0 && seenSupplier[2] > 0);
+	assert(seenSupplier[0] + seenSupplier[1] + seenSupplier[2] == 1000);
+
+	// Rewinding repeats the sequence, another seed gives another one.
+	matGen_rewind(gen);
+	matGen_rewind(same);
+	matGen_next(gen, mat);
+	matGen_next(same, other);
+	assert(strcmp(material_name(mat), material_name(other)) == 0 && material_quantity(mat) == material_quantity(other));
+
+	config.seed = 8;
+	MaterialGenerator* different = matGen_create(&config);
+	int differences = 0;
+	matGen_rewind(gen);
+	for (int i = 0; i < 10; ++i) {
+		matGen_next(gen, mat);
+		matGen_next(different, other);
+		differences += material_quantity(mat) != material_quantity(other);
+	}
+	assert(differences > 0);
+
+	// Names are distinct for distinct indexes.
+	char name[MAT_GEN_STRING];
+	strcpy(name, matGen_name(gen, 3));
+	assert(strcmp(name, matGen_name(gen, 3 + 16)) != 0);
+	assert(strcmp(name, matGen_name(gen, 4)) != 0);
+
+	// Early dates are more likely than late ones.
+	config.dates = GEN_DATES_EARLY;
+	config.dateSpan = 100;
+	MaterialGenerator* early = matGen_create(&config);
+	firstDay = date_serial(config.firstDate);
+	int firstHalf = 0;
+	for (int i = 0; i < 1000; ++i) {
+		matGen_next(early, mat);
+		firstHalf += material_expSerial(mat) < firstDay + 50;
+	}
+	assert(firstHalf > 650);
+
+	material_destroy(mat);
+	material_destroy(other);
+	matGen_destroy(gen);
+	matGen_destroy(same);
+	matGen_destroy(different);
+	matGen_destroy(early);
+	matGen_destroy(NULL);
+}
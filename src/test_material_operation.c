@@ -6,7 +6,7 @@ void test_material_operation()
 	MaterialOperation* op = matOp_create();
 	assert(op != NULL);
 	assert(op->type == NONE);
-	assert(op->mat == NULL);
+	assert(material_id(&op->mat) == 0 && material_name(&op->mat) == NULL);
 	assert(matOp_type(op) == NONE);
 	assert(matOp_material(op) == NULL);
 	matOp_destroy(op);
@@ -20,7 +20,7 @@ void test_material_operation()
 	material_id_set(mat, 10);
 	assert(op = matOp_construct(ADD, mat));
 	assert(op->type == ADD);
-	assert(op->mat != mat);
+	assert(&op->mat != mat);
 	assert(matOp_type(op) == ADD);
 	assert(matOp_material(op) != mat);
 	material_destroy(mat);
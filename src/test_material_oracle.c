@@ -0,0 +1,63 @@
+#include "MaterialOracle.h"
+#include <assert.h>
+#include <string.h>
+
+// A broken candidate: the low stock threshold of the supplier checked by the oracle is higher than in the reference.
+static void test_material_oracle_raiseThreshold(void* context, MaterialService* serv)
+{
+	(void)context;
+	matServ_setLowStockThreshold(serv, matOracle_supplier(ORACLE_LOW_STOCK_SUPPLIER), ORACLE_LOW_STOCK_THRESHOLD * 2);
+}
+
+void test_material_oracle()
+{
+	assert(strcmp(matOracle_name(0), "Flour") == 0);
+	assert(matOracle_name(-1) == NULL);
+	assert(matOracle_supplier(100) == NULL);
+
+	// The same seed gives the same operations.
+	OracleOp a[200], b[200];
+	assert(matOracle_generate(7, a, 200) && matOracle_generate(7, b, 200));
+	assert(memcmp(a, b, sizeof(a)) == 0);
+	assert(matOracle_generate(8, b, 200));
+	assert(memcmp(a, b, sizeof(a)) != 0);
+
+	// The sharded service with all its indexes and views gives the results of the reference.
+	OracleBackend backend = { MAT_REPO_DEFAULT_SHARDS, NULL, NULL, NULL };
+	assert(matOracle_run(&backend, a, 200, NULL) == 200);
+	assert(matOracle_shrink(&backend, a, 200) == 200);
+	assert(matOracle_check(&backend, 1, 3000, stderr));
+	backend.shardCount = 3;
+	assert(matOracle_check(&backend, 2, 3000, stderr));
+
+	// A difference is found and shrunk to a few writes that put a material in low stock for the candidate only, and the read.
+	OracleBackend broken = { 4, NULL, test_material_oracle_raiseThreshold, NULL };
+	OracleOp ops[500];
+	assert(matOracle_generate(3, ops, 500));
+	size_t failed = matOracle_run(&broken, ops, 500, NULL);
+	assert(failed < 500 && ops[failed].type == ORACLE_LOW_STOCK);
+	assert(!matOracle_check(&broken, 3, 500, NULL));
+
+	size_t length = matOracle_shrink(&broken, ops, 500);
+	assert(length >= 2 && length <= 3);
+	assert(ops[0].type == ORACLE_ADD && ops[length - 1].type == ORACLE_LOW_STOCK);
+	assert(matOracle_run(&broken, ops, length, NULL) == length - 1);
+
+	// No single operation can be removed.
+	for (size_t i = 0; i < length; ++i) {
+		OracleOp fewer[3];
+		memcpy(fewer, ops, i * sizeof(OracleOp));
+		memcpy(fewer + i, ops + i + 1, (length - i - 1) * sizeof(OracleOp));
+		assert(matOracle_run(&broken, fewer, length - 1, NULL) == length - 1);
+	}
+
+	// The description of a failure names the operation.
+	FILE* out = tmpfile();
+	assert(out != NULL);
+	assert(matOracle_run(&broken, ops, length, out) == length - 1);
+	rewind(out);
+	char line[256];
+	assert(fgets(line, sizeof(line), out) != NULL);
+	assert(strncmp(line, "Operation ", 10) == 0 && strstr(line, " (low_stock): ") != NULL);
+	fclose(out);
+}
@@ -0,0 +1,85 @@
+#include "MaterialPipeline.h"
+#include "MaterialValidator.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_PIPELINE_WRITERS 4
+#define TEST_PIPELINE_WRITES 500
+
+typedef struct {
+	MaterialPipeline* pipeline;
+	int writer;
+	int failures;
+} TestPipelineWriter;
+
+// Adds materials of its own, adds one of them again and removes every other one.
+static void test_material_pipeline_write(void* argument)
+{
+	TestPipelineWriter* writer = argument;
+	char name[32];
+	Material* mat = material_create();
+	for (int i = 0; i < TEST_PIPELINE_WRITES; ++i) {
+		sprintf(name, "Flour %d-%d", writer->writer, i);
+		material_id_set(mat, -1);
+		material_name_set(mat, name);
+		material_supplier_set(mat, "sup1");
+		material_quantity_set(mat, QUANTITY(1));
+		material_expDate_set(mat, (Date) { 2030, 1, 1 });
+		writer->failures += matPipe_submit(writer->pipeline, ADD, mat) < 0;
+		if (i == 0)
+			writer->failures += matPipe_submit(writer->pipeline, ADD, mat) < 0;
+		else if (i % 2 == 1)
+			writer->failures += matPipe_submit(writer->pipeline, REMOVE, mat) < 0;
+	}
+	material_destroy(mat);
+}
+
+void test_material_pipeline()
+{
+	MaterialRepository* repo = matRepo_create(matValid_validate);
+	MaterialService* serv = matServ_create(repo);
+	MaterialPipeline* p = matPipe_create(serv);
+	assert(p != NULL);
+
+	// A single write is applied and acknowledged with its result.
+	Material* mat = material_construct(-1, "Milk", "sup2", QUANTITY(2), (Date) { 2030, 1, 1 });
+	assert(matPipe_submit(p, ADD, mat) == 0);
+	assert(matPipe_submit(p, UPDATE, mat) == 0);
+	material_name_set(mat, "Sugar");
+	assert(matPipe_submit(p, REMOVE, mat) == -4);
+	material_quantity_set(mat, QUANTITY(-1));
+	assert(matPipe_submit(p, ADD, mat) == -1);
+
+	// Concurrent writers: nothing is lost and the writes are grouped.
+	TestPipelineWriter writers[TEST_PIPELINE_WRITERS];
+	Thread threads[TEST_PIPELINE_WRITERS];
+	for (int i = 0; i < TEST_PIPELINE_WRITERS; ++i) {
+		writers[i] = (TestPipelineWriter) { p, i, 0 };
+		assert(thread_start(&threads[i], test_material_pipeline_write, &writers[i]));
+	}
+	for (int i = 0; i < TEST_PIPELINE_WRITERS; ++i) {
+		thread_join(&threads[i]);
+		assert(writers[i].failures == 0);
+	}
+
+	size_t writes = 4 + TEST_PIPELINE_WRITERS * (TEST_PIPELINE_WRITES + 1 + TEST_PIPELINE_WRITES / 2);
+	assert(matPipe_writeCount(p) == writes);
+	assert(matPipe_batchCount(p) > 0 && matPipe_batchCount(p) <= writes);
+	matPipe_destroy(p);
+
+	assert(matServ_matCount(serv) == 1 + TEST_PIPELINE_WRITERS * TEST_PIPELINE_WRITES / 2);
+	const Material* twice = matServ_findByNSE(serv, "Flour 0-0", "sup1", (Date) { 2030, 1, 1 });
+	assert(twice && material_quantity(twice) == QUANTITY(2));
+	assert(strcmp(material_name(matServ_findById(serv, 0)), "Milk") == 0);
+
+	// Every write recorded its undo operation.
+	for (size_t i = 0; i < writes - 2; ++i)
+		assert(matServ_undo(serv));
+	assert(!matServ_undo(serv));
+	assert(matServ_matCount(serv) == 0);
+
+	material_destroy(mat);
+	matServ_destroy(serv);
+	matRepo_destroy(repo);
+}
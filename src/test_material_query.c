@@ -0,0 +1,208 @@
+#include "MaterialQuery.h"
+#include "MaterialService.h"
+#include "MaterialValidator.h"
+#include <assert.h>
+#include <string.h>
+
+void test_material_query()
+{
+	MaterialQuery* q = matQuery_create();
+	assert(q != NULL);
+	assert(matQuery_predicateCount(q) == 0);
+	assert(matQuery_predicate(q, 0) == NULL);
+	assert(matQuery_sortKey(q) == SORT_NONE);
+	assert(matQuery_limit(q) == 0);
+	assert(!matQuery_failed(q));
+
+	Material* mat = material_construct(3, "Flour", "sup1", QUANTITY(10), (Date) { 2022, 5, 10 });
+	Material* other = material_construct(4, "Milk", "sup2", QUANTITY(5), (Date) { 2022, 5, 11 });
+	assert(matQuery_matches(q, mat));
+
+	assert(matQuery_whereNameContains(q, "") == q);
+	assert(matQuery_whereNameContains(q, NULL) == q);
+	assert(matQuery_predicateCount(q) == 0);
+
+	matQuery_whereNameContains(matQuery_whereSupplierIs(q, "sup1"), "lou");
+	assert(matQuery_predicateCount(q) == 2);
+	assert(matQuery_predicate(q, 0)->type == SUPPLIER_IS);
+	assert(strcmp(matQuery_predicate(q, 1)->text, "lou") == 0);
+	assert(matQuery_matches(q, mat));
+	assert(!matQuery_matches(q, other));
+
+	matQuery_whereQuantityAtMost(q, QUANTITY(10));
+	matQuery_whereExpiresBefore(q, (Date) { 2022, 5, 11 });
+	assert(matQuery_matches(q, mat));
+	matQuery_whereExpiresFrom(q, (Date) { 2022, 5, 11 });
+	assert(!matQuery_matches(q, mat));
+	matQuery_destroy(q);
+
+	// A date that does not exist compares as the next one that does.
+	q = matQuery_create();
+	matQuery_whereExpiresBefore(q, (Date) { 2022, 4, 31 });
+	assert(matQuery_predicate(q, 0)->serial == date_serial((Date) { 2022, 5, 1 }));
+	assert(!matQuery_matches(q, mat));
+	matQuery_destroy(q);
+
+	q = matQuery_create();
+	matQuery_whereQuantityGreater(q, QUANTITY(9));
+	assert(matQuery_matches(q, mat) && !matQuery_matches(q, other));
+
+	// Order.
+	assert(matQuery_compare(q, mat, other) < 0);
+	assert(matQuery_compare(q, mat, mat) == 0);
+	assert(matQuery_orderBy(q, SORT_QUANTITY, 0) == q);
+	assert(matQuery_compare(q, mat, other) > 0);
+	matQuery_orderBy(q, SORT_QUANTITY, 1);
+	assert(matQuery_descending(q));
+	assert(matQuery_compare(q, mat, other) < 0);
+	matQuery_orderBy(q, SORT_NAME, 0);
+	assert(matQuery_compare(q, mat, other) < 0);
+	matQuery_orderBy(q, SORT_EXP_DATE, 1);
+	assert(matQuery_compare(q, mat, other) > 0);
+	material_quantity_set(other, QUANTITY(10));
+	matQuery_orderBy(q, SORT_QUANTITY, 1);
+	assert(matQuery_compare(q, mat, other) < 0);
+	assert(matQuery_setLimit(q, 3) == q);
+	assert(matQuery_limit(q) == 3);
+	matQuery_destroy(q);
+
+	material_destroy(mat);
+	material_destroy(other);
+
+	// Running queries.
+	MaterialRepository* repo = matRepo_create(matValid_validate);
+	MaterialService* serv = matServ_create(repo);
+	const char* suppliers[] = { "sup1", "sup2", "sup3" };
+	for (int i = 0; i < 60; ++i)
+		matServ_add(serv, -1, i % 2 ? "Flour" : "Milk", suppliers[i % 3], QUANTITY((i * 7) % 13 + 1), (Date) { 2020 + i % 5, 1 + i % 12, 1 }, 0);
+
+	q = matQuery_create();
+	assert(matServ_planQuery(serv, q) == FULL_SCAN);
+	matQuery_whereQuantityAtMost(q, QUANTITY(6));
+	assert(matServ_planQuery(serv, q) == COLUMN_SCAN);
+	matQuery_whereNameContains(q, "lou");
+	matQuery_whereExpiresFrom(q, (Date) { 2022, 1, 1 });
+	matQuery_orderBy(q, SORT_QUANTITY, 1);
+
+	Vector* v = vector_create(0);
+	matServ_query(serv, q, v);
+	size_t expected = 0;
+	for (size_t i = 0; i < matServ_matCount(serv); ++i)
+		expected += matQuery_matches(q, matRepo_getByIndex(repo, i));
+	assert(expected > 0);
+	assert(vector_length(v) == expected);
+	for (size_t i = 0; i < vector_length(v); ++i) {
+		assert(matQuery_matches(q, vector_get(v, i)));
+		if (i > 0)
+			assert(matQuery_compare(q, vector_get(v, i - 1), vector_get(v, i)) < 0);
+	}
+
+	// A limit keeps the first results of the full order.
+	Vector* limited = vector_create(0);
+	matQuery_setLimit(q, 3);
+	matServ_query(serv, q, limited);
+	assert(vector_length(limited) == 3);
+	for (size_t i = 0; i < 3; ++i)
+		assert(vector_get(limited, i) == vector_get(v, i));
+	vector_destroy(limited);
+	vector_destroy(v);
+
+	// Without an order, the scan stops at the limit.
+	matQuery_orderBy(q, SORT_NONE, 0);
+	v = vector_create(0);
+	matServ_query(serv, q, v);
+	assert(vector_length(v) == 3);
+	vector_destroy(v);
+	matQuery_destroy(q);
+
+	q = matQuery_create();
+	matQuery_orderBy(matQuery_whereQuantityAtMost(matQuery_whereSupplierIs(q, "sup2"), QUANTITY(5)), SORT_QUANTITY, 0);
+	assert(matServ_planQuery(serv, q) == SHARD_SCAN);
+	v = vector_create(0);
+	matServ_query(serv, q, v);
+	Vector* report = vector_create(0);
+	matServ_getMaterialsFromSupplierInShortSupply(serv, report, "sup2", QUANTITY(5));
+	assert(vector_length(v) > 0);
+	assert(vector_length(v) == vector_length(report));
+	for (size_t i = 0; i < vector_length(v); ++i) {
+		assert(strcmp(material_supplier(vector_get(v, i)), "sup2") == 0);
+		assert(vector_get(v, i) == vector_get(report, i));
+	}
+	vector_destroy(report);
+	vector_destroy(v);
+	matQuery_destroy(q);
+
+	// Prefix conditions, and prefixes that no material has.
+	q = matQuery_create();
+	matQuery_whereSupplierStartsWith(matQuery_whereNameStartsWith(q, "Fl"), "sup");
+	v = vector_create(0);
+	matServ_query(serv, q, v);
+	assert(vector_length(v) == 30);
+	for (size_t i = 0; i < vector_length(v); ++i)
+		assert(strcmp(material_name(vector_get(v, i)), "Flour") == 0);
+	vector_destroy(v);
+	matQuery_whereNameStartsWith(q, "Flx");
+	v = vector_create(0);
+	matServ_query(serv, q, v);
+	assert(vector_length(v) == 0);
+	vector_destroy(v);
+	matQuery_destroy(q);
+
+	v = vector_create(0);
+	assert(matServ_completeName(serv, "", v, 0) == 2);
+	assert(strcmp(vector_get(v, 0), "Flour") == 0);
+	vector_destroy(v);
+
+	v = vector_create(0);
+	matServ_getMaterialsSortedByQuantity(serv, v);
+	assert(vector_length(v) == 60);
+	for (size_t i = 1; i < vector_length(v); ++i)
+		assert(material_quantity(vector_get(v, i - 1)) <= material_quantity(vector_get(v, i)));
+
+	// Walking the pages gives the same materials as the full sort.
+	size_t seen = 0;
+	const Material* after = NULL;
+	do {
+		Vector* page = vector_create(0);
+		matServ_getMaterialsSortedByQuantityPage(serv, page, after, 7);
+		assert(vector_length(page) <= 7);
+		for (size_t i = 0; i < vector_length(page); ++i)
+			assert(vector_get(page, i) == vector_get(v, seen + i));
+		seen += vector_length(page);
+		after = vector_length(page) == 7 ? vector_get(page, 6) : NULL;
+		vector_destroy(page);
+	} while (after != NULL);
+	assert(seen == 60);
+	vector_destroy(v);
+
+	v = vector_create(0);
+	matServ_getMaterialsFromSupplierInShortSupply(serv, v, "sup1", QUANTITY(8));
+	Vector* page = vector_create(0);
+	matServ_getMaterialsFromSupplierInShortSupplyPage(serv, page, "sup1", QUANTITY(8), NULL, 2);
+	assert(vector_length(page) == 2);
+	assert(vector_get(page, 0) == vector_get(v, 0) && vector_get(page, 1) == vector_get(v, 1));
+	Vector* rest = vector_create(0);
+	matServ_getMaterialsFromSupplierInShortSupplyPage(serv, rest, "sup1", QUANTITY(8), vector_get(page, 1), 0);
+	assert(vector_length(rest) == vector_length(v) - 2);
+	assert(vector_get(rest, 0) == vector_get(v, 2));
+	vector_destroy(rest);
+	vector_destroy(page);
+	vector_destroy(v);
+
+	// A paginated query without an order pages by id.
+	q = matQuery_create();
+	matQuery_setAfter(matQuery_setLimit(q, 5), matServ_findById(serv, 10));
+	assert(material_id(matQuery_after(q)) == 10);
+	v = vector_create(0);
+	matServ_query(serv, q, v);
+	assert(vector_length(v) == 5);
+	for (size_t i = 0; i < 5; ++i)
+		assert(material_id(vector_get(v, i)) == 11 + (int)i);
+	matQuery_setAfter(q, NULL);
+	assert(matQuery_after(q) == NULL);
+	vector_destroy(v);
+	matQuery_destroy(q);
+
+	matServ_destroy(serv);
+	matRepo_destroy(repo);
+}
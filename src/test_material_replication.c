@@ -0,0 +1,310 @@
+#include "MaterialReplication.h"
+#include "MaterialValidator.h"
+#include <assert.h>
+#include <string.h>
+
+// Returns 1 if both services hold the same materials, otherwise 0.
+static int test_material_replication_sameCatalog(MaterialService* a, MaterialService* b)
+{
+	if (matServ_matCount(a) != matServ_matCount(b))
+		return 0;
+
+	MaterialCursor cur = matServ_cursorAll(a);
+	for (const Material* mat; (mat = matCursor_next(&cur)) != NULL;) {
+		const Material* other = matServ_findById(b, material_id(mat));
+		if (other == NULL || strcmp(material_name(mat), material_name(other)) != 0
+			|| strcmp(material_supplier(mat), material_supplier(other)) != 0
+			|| material_quantity(mat) != material_quantity(other) || material_expSerial(mat) != material_expSerial(other))
+			return 0;
+	}
+
+	return 1;
+}
+
+// Applies records until 'count' were applied, waiting for them to arrive. Returns the number applied, or -1 on an error.
+static long long test_material_replication_apply(LogFollower* f, long long count)
+{
+	long long applied = 0;
+	for (int waits = 0; applied < count && waits < 100;) {
+		int status = logFollower_applyNext(f);
+		if (status < 0)
+			return -1;
+		if (status > 0)
+			++applied;
+		else if (logFollower_wait(f, 50000000LL) <= 0)
+			++waits;
+	}
+	return applied;
+}
+
+// Receives the bytes sent on the connection until none arrive for a while, and returns them (to free) and their number.
+static unsigned char* test_material_replication_receive(LocalSocket* connection, size_t* length)
+{
+	size_t capacity = 0x10000;
+	unsigned char* bytes = malloc(capacity);
+	assert(bytes != NULL);
+	*length = 0;
+	while (localSocket_wait(connection, 200000000LL) > 0) {
+		long long received = localSocket_receive(connection, bytes + *length, capacity - *length);
+		if (received <= 0)
+			break;
+		*length += (size_t)received;
+		assert(*length < capacity);
+	}
+	return bytes;
+}
+
+// Returns the offset after the record that starts at the given offset: its type, its length and its bytes.
+static size_t test_material_replication_recordEnd(const unsigned char* bytes, size_t offset)
+{
+	size_t length = 0;
+	size_t i = offset + 1;
+	int shift = 0;
+	do {
+		length |= (size_t)(bytes[i] & 0x7F) << shift;
+		shift += 7;
+	} while (bytes[i++] & 0x80);
+	return i + length;
+}
+
+static FILE* test_material_replication_file(const unsigned char* bytes, size_t length)
+{
+	FILE* file = tmpfile();
+	assert(file != NULL);
+	fwrite(bytes, 1, length, file);
+	fflush(file);
+	rewind(file);
+	return file;
+}
+
+void test_material_replication()
+{
+	MaterialRepository* primaryRepo = matRepo_create(matValid_validate);
+	MaterialService* primary = matServ_create(primaryRepo);
+	matServ_addOrUpdateByNSE(primary, -1, "Flour", "sup1", QUANTITY(10), (Date) { 2022, 5, 10 }, NULL);
+	matServ_addOrUpdateByNSE(primary, -1, "Milk", "sup2", QUANTITY(2.5), (Date) { 2024, 2, 29 }, NULL);
+
+	LogShipper* shipper = logShipper_create(primary);
+	assert(shipper != NULL);
+	assert(logShipper_lsn(shipper) == 0 && logShipper_port(shipper) == 0);
+	assert(logShipper_accept(shipper) == 0);
+	assert(logShipper_listen(shipper, 0));
+	unsigned short port = logShipper_port(shipper);
+	assert(port != 0);
+
+	MaterialRepository* repos[2];
+	MaterialService* servs[2];
+	LogFollower* followers[2];
+	for (int i = 0; i < 2; ++i) {
+		repos[i] = matRepo_create(matValid_validate);
+		servs[i] = matServ_create(repos[i]);
+	}
+
+	// The first follower starts from a snapshot of the two materials, then gets every change, including undo and redo.
+	// A raw connection keeps the bytes of the same log.
+	followers[0] = logFollower_connect(servs[0], port);
+	assert(followers[0] != NULL);
+	assert(logFollower_staleness(followers[0]) == -1);
+	LocalSocket raw;
+	assert(localSocket_connect(&raw, port));
+	assert(logShipper_accept(shipper) == 2);
+	assert(logShipper_followerCount(shipper) == 2 && logShipper_shipped(shipper, 0) == 1);
+
+	assert(matServ_addOrUpdateByNSE(primary, -1, "Sugar", "sup1", QUANTITY(4), (Date) { 2023, 1, 1 }, NULL) >= 0);
+	assert(matServ_addOrUpdateByNSE(primary, -1, "Flour", "sup1", QUANTITY(1.25), (Date) { 2022, 5, 10 }, NULL) == 0);
+	assert(matServ_removeByNSE(primary, "Milk", "sup2", (Date) { 2024, 2, 29 }, NULL) == 1);
+	assert(matServ_undo(primary) == 1);
+	assert(matServ_redo(primary) == 1);
+	assert(logShipper_lsn(shipper) == 5);
+	assert(logShipper_shipped(shipper, 0) == 6 && logShipper_shipped(shipper, 1) == 6);
+
+	// The changes wait in the buffers until the flush.
+	assert(logShipper_pending(shipper, 0) > 0);
+	logShipper_flush(shipper);
+	assert(logShipper_pending(shipper, 0) == 0 && logShipper_pending(shipper, 1) == 0);
+
+	// The second follower catches up from a snapshot taken in the middle of the log.
+	followers[1] = logFollower_connect(servs[1], port);
+	assert(followers[1] != NULL);
+	assert(logShipper_accept(shipper) == 1);
+	assert(matServ_updateById(primary, 0, "Rye flour", "sup3", QUANTITY(7), (Date) { 2025, 12, 31 }, NULL, 1) == 0);
+	logShipper_heartbeat(shipper);
+	assert(logShipper_shipped(shipper, 0) == 8 && logShipper_shipped(shipper, 2) == 3);
+
+	// A follower that closes its connection is dropped.
+	size_t logLength = 0;
+	unsigned char* log = test_material_replication_receive(&raw, &logLength);
+	localSocket_close(&raw);
+	for (int i = 0; i < 100000 && logShipper_followerCount(shipper) == 3; ++i) {
+		thread_yield();
+		logShipper_flush(shipper);
+	}
+	assert(logShipper_followerCount(shipper) == 2);
+	assert(logShipper_shipped(shipper, 1) == 3);
+
+	assert(matServ_removeById(primary, 2, NULL, 1) == 0);
+	logShipper_flush(shipper);
+	assert(logShipper_shipped(shipper, 0) == 9 && logShipper_shipped(shipper, 1) == 4);
+
+	// A tick right after a change only flushes it, without a heartbeat.
+	logShipper_tick(shipper);
+	assert(logShipper_shipped(shipper, 1) == 4);
+	assert(logShipper_lsn(shipper) == 7);
+
+	for (int i = 0; i < 2; ++i) {
+		LogFollower* f = followers[i];
+
+		// A snapshot, then the changes.
+		assert(test_material_replication_apply(f, 1) == 1);
+		assert(logFollower_snapshots(f) == 1);
+		assert(logFollower_appliedLsn(f) == (i == 0 ? 0 : 5));
+		assert(matServ_matCount(servs[i]) == 2);
+
+		assert(test_material_replication_apply(f, i == 0 ? 8 : 3) == (i == 0 ? 8 : 3));
+		assert(logFollower_applyNext(f) == 0);
+		assert(logFollower_appliedLsn(f) == 7);
+		assert(logFollower_lagRecords(f) == 0);
+		assert(logFollower_records(f) == (i == 0 ? 9 : 4));
+		assert(hist_count(logFollower_lag(f)) == (i == 0 ? 7 : 2));
+		assert(logFollower_lastLag(f) >= 0 && logFollower_staleness(f) >= 0);
+		assert(logFollower_service(f) == servs[i]);
+		assert(!logFollower_closed(f));
+		assert(test_material_replication_sameCatalog(primary, servs[i]));
+
+		// The follower's views and running totals follow the applied changes.
+		assert(matAgg_count(matServ_statsBySupplier(servs[i], "sup3")) == 1);
+	}
+
+	// A material loaded on the primary is shipped as a LOAD record and loaded by the followers.
+	assert(localSocket_connect(&raw, port));
+	assert(logShipper_accept(shipper) == 1);
+	Material* loaded = material_create();
+	material_id_set(loaded, 40);
+	material_name_set(loaded, "Salt");
+	material_supplier_set(loaded, "sup5");
+	material_quantity_set(loaded, QUANTITY(3));
+	material_expDate_set(loaded, (Date) { 2031, 6, 15 });
+	assert(matServ_load(primary, loaded) >= 0);
+	material_destroy(loaded);
+	logShipper_flush(shipper);
+	for (int i = 0; i < 2; ++i) {
+		assert(test_material_replication_apply(followers[i], 1) == 1);
+		assert(logFollower_appliedLsn(followers[i]) == 8);
+		assert(test_material_replication_sameCatalog(primary, servs[i]));
+	}
+
+	size_t loadLength = 0;
+	unsigned char* loadLog = test_material_replication_receive(&raw, &loadLength);
+	localSocket_close(&raw);
+	size_t loadStart = test_material_replication_recordEnd(loadLog, 5);
+	assert(loadStart < loadLength && loadLog[loadStart] == LOG_LOAD);
+	assert(test_material_replication_recordEnd(loadLog, loadStart) == loadLength);
+
+	// A log saved to a file can be followed too. A record that has not fully arrived is read once the rest of it did.
+	MaterialRepository* repo = matRepo_create(matValid_validate);
+	MaterialService* serv = matServ_create(repo);
+	FILE* partial = test_material_replication_file(loadLog, loadLength - 3);
+	LogFollower* f = logFollower_create(serv, partial);
+	assert(logFollower_applyNext(f) == 1);
+	assert(logFollower_applyNext(f) == 0);
+	assert(logFollower_wait(f, 0) == 1 && logFollower_applyNext(f) == 0);
+	long position = ftell(partial);
+	fseek(partial, 0, SEEK_END);
+	fwrite(loadLog + loadLength - 3, 1, 3, partial);
+	fflush(partial);
+	fseek(partial, position, SEEK_SET);
+	assert(logFollower_applyNext(f) == 1);
+	assert(logFollower_appliedLsn(f) == 8);
+	assert(test_material_replication_sameCatalog(primary, serv));
+	assert(logFollower_applyNext(f) == 0);
+	logFollower_destroy(f);
+	matServ_destroy(serv);
+	matRepo_destroy(repo);
+	fclose(partial);
+	free(loadLog);
+
+	// A log that skips a change, or is not a log, is rejected, and the follower stops.
+	size_t snapshotEnd = test_material_replication_recordEnd(log, 5);
+	size_t firstChangeEnd = test_material_replication_recordEnd(log, snapshotEnd);
+	FILE* whole = test_material_replication_file(log, logLength);
+	FILE* broken = tmpfile();
+	assert(broken != NULL);
+	fwrite(log, 1, snapshotEnd, broken);
+	fwrite(log + firstChangeEnd, 1, logLength - firstChangeEnd, broken);
+	rewind(broken);
+	free(log);
+
+	repo = matRepo_create(matValid_validate);
+	serv = matServ_create(repo);
+	f = logFollower_create(serv, whole);
+	assert(logFollower_applyAll(f) == 8);
+	assert(logFollower_appliedLsn(f) == 6);
+	logFollower_destroy(f);
+	matServ_destroy(serv);
+	matRepo_destroy(repo);
+
+	repo = matRepo_create(matValid_validate);
+	serv = matServ_create(repo);
+	f = logFollower_create(serv, broken);
+	assert(logFollower_applyNext(f) == 1);
+	assert(logFollower_applyNext(f) == -1);
+	assert(logFollower_applyNext(f) == -1);
+	assert(logFollower_appliedLsn(f) == 0);
+	logFollower_destroy(f);
+
+	FILE* notLog = tmpfile();
+	assert(notLog != NULL);
+	fputs("not a log", notLog);
+	rewind(notLog);
+	f = logFollower_create(serv, notLog);
+	assert(logFollower_applyAll(f) == -1);
+	logFollower_destroy(f);
+
+	FILE* empty = tmpfile();
+	assert(empty != NULL);
+	f = logFollower_create(serv, empty);
+	assert(logFollower_applyAll(f) == 0);
+	logFollower_destroy(f);
+
+	fclose(empty);
+	fclose(notLog);
+	fclose(broken);
+	fclose(whole);
+	matServ_destroy(serv);
+	matRepo_destroy(repo);
+
+	// A serving shipper takes a follower that connects at any time and keeps it up to date, while the service is changed
+	// under its lock.
+	assert(logShipper_serve(shipper));
+	repo = matRepo_create(matValid_validate);
+	serv = matServ_create(repo);
+	f = logFollower_connect(serv, port);
+	assert(f != NULL);
+	assert(test_material_replication_apply(f, 1) == 1);
+	assert(logFollower_appliedLsn(f) == 8);
+	logShipper_lock(shipper);
+	assert(matServ_addOrUpdateByNSE(primary, -1, "Rice", "sup4", QUANTITY(1), (Date) { 2030, 1, 1 }, NULL) >= 0);
+	logShipper_unlock(shipper);
+	while (logFollower_appliedLsn(f) < 9)
+		assert(test_material_replication_apply(f, 1) == 1);
+
+	// A destroyed shipper stops shipping and closes the connections: the followers see the end of the log.
+	logShipper_destroy(shipper);
+	matServ_addOrUpdateByNSE(primary, -1, "Oats", "sup4", QUANTITY(1), (Date) { 2030, 1, 1 }, NULL);
+	assert(test_material_replication_apply(f, 100) >= 0);
+	assert(logFollower_closed(f) && logFollower_wait(f, 0) == -1);
+	assert(logFollower_appliedLsn(f) == 9);
+	for (int i = 0; i < 2; ++i) {
+		assert(test_material_replication_apply(followers[i], 100) >= 1);
+		assert(logFollower_closed(followers[i]) && logFollower_appliedLsn(followers[i]) == 9);
+		logFollower_destroy(followers[i]);
+		matServ_destroy(servs[i]);
+		matRepo_destroy(repos[i]);
+	}
+
+	logFollower_destroy(f);
+	matServ_destroy(serv);
+	matRepo_destroy(repo);
+	matServ_destroy(primary);
+	matRepo_destroy(primaryRepo);
+}
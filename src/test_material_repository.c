@@ -3,6 +3,44 @@
 #include <assert.h>
 #include <string.h>
 
+// An allocator that fails once the number of allocations in its context runs out.
+static void* test_material_repository_alloc(void* context, size_t size)
+{
+	int* left = context;
+	return *left > 0 && (*left)-- ? malloc(size) : NULL;
+}
+
+static void* test_material_repository_realloc(void* context, void* block, size_t size)
+{
+	int* left = context;
+	return *left > 0 && (*left)-- ? realloc(block, size) : NULL;
+}
+
+static void test_material_repository_free(void* context, void* block)
+{
+	(void)context;
+	free(block);
+}
+
+// Reads the shard of "sup1" under its lock until the writer is done.
+typedef struct {
+	MaterialRepository* repository;
+	volatile long done;
+} ShardReader;
+
+static void test_material_repository_read(void* argument)
+{
+	ShardReader* reader = argument;
+	size_t shard = matRepo_shardOf(reader->repository, "sup1");
+	while (!sync_loadLong(&reader->done)) {
+		matRepo_lockShard(reader->repository, shard);
+		const Vector* materials = matRepo_getShardBySupplier(reader->repository, "sup1");
+		for (size_t i = 0; i < vector_length(materials); ++i)
+			assert(strcmp(material_name(vector_get(materials, i)), "mat1") == 0);
+		matRepo_unlockShard(reader->repository, shard);
+	}
+}
+
 void test_material_repository()
 {
 	MaterialRepository* matRepo = matRepo_create(NULL);
@@ -17,11 +55,11 @@ void test_material_repository()
 	assert(matRepo->validator == matValid_validate);
 
 	Date expDate = { .year = 2022, .month = 12, .day = 1 };
-	Material* mat = material_construct(0, "mat1", "sup1", 1.0f, expDate);
+	Material* mat = material_construct(0, "mat1", "sup1", QUANTITY(1), expDate);
 	assert(matRepo_save(matRepo, mat) == 0);
 	material_destroy(mat);
 
-	mat = material_construct(1, "mat2", "sup2", 2.0f, expDate);
+	mat = material_construct(1, "mat2", "sup2", QUANTITY(2), expDate);
 	assert(matRepo_save(matRepo, mat) == 1);
 
 	assert(matRepo_matCount(matRepo) == 2);
@@ -33,24 +71,29 @@ void test_material_repository()
 	assert(matRepo_matCount(matRepo) == 2);
 	
 	material_id_set(mat, 10);
-	material_quantity_set(mat, -1.0f);
+	material_quantity_set(mat, QUANTITY(-1));
 	assert(matRepo_save(matRepo, mat) == -1);
 
 	assert(matRepo_getFreeid(matRepo) == 2);
 
+	assert(matRepo_quantities(matRepo)[1] == QUANTITY(2));
+	assert(matRepo_expSerials(matRepo)[0] == date_serial((Date) { 2022, 12, 1 }));
+
 	assert(matRepo_deleteById(matRepo, 0) == 0);
 	assert(matRepo_matCount(matRepo) == 1);
+	assert(matRepo_quantities(matRepo)[0] == QUANTITY(2));
 	assert(matRepo_getByIndex(matRepo, 0) == matRepo_getById(matRepo, 1));
-	assert(strcmp(matRepo_getByIndex(matRepo, 0)->name, "mat2") == 0);
+	assert(strcmp(material_name(matRepo_getByIndex(matRepo, 0)), "mat2") == 0);
 
 	material_supplier_set(mat, "sup2.1");
-	material_quantity_set(mat, 100.0f);
+	material_quantity_set(mat, QUANTITY(100));
 	assert(matRepo_updateById(matRepo, mat) == -3);
 	material_id_set(mat, 1);
 	assert(matRepo_updateById(matRepo, mat) == 0);
 	assert(matRepo_matCount(matRepo) == 1);
-	assert(strcmp(matRepo_getById(matRepo, 1)->supplier, "sup2.1") == 0);
-	assert(matRepo_getByIndex(matRepo, 0)->quantity == 100.0f);
+	assert(strcmp(material_supplier(matRepo_getById(matRepo, 1)), "sup2.1") == 0);
+	assert(matRepo_getByIndex(matRepo, 0)->quantity == QUANTITY(100));
+	assert(matRepo_quantities(matRepo)[0] == QUANTITY(100));
 
 	assert(matRepo_deleteById(matRepo, 1) == 0);
 	assert(matRepo_matCount(matRepo) == 0);
@@ -58,4 +101,119 @@ void test_material_repository()
 
 	material_destroy(mat);
 	matRepo_destroy(matRepo);
+
+	// Supplier shards.
+	matRepo = matRepo_createSharded(NULL, 0);
+	assert(matRepo_shardCount(matRepo) == 1);
+	matRepo_destroy(matRepo);
+
+	matRepo = matRepo_createSharded(NULL, 4);
+	assert(matRepo_shardCount(matRepo) == 4);
+	assert(matRepo_shardOf(matRepo, "sup1") == matRepo_shardOf(matRepo, "sup1"));
+	assert(matRepo_shardOf(matRepo, "sup1") < 4);
+
+	mat = material_construct(0, "mat1", "sup1", QUANTITY(1), expDate);
+	matRepo_save(matRepo, mat);
+	material_id_set(mat, 1);
+	matRepo_save(matRepo, mat);
+	assert(vector_length(matRepo_getShardBySupplier(matRepo, "sup1")) == 2);
+
+	size_t shardCount = 0;
+	for (size_t i = 0; i < matRepo_shardCount(matRepo); ++i)
+		shardCount += matRepo_shardLength(matRepo, i);
+	assert(shardCount == 2);
+	assert(matRepo_shardLength(matRepo, matRepo_shardCount(matRepo)) == 0);
+
+	material_supplier_set(mat, "sup2");
+	assert(matRepo_updateById(matRepo, mat) == 1);
+	const Vector* shard = matRepo_getShardBySupplier(matRepo, "sup2");
+	int found = 0;
+	for (size_t i = 0; i < vector_length(shard); ++i)
+		found |= vector_get(shard, i) == matRepo_getById(matRepo, 1);
+	assert(found);
+	if (matRepo_shardOf(matRepo, "sup1") != matRepo_shardOf(matRepo, "sup2"))
+		assert(vector_length(matRepo_getShardBySupplier(matRepo, "sup1")) == 1);
+
+	// The prefix tries follow the changes.
+	Vector* completed = vector_create(0);
+	assert(matRepo_completeSupplier(matRepo, "sup", completed, 0) == 2);
+	assert(strcmp(vector_get(completed, 0), "sup1") == 0);
+	assert(strcmp(vector_get(completed, 1), "sup2") == 0);
+	vector_clear(completed);
+	assert(matRepo_completeName(matRepo, "m", completed, 0) == 1);
+	vector_clear(completed);
+
+	assert(matRepo_deleteById(matRepo, 0) == 0);
+	assert(matRepo_deleteById(matRepo, 1) == 0);
+	for (size_t i = 0; i < matRepo_shardCount(matRepo); ++i)
+		assert(matRepo_shardLength(matRepo, i) == 0);
+	assert(matRepo_completeSupplier(matRepo, "", completed, 0) == 0);
+	assert(matRepo_completeName(matRepo, "", completed, 0) == 0);
+	vector_destroy(completed);
+
+	// The id maps of the shards follow the materials moved by the deletions, and the free id follows the biggest id.
+	const char* suppliers[] = { "sup1", "sup2", "sup3", "sup4", "sup5" };
+	for (int id = 0; id < 50; ++id) {
+		material_id_set(mat, id);
+		material_supplier_set(mat, suppliers[id % 5]);
+		assert(matRepo_save(matRepo, mat) == (size_t)id);
+	}
+	assert(matRepo_save(matRepo, mat) == (size_t)-2);
+	assert(matRepo_getFreeid(matRepo) == 50);
+
+	for (int id = 0; id < 50; id += 3)
+		assert(matRepo_deleteById(matRepo, id) != (size_t)-3);
+	assert(matRepo_deleteById(matRepo, 49) != (size_t)-3);
+	assert(matRepo_getFreeid(matRepo) == 48);
+	for (int id = 0; id < 50; ++id) {
+		const Material* saved = matRepo_getById(matRepo, id);
+		assert((saved == NULL) == (id % 3 == 0 || id == 49));
+		if (saved)
+			assert(strcmp(material_supplier(saved), suppliers[id % 5]) == 0);
+	}
+	for (size_t i = 0; i < matRepo_matCount(matRepo); ++i) {
+		const Material* saved = matRepo_getByIndex(matRepo, i);
+		assert(matRepo_getById(matRepo, material_id(saved)) == saved);
+		material_id_set(mat, material_id(saved));
+		assert(matRepo_updateById(matRepo, mat) == i);
+		assert(matRepo_getById(matRepo, material_id(saved)) == saved);
+	}
+	while (matRepo_matCount(matRepo) > 0)
+		matRepo_deleteById(matRepo, material_id(matRepo_getByIndex(matRepo, 0)));
+	assert(matRepo_getFreeid(matRepo) == 0);
+	material_id_set(mat, 1);
+	material_supplier_set(mat, "sup2");
+
+	// A material whose copy cannot be allocated is not saved, and the repository is left as it was.
+	int allocationsLeft = 1000;
+	Allocator failing = { test_material_repository_alloc, test_material_repository_realloc, test_material_repository_free, &allocationsLeft };
+	MaterialRepository* failRepo = matRepo_createWith(NULL, 1, &failing);
+	assert(failRepo != NULL);
+	allocationsLeft = 0;
+	assert(matRepo_save(failRepo, mat) == (size_t)-1);
+	assert(matRepo_matCount(failRepo) == 0 && matRepo_shardLength(failRepo, 0) == 0);
+	allocationsLeft = 1000;
+	assert(matRepo_save(failRepo, mat) == 0);
+	assert(matRepo_matCount(failRepo) == 1 && matRepo_shardLength(failRepo, 0) == 1);
+	assert(material_quantity(matRepo_getById(failRepo, 1)) == material_quantity(mat));
+	matRepo_destroy(failRepo);
+
+	// A thread holding the lock of a shard reads it while the repository is changed.
+	ShardReader reader = { matRepo, 0 };
+	Thread readerThread;
+	assert(thread_start(&readerThread, test_material_repository_read, &reader));
+	for (int id = 0; id < 200; ++id) {
+		material_id_set(mat, id);
+		material_supplier_set(mat, id % 2 ? "sup1" : "sup2");
+		matRepo_save(matRepo, mat);
+		material_supplier_set(mat, id % 2 ? "sup2" : "sup1");
+		matRepo_updateById(matRepo, mat);
+		if (id % 3 == 0)
+			matRepo_deleteById(matRepo, id / 2);
+	}
+	sync_storeLong(&reader.done, 1);
+	thread_join(&readerThread);
+
+	material_destroy(mat);
+	matRepo_destroy(matRepo);
 }
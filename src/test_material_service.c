@@ -1,32 +1,66 @@
 #include "MaterialService.h"
 #include "MaterialValidator.h"
 #include <assert.h>
+#include <limits.h>
 #include <string.h>
 
+static Date serviceToday = { 2026, 6, 15 };
+
+static Date test_serviceClock()
+{
+	return serviceToday;
+}
+
+// Records the id of a removed material and whether the service still found it when the removal was reported.
+typedef struct {
+	MaterialService* service;
+	int removedId;
+	int stillStored;
+} RemovalObserver;
+
+static void test_serviceOnRemove(void* context, const Material* oldMat, const Material* newMat)
+{
+	RemovalObserver* observer = context;
+	if (newMat == NULL) {
+		observer->removedId = material_id(oldMat);
+		observer->stillStored = matServ_findById(observer->service, material_id(oldMat)) != NULL;
+	}
+}
+
 void test_material_service()
 {
 	// CRUD Operations.
 	MaterialRepository* repo = matRepo_create(matValid_validate);
 	MaterialService* serv = matServ_create(repo);
 
+	// A fixed today, so which materials are past their expiration date does not depend on the day the tests run.
+	matServ_setClock(serv, test_serviceClock);
+
 	assert(matServ_matCount(serv) == 0);
 	assert(matServ_findById(serv, 0) == NULL);
 
-	assert(matServ_add(serv, -1, "name1", "sup1", 10.0f, (Date) { 2030, 1, 1 }, 1) == 0);
+	assert(matServ_add(serv, -1, "name1", "sup1", QUANTITY(10), (Date) { 2030, 1, 1 }, 1) == 0);
 	const Material* mat = matServ_findById(serv, 0);
 	assert(mat != NULL);
 	assert(mat == matServ_findById(serv, 0));
 	assert(material_id(mat) == 0);
 	assert(strcmp(material_name(mat), "name1") == 0);
-	assert(material_quantity(mat) == 10.0f);
+	assert(material_quantity(mat) == QUANTITY(10));
 
-	assert(matServ_add(serv, -1, "name2", "sup1", -1.0f, (Date) { 2030, 1, 1 }, 1) == -1);
+	assert(matServ_add(serv, -1, "name2", "sup1", QUANTITY(-1), (Date) { 2030, 1, 1 }, 1) == -1);
 	assert(matServ_matCount(serv) == 1);
-	assert(material_quantity(matServ_findById(serv, 0)) == 10.0f);
+	assert(material_quantity(matServ_findById(serv, 0)) == QUANTITY(10));
 
-	assert(matServ_addOrUpdateByNSE(serv, -1, "name1", "sup1", 2.0f, (Date) { 2030, 1, 1 }, NULL) == 0);
+	assert(matServ_addOrUpdateByNSE(serv, -1, "name1", "sup1", QUANTITY(2), (Date) { 2030, 1, 1 }, NULL) == 0);
 	assert(matServ_matCount(serv) == 1);
-	assert(material_quantity(matServ_findById(serv, 0)) == 10.0f + 2.0f);
+	assert(material_quantity(matServ_findById(serv, 0)) == QUANTITY(10) + QUANTITY(2));
+
+	// Quantities add up exactly, and a quantity too big to be valid does not overflow the sum.
+	for (int i = 0; i < 10; ++i)
+		assert(matServ_addOrUpdateByNSE(serv, -1, "name1", "sup1", QUANTITY(0.1), (Date) { 2030, 1, 1 }, NULL) == 0);
+	assert(material_quantity(matServ_findById(serv, 0)) == QUANTITY(13));
+	assert(matServ_addOrUpdateByNSE(serv, -1, "name1", "sup1", LLONG_MAX, (Date) { 2030, 1, 1 }, NULL) == -1);
+	assert(material_quantity(matServ_findById(serv, 0)) == QUANTITY(13));
 
 	assert(matServ_removeById(serv, 1, NULL, 1) == -3);
 	assert(matServ_removeById(serv, 0, NULL, 1) == 0);
@@ -34,15 +68,121 @@ void test_material_service()
 	assert(matServ_findById(serv, 0) == NULL);
 	assert(matServ_findById(serv, 0) == NULL);
 
-	assert(matServ_updateById(serv, 0, "name1.1", "sup1.1", 10.0f, (Date) { 2025, 10, 10 }, NULL, 1) == -3);
+	assert(matServ_updateById(serv, 0, "name1.1", "sup1.1", QUANTITY(10), (Date) { 2025, 10, 10 }, NULL, 1) == -3);
 
-	assert(matServ_add(serv, -1, "name1.2", "sup1.2", 110.0f, (Date) { 2022, 12, 12 }, 1) == 0);
-	assert(matServ_updateById(serv, 0, "name1.3", "sup1.3", -10.0f, (Date) { 2023, 11, 11 }, NULL, 1) == -1);
+	assert(matServ_add(serv, -1, "name1.2", "sup1.2", QUANTITY(110), (Date) { 2022, 12, 12 }, 1) == 0);
+	assert(matServ_updateById(serv, 0, "name1.3", "sup1.3", QUANTITY(-10), (Date) { 2023, 11, 11 }, NULL, 1) == -1);
 	assert(strcmp(material_name(matServ_findById(serv, 0)), "name1.2") == 0);
 
-	assert(matServ_updateById(serv, 0, "name1.3", "sup1.3", 10.0f, (Date) { 2023, 11, 11 }, NULL, 1) == 0);
+	assert(matServ_updateById(serv, 0, "name1.3", "sup1.3", QUANTITY(10), (Date) { 2023, 11, 11 }, NULL, 1) == 0);
 	assert(strcmp(material_name(matServ_findById(serv, 0)), "name1.3") == 0);
-	assert(material_quantity(matServ_findById(serv, 0)) == 10.0f);
+	assert(material_quantity(matServ_findById(serv, 0)) == QUANTITY(10));
+
+	// Queries.
+	assert(matServ_add(serv, -1, "name2", "sup2", QUANTITY(5), (Date) { 2030, 11, 11 }, 1) == 1);
+	assert(matServ_add(serv, -1, "name3", "sup2", QUANTITY(3), (Date) { 2030, 11, 11 }, 1) == 2);
+	assert(matServ_add(serv, -1, "name4", "sup2", QUANTITY(30), (Date) { 2030, 11, 11 }, 1) == 3);
+	assert(matServ_add(serv, -1, "name5", "sup3", QUANTITY(1), (Date) { 2030, 11, 11 }, 1) == 4);
+	assert(matServ_findByNSE(serv, "name3", "sup2", (Date) { 2030, 11, 11 }) == matServ_findById(serv, 2));
+	assert(matServ_findByNSE(serv, "name3", "sup3", (Date) { 2030, 11, 11 }) == NULL);
+
+	Vector* v = vector_create(0);
+	matServ_getMaterialsFromSupplierInShortSupply(serv, v, "sup2", QUANTITY(5));
+	assert(vector_length(v) == 2);
+	assert(material_id(vector_get(v, 0)) == 2);
+	assert(material_id(vector_get(v, 1)) == 1);
+	vector_destroy(v);
+
+	assert(matServ_add(serv, -1, "name6", "sup3", QUANTITY(2), (Date) { 2001, 1, 1 }, 1) == 5);
+	assert(matServ_add(serv, -1, "other", "sup3", QUANTITY(20), (Date) { 2001, 1, 2 }, 1) == 6);
+
+	v = vector_create(0);
+	matServ_get_materials_past_exp(serv, v, "name");
+	assert(vector_length(v) == 2);
+	assert(material_id(vector_get(v, 0)) + material_id(vector_get(v, 1)) == 0 + 5);
+	vector_destroy(v);
+
+	v = vector_create(0);
+	matServ_get_materials_past_exp(serv, v, "");
+	assert(vector_length(v) == 3);
+	vector_destroy(v);
+
+	// Fuzzy search by name or supplier, closest first.
+	v = vector_create(0);
+	matServ_fuzzySearch(serv, "Othre", 2, v);
+	assert(vector_length(v) == 1 && material_id(vector_get(v, 0)) == 6);
+	vector_destroy(v);
+	v = vector_create(0);
+	matServ_fuzzySearch(serv, "nme6", 1, v);
+	assert(vector_length(v) == 1 && material_id(vector_get(v, 0)) == 5);
+	vector_destroy(v);
+	v = vector_create(0);
+	matServ_fuzzySearch(serv, "name6", 1, v);
+	assert(vector_length(v) > 1 && material_id(vector_get(v, 0)) == 5);
+	vector_destroy(v);
+
+	Bitmap* expired = bitmap_create(0);
+	Bitmap* shortSupply = bitmap_create(0);
+	matServ_selectExpired(serv, expired);
+	matServ_selectQuantityAtMost(serv, QUANTITY(5), shortSupply);
+	assert(bitmap_length(expired) == matServ_matCount(serv));
+	assert(bitmap_count(expired) == 3);
+	assert(bitmap_count(shortSupply) == 4);
+	bitmap_and(expired, shortSupply);
+	assert(bitmap_count(expired) == 1);
+	assert(material_id(matRepo_getByIndex(repo, bitmap_next(expired, 0))) == 5);
+	bitmap_destroy(shortSupply);
+	bitmap_destroy(expired);
+
+	// Latency tracking.
+	assert(matServ_latency(serv) == NULL);
+	assert(!matServ_writeLatency(serv, stdout));
+	assert(matServ_setLatencyTracking(serv, 1));
+	assert(matServ_latency(serv) != NULL && matRepo_latency(repo) != NULL);
+	assert(matServ_findByNSE(serv, "name6", "Other", (Date) { 2000, 1, 1 }) == NULL);
+	assert(matServ_undo(serv));
+	size_t found = 0;
+	for (size_t i = 0; i < latency_count(matServ_latency(serv)); ++i) {
+		const char* name = latency_name(matServ_latency(serv), i);
+		unsigned long long count = hist_count(latency_histogram(matServ_latency(serv), i));
+		if (strcmp(name, "find_by_nse") == 0 || strcmp(name, "undo") == 0)
+			found += count > 0;
+	}
+	assert(found == 2);
+	assert(matServ_setLatencyTracking(serv, 0));
+	assert(matServ_latency(serv) == NULL && matRepo_latency(repo) == NULL);
+
+	// An undo that cannot be applied any more is dropped: the removed material cannot come back while another one has its
+	// name, supplier and expiration date, which an update by id gave it.
+	assert(matServ_add(serv, 200, "twin", "sup9", QUANTITY(1), (Date) { 2031, 2, 2 }, 1) == 200);
+	assert(matServ_add(serv, 201, "other", "sup9", QUANTITY(1), (Date) { 2031, 2, 2 }, 1) == 201);
+	assert(matServ_updateById(serv, 201, "twin", "sup9", QUANTITY(2), (Date) { 2031, 2, 2 }, NULL, 1) == 0);
+	assert(matServ_removeById(serv, 200, NULL, 1) == 0);
+	assert(matServ_undo(serv) == 0);
+	assert(matServ_findById(serv, 200) == NULL);
+	assert(matServ_redo(serv) == 0);
+	assert(matServ_undo(serv) == 1);
+	assert(strcmp(material_name(matServ_findById(serv, 201)), "other") == 0);
+	assert(matServ_removeById(serv, 201, NULL, 0) == 0);
+
+	// A trusted load stores the material and notifies the observers, but cannot be undone.
+	Material* loadedMat = material_construct(100, "loaded", "sup9", QUANTITY(2), (Date) { 2031, 1, 1 });
+	size_t countBefore = matServ_matCount(serv);
+	assert(matServ_load(serv, loadedMat) == 100);
+	assert(matServ_matCount(serv) == countBefore + 1);
+	assert(matServ_findByNSE(serv, "loaded", "sup9", (Date) { 2031, 1, 1 }) == matServ_findById(serv, 100));
+	assert(matAgg_count(matServ_statsBySupplier(serv, "sup9")) == 1);
+	material_quantity_set(loadedMat, QUANTITY(-1));
+	assert(matServ_load(serv, loadedMat) == -1);
+	material_destroy(loadedMat);
+
+	// A removal is reported once the material is removed, with a copy of it.
+	RemovalObserver removal = { serv, -1, 1 };
+	matServ_addObserver(serv, test_serviceOnRemove, &removal);
+	assert(matServ_removeById(serv, 100, NULL, 1) == 0);
+	assert(removal.removedId == 100 && !removal.stillStored);
+	assert(matServ_removeById(serv, 100, NULL, 1) == -3);
+	matServ_removeObserver(serv, test_serviceOnRemove, &removal);
 
 	matServ_destroy(serv);
 	matRepo_destroy(repo);
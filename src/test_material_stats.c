@@ -0,0 +1,85 @@
+#include "MaterialService.h"
+#include "MaterialValidator.h"
+#include <assert.h>
+#include <limits.h>
+
+void test_material_stats()
+{
+	MaterialRepository* repo = matRepo_create(matValid_validate);
+	Material* mat = material_construct(0, "Flour", "sup1", QUANTITY(4), (Date) { 2022, 6, 10 });
+	matRepo_save(repo, mat);
+	material_destroy(mat);
+
+	// Materials already in the repository are counted.
+	MaterialService* serv = matServ_create(repo);
+	const MaterialAggregate* agg = matServ_statsBySupplier(serv, "sup1");
+	assert(agg != NULL);
+	assert(matAgg_count(agg) == 1);
+	assert(matAgg_totalQuantity(agg) == QUANTITY(4));
+	assert(matServ_statsBySupplier(serv, "sup2") == NULL);
+	assert(matServ_statsByName(serv, "Milk") == NULL);
+
+	assert(matServ_add(serv, -1, "Milk", "sup1", QUANTITY(2), (Date) { 2022, 6, 5 }, 1) == 1);
+	assert(matServ_add(serv, -1, "Flour", "sup2", QUANTITY(8), (Date) { 2022, 6, 1 }, 1) == 2);
+	assert(matServ_add(serv, -1, "Sugar", "sup1", QUANTITY(1), (Date) { 2022, 6, 5 }, 1) == 3);
+
+	agg = matServ_statsBySupplier(serv, "sup1");
+	assert(matAgg_count(agg) == 3);
+	assert(matAgg_totalQuantity(agg) == QUANTITY(7));
+	assert(matAgg_earliestExpiry(agg).day == 5);
+
+	agg = matServ_statsByName(serv, "Flour");
+	assert(matAgg_count(agg) == 2);
+	assert(matAgg_totalQuantity(agg) == QUANTITY(12));
+	assert(matAgg_earliestExpiry(agg).day == 1);
+
+	// Updates move the material between groups.
+	assert(matServ_addOrUpdateByNSE(serv, -1, "Flour", "sup2", QUANTITY(2), (Date) { 2022, 6, 1 }, NULL) == 2);
+	assert(matAgg_totalQuantity(matServ_statsByName(serv, "Flour")) == QUANTITY(14));
+	assert(matServ_updateById(serv, 1, "Milk", "sup2", QUANTITY(2), (Date) { 2022, 6, 5 }, NULL, 1) == 0);
+	agg = matServ_statsBySupplier(serv, "sup1");
+	assert(matAgg_count(agg) == 2);
+	assert(matAgg_earliestExpiry(agg).day == 5);
+
+	// The earliest date moves when its last material is removed.
+	assert(matServ_removeById(serv, 3, NULL, 1) == 0);
+	agg = matServ_statsBySupplier(serv, "sup1");
+	assert(matAgg_count(agg) == 1);
+	assert(matAgg_earliestExpiry(agg).day == 10);
+	assert(matServ_statsByName(serv, "Sugar") == NULL);
+
+	// Undo and redo keep the totals.
+	assert(matServ_undo(serv));
+	assert(matAgg_earliestExpiry(matServ_statsBySupplier(serv, "sup1")).day == 5);
+	assert(matServ_undo(serv));
+	assert(matServ_undo(serv));
+	assert(matAgg_count(matServ_statsBySupplier(serv, "sup1")) == 3);
+	assert(matAgg_totalQuantity(matServ_statsByName(serv, "Flour")) == QUANTITY(12));
+	assert(matServ_redo(serv));
+	assert(matAgg_totalQuantity(matServ_statsByName(serv, "Flour")) == QUANTITY(14));
+
+	assert(matServ_removeById(serv, 0, NULL, 1) == 0);
+	assert(matServ_removeById(serv, 3, NULL, 1) == 0);
+	assert(matServ_statsBySupplier(serv, "sup1") != NULL);
+	assert(matServ_removeById(serv, 1, NULL, 1) == 0);
+	assert(matServ_statsBySupplier(serv, "sup1") == NULL);
+
+	matServ_destroy(serv);
+	matRepo_destroy(repo);
+
+	// The total of many materials of the biggest quantity does not overflow, and is exact again once it fits.
+	MaterialStats* stats = matStats_create();
+	Material* big = material_construct(0, "Salt", "mine", QUANTITY_MAX, (Date) { 2030, 1, 1 });
+	const size_t bigCount = 10000;
+	for (size_t i = 0; i < bigCount; ++i)
+		matStats_onChange(stats, NULL, big);
+	agg = matStats_bySupplier(stats, "mine");
+	assert(matAgg_count(agg) == bigCount && matAgg_totalOverflows(agg));
+	assert(matAgg_totalQuantity(agg) == LLONG_MAX);
+	assert(matAgg_totalUnits(agg) > 9.99e15 && matAgg_totalUnits(agg) < 1.01e16);
+	for (size_t i = 1; i < bigCount; ++i)
+		matStats_onChange(stats, big, NULL);
+	assert(!matAgg_totalOverflows(agg) && matAgg_totalQuantity(agg) == QUANTITY_MAX);
+	material_destroy(big);
+	matStats_destroy(stats);
+}
@@ -0,0 +1,168 @@
+#include "MaterialService.h"
+#include "MaterialTrace.h"
+#include "MaterialValidator.h"
+#include <assert.h>
+#include <string.h>
+
+static int test_material_trace_sameDate(Date a, Date b)
+{
+	return a.year == b.year && a.month == b.month && a.day == b.day;
+}
+
+void test_material_trace()
+{
+	assert(strcmp(trace_callName(TRACE_ADD_OR_UPDATE), "add_or_update") == 0);
+	assert(strcmp(trace_callName(TRACE_STATS_BY_NAME), "stats_by_name") == 0);
+	assert(trace_callName(0) == NULL);
+	assert(trace_callName(TRACE_CALL_COUNT) == NULL);
+
+	// Write a record of every kind and read them back.
+	FILE* file = tmpfile();
+	assert(file != NULL);
+	TraceWriter* w = traceWriter_create(file);
+	assert(w != NULL);
+
+	Material* after = material_construct(7, "after", "sup after", QUANTITY(2.5), (Date) { 2024, 2, 29 });
+	MaterialQuery* q = matQuery_create();
+	matQuery_whereNameContains(matQuery_whereSupplierIs(q, "sup1"), "our");
+	matQuery_whereQuantityAtMost(matQuery_whereExpiresBefore(q, (Date) { -5, 12, 31 }), QUANTITY(12.75));
+	matQuery_setAfter(matQuery_setLimit(matQuery_orderBy(q, SORT_EXP_DATE, 1), 300), after);
+
+	assert(traceWriter_write(w, &(TraceRecord) { .call = TRACE_ADD_OR_UPDATE, .id = -1, .name = "Flour", .supplier = "", .quantity = QUANTITY(1.5), .date = { 2030, 1, 2 } }));
+	assert(traceWriter_write(w, &(TraceRecord) { .call = TRACE_REMOVE, .name = "Milk", .supplier = "Cow inc", .date = { 1999, 12, 31 } }));
+	assert(traceWriter_write(w, &(TraceRecord) { .call = TRACE_UNDO }));
+	assert(traceWriter_write(w, &(TraceRecord) { .call = TRACE_PAST_EXP, .text = NULL }));
+	assert(traceWriter_write(w, &(TraceRecord) { .call = TRACE_QUERY, .query = q }));
+	assert(traceWriter_write(w, &(TraceRecord) { .call = TRACE_FUZZY_SEARCH, .text = "Fluor", .count = 2 }));
+	assert(!traceWriter_write(w, &(TraceRecord) { .call = TRACE_CURSOR_QUERY }));
+	assert(!traceWriter_write(w, &(TraceRecord) { .call = TRACE_CALL_COUNT }));
+	assert(traceWriter_count(w) == 6);
+	assert(!traceWriter_failed(w));
+	traceWriter_destroy(w);
+	matQuery_destroy(q);
+	material_destroy(after);
+
+	rewind(file);
+	TraceReader* r = traceReader_create(file);
+	assert(r != NULL);
+	TraceRecord rec;
+
+	assert(traceReader_next(r, &rec) == 1);
+	assert(rec.call == TRACE_ADD_OR_UPDATE && rec.id == -1 && rec.quantity == QUANTITY(1.5));
+	assert(strcmp(rec.name, "Flour") == 0 && strcmp(rec.supplier, "") == 0);
+	assert(test_material_trace_sameDate(rec.date, (Date) { 2030, 1, 2 }));
+
+	assert(traceReader_next(r, &rec) == 1);
+	assert(rec.call == TRACE_REMOVE && strcmp(rec.name, "Milk") == 0 && strcmp(rec.supplier, "Cow inc") == 0);
+	assert(test_material_trace_sameDate(rec.date, (Date) { 1999, 12, 31 }));
+
+	assert(traceReader_next(r, &rec) == 1);
+	assert(rec.call == TRACE_UNDO);
+	assert(traceReader_next(r, &rec) == 1);
+	assert(rec.call == TRACE_PAST_EXP && rec.text == NULL);
+
+	assert(traceReader_next(r, &rec) == 1);
+	assert(rec.call == TRACE_QUERY && matQuery_predicateCount(rec.query) == 4);
+	assert(matQuery_predicate(rec.query, 0)->type == SUPPLIER_IS && strcmp(matQuery_predicate(rec.query, 0)->text, "sup1") == 0);
+	assert(matQuery_predicate(rec.query, 1)->type == NAME_CONTAINS && strcmp(matQuery_predicate(rec.query, 1)->text, "our") == 0);
+	assert(matQuery_predicate(rec.query, 2)->type == EXPIRES_BEFORE);
+	assert(test_material_trace_sameDate(matQuery_predicate(rec.query, 2)->date, (Date) { -5, 12, 31 }));
+	assert(matQuery_predicate(rec.query, 3)->type == QUANTITY_AT_MOST && matQuery_predicate(rec.query, 3)->quantity == QUANTITY(12.75));
+	assert(matQuery_sortKey(rec.query) == SORT_EXP_DATE && matQuery_descending(rec.query) && matQuery_limit(rec.query) == 300);
+	assert(material_id(matQuery_after(rec.query)) == 7 && strcmp(material_supplier(matQuery_after(rec.query)), "sup after") == 0);
+
+	assert(traceReader_next(r, &rec) == 1);
+	assert(rec.call == TRACE_FUZZY_SEARCH && strcmp(rec.text, "Fluor") == 0 && rec.count == 2);
+	assert(traceReader_next(r, &rec) == 0);
+	assert(traceReader_count(r) == 6);
+	traceReader_destroy(r);
+
+	// A trace cut in the middle of a record, or with an unknown call, is corrupt.
+	rewind(file);
+	unsigned char bytes[64];
+	size_t length = fread(bytes, 1, sizeof(bytes), file);
+	assert(length > 12);
+	fclose(file);
+
+	file = tmpfile();
+	fwrite(bytes, 1, 12, file);
+	rewind(file);
+	r = traceReader_create(file);
+	assert(r != NULL);
+	assert(traceReader_next(r, &rec) == -1);
+	traceReader_destroy(r);
+	fclose(file);
+
+	file = tmpfile();
+	fwrite(bytes, 1, 5, file);
+	fputc(TRACE_CALL_COUNT, file);
+	rewind(file);
+	r = traceReader_create(file);
+	assert(traceReader_next(r, &rec) == -1);
+	traceReader_destroy(r);
+	fclose(file);
+
+	file = tmpfile();
+	fputs("not a trace", file);
+	rewind(file);
+	assert(traceReader_create(file) == NULL);
+	fclose(file);
+
+	// Record a session of the service and replay it on a fresh one.
+	file = tmpfile();
+	w = traceWriter_create(file);
+	MaterialRepository* repo = matRepo_create(matValid_validate);
+	MaterialService* serv = matServ_create(repo);
+	Vector* v = vector_create(0);
+	matServ_setTrace(serv, w);
+
+	assert(matServ_addOrUpdateByNSE(serv, -1, "name1", "sup1", QUANTITY(10), (Date) { 2030, 1, 1 }, NULL) == 0);
+	assert(matServ_addOrUpdateByNSE(serv, -1, "name1", "sup1", QUANTITY(5), (Date) { 2030, 1, 1 }, NULL) == 0);
+	assert(matServ_addOrUpdateByNSE(serv, 5, "name2", "sup2", QUANTITY(1), (Date) { 2000, 1, 1 }, NULL) == 5);
+	assert(matServ_updateByNSE(serv, "name2", "sup2", QUANTITY(3), (Date) { 2000, 1, 1 }, NULL) == 5);
+	assert(matServ_removeByNSE(serv, "name1", "sup1", (Date) { 2030, 1, 1 }, NULL) == 0);
+	assert(matServ_undo(serv) && matServ_undo(serv) && matServ_redo(serv));
+	matServ_getAll(serv, v);
+	vector_clear(v);
+	matServ_get_materials_past_exp(serv, v, "name");
+	vector_clear(v);
+	matServ_getMaterialsSortedByQuantity(serv, v);
+	vector_clear(v);
+	matServ_statsBySupplier(serv, "sup2");
+	matServ_setTrace(serv, NULL);
+	matServ_removeByNSE(serv, "name2", "sup2", (Date) { 2000, 1, 1 }, NULL);
+
+	// The update made by 'matServ_addOrUpdateByNSE' and the cursor used by 'matServ_get_materials_past_exp' are not recorded.
+	assert(traceWriter_count(w) == 12);
+	traceWriter_destroy(w);
+	matServ_destroy(serv);
+	matRepo_destroy(repo);
+
+	repo = matRepo_create(matValid_validate);
+	serv = matServ_create(repo);
+	rewind(file);
+	r = traceReader_create(file);
+	int results[12];
+	for (size_t i = 0; i < 12; ++i) {
+		assert(traceReader_next(r, &rec) == 1);
+		vector_clear(v);
+		results[i] = matServ_replay(serv, &rec, v);
+	}
+	assert(traceReader_next(r, &rec) == 0);
+	traceReader_destroy(r);
+	fclose(file);
+
+	assert(results[0] == 0 && results[1] == 0 && results[2] == 5 && results[3] == 5 && results[4] == 0);
+	assert(results[5] == 1 && results[6] == 1 && results[7] == 1);
+	assert(results[8] == 2 && results[9] == 1 && results[10] == 2 && results[11] == 1);
+	assert(rec.call == TRACE_STATS_BY_SUPPLIER);
+
+	assert(matServ_matCount(serv) == 2);
+	assert(material_quantity(matServ_findById(serv, 0)) == QUANTITY(15));
+	assert(material_quantity(matServ_findById(serv, 5)) == QUANTITY(3));
+	assert(matServ_replay(serv, &(TraceRecord) { 0 }, v) == -1);
+
+	vector_destroy(v);
+	matServ_destroy(serv);
+	matRepo_destroy(repo);
+}
@@ -1,5 +1,6 @@
 #include "MaterialValidator.h"
 #include <assert.h>
+#include <string.h>
 
 void test_material_validator()
 {
@@ -10,21 +11,66 @@ void test_material_validator()
 	material_name_set(mat, "matty");
 	material_supplier_set(mat, "suppi");
 	material_expDate_set(mat, expDate);
-	material_quantity_set(mat, 1.0f);
+	material_quantity_set(mat, QUANTITY(1));
 	assert(matValid_validate(mat));
 
 	material_id_set(mat, -1);
 	assert(!matValid_validate(mat));
 
 	material_id_set(mat, 10);
-	material_quantity_set(mat, -1.0f);
+	material_quantity_set(mat, QUANTITY(-1));
 	assert(!matValid_validate(mat));
 
-	material_quantity_set(mat, 10.0f);
+	material_quantity_set(mat, QUANTITY_MAX + 1);
+	assert(!matValid_validate(mat));
+	material_quantity_set(mat, QUANTITY_MAX);
+	assert(matValid_validate(mat));
+
+	// Dates that do not exist.
+	material_expDate_set(mat, (Date) { 2023, 2, 31 });
+	assert(!matValid_validate(mat));
+	material_expDate_set(mat, (Date) { 2023, 2, 29 });
+	assert(!matValid_validate(mat));
+	material_expDate_set(mat, (Date) { 2024, 2, 29 });
+	assert(matValid_validate(mat));
+	material_expDate_set(mat, (Date) { 10000, 1, 1 });
+	assert(!matValid_validate(mat));
+	material_expDate_set(mat, expDate);
+
+	material_quantity_set(mat, QUANTITY(10));
 	material_supplier_set(mat, "Bn 1");
 	assert(matValid_validate(mat));
 
 	assert(!matValid_validate(NULL));
 
+	// Long strings are checked in blocks, including the invalid characters at the end.
+	material_name_set(mat, "Whole wheat flour, type 650 (25kg bag)");
+	assert(matValid_validate(mat));
+	material_name_set(mat, "Whole wheat flour, type 650\t(25kg bag)");
+	assert(!matValid_validate(mat));
+	material_name_set(mat, "Whole wheat flour, type 650 (25kg bag)\x80");
+	assert(!matValid_validate(mat));
+
+	char longName[102] = { 0 };
+	memset(longName, 'a', 100);
+	material_name_set(mat, longName);
+	assert(matValid_validate(mat));
+	longName[100] = 'a';
+	material_name_set(mat, longName);
+	assert(!matValid_validate(mat));
+	material_name_set(mat, "matty");
+
+	for (int c = 1; c < 256; ++c)
+		assert(matValid_validChar((char)c) == (strchr("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 `~!@#$%^&*()-_=+[{]}\\|;:'\",<.>/?", c) != NULL));
+
+	// Batch validation.
+	Material* invalidMat = material_create();
+	const Material* mats[] = { mat, invalidMat, NULL, mat };
+	int results[4] = { 0 };
+	assert(matValid_validateAll(mats, 4, results) == 2);
+	assert(results[0] == 1 && results[1] == 0 && results[2] == 0 && results[3] == 1);
+	assert(matValid_validateAll(mats, 2, NULL) == 1);
+	material_destroy(invalidMat);
+
 	material_destroy(mat);
 }
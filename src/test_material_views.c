@@ -0,0 +1,132 @@
+#include "MaterialService.h"
+#include "MaterialValidator.h"
+#include <assert.h>
+#include <string.h>
+
+static Date testToday = { 2022, 6, 15 };
+
+static Date test_clock()
+{
+	return testToday;
+}
+
+// Returns 1 if the vector contains a material with the given id.
+static int test_containsId(const Vector* v, int id)
+{
+	for (size_t i = 0; i < vector_length(v); ++i) {
+		if (material_id(vector_get(v, i)) == id)
+			return 1;
+	}
+
+	return 0;
+}
+
+static size_t test_expiredCount(MaterialService* serv)
+{
+	Vector* v = vector_create(0);
+	matServ_getExpired(serv, v);
+	size_t count = vector_length(v);
+	vector_destroy(v);
+	return count;
+}
+
+static size_t observedChanges = 0;
+
+static void test_observer(void* context, const Material* oldMat, const Material* newMat)
+{
+	assert(context == &observedChanges);
+	assert(oldMat != NULL || newMat != NULL);
+	++observedChanges;
+}
+
+void test_material_views()
+{
+	MaterialRepository* repo = matRepo_create(matValid_validate);
+	MaterialService* serv = matServ_create(repo);
+	matServ_setClock(serv, test_clock);
+	matServ_addObserver(serv, test_observer, &observedChanges);
+
+	assert(matServ_add(serv, -1, "Flour", "sup1", QUANTITY(10), (Date) { 2022, 6, 14 }, 1) == 0);
+	assert(matServ_add(serv, -1, "Milk", "sup1", QUANTITY(2), (Date) { 2022, 6, 15 }, 1) == 1);
+	assert(matServ_add(serv, -1, "Sugar", "sup2", QUANTITY(1), (Date) { 2022, 6, 20 }, 1) == 2);
+	assert(observedChanges == 3);
+
+	// Expired view.
+	Vector* v = vector_create(0);
+	matServ_getExpired(serv, v);
+	assert(vector_length(v) == 1);
+	assert(material_id(vector_get(v, 0)) == 0);
+	vector_destroy(v);
+
+	assert(matServ_add(serv, -1, "Eggs", "sup2", QUANTITY(3), (Date) { 2022, 1, 1 }, 1) == 3);
+	assert(test_expiredCount(serv) == 2);
+	assert(matServ_updateById(serv, 3, "Eggs", "sup2", QUANTITY(3), (Date) { 2023, 1, 1 }, NULL, 1) == 0);
+	assert(test_expiredCount(serv) == 1);
+	assert(matServ_undo(serv));
+	assert(test_expiredCount(serv) == 2);
+	assert(matServ_removeByNSE(serv, "Flour", "sup1", (Date) { 2022, 6, 14 }, NULL) == 0);
+	assert(test_expiredCount(serv) == 1);
+	assert(matServ_undo(serv));
+	assert(test_expiredCount(serv) == 2);
+	assert(matServ_redo(serv));
+	assert(test_expiredCount(serv) == 1);
+	assert(matServ_undo(serv));
+	assert(observedChanges == 10);
+
+	v = vector_create(0);
+	matServ_get_materials_past_exp(serv, v, "lou");
+	assert(vector_length(v) == 1);
+	assert(strcmp(material_name(vector_get(v, 0)), "Flour") == 0);
+	vector_destroy(v);
+
+	// A new day advances the view.
+	testToday = (Date) { 2022, 6, 16 };
+	assert(test_expiredCount(serv) == 3);
+	testToday = (Date) { 2022, 6, 21 };
+	v = vector_create(0);
+	matServ_getExpired(serv, v);
+	assert(vector_length(v) == 4);
+	assert(test_containsId(v, 2));
+	vector_destroy(v);
+	testToday = (Date) { 2022, 6, 15 };
+	assert(test_expiredCount(serv) == 2);
+
+	// Low stock view.
+	v = vector_create(0);
+	matServ_getLowStock(serv, v);
+	assert(vector_length(v) == 0);
+	vector_destroy(v);
+
+	matServ_setLowStockThreshold(serv, "sup1", QUANTITY(5));
+	assert(matViews_lowStockThreshold(serv->views, "sup1") == QUANTITY(5));
+	assert(matViews_lowStockThreshold(serv->views, "sup2") == 0);
+	v = vector_create(0);
+	matServ_getLowStock(serv, v);
+	assert(vector_length(v) == 1);
+	assert(material_id(vector_get(v, 0)) == 1);
+	vector_destroy(v);
+
+	matServ_setLowStockThreshold(serv, "sup2", QUANTITY(2));
+	assert(matServ_addOrUpdateByNSE(serv, -1, "Milk", "sup1", QUANTITY(10), (Date) { 2022, 6, 15 }, NULL) == 1);
+	assert(matServ_updateById(serv, 0, "Flour", "sup2", QUANTITY(1.5), (Date) { 2022, 6, 14 }, NULL, 1) == 0);
+	v = vector_create(0);
+	matServ_getLowStock(serv, v);
+	assert(vector_length(v) == 2);
+	assert(test_containsId(v, 0) && test_containsId(v, 2));
+	vector_destroy(v);
+
+	matServ_setLowStockThreshold(serv, "sup2", 0);
+	assert(matViews_lowStockThreshold(serv->views, "sup2") == 0);
+	v = vector_create(0);
+	matServ_getLowStock(serv, v);
+	assert(vector_length(v) == 0);
+	vector_destroy(v);
+
+	matServ_removeObserver(serv, test_observer, &observedChanges);
+	size_t changes = observedChanges;
+	assert(matServ_undo(serv));
+	assert(observedChanges == changes);
+
+	matServ_destroy(serv);
+	matRepo_destroy(repo);
+}
@@ -0,0 +1,115 @@
+#include "MemoryTracker.h"
+#include "MaterialService.h"
+#include "MaterialValidator.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+void test_memory_tracker()
+{
+	// Default allocator.
+	const Allocator* heap = allocator_default();
+	char* copy = allocator_strdup(heap, "Flour");
+	assert(strcmp(copy, "Flour") == 0);
+	allocator_free(heap, copy);
+	copy = allocator_strdup(NULL, "Milk");
+	assert(strcmp(copy, "Milk") == 0);
+	allocator_free(NULL, copy);
+
+	// Accounts.
+	MemoryTracker* t = memTracker_create(NULL);
+	assert(memTracker_accountCount(t) == 0);
+	const Allocator* first = memTracker_allocator(t, "first");
+	const Allocator* second = memTracker_allocator(t, "second");
+	assert(first != NULL && second != NULL && first != second);
+	assert(memTracker_allocator(t, "first") == first);
+	assert(memTracker_allocator(t, NULL) == NULL);
+	assert(memTracker_accountCount(t) == 2);
+	assert(strcmp(memTracker_stats(t, 1)->name, "second") == 0);
+	assert(memTracker_stats(t, 2) == NULL);
+
+	int* block = allocator_calloc(first, 10, sizeof(int));
+	for (int i = 0; i < 10; ++i)
+		assert(block[i] == 0);
+	const MemoryStats* stats = memTracker_stats(t, 0);
+	assert(stats->bytes == 10 * sizeof(int) && stats->blocks == 1 && stats->allocations == 1);
+
+	block = allocator_realloc(first, block, 100 * sizeof(int));
+	block[99] = 1;
+	assert(stats->bytes == 100 * sizeof(int) && stats->blocks == 1 && stats->reallocations == 1);
+	block = allocator_realloc(first, block, 20 * sizeof(int));
+	assert(stats->bytes == 20 * sizeof(int) && stats->peakBytes == 100 * sizeof(int));
+
+	void* other = allocator_alloc(second, 50);
+	assert(memTracker_stats(t, 1)->bytes == 50);
+	assert(memTracker_total(t)->bytes == 20 * sizeof(int) + 50);
+	assert(memTracker_total(t)->blocks == 2);
+
+	allocator_free(first, block);
+	allocator_free(second, other);
+	allocator_free(second, NULL);
+	assert(stats->bytes == 0 && stats->blocks == 0 && stats->frees == 1);
+	assert(memTracker_total(t)->bytes == 0 && memTracker_total(t)->peakBytes == 100 * sizeof(int));
+	assert(memTracker_total(t)->allocations == 2 && memTracker_total(t)->frees == 2);
+
+	// Containers take all their memory from their allocator, and give all of it back.
+	const Allocator* containers = memTracker_allocator(t, "containers");
+	const MemoryStats* containerStats = memTracker_stats(t, 2);
+	Vector* v = vector_createWith(containers, 0);
+	for (size_t i = 0; i < 100; ++i)
+		vector_add(v, (void*)(i + 1));
+	assert(containerStats->bytes >= sizeof(Vector) + 100 * sizeof(void*));
+	vector_destroy(v);
+
+	IntVector ints;
+	intVec_initWith(&ints, containers);
+	for (int i = 0; i < 100; ++i)
+		intVec_add(&ints, i);
+	assert(containerStats->bytes >= 100 * sizeof(int));
+	intVec_free(&ints);
+
+	StringTrie* trie = trie_createWith(containers);
+	trie_insert(trie, "Flour");
+	trie_insert(trie, "Flowers");
+	trie_remove(trie, "Flour");
+	trie_destroy(trie);
+
+	Material* mat = material_createWith(containers);
+	material_name_set(mat, "A name too long to be stored inside the material");
+	Material* dup = material_duplicateWith(containers, mat);
+	material_destroy(mat);
+	material_destroy(dup);
+	assert(containerStats->bytes == 0 && containerStats->blocks == 0);
+
+	// Repository and service accounts.
+	const Allocator* repoAlloc = memTracker_allocator(t, "repository");
+	const Allocator* servAlloc = memTracker_allocator(t, "service");
+	MaterialRepository* repo = matRepo_createWith(matValid_validate, 4, repoAlloc);
+	MaterialService* serv = matServ_createWith(repo, servAlloc);
+	const MemoryStats* repoStats = memTracker_stats(t, 3);
+	const MemoryStats* servStats = memTracker_stats(t, 4);
+	size_t repoEmpty = repoStats->bytes, servEmpty = servStats->bytes;
+	assert(repoEmpty > 0 && servEmpty > 0);
+
+	char name[32];
+	for (int i = 0; i < 100; ++i) {
+		sprintf(name, "Material %d", i);
+		assert(matServ_add(serv, -1, name, "Supplier", QUANTITY(1 + i), (Date) { 2030, 1, 1 }, 1) == i);
+	}
+	assert(repoStats->bytes >= repoEmpty + 100 * sizeof(Material));
+	assert(servStats->bytes >= servEmpty + 100 * sizeof(Material));
+
+	// Undo gives the material back to the repository; the history stays in the service.
+	size_t repoFull = repoStats->bytes;
+	assert(matServ_undo(serv));
+	assert(repoStats->bytes < repoFull);
+	assert(matServ_redo(serv));
+
+	matServ_destroy(serv);
+	matRepo_destroy(repo);
+	assert(repoStats->bytes == 0 && repoStats->blocks == 0 && repoStats->allocations == repoStats->frees);
+	assert(servStats->bytes == 0 && servStats->blocks == 0 && servStats->allocations == servStats->frees);
+	assert(memTracker_total(t)->bytes == 0 && memTracker_total(t)->failures == 0);
+
+	memTracker_destroy(t);
+}
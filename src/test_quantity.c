@@ -0,0 +1,37 @@
+#include "Quantity.h"
+#include <assert.h>
+
+void test_quantity()
+{
+	assert(QUANTITY(2.5) == 2500);
+	assert(QUANTITY(0.001) == 1);
+	assert(QUANTITY(-1.25) == -1250);
+	assert(QUANTITY(12.1) == 12100);
+	assert(quantity_toUnits(QUANTITY(3.75)) == 3.75);
+
+	Quantity q = 7;
+	assert(quantity_parse("12", &q) && q == 12000);
+	assert(quantity_parse(" 3.125 ", &q) && q == 3125);
+	assert(quantity_parse("-0.5", &q) && q == -500);
+	assert(quantity_parse("+.25", &q) && q == 250);
+	assert(quantity_parse("4.", &q) && q == 4000);
+	assert(quantity_parse("1.500000", &q) && q == 1500);
+	assert(quantity_parse("1000000000000", &q) && q == QUANTITY_MAX);
+
+	// Repeated additions stay exact.
+	Quantity total = 0;
+	for (int i = 0; i < 1000; ++i)
+		total += QUANTITY(0.1);
+	assert(total == QUANTITY(100));
+
+	q = 7;
+	assert(!quantity_parse("", &q));
+	assert(!quantity_parse("-", &q));
+	assert(!quantity_parse(".", &q));
+	assert(!quantity_parse("1.0005", &q));
+	assert(!quantity_parse("1e3", &q));
+	assert(!quantity_parse("12 kg", &q));
+	assert(!quantity_parse("1000000000000.001", &q));
+	assert(!quantity_parse("99999999999999999999999", &q));
+	assert(q == 7);
+}
@@ -0,0 +1,61 @@
+#include "Scan.h"
+#include <assert.h>
+
+void test_scan()
+{
+	long long quantities[100];
+	int dates[100];
+	for (int i = 0; i < 100; ++i) {
+		quantities[i] = (long long)((i * 37) % 23) * 500;
+		dates[i] = 20220101 + (i * 53) % 400;
+	}
+
+	Bitmap* result = bitmap_create(0);
+
+	// Compare with the scalar definition for every length, to cover the vector steps and the tails.
+	for (size_t count = 0; count <= 100; ++count) {
+		scan_longsAtMost(quantities, count, 5000, result);
+		assert(bitmap_length(result) == count);
+		for (size_t i = 0; i < count; ++i)
+			assert(bitmap_get(result, i) == (quantities[i] <= 5000));
+
+		scan_longsGreater(quantities, count, 5000, result);
+		for (size_t i = 0; i < count; ++i)
+			assert(bitmap_get(result, i) == (quantities[i] > 5000));
+
+		scan_intsLess(dates, count, 20220301, result);
+		for (size_t i = 0; i < count; ++i)
+			assert(bitmap_get(result, i) == (dates[i] < 20220301));
+
+		scan_intsAtLeast(dates, count, 20220301, result);
+		for (size_t i = 0; i < count; ++i)
+			assert(bitmap_get(result, i) == (dates[i] >= 20220301));
+	}
+
+	// Combine two predicates.
+	Bitmap* other = bitmap_create(0);
+	scan_longsAtMost(quantities, 100, 5000, result);
+	scan_intsLess(dates, 100, 20220301, other);
+	bitmap_and(result, other);
+
+	size_t expected = 0;
+	for (size_t i = 0; i < 100; ++i)
+		expected += quantities[i] <= 5000 && dates[i] < 20220301;
+	assert(bitmap_count(result) == expected);
+
+	// The 64-bit compares are exact where only the low or only the high halves differ, with any signs.
+	long long edges[16] = { 0, -1, 1, 0xFFFFFFFFLL, 0x80000000LL, 0x7FFFFFFFLL, 0x100000000LL, -0x100000000LL,
+		-0x80000000LL, 0x180000000LL, 0x17FFFFFFFLL, 0x7FFFFFFFFFFFFFFFLL, -0x7FFFFFFFFFFFFFFFLL - 1, 2, -2, 0x100000001LL };
+	for (int t = 0; t < 16; ++t) {
+		scan_longsGreater(edges, 16, edges[t], result);
+		for (size_t i = 0; i < 16; ++i)
+			assert(bitmap_get(result, i) == (edges[i] > edges[t]));
+
+		scan_longsAtMost(edges, 16, edges[t], result);
+		for (size_t i = 0; i < 16; ++i)
+			assert(bitmap_get(result, i) == (edges[i] <= edges[t]));
+	}
+
+	bitmap_destroy(other);
+	bitmap_destroy(result);
+}
@@ -0,0 +1,87 @@
+#include "SpanTracer.h"
+#include <assert.h>
+#include <string.h>
+
+#define TEST_SPAN_THREADS 4
+#define TEST_SPAN_SPANS 100
+
+static void test_span_record(void* argument)
+{
+	SpanTracer* t = argument;
+	for (int i = 0; i < TEST_SPAN_SPANS; ++i) {
+		spanTracer_begin(t, "span");
+		spanTracer_end(t);
+	}
+}
+
+void test_span_tracer()
+{
+	// Nothing is recorded without a tracer.
+	spanTracer_install(NULL);
+	assert(spanTracer_installed() == NULL);
+	spanTracer_begin(NULL, "nothing");
+	spanTracer_end(NULL);
+	SPAN_BEGIN("nothing");
+	SPAN_END();
+
+	// A block of 2 events is handed to the writer every 2 events.
+	FILE* file = tmpfile();
+	assert(file != NULL);
+	SpanTracer* t = spanTracer_create(file, 2);
+	assert(t != NULL);
+	spanTracer_install(t);
+	assert(spanTracer_installed() == t);
+
+	spanTracer_begin(t, "outer");
+	spanTracer_begin(t, "in\"ner");
+	assert(spanTracer_count(t) == 2);
+	spanTracer_end(t);
+	spanTracer_end(t);
+	spanTracer_begin(t, NULL);
+	spanTracer_end(t);
+	assert(spanTracer_count(t) == 6);
+	assert(!spanTracer_failed(t));
+	spanTracer_destroy(t);
+	assert(spanTracer_installed() == NULL);
+
+	rewind(file);
+	char text[1024];
+	size_t length = fread(text, 1, sizeof(text) - 1, file);
+	text[length] = '\0';
+	fclose(file);
+
+	assert(strncmp(text, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [", 42) == 0);
+	const char* outer = strstr(text, "{\"name\": \"outer\", \"ph\": \"B\", \"ts\": ");
+	const char* inner = strstr(text, "{\"name\": \"in\\\"ner\", \"ph\": \"B\"");
+	const char* end = strstr(text, "{\"ph\": \"E\", \"ts\": ");
+	assert(outer != NULL && inner > outer && end > inner);
+	assert(strstr(text, "{\"name\": \"\", \"ph\": \"B\"") != NULL);
+
+	size_t events = 0;
+	for (const char* e = strstr(text, "\"pid\": 1, \"tid\": "); e; e = strstr(e + 1, "\"pid\": 1, \"tid\": "))
+		++events;
+	assert(events == 6);
+	assert(strcmp(text + length - 4, "\n]}\n") == 0);
+
+	// Every thread records to its own blocks, and is a track of its own in the file.
+	file = tmpfile();
+	assert(file != NULL);
+	t = spanTracer_create(file, 3);
+	assert(t != NULL);
+	Thread threads[TEST_SPAN_THREADS];
+	for (int i = 0; i < TEST_SPAN_THREADS; ++i)
+		assert(thread_start(&threads[i], test_span_record, t));
+	for (int i = 0; i < TEST_SPAN_THREADS; ++i)
+		thread_join(&threads[i]);
+	spanTracer_flush(t);
+	assert(spanTracer_count(t) == TEST_SPAN_THREADS * TEST_SPAN_SPANS * 2);
+	spanTracer_destroy(t);
+
+	rewind(file);
+	events = 0;
+	int c;
+	while ((c = getc(file)) != EOF)
+		events += c == '}';
+	fclose(file);
+	assert(events == TEST_SPAN_THREADS * TEST_SPAN_SPANS * 2 + 1);
+}
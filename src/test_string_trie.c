@@ -0,0 +1,90 @@
+#include "StringTrie.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+void test_string_trie()
+{
+	StringTrie* t = trie_create();
+	assert(t != NULL);
+	assert(trie_size(t) == 0);
+	assert(trie_count(t, "a") == 0);
+
+	Vector* v = vector_create(0);
+	assert(trie_complete(t, "", v, 0) == 0);
+
+	const char* flour = trie_insert(t, "flour");
+	assert(flour != NULL && strcmp(flour, "flour") == 0);
+	assert(trie_insert(t, "flour") == flour);
+	assert(trie_insert(t, "flower") != NULL);
+	assert(trie_insert(t, "flow") != NULL);
+	assert(trie_insert(t, "milk") != NULL);
+	assert(trie_insert(t, "") != NULL);
+	assert(trie_size(t) == 5);
+	assert(trie_count(t, "flour") == 2);
+	assert(trie_count(t, "flo") == 0);
+	assert(trie_count(t, "flowers") == 0);
+
+	// Matches come in alphabetical order, and the prefix may end in the middle of an edge.
+	assert(trie_complete(t, "fl", v, 0) == 3);
+	assert(strcmp(vector_get(v, 0), "flour") == 0);
+	assert(strcmp(vector_get(v, 1), "flow") == 0);
+	assert(strcmp(vector_get(v, 2), "flower") == 0);
+	vector_clear(v);
+
+	assert(trie_complete(t, "flowe", v, 0) == 1);
+	assert(vector_get(v, 0) != NULL && strcmp(vector_get(v, 0), "flower") == 0);
+	vector_clear(v);
+
+	assert(trie_complete(t, "", v, 2) == 2);
+	assert(strcmp(vector_get(v, 0), "") == 0);
+	assert(strcmp(vector_get(v, 1), "flour") == 0);
+	vector_clear(v);
+
+	assert(trie_complete(t, "fx", v, 0) == 0);
+	assert(trie_complete(t, "milky", v, 0) == 0);
+
+	// A string stays until it is removed as many times as it was inserted.
+	trie_remove(t, "flour");
+	assert(trie_count(t, "flour") == 1);
+	trie_remove(t, "flour");
+	assert(trie_count(t, "flour") == 0);
+	trie_remove(t, "flour");
+	trie_remove(t, "fl");
+	trie_remove(t, "");
+	assert(trie_size(t) == 3);
+	assert(trie_complete(t, "flo", v, 0) == 2);
+	vector_clear(v);
+
+	trie_remove(t, "flow");
+	assert(trie_count(t, "flower") == 1);
+	assert(trie_complete(t, "flo", v, 0) == 1);
+	vector_clear(v);
+
+	// Many strings sharing prefixes.
+	char str[16];
+	for (size_t i = 0; i < 2000; ++i) {
+		sprintf(str, "item%zu", i);
+		assert(trie_insert(t, str) != NULL);
+	}
+	assert(trie_size(t) == 2002);
+	assert(trie_complete(t, "item1", v, 0) == 1111);
+	vector_clear(v);
+	assert(trie_complete(t, "item1", v, 5) == 5);
+	assert(strcmp(vector_get(v, 0), "item1") == 0);
+	assert(strcmp(vector_get(v, 1), "item10") == 0);
+	vector_clear(v);
+
+	for (size_t i = 0; i < 2000; i += 2) {
+		sprintf(str, "item%zu", i);
+		trie_remove(t, str);
+	}
+	for (size_t i = 0; i < 2000; ++i) {
+		sprintf(str, "item%zu", i);
+		assert(trie_count(t, str) == i % 2);
+	}
+	assert(trie_size(t) == 1002);
+
+	vector_destroy(v);
+	trie_destroy(t);
+}
@@ -0,0 +1,66 @@
+#include "Thread.h"
+#include <assert.h>
+
+#define TEST_THREAD_COUNT 4
+#define TEST_THREAD_ADDS 10000
+
+typedef struct {
+	volatile long counter;
+	long locked;
+	Mutex lock;
+	size_t indexes[TEST_THREAD_COUNT];
+	int started;
+} TestThreadShared;
+
+static void test_thread_add(void* argument)
+{
+	TestThreadShared* shared = argument;
+	size_t index = thread_index();
+	mutex_lock(&shared->lock);
+	shared->indexes[shared->started++] = index;
+	mutex_unlock(&shared->lock);
+
+	for (int i = 0; i < TEST_THREAD_ADDS; ++i) {
+		sync_addLong(&shared->counter, 1);
+		mutex_lock(&shared->lock);
+		++shared->locked;
+		mutex_unlock(&shared->lock);
+	}
+}
+
+void test_thread()
+{
+	// Atomic operations.
+	volatile long number = 5;
+	assert(sync_addLong(&number, 3) == 8);
+	sync_storeLong(&number, -1);
+	assert(sync_loadLong(&number) == -1);
+
+	int a = 1, b = 2;
+	void* volatile pointer = &a;
+	assert(sync_exchangePointer(&pointer, &b) == &a);
+	assert(sync_loadPointer(&pointer) == &b);
+	sync_storePointer(&pointer, NULL);
+	assert(pointer == NULL);
+
+	// Atomic adds and locked adds from many threads are not lost.
+	TestThreadShared shared = { 0 };
+	mutex_init(&shared.lock);
+	Thread threads[TEST_THREAD_COUNT];
+	for (int i = 0; i < TEST_THREAD_COUNT; ++i)
+		assert(thread_start(&threads[i], test_thread_add, &shared));
+	for (int i = 0; i < TEST_THREAD_COUNT; ++i)
+		thread_join(&threads[i]);
+	assert(shared.counter == TEST_THREAD_COUNT * TEST_THREAD_ADDS);
+	assert(shared.locked == TEST_THREAD_COUNT * TEST_THREAD_ADDS);
+
+	// Every thread has its own index, which does not change.
+	size_t index = thread_index();
+	assert(thread_index() == index);
+	for (int i = 0; i < TEST_THREAD_COUNT; ++i) {
+		assert(shared.indexes[i] != index);
+		for (int j = 0; j < i; ++j)
+			assert(shared.indexes[i] != shared.indexes[j]);
+	}
+	mutex_free(&shared.lock);
+}
@@ -0,0 +1,72 @@
+#include "TimingWheel.h"
+#include <assert.h>
+
+typedef struct {
+	long last;
+	size_t fired;
+	TimingWheel* wheel;
+} WheelTestState;
+
+static void test_fire(void* context, void* item)
+{
+	WheelTestState* state = context;
+	long when = (long)(size_t)item;
+
+	// Timers fire in order, exactly on their time.
+	assert(when >= state->last);
+	assert(when == wheel_now(state->wheel));
+	state->last = when;
+	++state->fired;
+}
+
+void test_timing_wheel()
+{
+	TimingWheel* w = wheel_create(1000);
+	assert(w != NULL);
+	assert(wheel_now(w) == 1000);
+	assert(wheel_count(w) == 0);
+
+	WheelTestState state = { 0, 0, w };
+
+	// Nothing scheduled: the wheel jumps forward.
+	assert(wheel_advance(w, 5000, test_fire, &state) == 0);
+	assert(wheel_now(w) == 5000);
+
+	// Timers on every level, scheduled in a scrambled order.
+	const long delays[] = { 1, 2, 63, 64, 65, 100, 4095, 4096, 4097, 70000, 262143, 262144, 300000, 1 << 20 };
+	const size_t delayCount = sizeof(delays) / sizeof(delays[0]);
+	for (size_t i = 0; i < delayCount; ++i) {
+		long when = 5000 + delays[(i * 5) % delayCount];
+		assert(wheel_schedule(w, when, (void*)(size_t)when) != NULL);
+	}
+	assert(wheel_count(w) == delayCount);
+
+	// Cancelled and rescheduled timers.
+	WheelTimer* cancelled = wheel_schedule(w, 5010, (void*)(size_t)5010);
+	WheelTimer* moved = wheel_schedule(w, 5020, (void*)(size_t)7000);
+	wheel_cancel(w, cancelled);
+	wheel_cancel(w, NULL);
+	wheel_reschedule(w, moved, 7000);
+	assert(wheel_count(w) == delayCount + 1);
+
+	state.last = 5000;
+	assert(wheel_advance(w, 5064, test_fire, &state) == 4);
+	assert(wheel_advance(w, 5064, test_fire, &state) == 0);
+	assert(wheel_advance(w, 10000, test_fire, &state) == 6);
+	assert(wheel_advance(w, 5000 + (1 << 20) - 1, test_fire, &state) == 4);
+	assert(wheel_count(w) == 1);
+	assert(wheel_advance(w, 5000 + (1 << 20), test_fire, &state) == 1);
+	assert(state.fired == delayCount + 1);
+	assert(wheel_count(w) == 0);
+
+	// A time that is not in the future fires on the next advance.
+	long now = wheel_now(w);
+	wheel_schedule(w, now - 10, (void*)(size_t)(now + 1));
+	state.last = now;
+	assert(wheel_advance(w, now + 1, test_fire, &state) == 1);
+
+	// Timers left in the wheel are freed with it.
+	wheel_schedule(w, now + 100, NULL);
+	wheel_schedule(w, now + 100000, NULL);
+	wheel_destroy(w);
+}
@@ -0,0 +1,59 @@
+#include "TypedVector.h"
+#include "Date.h"
+#include <assert.h>
+
+VECTOR_DEFINE(Date, DateVector, dateVec)
+
+void test_typed_vector()
+{
+	IntVector ints;
+	intVec_init(&ints);
+	assert(intVec_length(&ints) == 0);
+	assert(intVec_capacity(&ints) == 0);
+	assert(intVec_get(&ints, 0) == NULL);
+
+	for (int i = 0; i < 100; ++i)
+		assert(intVec_add(&ints, i * i));
+	assert(intVec_length(&ints) == 100);
+	assert(intVec_capacity(&ints) >= 100);
+	for (size_t i = 0; i < 100; ++i) {
+		assert(*intVec_at(&ints, i) == (int)(i * i));
+		assert(intVec_get(&ints, i) == &intVec_array(&ints)[i]);
+	}
+	assert(intVec_get(&ints, 100) == NULL);
+
+	*intVec_at(&ints, 0) = -1;
+	assert(intVec_array(&ints)[0] == -1);
+
+	intVec_removeFastAt(&ints, 0);
+	assert(intVec_length(&ints) == 99);
+	assert(*intVec_at(&ints, 0) == 99 * 99);
+	intVec_removeFastAt(&ints, 99);
+	assert(intVec_length(&ints) == 99);
+	assert(intVec_removeLast(&ints) == 98 * 98);
+	assert(intVec_length(&ints) == 98);
+
+	size_t capacity = intVec_capacity(&ints);
+	intVec_clear(&ints);
+	assert(intVec_length(&ints) == 0);
+	assert(intVec_capacity(&ints) == capacity);
+	assert(intVec_reserve(&ints, capacity * 4));
+	assert(intVec_capacity(&ints) == capacity * 4);
+	assert(intVec_reserve(&ints, 1));
+	assert(intVec_capacity(&ints) == capacity * 4);
+
+	intVec_free(&ints);
+	assert(intVec_length(&ints) == 0 && intVec_array(&ints) == NULL);
+
+	// Structs are stored by value, in one array.
+	DateVector dates;
+	dateVec_init(&dates);
+	Date date = { 2022, 1, 1 };
+	for (int i = 0; i < 10; ++i) {
+		date.day = i + 1;
+		assert(dateVec_add(&dates, date));
+	}
+	assert(dateVec_at(&dates, 9)->day == 10);
+	assert(dateVec_at(&dates, 1) == dateVec_at(&dates, 0) + 1);
+	dateVec_free(&dates);
+}
@@ -1,6 +1,25 @@
 #include "Vector.h"
 #include <assert.h>
 
+static int test_compareInts(void* context, const void* a, const void* b)
+{
+	assert(context == (void*)1);
+	return ((size_t)a > (size_t)b) - ((size_t)a < (size_t)b);
+}
+
+static int test_isOdd(void* context, const void* item)
+{
+	(void)context;
+	return (size_t)item % 2 == 1;
+}
+
+static void test_sortAndCheck(Vector* vec)
+{
+	vector_sort(vec, test_compareInts, (void*)1);
+	for (size_t i = 1; i < vector_length(vec); ++i)
+		assert((size_t)vector_get(vec, i - 1) <= (size_t)vector_get(vec, i));
+}
+
 void test_vector()
 {
 	Vector* vec = vector_create(0);
@@ -54,6 +73,20 @@ void test_vector()
 	assert(vector_get(cvec, 1) == (void*)500);
 	assert(vector_get(cvec, 2) == (void*)400);
 
+	vector_insertAt(vec, 0, (void*)100);
+	vector_insertAt(vec, 2, (void*)150);
+	vector_insertAt(vec, 5, (void*)600);
+	vector_insertAt(vec, 6, (void*)700);
+
+	assert(vector_length(cvec) == 7);
+	assert(vector_get(cvec, 0) == (void*)100);
+	assert(vector_get(cvec, 1) == (void*)200);
+	assert(vector_get(cvec, 2) == (void*)150);
+	assert(vector_get(cvec, 3) == (void*)500);
+	assert(vector_get(cvec, 4) == (void*)400);
+	assert(vector_get(cvec, 5) == (void*)600);
+	assert(vector_get(cvec, 6) == (void*)700);
+
 	vector_clear(vec);
 
 	assert(vector_capacity(cvec) == 0);
@@ -61,4 +94,87 @@ void test_vector()
 	assert(cvec->array == NULL);
 
 	vector_destroy(vec);
+
+	// Bulk operations.
+	void* items[100];
+	for (size_t i = 0; i < 100; ++i)
+		items[i] = (void*)(i + 1);
+
+	vec = vector_create(0);
+	cvec = vec;
+	vector_addRange(vec, items, 0);
+	assert(vector_length(cvec) == 0);
+	vector_addRange(vec, items, 100);
+	assert(vector_length(cvec) == 100);
+	for (size_t i = 0; i < 100; ++i)
+		assert(vector_get(cvec, i) == items[i]);
+
+	assert(vector_removeIf(vec, test_isOdd, NULL) == 50);
+	assert(vector_length(cvec) == 50);
+	for (size_t i = 0; i < 50; ++i)
+		assert(vector_get(cvec, i) == (void*)(2 * i + 2));
+	assert(vector_removeIf(vec, test_isOdd, NULL) == 0);
+
+	// Removals do not shrink small containers, so removing and adding does not reallocate.
+	vector_clear(vec);
+	vector_addRange(vec, items, 6);
+	size_t capacity = vector_capacity(cvec);
+	for (int i = 0; i < 10; ++i) {
+		vector_removeAt(vec, 0);
+		vector_removeFastAt(vec, 0);
+		vector_removeAt(vec, 0);
+		vector_addRange(vec, items, 3);
+		assert(vector_capacity(cvec) == capacity);
+	}
+
+	// Big containers still shrink when mostly empty.
+	vector_clear(vec);
+	vector_addRange(vec, items, 100);
+	while (vector_length(cvec) > 10)
+		vector_removeFastAt(vec, 0);
+	assert(vector_capacity(cvec) <= VECTOR_MIN_SHRINK_CAPACITY * 4);
+	assert(vector_capacity(cvec) >= VECTOR_MIN_SHRINK_CAPACITY);
+
+	// Sorting: random, sorted, reversed and many equal values.
+	vector_clear(vec);
+	unsigned int seed = 7;
+	for (size_t i = 0; i < 1000; ++i) {
+		seed = seed * 1103515245u + 12345u;
+		vector_add(vec, (void*)(size_t)((seed >> 16) % 500));
+	}
+	test_sortAndCheck(vec);
+	test_sortAndCheck(vec);
+
+	vector_clear(vec);
+	for (size_t i = 1000; i > 0; --i)
+		vector_add(vec, (void*)(i % 3));
+	test_sortAndCheck(vec);
+
+	vector_clear(vec);
+	for (size_t i = 1000; i > 0; --i)
+		vector_add(vec, (void*)i);
+	test_sortAndCheck(vec);
+	assert(vector_get(cvec, 0) == (void*)1);
+	assert(vector_get(cvec, 999) == (void*)1000);
+
+	// Binary search returns the first element not before the key.
+	assert(vector_bsearch(vec, (void*)1, test_compareInts, (void*)1) == 0);
+	assert(vector_bsearch(vec, (void*)500, test_compareInts, (void*)1) == 499);
+	assert(vector_bsearch(vec, (void*)0, test_compareInts, (void*)1) == 0);
+	assert(vector_bsearch(vec, (void*)1001, test_compareInts, (void*)1) == 1000);
+
+	// Merging two sorted vectors.
+	Vector* evens = vector_create(0);
+	Vector* odds = vector_create(0);
+	for (size_t i = 0; i < 20; ++i)
+		vector_add(i % 2 ? odds : evens, (void*)i);
+	vector_clear(vec);
+	vector_merge(vec, evens, odds, test_compareInts, (void*)1);
+	assert(vector_length(cvec) == 20);
+	for (size_t i = 0; i < 20; ++i)
+		assert(vector_get(cvec, i) == (void*)i);
+	vector_destroy(evens);
+	vector_destroy(odds);
+
+	vector_destroy(vec);
 }
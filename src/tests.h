@@ -2,13 +2,41 @@
 #define TESTS
 
 void test_material();
+void test_quantity();
+void test_date();
 void test_vector();
+void test_typed_vector();
+void test_int_map();
+void test_arena();
+void test_thread();
+void test_codec();
+void test_memory_tracker();
+void test_bitmap();
+void test_histogram();
+void test_latency_recorder();
+void test_span_tracer();
+void test_scan();
+void test_hash_map();
+void test_string_trie();
+void test_fuzzy_match();
+void test_timing_wheel();
 void test_material_validator();
 void test_material_operation();
+void test_material_batch();
+void test_material_pipeline();
+void test_material_generator();
 
 void test_material_repository();
 
 void test_material_service();
+void test_material_query();
+void test_material_cursor();
+void test_material_views();
+void test_material_stats();
+void test_material_expiry();
+void test_material_trace();
+void test_material_oracle();
+void test_material_replication();
 
 void test_all();
 